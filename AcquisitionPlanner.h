@@ -0,0 +1,162 @@
+/*****************************************************************************
+ *
+ * Humidity Acquisition Planning from Change Statistics
+ *
+ * file:     AcquisitionPlanner.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * decide per acquisition of one sensor channel whether a humidity conversion
+ * is needed or a temperature-only conversion is sufficient
+ *
+ * The humidity conversion is the longest and most expensive sensor phase.
+ * Humidity is requested if
+ * - no humidity is known or the last humidity read failed
+ * - the max. number of acquisitions without humidity is reached
+ * - the temperature changed since the last humidity by the temperature delta
+ *   (relative humidity changes ~5 %/°C at constant absolute humidity)
+ * - the expected humidity change reaches the humidity delta, estimated from
+ *   the average humidity change per acquisition of the past conversions
+ *
+ * The decision is made before the acquisition, so a temperature change is
+ * followed by a humidity conversion in the next acquisition.
+ */
+class AcquisitionPlanner
+{
+public:
+  static const byte RATE_WEIGHT = 4; // moving average of humidity change rate over ~4 conversions
+
+  enum Trigger
+  {
+    TRIGGER_NONE,         // temperature-only
+    TRIGGER_UNKNOWN,      // no humidity known or last read failed
+    TRIGGER_EVERY,        // max. acquisitions without humidity
+    TRIGGER_TEMPERATURE,  // temperature delta
+    TRIGGER_HUMIDITY      // expected humidity delta
+  };
+
+public:
+  /**
+   * @param every max. acquisitions per humidity conversion, 1 = always
+   * @param temperatureDelta [°C]
+   * @param humidityDelta [%]
+   */
+  AcquisitionPlanner(byte every, float temperatureDelta, float humidityDelta) :
+    every(every), temperatureDelta(temperatureDelta), humidityDelta(humidityDelta) {}
+
+public:
+  bool isHumidityDue() const
+  {
+    return getTrigger() != TRIGGER_NONE;
+  }
+
+  /**
+   * @return reason for the next humidity conversion, TRIGGER_NONE if not due
+   */
+  Trigger getTrigger() const
+  {
+    if (!known)
+    {
+      return TRIGGER_UNKNOWN;
+    }
+    if (skipped + 1 >= every)
+    {
+      return TRIGGER_EVERY;
+    }
+    float dt = temperature - humidityTemperature;
+    if ((dt >= 0? dt : -dt) >= temperatureDelta)
+    {
+      return TRIGGER_TEMPERATURE;
+    }
+    return rate*(skipped + 1) >= humidityDelta? TRIGGER_HUMIDITY : TRIGGER_NONE;
+  }
+
+  /**
+   * humidity and temperature acquired
+   */
+  void addHumidity(float humidity, float temperature)
+  {
+    if (known)
+    {
+      // change per acquisition, averaged
+      float dh = humidity - this->humidity;
+      float change = (dh >= 0? dh : -dh)/(skipped + 1);
+      rate += (change - rate)/RATE_WEIGHT;
+    }
+    known = true;
+    skipped = 0;
+    this->humidity = humidity;
+    this->temperature = temperature;
+    humidityTemperature = temperature;
+  }
+
+  /**
+   * temperature-only acquisition
+   */
+  void addTemperature(float temperature)
+  {
+    this->temperature = temperature;
+    if (skipped < 255)
+    {
+      skipped++;
+    }
+  }
+
+  /**
+   * humidity requested but not read, request again next time
+   */
+  void setFailed()
+  {
+    known = false;
+  }
+
+  /**
+   * @return acquisitions without humidity since last conversion
+   */
+  byte getSkipped() const
+  {
+    return skipped;
+  }
+
+  /**
+   * @return [%] average humidity change per acquisition
+   */
+  float getRate() const
+  {
+    return rate;
+  }
+
+private:
+  byte every;
+  float temperatureDelta;
+  float humidityDelta;
+  bool known = false;
+  byte skipped = 0;
+  float humidity = 0;
+  float temperature = 0;
+  float humidityTemperature = 0;
+  float rate = 0;
+};
@@ -0,0 +1,294 @@
+/*****************************************************************************
+ *
+ * Asynchronous ADC Sequence for Supply Voltage and MCU Temperature
+ *
+ * file:     AdcSequencer.hpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+#include "DirectMemoryAccess.hpp"
+
+/**
+ * convert SCALEDIOVCC and optionally TEMP in one free running input scan,
+ * collect the raw samples with DMA and disable the ADC on completion
+ *
+ * The scan starts at TEMP (0x18) and ends at SCALEDIOVCC (0x1B), BANDGAP and
+ * SCALEDCOREVCC are converted but ignored. Without temperature only
+ * SCALEDIOVCC is converted.
+ *
+ * Samples are averaged in software. The standard deviation of the samples is
+ * tracked per input and the number of samples for the next sequence is the
+ * smallest power of 2 that brings the standard error of the mean below the
+ * target resolution of each input.
+ *
+ * The ADC must be clocked and calibrated (Analog2DigitalConverter::enable()),
+ * the sequence uses the internal 1.0 V reference, 12 bit resolution and an
+ * ADC clock of max. 500 kHz.
+ */
+class AdcSequencer
+{
+public:
+  enum Input
+  {
+    INPUT_TEMPERATURE,
+    INPUT_BANDGAP,
+    INPUT_CORE_VCC,
+    INPUT_IO_VCC,
+    INPUTS
+  };
+
+  static const byte MIN_SAMPLES = 2;      // for noise estimate
+  static const byte MAX_SAMPLES = 16;
+  static const byte SAMPLE_LENGTH = 3;    // SAMPCTRL.SAMPLEN, sampling time (SAMPLEN+1)/2 ADC clocks
+  static const uint32_t MAX_ADC_CLOCK = 500000; // [Hz]
+
+  static constexpr float TARGET_VOLTAGE = 0.005;     // [V] supply voltage resolution
+  static constexpr float TARGET_TEMPERATURE = 0.1;   // [°C] temperature resolution
+
+  typedef void (*Callback)();
+
+private:
+  AdcSequencer() = default;
+
+public:
+  static AdcSequencer& instance()
+  {
+    static AdcSequencer sequencer;
+    return sequencer;
+  }
+
+public:
+  /**
+   * select ADC prescaler, read temperature calibration and enable temperature sensor
+   *
+   * @param gclkFrequency [Hz] frequency of ADC generic clock
+   */
+  void enable(uint32_t gclkFrequency)
+  {
+    DirectMemoryAccess::instance().enable();
+
+    // smallest prescaler DIV4..DIV512 for max. ADC clock
+    prescaler = 0;
+    while (prescaler < 7 && (gclkFrequency >> (prescaler + 2)) > MAX_ADC_CLOCK)
+    {
+      prescaler++;
+    }
+    adcClock = gclkFrequency >> (prescaler + 2);
+
+    // temperature log row (datasheet 10.3.2)
+    uint32_t log0 = *(volatile uint32_t*)NVMCTRL_TEMP_LOG;
+    uint32_t log1 = *(volatile uint32_t*)(NVMCTRL_TEMP_LOG + 4);
+    roomTemperature = (log0 & 0xFF) + ((log0 >> 8) & 0xF)/10.0f;
+    hotTemperature = ((log0 >> 12) & 0xFF) + ((log0 >> 20) & 0xF)/10.0f;
+    roomInt1V = 1 - (int8_t)(log0 >> 24)/1000.0f;
+    hotInt1V = 1 - (int8_t)(log1 & 0xFF)/1000.0f;
+    roomAdc = (log1 >> 8) & 0xFFF;
+    hotAdc = (log1 >> 20) & 0xFFF;
+
+    SYSCTRL->VREF.reg |= SYSCTRL_VREF_TSEN;
+  }
+
+  /**
+   * start sequence, ADC is enabled until completion
+   *
+   * @param temperature include TEMP input
+   * @param callback called from DMAC ISR on completion, may be null
+   * @return false if a sequence is in progress
+   */
+  bool start(bool temperature, Callback callback)
+  {
+    if (busy)
+    {
+      return false;
+    }
+    busy = true;
+    withTemperature = temperature;
+    this->callback = callback;
+    inputs = temperature? INPUTS : 1;
+
+    // single samples, averaging in software
+    ADC->CTRLA.reg &= ~ADC_CTRLA_ENABLE;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->REFCTRL.reg = ADC_REFCTRL_REFSEL_INT1V;
+    ADC->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM_1 | ADC_AVGCTRL_ADJRES(0);
+    ADC->SAMPCTRL.reg = ADC_SAMPCTRL_SAMPLEN(SAMPLE_LENGTH);
+    ADC->INPUTCTRL.reg = ADC_INPUTCTRL_MUXPOS(temperature? ADC_INPUTCTRL_MUXPOS_TEMP_Val : ADC_INPUTCTRL_MUXPOS_SCALEDIOVCC_Val)
+                       | ADC_INPUTCTRL_MUXNEG_GND | ADC_INPUTCTRL_INPUTSCAN(inputs - 1) | ADC_INPUTCTRL_GAIN_1X;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->CTRLB.reg = ADC_CTRLB_PRESCALER(prescaler) | ADC_CTRLB_RESSEL_12BIT | ADC_CTRLB_FREERUN;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->INTFLAG.reg = ADC_INTFLAG_MASK;
+
+    DirectMemoryAccess::instance().start(DirectMemoryAccess::CHANNEL_ADC, ADC_DMAC_ID_RESRDY, &ADC->RESULT.reg, samples,
+                                         samplesPerInput*inputs, DMAC_BTCTRL_BEATSIZE_HWORD | DMAC_BTCTRL_DSTINC,
+                                         []{ AdcSequencer::instance().complete(); });
+
+    ADC->CTRLA.reg |= ADC_CTRLA_ENABLE;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->SWTRIG.reg = ADC_SWTRIG_START;
+
+    return true;
+  }
+
+  bool isBusy() const
+  {
+    return busy;
+  }
+
+  /**
+   * busy wait for completion, serves the DMAC interrupt if it cannot preempt the caller
+   */
+  void wait()
+  {
+    while (busy)
+    {
+      if (NVIC_GetPendingIRQ(DMAC_IRQn))
+      {
+        NVIC_ClearPendingIRQ(DMAC_IRQn);
+        DirectMemoryAccess::instance().handleInterrupt();
+      }
+    }
+  }
+
+  /**
+   * @return [V] supply voltage of last sequence
+   */
+  float getSupplyVoltage() const
+  {
+    return 4*means[INPUT_IO_VCC]/4095;
+  }
+
+  /**
+   * @return [°C] MCU temperature of last sequence with temperature
+   */
+  float getTemperature() const
+  {
+    // datasheet 37.11.8.2.1: coarse value with INT1V = 1.0 V, fine value with interpolated INT1V
+    float roomVoltage = roomAdc*roomInt1V/4095;
+    float hotVoltage = hotAdc*hotInt1V/4095;
+    float slope = (hotTemperature - roomTemperature)/(hotVoltage - roomVoltage);
+    float coarse = roomTemperature + (means[INPUT_TEMPERATURE]/4095 - roomVoltage)*slope;
+    float int1V = roomInt1V + (hotInt1V - roomInt1V)*(coarse - roomTemperature)/(hotTemperature - roomTemperature);
+    return roomTemperature + (means[INPUT_TEMPERATURE]*int1V/4095 - roomVoltage)*slope;
+  }
+
+  /**
+   * @return number of samples per input of next sequence
+   */
+  byte getSamples() const
+  {
+    return samplesPerInput;
+  }
+
+  /**
+   * @return [µs] ADC conversion time of next sequence
+   */
+  uint32_t getConversionTime() const
+  {
+    // sampling (SAMPLEN+1)/2 + 12 bit conversion 7 ADC clocks per sample
+    return (uint64_t)samplesPerInput*(withTemperature? INPUTS : 1)*((SAMPLE_LENGTH + 1)/2.0f + 7)*1000000/adcClock;
+  }
+
+private:
+  /**
+   * DMAC ISR (prio 3)
+   */
+  void complete()
+  {
+    ADC->CTRLA.reg &= ~ADC_CTRLA_ENABLE;
+
+    // mean and standard deviation per input, samples are interleaved by scan
+    byte required = MIN_SAMPLES;
+    for (byte input=0; input<inputs; input++)
+    {
+      byte index = withTemperature? input : (byte)INPUT_IO_VCC;
+      uint32_t sum = 0, sumSquares = 0;
+      for (byte i=0; i<samplesPerInput; i++)
+      {
+        uint32_t sample = samples[i*inputs + input];
+        sum += sample;
+        sumSquares += sample*sample;
+      }
+      float mean = (float)sum/samplesPerInput;
+      float variance = ((float)sumSquares/samplesPerInput - mean*mean)*samplesPerInput/(samplesPerInput - 1);
+      means[index] = mean;
+      noise[index] += ((variance > 0? sqrtf(variance) : 0) - noise[index])/4;
+
+      // samples for standard error of mean below target resolution
+      float target = getTargetLsb(index);
+      if (target > 0)
+      {
+        float n = noise[index]*noise[index]/(target*target);
+        while (required < MAX_SAMPLES && required < n)
+        {
+          required <<= 1;
+        }
+      }
+    }
+    samplesPerInput = required;
+
+    busy = false;
+    if (callback)
+    {
+      callback();
+    }
+  }
+
+  /**
+   * @return target resolution of input [LSB], 0 if input is ignored
+   */
+  float getTargetLsb(byte input) const
+  {
+    switch (input)
+    {
+      case INPUT_IO_VCC:
+        return TARGET_VOLTAGE/4*4095;
+      case INPUT_TEMPERATURE:
+        return TARGET_TEMPERATURE*(hotAdc - roomAdc)/(hotTemperature - roomTemperature);
+      default:
+        return 0;
+    }
+  }
+
+private:
+  volatile bool busy = false;
+  byte prescaler = 0;
+  uint32_t adcClock = 0; // [Hz]
+  bool withTemperature = false;
+  byte inputs = 1;
+  byte samplesPerInput = 8;
+  Callback callback = nullptr;
+  uint16_t samples[MAX_SAMPLES*INPUTS];
+  float means[INPUTS] = {};
+  float noise[INPUTS] = {};   // [LSB] standard deviation, rolling average
+  float roomTemperature = 25;
+  float hotTemperature = 85;
+  float roomInt1V = 1;
+  float hotInt1V = 1;
+  uint16_t roomAdc = 0;
+  uint16_t hotAdc = 1;
+};
@@ -0,0 +1,222 @@
+/*****************************************************************************
+ *
+ * Per-phase CPU Clock Scaling for SAMD21
+ *
+ * file:     ClockManager.hpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <System.h>
+using namespace SAMD21LPE;
+
+/**
+ * switch the CPU clock (GCLK0) between a low speed for waiting phases and a
+ * high speed for compute bursts while the peripherals run from a separate
+ * generator with fixed frequency
+ *
+ * GCLK0 sources:
+ * - high: DFLL48M (F_CPU 48 MHz) or OSC8M (F_CPU 8 MHz)
+ * - low:  OSC8M divided by low divider (default 1 MHz)
+ *
+ * Peripherals (SERCOM, ADC, TC, TCC, EIC) must be attached to the peripheral
+ * generator (GCLK3, OSC8M 8 MHz, same as Arduino core) to keep baud rates,
+ * prescalers and timer ticks independent of the CPU clock. The Arduino
+ * libraries select GCLK0 whenever they configure the SERCOM: Wire in begin()
+ * and setClock() with a baud rate calculated from SystemCoreClock, SPI in
+ * begin() and in beginTransaction() if the settings differ from the last
+ * transaction, with a baud rate calculated from SERCOM_SPI_FREQ_REF. After
+ * each of these calls attach() must reconnect the peripheral generator and
+ * setWireBaud() or setSpiBaud() must set the baud rate for it.
+ *
+ * SysTick and SystemCoreClock are updated on each switch, so millis(),
+ * delay() and SystemCoreClock based calculations stay valid.
+ *
+ * USB is clocked by GCLK0 and requires 48 MHz, do not switch to low speed
+ * while USB is used.
+ */
+class ClockManager
+{
+public:
+  static const byte GCLKGEN_ID_PERIPHERAL = 3;
+  static const uint32_t PERIPHERAL_CLOCK = 8000000; // [Hz]
+
+  enum Speed
+  {
+    SPEED_LOW,
+    SPEED_HIGH
+  };
+
+private:
+  ClockManager() = default;
+
+public:
+  static ClockManager& instance()
+  {
+    static ClockManager clockManager;
+    return clockManager;
+  }
+
+public:
+  /**
+   * configure peripheral generator, CPU clock remains at high speed
+   *
+   * @param lowDivider OSC8M divider for low speed, 1..255
+   */
+  void enable(byte lowDivider = 8)
+  {
+    this->lowDivider = lowDivider? lowDivider : 1;
+
+    // OSC8M without prescaler
+    SYSCTRL->OSC8M.bit.PRESC = 0;
+
+    // peripheral generator: OSC8M / 1
+    GCLK->GENDIV.reg = GCLK_GENDIV_ID(GCLKGEN_ID_PERIPHERAL) | GCLK_GENDIV_DIV(1);
+    while (GCLK->STATUS.bit.SYNCBUSY);
+    GCLK->GENCTRL.reg = GCLK_GENCTRL_ID(GCLKGEN_ID_PERIPHERAL) | GCLK_GENCTRL_SRC_OSC8M | GCLK_GENCTRL_IDC | GCLK_GENCTRL_GENEN;
+    while (GCLK->STATUS.bit.SYNCBUSY);
+
+    speed = SPEED_HIGH;
+  }
+
+  /**
+   * connect peripheral clock to peripheral generator
+   *
+   * @param clockId GCLK_CLKCTRL_ID_* or GCM_*
+   */
+  void attach(byte clockId)
+  {
+    System::enableClock(clockId, GCLKGEN_ID_PERIPHERAL);
+  }
+
+  /**
+   * @param index SERCOM index (SERCOM::getSercomIndex())
+   */
+  static Sercom* getSercom(byte index)
+  {
+    static Sercom* const SERCOMS[] = SERCOM_INSTS;
+    return SERCOMS[index];
+  }
+
+  /**
+   * set I2C master baud rate for the peripheral generator
+   *
+   * @param riseTime [ns] SCL rise time
+   */
+  static void setWireBaud(Sercom* sercom, uint32_t baud, uint16_t riseTime = 125)
+  {
+    // datasheet 28.6.2.4.1: fSCL = fGCLK/(10 + 2*BAUD + fGCLK*tRISE)
+    sercom->I2CM.CTRLA.bit.ENABLE = 0;
+    while (sercom->I2CM.SYNCBUSY.bit.ENABLE);
+    sercom->I2CM.BAUD.bit.BAUD = PERIPHERAL_CLOCK/(2*baud) - 5 - (PERIPHERAL_CLOCK/1000000*riseTime)/2000;
+    sercom->I2CM.CTRLA.bit.ENABLE = 1;
+    while (sercom->I2CM.SYNCBUSY.bit.ENABLE);
+    sercom->I2CM.STATUS.bit.BUSSTATE = 1; // idle
+    while (sercom->I2CM.SYNCBUSY.bit.SYSOP);
+  }
+
+  /**
+   * set SPI master baud rate for the peripheral generator, max. PERIPHERAL_CLOCK/2
+   */
+  static void setSpiBaud(Sercom* sercom, uint32_t baud)
+  {
+    // datasheet 26.6.2.3: fBAUD = fGCLK/(2*(BAUD + 1)), round up to stay below baud
+    uint32_t divider = (PERIPHERAL_CLOCK + 2*baud - 1)/(2*baud);
+    sercom->SPI.CTRLA.bit.ENABLE = 0;
+    while (sercom->SPI.SYNCBUSY.bit.ENABLE);
+    sercom->SPI.BAUD.reg = divider? divider - 1 : 0;
+    sercom->SPI.CTRLA.bit.ENABLE = 1;
+    while (sercom->SPI.SYNCBUSY.bit.ENABLE);
+  }
+
+  /**
+   * switch CPU clock, may be called from ISR
+   */
+  void setSpeed(Speed speed)
+  {
+    if (speed == this->speed)
+    {
+      return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (speed == SPEED_HIGH)
+    {
+      // remove divider first, OSC8M / 1 is valid for both sources
+      GCLK->GENDIV.reg = GCLK_GENDIV_ID(0) | GCLK_GENDIV_DIV(1);
+      while (GCLK->STATUS.bit.SYNCBUSY);
+    #if F_CPU == 48000000L
+      GCLK->GENCTRL.reg = GCLK_GENCTRL_ID(0) | GCLK_GENCTRL_SRC_DFLL48M | GCLK_GENCTRL_IDC | GCLK_GENCTRL_GENEN;
+      while (GCLK->STATUS.bit.SYNCBUSY);
+    #endif
+    }
+    else
+    {
+      // switch source first, then divide
+      GCLK->GENCTRL.reg = GCLK_GENCTRL_ID(0) | GCLK_GENCTRL_SRC_OSC8M | GCLK_GENCTRL_IDC | GCLK_GENCTRL_GENEN;
+      while (GCLK->STATUS.bit.SYNCBUSY);
+      GCLK->GENDIV.reg = GCLK_GENDIV_ID(0) | GCLK_GENDIV_DIV(lowDivider);
+      while (GCLK->STATUS.bit.SYNCBUSY);
+    }
+
+    this->speed = speed;
+    switchCount++;
+
+    // keep 1 ms SysTick
+    SystemCoreClock = getCpuClock(speed);
+    SysTick->LOAD = SystemCoreClock/1000 - 1;
+    SysTick->VAL = 0;
+
+    __set_PRIMASK(primask);
+  }
+
+  Speed getSpeed() const
+  {
+    return speed;
+  }
+
+  /**
+   * @return CPU clock [Hz] at given speed
+   */
+  uint32_t getCpuClock(Speed speed) const
+  {
+    return speed == SPEED_HIGH? F_CPU : PERIPHERAL_CLOCK/lowDivider;
+  }
+
+  /**
+   * @return number of speed switches since power up
+   */
+  uint32_t getSwitchCount() const
+  {
+    return switchCount;
+  }
+
+private:
+  Speed speed = SPEED_HIGH;
+  byte lowDivider = 8;
+  uint32_t switchCount = 0;
+};
@@ -0,0 +1,367 @@
+/*****************************************************************************
+ *
+ * Compact Sensor Frame with Forward Error Correction
+ *
+ * file:     CompactFrame.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef RAMFUNC
+  #define RAMFUNC // execution from RAM, see option HAS_RAMFUNC of SolarDHTConfig.h
+#endif
+
+/**
+ * compact temperature/humidity frame with convolutional code and bit
+ * interleaving as alternative to the Oregon Scientific frame (option HAS_FEC)
+ *
+ * payload (6 bytes, little endian):
+ *
+ *   offset  size  content
+ *   0       1     rolling code
+ *   1       1     channel (bits 0..1), low battery (bit 7)
+ *   2       2     temperature [0.1 °C], signed
+ *   4       1     humidity [%]
+ *   5       1     CRC-8 (poly 0x31, init 0xFF) over bytes 0..4
+ *
+ * The payload bits followed by 6 zero tail bits are encoded with the
+ * convolutional code K=7, rate 1/2 (polynomials 171/133 octal, free distance
+ * 10) and the 108 code bits are interleaved with a 12x9 block interleaver, so
+ * a burst of up to 12 bit errors on air becomes single errors 9 code bits
+ * apart. The receiver uses a hard decision Viterbi decoder.
+ *
+ * frame on air: preamble 0xFF 0xFF 0xFF (as Oregon Scientific 3.0, needed by
+ * the demodulator to settle), sync 0x96, 14 bytes code bits
+ *
+ * Bit n of the code stream is bit n%8 of byte n/8, matching the LSB first
+ * transmission of the radio. Coding and interleaving can be disabled for
+ * comparison on the host, the payload is then sent as is.
+ *
+ * The frame is not understood by rtl_433, see host/OregonDecode.cpp.
+ */
+class CompactFrame
+{
+public:
+  static const byte PREAMBLE_SIZE = 3;   // [bytes]
+  static const byte SYNC = 0x96;
+  static const byte PAYLOAD_SIZE = 6;    // [bytes]
+  static const byte TAIL_BITS = 6;       // constraint length - 1
+  static const byte CODE_BITS = 2*(8*PAYLOAD_SIZE + TAIL_BITS);
+  static const byte CODE_SIZE = (CODE_BITS + 7)/8; // [bytes]
+  static const byte INTERLEAVER_ROWS = 12;
+  static const byte INTERLEAVER_COLUMNS = CODE_BITS/INTERLEAVER_ROWS;
+  static const byte MAX_FRAME_SIZE = PREAMBLE_SIZE + 1 + CODE_SIZE; // [bytes]
+
+  struct Data
+  {
+    byte channel;     // 1 .. 3
+    byte rollingCode;
+    bool lowBatt;
+    float temp;       // [°C]
+    byte hum;         // [%]
+  };
+
+public:
+  CompactFrame() = default;
+
+public:
+  /**
+   * if disabled the payload is sent without convolutional code, default enabled
+   */
+  void setCoding(bool enabled)
+  {
+    coding = enabled;
+  }
+
+  /**
+   * if disabled the code bits are sent in order, default enabled
+   */
+  void setInterleaving(bool enabled)
+  {
+    interleaving = enabled;
+  }
+
+  /**
+   * @return size of frame incl. preamble and sync [bytes]
+   */
+  byte getFrameSize() const
+  {
+    return PREAMBLE_SIZE + 1 + getCodeSize();
+  }
+
+  /**
+   * @return size of frame after sync [bytes]
+   */
+  byte getCodeSize() const
+  {
+    return coding? CODE_SIZE : PAYLOAD_SIZE;
+  }
+
+  /**
+   * @param temp temperature [°C], min -3276.8, max 3276.7
+   * @param hum humidity [%]
+   * @return frame size [bytes] or 0 on error
+   */
+  RAMFUNC byte encodeTH(byte channel, byte rollingCode, bool lowBatt, float temp, byte hum)
+  {
+    if (channel < 1 || channel > 3)
+    {
+      return 0;
+    }
+
+    byte payload[PAYLOAD_SIZE];
+    int16_t t = (int16_t)(temp >= 0? temp*10 + 0.5f : temp*10 - 0.5f);
+    payload[0] = rollingCode;
+    payload[1] = (channel & 0x03) | (lowBatt? 0x80 : 0);
+    payload[2] = t & 0xFF;
+    payload[3] = (uint16_t)t >> 8;
+    payload[4] = hum;
+    payload[5] = crc8(payload, PAYLOAD_SIZE - 1);
+
+    for (byte i=0; i<PREAMBLE_SIZE; i++)
+    {
+      message[i] = 0xFF;
+    }
+    message[PREAMBLE_SIZE] = SYNC;
+    encode(payload, message + PREAMBLE_SIZE + 1);
+
+    return getFrameSize();
+  }
+
+  byte* getMessage()
+  {
+    return message;
+  }
+
+  /**
+   * encode payload
+   *
+   * @param payload PAYLOAD_SIZE bytes
+   * @param code getCodeSize() bytes
+   */
+  void encode(const byte* payload, byte* code) const
+  {
+    if (!coding)
+    {
+      for (byte i=0; i<PAYLOAD_SIZE; i++)
+      {
+        code[i] = payload[i];
+      }
+      return;
+    }
+
+    for (byte i=0; i<CODE_SIZE; i++)
+    {
+      code[i] = 0;
+    }
+    byte state = 0;
+    for (byte i=0; i<8*PAYLOAD_SIZE + TAIL_BITS; i++)
+    {
+      byte bit = i < 8*PAYLOAD_SIZE? (payload[i/8] >> (i%8)) & 1 : 0;
+      byte out = output(state, bit);
+      setBit(code, interleave(2*i), out & 1);
+      setBit(code, interleave(2*i + 1), out >> 1);
+      state = ((state << 1) | bit) & (STATES - 1);
+    }
+  }
+
+  /**
+   * decode frame after sync
+   *
+   * @param code getCodeSize() bytes
+   * @param data decoded values
+   * @return true if CRC is valid
+   */
+  bool decode(const byte* code, Data& data)
+  {
+    byte payload[PAYLOAD_SIZE];
+    if (coding)
+    {
+      viterbi(code, payload);
+    }
+    else
+    {
+      for (byte i=0; i<PAYLOAD_SIZE; i++)
+      {
+        payload[i] = code[i];
+      }
+      corrected = 0;
+    }
+
+    if (crc8(payload, PAYLOAD_SIZE - 1) != payload[PAYLOAD_SIZE - 1] || (payload[1] & 0x03) == 0)
+    {
+      return false;
+    }
+    data.rollingCode = payload[0];
+    data.channel = payload[1] & 0x03;
+    data.lowBatt = payload[1] & 0x80;
+    data.temp = (int16_t)(payload[2] | (payload[3] << 8))/10.0f;
+    data.hum = payload[4];
+    return true;
+  }
+
+  /**
+   * @return number of code bits corrected by last decode()
+   */
+  byte getCorrected() const
+  {
+    return corrected;
+  }
+
+  static byte crc8(const byte* data, byte size)
+  {
+    byte crc = 0xFF;
+    for (byte i=0; i<size; i++)
+    {
+      crc ^= data[i];
+      for (byte j=0; j<8; j++)
+      {
+        crc = (crc & 0x80)? (crc << 1) ^ 0x31 : crc << 1;
+      }
+    }
+    return crc;
+  }
+
+private:
+  static const byte STATES = 64;
+  static const byte POLY_A = 0x79; // 171 octal
+  static const byte POLY_B = 0x5B; // 133 octal
+
+  static byte parity(byte x)
+  {
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return x & 1;
+  }
+
+  /**
+   * @param state previous 6 input bits, most recent in bit 0
+   * @return code bits A (bit 0) and B (bit 1)
+   */
+  static byte output(byte state, byte bit)
+  {
+    byte reg = (state << 1) | bit;
+    return parity(reg & POLY_A) | (parity(reg & POLY_B) << 1);
+  }
+
+  /**
+   * @return position on air of code bit
+   */
+  byte interleave(byte index) const
+  {
+    if (!interleaving)
+    {
+      return index;
+    }
+    byte row = index / INTERLEAVER_COLUMNS;
+    byte column = index % INTERLEAVER_COLUMNS;
+    return column*INTERLEAVER_ROWS + row;
+  }
+
+  static void setBit(byte* data, byte index, byte bit)
+  {
+    if (bit)
+    {
+      data[index/8] |= 1 << (index%8);
+    }
+  }
+
+  static byte getBit(const byte* data, byte index)
+  {
+    return (data[index/8] >> (index%8)) & 1;
+  }
+
+  /**
+   * hard decision Viterbi decoder, trellis terminated in state 0
+   */
+  void viterbi(const byte* code, byte* payload)
+  {
+    const byte STEPS = 8*PAYLOAD_SIZE + TAIL_BITS;
+    uint16_t metric[STATES];
+    uint16_t next[STATES];
+    uint64_t decisions[STEPS]; // bit s: predecessor of state s had the oldest bit set
+
+    // both polynomials use the newest and the oldest bit, so the 2 branches into a state differ in both code bits
+    byte branch[STATES];
+    for (byte s=0; s<STATES; s++)
+    {
+      metric[s] = s? 0x3FFF : 0;
+      branch[s] = output(s >> 1, s & 1);
+    }
+
+    for (byte i=0; i<STEPS; i++)
+    {
+      byte received = getBit(code, interleave(2*i)) | (getBit(code, interleave(2*i + 1)) << 1);
+      uint64_t decision = 0;
+      for (byte s=0; s<STATES; s++)
+      {
+        // state s = (previous state << 1 | bit) & 63, the 2 predecessors differ in bit 5
+        byte p0 = s >> 1;
+        byte p1 = p0 | (STATES >> 1);
+        byte d = branch[s] ^ received;
+        byte distance = (d & 1) + (d >> 1);
+        uint16_t m0 = metric[p0] + distance;
+        uint16_t m1 = metric[p1] + 2 - distance;
+        if (m1 < m0)
+        {
+          next[s] = m1;
+          decision |= (uint64_t)1 << s;
+        }
+        else
+        {
+          next[s] = m0;
+        }
+      }
+      decisions[i] = decision;
+      for (byte s=0; s<STATES; s++)
+      {
+        metric[s] = next[s];
+      }
+    }
+
+    // trace back from state 0
+    corrected = metric[0] > 255? 255 : metric[0];
+    for (byte i=0; i<PAYLOAD_SIZE; i++)
+    {
+      payload[i] = 0;
+    }
+    byte state = 0;
+    for (int i=STEPS - 1; i>=0; i--)
+    {
+      byte bit = state & 1;
+      if (i < 8*PAYLOAD_SIZE && bit)
+      {
+        payload[i/8] |= 1 << (i%8);
+      }
+      state = (state >> 1) | (((decisions[i] >> state) & 1)? (STATES >> 1) : 0);
+    }
+  }
+
+private:
+  byte message[MAX_FRAME_SIZE];
+  byte corrected = 0;
+  bool coding = true;
+  bool interleaving = true;
+};
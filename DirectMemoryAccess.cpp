@@ -0,0 +1,43 @@
+/*****************************************************************************
+ *
+ * DMAC Interrupt Handler
+ *
+ * file:     DirectMemoryAccess.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#include <Arduino.h>
+
+#include "SolarDHTConfig.h"
+
+// only builds with a DMA user link the ISR and the descriptor memory
+#if HAS_RADIO == 2 || HAS_ADC_SEQUENCE
+
+#include "DirectMemoryAccess.hpp"
+
+extern "C" void DMAC_Handler()
+{
+  DirectMemoryAccess::instance().handleInterrupt();
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*****************************************************************************
+ *
+ * minimal SAMD21 DMAC channel management with completion callbacks
+ *
+ * file:     DirectMemoryAccess.hpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * single block peripheral transfers on a few DMAC channels
+ *
+ * notes:
+ * - descriptor and write back sections are shared by all channels
+ * - channels run in standby, so the CPU can sleep during a transfer
+ * - the completion callback is executed in the DMAC ISR, defined in
+ *   DirectMemoryAccess.cpp for the builds that use DMA
+ */
+class DirectMemoryAccess
+{
+public:
+  static const byte CHANNELS = 2;
+
+  enum Channel
+  {
+    CHANNEL_RADIO = 0,
+    CHANNEL_ADC   = 1
+  };
+
+  typedef void (*Callback)();
+
+private:
+  DirectMemoryAccess() = default;
+
+public:
+  static DirectMemoryAccess& instance()
+  {
+    static DirectMemoryAccess dma;
+    return dma;
+  }
+
+public:
+  /**
+   * enable DMAC clocks and descriptor memory
+   */
+  void enable()
+  {
+    if (!enabled)
+    {
+      PM->AHBMASK.reg |= PM_AHBMASK_DMAC;
+      PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+
+      DMAC->CTRL.reg &= ~DMAC_CTRL_DMAENABLE;
+      DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+      while (DMAC->CTRL.reg & DMAC_CTRL_SWRST);
+
+      DMAC->BASEADDR.reg = (uintptr_t)descriptors;
+      DMAC->WRBADDR.reg = (uintptr_t)writeBack;
+      DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+
+      NVIC_SetPriority(DMAC_IRQn, 3);
+      NVIC_EnableIRQ(DMAC_IRQn);
+
+      enabled = true;
+    }
+  }
+
+  /**
+   * start single block transfer with one beat per trigger
+   *
+   * @param channel DMAC channel
+   * @param trigger trigger source, e.g. TCC1_DMAC_ID_OVF
+   * @param source source address (start of block if incremented)
+   * @param destination destination address (start of block if incremented)
+   * @param beats number of beats
+   * @param btctrl beat size and address increment, DMAC_BTCTRL_VALID and DMAC_BTCTRL_BLOCKACT_INT are added
+   * @param callback called on transfer completion or error, may be null
+   */
+  void start(Channel channel, byte trigger, const volatile void* source, volatile void* destination, uint16_t beats, uint16_t btctrl, Callback callback)
+  {
+    // source and destination address must point to the end of the block if incremented
+    uint32_t beatSize = 1 << ((btctrl & DMAC_BTCTRL_BEATSIZE_Msk) >> DMAC_BTCTRL_BEATSIZE_Pos);
+    uintptr_t src = (uintptr_t)source;
+    uintptr_t dst = (uintptr_t)destination;
+    if (btctrl & DMAC_BTCTRL_SRCINC)
+    {
+      src += beats*beatSize;
+    }
+    if (btctrl & DMAC_BTCTRL_DSTINC)
+    {
+      dst += beats*beatSize;
+    }
+
+    DmacDescriptor& descriptor = descriptors[channel];
+    descriptor.BTCTRL.reg = btctrl | DMAC_BTCTRL_VALID | DMAC_BTCTRL_BLOCKACT_INT;
+    descriptor.BTCNT.reg = beats;
+    descriptor.SRCADDR.reg = src;
+    descriptor.DSTADDR.reg = dst;
+    descriptor.DESCADDR.reg = 0;
+
+    callbacks[channel] = callback;
+
+    noInterrupts();
+    DMAC->CHID.reg = DMAC_CHID_ID(channel);
+    DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+    while (DMAC->CHCTRLA.reg & DMAC_CHCTRLA_SWRST);
+    DMAC->CHCTRLB.reg = DMAC_CHCTRLB_TRIGSRC(trigger) | DMAC_CHCTRLB_TRIGACT_BEAT;
+    DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL | DMAC_CHINTENSET_TERR;
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE | DMAC_CHCTRLA_RUNSTDBY;
+    interrupts();
+  }
+
+  /**
+   * abort transfer without calling the completion callback
+   */
+  void abort(Channel channel)
+  {
+    noInterrupts();
+    DMAC->CHID.reg = DMAC_CHID_ID(channel);
+    DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_MASK;
+    callbacks[channel] = nullptr;
+    interrupts();
+  }
+
+  /**
+   * DMAC ISR (prio 3), called by DMAC_Handler() of DirectMemoryAccess.cpp
+   */
+  void handleInterrupt()
+  {
+    uint32_t pending = DMAC->INTSTATUS.reg;
+    for (byte channel=0; channel<CHANNELS; channel++)
+    {
+      if (pending & (1 << channel))
+      {
+        DMAC->CHID.reg = DMAC_CHID_ID(channel);
+        DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_MASK;
+        Callback callback = callbacks[channel];
+        callbacks[channel] = nullptr;
+        if (callback)
+        {
+          callback();
+        }
+      }
+    }
+  }
+
+private:
+  __attribute__((aligned(16))) DmacDescriptor descriptors[CHANNELS] = {};
+  __attribute__((aligned(16))) DmacDescriptor writeBack[CHANNELS] = {};
+  Callback callbacks[CHANNELS] = {};
+  bool enabled = false;
+};
@@ -0,0 +1,68 @@
+/*****************************************************************************
+ *
+ * E-Paper Display Update Decision
+ *
+ * file:     DisplayUpdate.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * decide when to refresh the e-paper display, shared by the firmware and the
+ * host benchmark
+ *
+ * The display is updated on a significant change of temperature or humidity
+ * but not more frequently than the min. period. Every n-th refresh is a full
+ * refresh (~4000 ms) to remove ghosting, otherwise a partial refresh
+ * (~1500 ms) is used.
+ */
+class DisplayUpdate
+{
+public:
+  static const uint16_t FULL_REFRESH_EVERY = 6;
+
+public:
+  /**
+   * @param now [ms] current time
+   * @param updated [ms] time of last update
+   * @param minPeriod [ms] min. time between updates
+   */
+  static bool isDue(float temperature, float humidity, float displayedTemperature, float displayedHumidity,
+                    float temperatureDelta, float humidityDelta, uint32_t now, uint32_t updated, uint32_t minPeriod)
+  {
+    float dt = temperature - displayedTemperature;
+    float dh = humidity - displayedHumidity;
+    return ((dt >= 0? dt : -dt) >= temperatureDelta || (dh >= 0? dh : -dh) >= humidityDelta)
+        && now >= updated
+        && now - updated >= minPeriod;
+  }
+
+  /**
+   * @param count number of updates performed
+   */
+  static bool isPartialRefresh(uint16_t count)
+  {
+    return count % FULL_REFRESH_EVERY != 0;
+  }
+};
@@ -0,0 +1,299 @@
+/*****************************************************************************
+ *
+ * Authenticated Downlink Configuration Frames
+ *
+ * file:     Downlink.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * compact configuration frames sent from a gateway to the sensor
+ *
+ * frame layout (little endian):
+ *
+ *   offset  size  content
+ *   0       1     frame type (FRAME_TYPE_CONFIG)
+ *   1       1     rolling code of target node
+ *   2       2     sequence number, must be greater than last accepted
+ *   4       n     items: 1 byte tag followed by value of fixed size
+ *   4+n     4     MAC: XTEA CBC-MAC over frame size and bytes 0 .. 3+n, truncated to 32 bits
+ *
+ * The same class is used by the sensor to verify and parse frames and by the
+ * gateway to create frames.
+ */
+class Downlink
+{
+public:
+  static const byte MAX_FRAME_SIZE = 32; // [bytes]
+  static const byte FRAME_TYPE_CONFIG = 0xC5;
+  static const byte HEADER_SIZE = 4; // [bytes]
+  static const byte MAC_SIZE = 4;    // [bytes]
+
+  enum Tag
+  {
+    TAG_PERIOD        = 1, // uint16 [s]
+    TAG_TX_POWER      = 2, // uint8 0 .. 7
+    TAG_SUPPLY_LOW    = 3, // uint16 [mV]
+    TAG_DISPLAY_TEMP  = 4, // uint8 [0.1 °C] min. temperature change for display update
+    TAG_DISPLAY_HUM   = 5, // uint8 [%] min. humidity change for display update
+    TAG_TIME          = 6, // uint32 [s] seconds since epoch
+    TAG_RX_EVERY      = 7, // uint8 downlink window every n-th wakeup
+    TAG_HISTORY       = 8  // uint16 transmit n most recent history blocks (maintenance mode)
+  };
+
+  struct Config
+  {
+    uint16_t present = 0; // bit mask (1 << tag)
+    uint16_t period;
+    byte txPower;
+    uint16_t supplyLow;
+    byte displayTemp;
+    byte displayHum;
+    uint32_t time;
+    byte rxEvery;
+    uint16_t historyBlocks;
+
+    bool has(Tag tag) const
+    {
+      return present & (1 << tag);
+    }
+  };
+
+public:
+  /**
+   * @param k0 .. k3 128 bit shared secret
+   */
+  Downlink(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3) :
+    key{ k0, k1, k2, k3 }
+  {}
+
+public:
+  /**
+   * verify and parse frame
+   *
+   * @param frame received frame
+   * @param size frame size [bytes]
+   * @param rollingCode rolling code of this node
+   * @param config parsed configuration
+   * @return true if frame is valid, addressed to this node and not replayed
+   */
+  bool parse(const byte* frame, byte size, byte rollingCode, Config& config)
+  {
+    if (size < HEADER_SIZE + MAC_SIZE || size > MAX_FRAME_SIZE
+      || frame[0] != FRAME_TYPE_CONFIG || frame[1] != rollingCode)
+    {
+      return false;
+    }
+
+    byte payloadSize = size - MAC_SIZE;
+    if (getUInt32(frame + payloadSize) != mac(frame, payloadSize))
+    {
+      return false;
+    }
+
+    uint16_t sequence = getUInt16(frame + 2);
+    if (sequenceValid && (int16_t)(sequence - lastSequence) <= 0)
+    {
+      return false;
+    }
+
+    Config c;
+    for (byte i = HEADER_SIZE; i < payloadSize; )
+    {
+      byte tag = frame[i++];
+      byte valueSize = getValueSize(tag);
+      if (!valueSize || i + valueSize > payloadSize)
+      {
+        return false;
+      }
+      const byte* v = frame + i;
+      switch (tag)
+      {
+        case TAG_PERIOD:       c.period = getUInt16(v); break;
+        case TAG_TX_POWER:     c.txPower = *v & 0x7; break;
+        case TAG_SUPPLY_LOW:   c.supplyLow = getUInt16(v); break;
+        case TAG_DISPLAY_TEMP: c.displayTemp = *v; break;
+        case TAG_DISPLAY_HUM:  c.displayHum = *v; break;
+        case TAG_TIME:         c.time = getUInt32(v); break;
+        case TAG_RX_EVERY:     c.rxEvery = *v; break;
+        case TAG_HISTORY:      c.historyBlocks = getUInt16(v); break;
+      }
+      c.present |= 1 << tag;
+      i += valueSize;
+    }
+
+    lastSequence = sequence;
+    sequenceValid = true;
+    config = c;
+
+    return true;
+  }
+
+  /**
+   * create frame
+   *
+   * @param rollingCode rolling code of target node
+   * @param sequence sequence number
+   * @param config configuration items to send (Config::present)
+   * @param frame output buffer of MAX_FRAME_SIZE bytes
+   * @return frame size [bytes] or 0 if the items do not fit
+   */
+  byte create(byte rollingCode, uint16_t sequence, const Config& config, byte* frame) const
+  {
+    byte size = 0;
+    frame[size++] = FRAME_TYPE_CONFIG;
+    frame[size++] = rollingCode;
+    putUInt16(frame + size, sequence); size += 2;
+
+    for (byte tag = TAG_PERIOD; tag <= TAG_HISTORY; tag++)
+    {
+      if (config.has((Tag)tag))
+      {
+        byte valueSize = getValueSize(tag);
+        if (size + 1 + valueSize + MAC_SIZE > MAX_FRAME_SIZE)
+        {
+          return 0;
+        }
+        frame[size++] = tag;
+        byte* v = frame + size;
+        switch (tag)
+        {
+          case TAG_PERIOD:       putUInt16(v, config.period); break;
+          case TAG_TX_POWER:     *v = config.txPower; break;
+          case TAG_SUPPLY_LOW:   putUInt16(v, config.supplyLow); break;
+          case TAG_DISPLAY_TEMP: *v = config.displayTemp; break;
+          case TAG_DISPLAY_HUM:  *v = config.displayHum; break;
+          case TAG_TIME:         putUInt32(v, config.time); break;
+          case TAG_RX_EVERY:     *v = config.rxEvery; break;
+          case TAG_HISTORY:      putUInt16(v, config.historyBlocks); break;
+        }
+        size += valueSize;
+      }
+    }
+
+    putUInt32(frame + size, mac(frame, size));
+    return size + MAC_SIZE;
+  }
+
+  /**
+   * @param sequence last accepted sequence number (e.g. restored from persistent storage)
+   */
+  void setLastSequence(uint16_t sequence)
+  {
+    lastSequence = sequence;
+    sequenceValid = true;
+  }
+
+  uint16_t getLastSequence() const
+  {
+    return lastSequence;
+  }
+
+private:
+  static byte getValueSize(byte tag)
+  {
+    switch (tag)
+    {
+      case TAG_PERIOD:
+      case TAG_SUPPLY_LOW:
+      case TAG_HISTORY:
+        return 2;
+      case TAG_TX_POWER:
+      case TAG_DISPLAY_TEMP:
+      case TAG_DISPLAY_HUM:
+      case TAG_RX_EVERY:
+        return 1;
+      case TAG_TIME:
+        return 4;
+      default:
+        return 0;
+    }
+  }
+
+  /**
+   * XTEA CBC-MAC, size is prepended to prevent length extension
+   */
+  uint32_t mac(const byte* data, byte size) const
+  {
+    uint32_t v[2] = { size, 0 };
+    encipher(v);
+    for (byte i=0; i<size; i+=8)
+    {
+      byte block[8] = {};
+      for (byte j=0; j<8 && i + j < size; j++)
+      {
+        block[j] = data[i + j];
+      }
+      v[0] ^= getUInt32(block);
+      v[1] ^= getUInt32(block + 4);
+      encipher(v);
+    }
+    return v[0];
+  }
+
+  /**
+   * XTEA block cipher, 32 cycles
+   */
+  void encipher(uint32_t v[2]) const
+  {
+    const uint32_t delta = 0x9E3779B9;
+    uint32_t v0 = v[0], v1 = v[1], sum = 0;
+    for (byte i=0; i<32; i++)
+    {
+      v0 += (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (sum + key[sum & 3]);
+      sum += delta;
+      v1 += (((v0 << 4) ^ (v0 >> 5)) + v0) ^ (sum + key[(sum >> 11) & 3]);
+    }
+    v[0] = v0;
+    v[1] = v1;
+  }
+
+  static uint16_t getUInt16(const byte* p)
+  {
+    return p[0] | (p[1] << 8);
+  }
+
+  static uint32_t getUInt32(const byte* p)
+  {
+    return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+
+  static void putUInt16(byte* p, uint16_t v)
+  {
+    p[0] = v;
+    p[1] = v >> 8;
+  }
+
+  static void putUInt32(byte* p, uint32_t v)
+  {
+    putUInt16(p, v);
+    putUInt16(p + 2, v >> 16);
+  }
+
+private:
+  uint32_t key[4];
+  uint16_t lastSequence = 0;
+  bool sequenceValid = false;
+};
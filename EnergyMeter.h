@@ -0,0 +1,232 @@
+/*****************************************************************************
+ *
+ * Energy Accounting by Power State
+ *
+ * file:     EnergyMeter.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * accumulate the time spent in each power state and derive the energy per
+ * wakeup cycle from a current model
+ *
+ * States of different consumers (MCU, radio, sensor, display) overlap, the
+ * caller keeps the states of one consumer exclusive. Running states are
+ * accumulated with start() and stop() using a µs timestamp, durations known
+ * in advance (e.g. standby measured with the RTC) are added with add().
+ * Durations are 64 bit, a standby of more than 71.6 min does not overflow.
+ *
+ * endCycle() closes a wakeup cycle, calculates its energy from the currents
+ * and the supply voltage and updates the rolling average power.
+ *
+ * Units: time [µs], current [mA], energy [µJ], power [mW]
+ */
+template<byte STATES>
+class EnergyMeter
+{
+public:
+  static const byte AVERAGE_WEIGHT = 8; // rolling average over ~8 cycles
+
+public:
+  EnergyMeter() = default;
+
+  EnergyMeter(const float (&currents)[STATES])
+  {
+    for (byte state=0; state<STATES; state++)
+    {
+      this->currents[state] = currents[state];
+    }
+  }
+
+public:
+  void setCurrent(byte state, float current)
+  {
+    if (state < STATES)
+    {
+      currents[state] = current;
+    }
+  }
+
+  float getCurrent(byte state) const
+  {
+    return state < STATES? currents[state] : 0;
+  }
+
+  /**
+   * start accumulating time of state, ignored if already running
+   */
+  void start(byte state, uint32_t now)
+  {
+    if (state < STATES && !(running & (1UL << state)))
+    {
+      running |= 1UL << state;
+      started[state] = now;
+    }
+  }
+
+  /**
+   * stop accumulating time of state, ignored if not running
+   */
+  void stop(byte state, uint32_t now)
+  {
+    if (state < STATES && (running & (1UL << state)))
+    {
+      running &= ~(1UL << state);
+      cycleTime[state] += now - started[state];
+    }
+  }
+
+  /**
+   * stop running state and start other state
+   */
+  void change(byte from, byte to, uint32_t now)
+  {
+    if (from != to)
+    {
+      stop(from, now);
+      start(to, now);
+    }
+  }
+
+  bool isRunning(byte state) const
+  {
+    return state < STATES && (running & (1UL << state));
+  }
+
+  /**
+   * add duration to state
+   */
+  void add(byte state, uint64_t duration)
+  {
+    if (state < STATES)
+    {
+      cycleTime[state] += duration;
+    }
+  }
+
+  /**
+   * close wakeup cycle, running states continue in next cycle
+   *
+   * @param now [µs] timestamp for running states
+   * @param duration [µs] cycle duration for average power, e.g. standby + awake time
+   * @param voltage [V] supply voltage
+   * @return [µJ] energy of cycle
+   */
+  float endCycle(uint32_t now, uint64_t duration, float voltage)
+  {
+    float charge = 0; // [nC] = mA * µs
+    for (byte state=0; state<STATES; state++)
+    {
+      if (running & (1UL << state))
+      {
+        cycleTime[state] += now - started[state];
+        started[state] = now;
+      }
+      charge += currents[state]*cycleTime[state];
+      totalTime[state] += cycleTime[state];
+      lastTime[state] = cycleTime[state];
+      cycleTime[state] = 0;
+    }
+
+    cycleEnergy = charge*voltage/1000;
+    totalEnergy += cycleEnergy;
+    cycles++;
+
+    if (duration)
+    {
+      float power = 1000*cycleEnergy/duration; // µJ/µs = W
+      averagePower = averagePower > 0? averagePower + (power - averagePower)/AVERAGE_WEIGHT : power;
+    }
+    return cycleEnergy;
+  }
+
+  /**
+   * @return [µJ] energy of last closed cycle
+   */
+  float getCycleEnergy() const
+  {
+    return cycleEnergy;
+  }
+
+  /**
+   * @return [mW] rolling average power
+   */
+  float getAveragePower() const
+  {
+    return averagePower;
+  }
+
+  /**
+   * @return [µJ] energy of all closed cycles
+   */
+  double getTotalEnergy() const
+  {
+    return totalEnergy;
+  }
+
+  /**
+   * @return [µs] time of state in last closed cycle
+   */
+  uint64_t getCycleTime(byte state) const
+  {
+    return state < STATES? lastTime[state] : 0;
+  }
+
+  /**
+   * @return [µs] time of state in all closed cycles
+   */
+  uint64_t getTotalTime(byte state) const
+  {
+    return state < STATES? totalTime[state] : 0;
+  }
+
+  uint32_t getCycles() const
+  {
+    return cycles;
+  }
+
+  /**
+   * restore totals, e.g. after brown-out
+   */
+  void setTotals(double energy, float power)
+  {
+    totalEnergy = energy;
+    averagePower = power;
+  }
+
+  static_assert(STATES <= 32, "max. 32 states");
+
+protected:
+  float currents[STATES] = {};
+  uint32_t started[STATES] = {};
+  uint64_t cycleTime[STATES] = {};
+  uint64_t lastTime[STATES] = {};
+  uint64_t totalTime[STATES] = {};
+  uint32_t running = 0;  // bit mask of running states
+  uint32_t cycles = 0;
+  float cycleEnergy = 0;
+  float averagePower = 0;
+  double totalEnergy = 0;
+};
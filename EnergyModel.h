@@ -0,0 +1,192 @@
+/*****************************************************************************
+ *
+ * Charge Model of the Wakeup Cycle
+ *
+ * file:     EnergyModel.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * charge per wakeup as sum of phases with MCU current depending on CPU clock
+ *
+ * A phase has a wall time given by the peripherals (radio start-up, sensor
+ * conversion, transmission) and a number of CPU cycles. The CPU is active for
+ * cycles/clock and sleeps in IDLE2 for the rest of the phase. If the CPU needs
+ * more time than the peripherals, the phase is extended. A phase may overlap
+ * the next phase (e.g. display rendering during transmission).
+ *
+ * With clock scaling, compute phases run at the high clock and all other
+ * phases at the low clock. Without, all phases run at the high clock.
+ *
+ * The cycles of a phase are counted for execution from flash. The RAMFUNC
+ * part of a phase runs without flash wait states and flash read current.
+ * Without flash sleep power reduction the flash draws current in IDLE2.
+ *
+ * Units: current [mA], time [ms], charge [µC] (= mA * ms), clock [MHz]
+ */
+class EnergyModel
+{
+public:
+  /**
+   * SAMD21 supply current approximated as base + slope * clock,
+   * rounded datasheet values at 3.3 V, CPU running from flash
+   */
+  struct Parameters
+  {
+    float activeBase = 0.20;     // [mA]
+    float activePerMHz = 0.062;  // [mA/MHz]
+    float idleBase = 0.10;       // [mA] IDLE2
+    float idlePerMHz = 0.022;    // [mA/MHz] generator and clock tree in IDLE2
+    float dfll = 0.30;           // [mA] DFLL48M, runs while awake if F_CPU is 48 MHz
+    float standby = 0.002;       // [mA] STANDBY with RTC, radio shutdown, sensor and display sleeping (measured)
+    float flashStall = 0.25;     // wait state cycles per cycle executing from flash (RWS 1, cache misses), estimate
+    float flashPerMHz = 0.008;   // [mA/MHz] flash read current while executing from flash, estimate
+    float flashIdle = 0.03;      // [mA] flash in IDLE2 without sleep power reduction (idle values include it), estimate
+  };
+
+  struct Phase
+  {
+    const char* name;
+    float duration;      // [ms] wall time given by peripherals
+    float cycles;        // CPU cycles
+    float peripheral;    // [mA] current of radio, sensor and display during duration
+    bool compute;        // high clock with clock scaling
+    bool overlapsNext;   // phase time is part of next phase duration
+    float ram;           // fraction of cycles in RAMFUNC code
+  };
+
+  struct Clocks
+  {
+    float high;          // [MHz]
+    float low;           // [MHz]
+    bool scaling;
+    bool dfll;           // DFLL48M running while awake
+    bool ramCode;        // RAMFUNC code executes from RAM (HAS_RAMFUNC)
+    bool nvmAwake;       // flash not powered down in IDLE2 (NVM_SLEEP_POWER_DOWN 0)
+  };
+
+  struct Result
+  {
+    float awake = 0;     // [ms]
+    float active = 0;    // [ms] CPU active
+    float mcu = 0;       // [µC] MCU charge while awake
+    float peripheral = 0;// [µC] peripheral charge while awake
+    float standby = 0;   // [µC] charge while in standby
+    unsigned switches = 0;
+
+    float getCharge() const
+    {
+      return mcu + peripheral + standby;
+    }
+  };
+
+public:
+  EnergyModel() = default;
+  EnergyModel(const Parameters& parameters) : parameters(parameters) {}
+
+public:
+  float getActiveCurrent(float clock) const
+  {
+    return parameters.activeBase + parameters.activePerMHz*clock;
+  }
+
+  float getIdleCurrent(float clock) const
+  {
+    return parameters.idleBase + parameters.idlePerMHz*clock;
+  }
+
+  /**
+   * @return clock [MHz] of phase
+   */
+  static float getClock(const Phase& phase, const Clocks& clocks)
+  {
+    return clocks.scaling && !phase.compute? clocks.low : clocks.high;
+  }
+
+  /**
+   * evaluate phases of one wakeup
+   *
+   * @param period [ms] wakeup period, 0 to exclude standby
+   * @param phaseCharge optional [µC] charge per phase
+   */
+  Result evaluate(const Phase* phases, unsigned count, const Clocks& clocks, float period = 0, float* phaseCharge = nullptr) const
+  {
+    Result result;
+    float carry = 0; // [ms] time of overlapping phases
+    bool high = !clocks.scaling; // wakeup with clock of shutdown
+    for (unsigned i=0; i<count; i++)
+    {
+      const Phase& phase = phases[i];
+      float clock = getClock(phase, clocks);
+      if ((clock == clocks.high) != high)
+      {
+        high = !high;
+        result.switches++;
+      }
+
+      // phase cycles include the flash wait states, RAM code runs without
+      float ram = clocks.ramCode? phase.ram : 0;
+      float cycles = phase.cycles*(1 - ram) + phase.cycles*ram/(1 + parameters.flashStall);
+      float active = cycles/(clock*1000);
+      float duration = phase.duration - carry;
+      float time = active > duration? active : duration;
+      carry = phase.overlapsNext? carry + time : 0;
+
+      float ramShare = cycles > 0? phase.cycles*ram/(1 + parameters.flashStall)/cycles : 0;
+      float activeCurrent = getActiveCurrent(clock) - ramShare*parameters.flashPerMHz*clock;
+      float idleCurrent = getIdleCurrent(clock) + (clocks.nvmAwake? parameters.flashIdle : 0);
+      float mcu = active*activeCurrent + (time - active)*idleCurrent;
+      if (clocks.dfll)
+      {
+        mcu += time*parameters.dfll;
+      }
+      float peripheral = (phase.duration > time? phase.duration : time)*phase.peripheral; // peripheral runs for its full duration
+
+      result.awake += time;
+      result.active += active;
+      result.mcu += mcu;
+      result.peripheral += peripheral;
+      if (phaseCharge)
+      {
+        phaseCharge[i] = mcu + peripheral;
+      }
+    }
+
+    if (high && clocks.scaling)
+    {
+      // back to low clock before standby
+      result.switches++;
+    }
+
+    if (period > result.awake)
+    {
+      result.standby = (period - result.awake)*parameters.standby;
+    }
+    return result;
+  }
+
+public:
+  Parameters parameters;
+};
@@ -0,0 +1,319 @@
+/*****************************************************************************
+ *
+ * Wear-levelled Key/Value Log in Flash
+ *
+ * file:     FlashLog.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * append-only log of 32 bit values in a ring of flash rows, shared by the
+ * firmware (NVMFlash) and the host tools (FileFlash)
+ *
+ * Each row starts with a header record holding the row sequence number,
+ * followed by 8 byte records (key, check, value). Values are staged in RAM
+ * and only the changed values are appended on commit. When the active row is
+ * full, the next row is erased, a snapshot of all values is written and the
+ * header is written last, so an interrupted row switch leaves the previous
+ * row active. A torn record fails the check and is skipped.
+ *
+ * At boot only the row headers and the records of the active row are read.
+ *
+ * Flash requirements: erase by row (bits to 1), write 4 byte aligned words
+ * within a page (bits to 0), row size multiple of 8 bytes.
+ */
+template<class Flash, byte KEYS>
+class FlashLog
+{
+public:
+  static const uint16_t ROW_SIZE = Flash::ROW_SIZE; // [bytes]
+  static const byte RECORD_SIZE = 8; // [bytes]
+  static const uint16_t RECORDS_PER_ROW = ROW_SIZE/RECORD_SIZE; // including header
+  static const uint16_t KEY_HEADER = 0xFFFE;
+  static const uint16_t NO_ROW = 0xFFFF;
+
+  static_assert(KEYS <= 32, "max. 32 keys");
+  static_assert(KEYS + 2 <= RECORDS_PER_ROW, "snapshot of all keys must fit into one row");
+
+public:
+  FlashLog(Flash& flash) : flash(flash) {};
+
+public:
+  /**
+   * find active row and restore values, format flash if no valid row is found
+   *
+   * @return true if at least one value was restored
+   */
+  bool begin()
+  {
+    valid = 0;
+    dirty = 0;
+    activeRow = NO_ROW;
+    sequence = 0;
+
+    // find row with highest sequence number
+    for (uint16_t row=0; row<flash.getRows(); row++)
+    {
+      uint32_t record[2];
+      readRecord(row, 0, record);
+      if (getKey(record) == KEY_HEADER && isValid(record) && (activeRow == NO_ROW || record[1] > sequence))
+      {
+        activeRow = row;
+        sequence = record[1];
+      }
+    }
+
+    if (activeRow == NO_ROW)
+    {
+      // blank or foreign flash content
+      return format();
+    }
+
+    // replay records of active row, last value of each key wins
+    uint16_t i;
+    for (i=1; i<RECORDS_PER_ROW; i++)
+    {
+      uint32_t record[2];
+      readRecord(activeRow, i, record);
+      if (record[0] == 0xFFFFFFFF && record[1] == 0xFFFFFFFF)
+      {
+        // erased, end of log
+        break;
+      }
+      uint16_t key = getKey(record);
+      if (key < KEYS && isValid(record))
+      {
+        values[key] = record[1];
+        valid |= 1UL << key;
+      }
+    }
+    nextRecord = i;
+
+    return valid != 0;
+  }
+
+  /**
+   * stage value in RAM, written to flash on next commit if changed
+   */
+  void set(byte key, uint32_t value)
+  {
+    if (key < KEYS && (!(valid & (1UL << key)) || values[key] != value))
+    {
+      values[key] = value;
+      valid |= 1UL << key;
+      dirty |= 1UL << key;
+    }
+  }
+
+  void setFloat(byte key, float value)
+  {
+    uint32_t v;
+    memcpy(&v, &value, sizeof(v));
+    set(key, v);
+  }
+
+  /**
+   * @return true if value is available
+   */
+  bool get(byte key, uint32_t& value) const
+  {
+    if (key < KEYS && (valid & (1UL << key)))
+    {
+      value = values[key];
+      return true;
+    }
+    return false;
+  }
+
+  bool getFloat(byte key, float& value) const
+  {
+    uint32_t v;
+    if (get(key, v))
+    {
+      memcpy(&value, &v, sizeof(value));
+      return true;
+    }
+    return false;
+  }
+
+  bool isDirty() const
+  {
+    return dirty != 0;
+  }
+
+  /**
+   * append changed values, switch row if active row is full
+   *
+   * @return true if all values are persistent
+   */
+  bool commit()
+  {
+    if (!dirty)
+    {
+      return true;
+    }
+    if (activeRow == NO_ROW)
+    {
+      return false;
+    }
+
+    if (nextRecord + countBits(dirty) > RECORDS_PER_ROW)
+    {
+      return switchRow();
+    }
+
+    for (byte key=0; key<KEYS; key++)
+    {
+      if (dirty & (1UL << key))
+      {
+        if (!writeRecord(activeRow, nextRecord++, key, values[key]))
+        {
+          return false;
+        }
+        dirty &= ~(1UL << key);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @return sequence number of active row, total number of row switches + 1
+   */
+  uint32_t getSequence() const
+  {
+    return sequence;
+  }
+
+  uint16_t getActiveRow() const
+  {
+    return activeRow;
+  }
+
+  /**
+   * @return free records in active row
+   */
+  uint16_t getFreeRecords() const
+  {
+    return activeRow == NO_ROW? 0 : RECORDS_PER_ROW - nextRecord;
+  }
+
+protected:
+  /**
+   * erase first row and write empty header
+   */
+  bool format()
+  {
+    if (!flash.eraseRow(0) || !writeRecord(0, 0, KEY_HEADER, 1))
+    {
+      return false;
+    }
+    activeRow = 0;
+    sequence = 1;
+    nextRecord = 1;
+    return false;
+  }
+
+  /**
+   * write snapshot of all values into next row
+   */
+  bool switchRow()
+  {
+    uint16_t row = (activeRow + 1) % flash.getRows();
+    if (!flash.eraseRow(row))
+    {
+      return false;
+    }
+
+    uint16_t record = 1;
+    for (byte key=0; key<KEYS; key++)
+    {
+      if ((valid & (1UL << key)) && !writeRecord(row, record++, key, values[key]))
+      {
+        return false;
+      }
+    }
+
+    // header last, makes row valid
+    if (!writeRecord(row, 0, KEY_HEADER, sequence + 1))
+    {
+      return false;
+    }
+
+    activeRow = row;
+    sequence++;
+    nextRecord = record;
+    dirty = 0;
+    return true;
+  }
+
+  bool writeRecord(uint16_t row, uint16_t index, uint16_t key, uint32_t value)
+  {
+    uint32_t record[2] = { key | ((uint32_t)getCheck(key, value) << 16), value };
+    return flash.write((uint32_t)row*ROW_SIZE + index*RECORD_SIZE, record, RECORD_SIZE);
+  }
+
+  void readRecord(uint16_t row, uint16_t index, uint32_t record[2])
+  {
+    flash.read((uint32_t)row*ROW_SIZE + index*RECORD_SIZE, record, RECORD_SIZE);
+  }
+
+  static uint16_t getKey(const uint32_t record[2])
+  {
+    return record[0] & 0xFFFF;
+  }
+
+  static bool isValid(const uint32_t record[2])
+  {
+    return (record[0] >> 16) == getCheck(getKey(record), record[1]);
+  }
+
+  /**
+   * multiplicative hash, an XOR of the value halves would not detect a torn
+   * value word (0xFFFFFFFF) if both halves of the value are equal
+   */
+  static uint16_t getCheck(uint16_t key, uint32_t value)
+  {
+    uint32_t h = (value ^ ((uint32_t)key << 16) ^ 0xA55A5AA5) * 0x9E3779B1;
+    h ^= h >> 15;
+    h *= 0x85EBCA77;
+    return h >> 16;
+  }
+
+  static byte countBits(uint32_t v)
+  {
+    byte n = 0;
+    for (; v; v &= v - 1) n++;
+    return n;
+  }
+
+protected:
+  Flash& flash;
+  uint32_t values[KEYS];
+  uint32_t valid = 0;  // bit mask of keys with value
+  uint32_t dirty = 0;  // bit mask of keys not yet written
+  uint32_t sequence = 0;
+  uint16_t activeRow = NO_ROW;
+  uint16_t nextRecord = 0;
+};
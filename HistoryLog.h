@@ -0,0 +1,551 @@
+/*****************************************************************************
+ *
+ * Compressed Measurement History in Flash
+ *
+ * file:     HistoryLog.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * ring of fixed size blocks with delta-of-delta compressed samples (time,
+ * temperature, humidity, supply voltage), shared by the firmware (NVMFlash)
+ * and the host tools (FileFlash)
+ *
+ * block layout (64 bytes = 1 flash page):
+ *
+ *   offset  size  content
+ *   0       4     block sequence number
+ *   4       4     time of 1st sample [s]
+ *   8       2     temperature of 1st sample [0.1 °C]
+ *   10      2     humidity of 1st sample [0.1 %]
+ *   12      2     supply voltage of 1st sample [10 mV]
+ *   14      1     flags (FLAG_EPOCH)
+ *   15      1     header check
+ *   16      48    bit stream, MSB first
+ *
+ * Each following sample is stored as the delta-of-delta of each value with a
+ * variable length code similar to the Gorilla time stamp encoding:
+ *
+ *   0                  0
+ *   10   + 4 bits      -8 .. 7
+ *   110  + 7 bits      -64 .. 63
+ *   1110 + 12 bits     -2048 .. 2047
+ *   1111 + 32 bits     any
+ *
+ * Unused bits stay erased (1), so the block can be appended in place and a
+ * 32 bit escape with all bits set marks the end of the block.
+ *
+ * A new block is started at each boot (time base may change), if the time
+ * flags change or if the next sample does not fit. Rows are erased when the
+ * first block of a row is written, so the oldest row is overwritten. Flash
+ * is only written by flush(), never by append().
+ */
+template<class Flash>
+class HistoryLog
+{
+public:
+  static const uint16_t BLOCK_SIZE = 64; // [bytes]
+  static const byte HEADER_SIZE = 16; // [bytes]
+  static const uint16_t BLOCK_BITS = 8*(BLOCK_SIZE - HEADER_SIZE);
+  static const uint16_t BLOCKS_PER_ROW = Flash::ROW_SIZE/BLOCK_SIZE;
+  static const byte CHANNELS = 4;
+  static const byte MAGIC = 0x48;
+  static const byte FLAG_EPOCH = 1; // time is seconds since epoch, otherwise since boot
+  static const uint16_t NO_BLOCK = 0xFFFF;
+
+  struct Sample
+  {
+    uint32_t time;       // [s]
+    int16_t temperature; // [0.1 °C]
+    uint16_t humidity;   // [0.1 %]
+    uint16_t voltage;    // [10 mV]
+  };
+
+public:
+  HistoryLog(Flash& flash) : flash(flash) {};
+
+public:
+  /**
+   * find newest block, next sample will start a new block
+   */
+  void begin()
+  {
+    blocks = flash.getRows()*BLOCKS_PER_ROW;
+    current = NO_BLOCK;
+    sequence = 0;
+    open = false;
+    full = false;
+
+    for (uint16_t b=0; b<blocks; b++)
+    {
+      byte header[HEADER_SIZE];
+      flash.read((uint32_t)b*BLOCK_SIZE, header, HEADER_SIZE);
+      uint32_t s = getUInt32(header);
+      if (isValidHeader(header) && (current == NO_BLOCK || s > sequence))
+      {
+        current = b;
+        sequence = s;
+      }
+    }
+  }
+
+  /**
+   * append sample to current block
+   *
+   * Flash is only written by flush(). If the sample does not fit, the block
+   * is closed and the sample is kept until flush() writes the block and
+   * starts the next block with it.
+   *
+   * @return false if the sample replaced a sample kept for the next block
+   */
+  bool append(const Sample& sample, byte flags = 0)
+  {
+    if (full)
+    {
+      // flush pending, keep newest sample
+      pending = sample;
+      pendingFlags = flags;
+      return false;
+    }
+
+    if (open)
+    {
+      int32_t v[CHANNELS];
+      getValues(sample, v);
+      uint16_t bits = 0;
+      for (byte c=0; c<CHANNELS; c++)
+      {
+        int32_t delta = v[c] - previous[c];
+        bits += getCodeSize(delta - previousDelta[c]);
+      }
+
+      if (flags == blockFlags && bitPos + bits <= BLOCK_BITS)
+      {
+        for (byte c=0; c<CHANNELS; c++)
+        {
+          int32_t delta = v[c] - previous[c];
+          putCode(delta - previousDelta[c]);
+          previous[c] = v[c];
+          previousDelta[c] = delta;
+        }
+        dirty = true;
+        return true;
+      }
+
+      // block full, written by next flush
+      pending = sample;
+      pendingFlags = flags;
+      full = true;
+      return true;
+    }
+
+    startBlock(sample, flags);
+    return true;
+  }
+
+  /**
+   * write unwritten part of current block (erases row on first write to a row),
+   * a full block is closed and the next block is started with the kept sample
+   */
+  bool flush()
+  {
+    if (!open || !dirty)
+    {
+      return true;
+    }
+
+    uint32_t base = (uint32_t)current*BLOCK_SIZE;
+    if (eraseNeeded)
+    {
+      if (!flash.eraseRow(current/BLOCKS_PER_ROW))
+      {
+        return false;
+      }
+      eraseNeeded = false;
+    }
+
+    if (!headerWritten)
+    {
+      if (!flash.write(base, block, HEADER_SIZE))
+      {
+        return false;
+      }
+      headerWritten = true;
+    }
+
+    // word containing the last written bit is written again, bits only change from 1 to 0
+    uint16_t from = HEADER_SIZE + flushedBits/32*4;
+    uint16_t to = HEADER_SIZE + (bitPos + 31)/32*4;
+    if (to > from && !flash.write(base + from, block + from, to - from))
+    {
+      return false;
+    }
+
+    flushedBits = bitPos;
+    dirty = false;
+
+    if (full)
+    {
+      full = false;
+      startBlock(pending, pendingFlags);
+    }
+    return true;
+  }
+
+  bool isDirty() const
+  {
+    return open && dirty;
+  }
+
+  /**
+   * @return true if the current block is full and waits for flush()
+   */
+  bool isFull() const
+  {
+    return full;
+  }
+
+  /**
+   * @return number of blocks in ring
+   */
+  uint16_t getBlocks() const
+  {
+    return blocks;
+  }
+
+  uint32_t getSequence() const
+  {
+    return sequence;
+  }
+
+  /**
+   * @return ring index of newest block, NO_BLOCK if empty
+   */
+  uint16_t getCurrentBlock() const
+  {
+    return current;
+  }
+
+  /**
+   * read block, current block from RAM
+   *
+   * @return true if block is valid
+   */
+  bool readBlock(uint16_t index, byte* data)
+  {
+    if (open && index == current)
+    {
+      memcpy(data, block, BLOCK_SIZE);
+    }
+    else
+    {
+      flash.read((uint32_t)index*BLOCK_SIZE, data, BLOCK_SIZE);
+    }
+    return isValidHeader(data);
+  }
+
+  /**
+   * @return ring index of n-th valid block before current block (0 = current), NO_BLOCK if not available
+   */
+  uint16_t getRecentBlock(uint16_t n)
+  {
+    if (current == NO_BLOCK)
+    {
+      return NO_BLOCK;
+    }
+    for (uint16_t i=0; i<blocks; i++)
+    {
+      uint16_t index = (current + blocks - i) % blocks;
+      byte header[HEADER_SIZE];
+      if (open && index == current)
+      {
+        memcpy(header, block, HEADER_SIZE);
+      }
+      else
+      {
+        flash.read((uint32_t)index*BLOCK_SIZE, header, HEADER_SIZE);
+      }
+      if (isValidHeader(header) && n-- == 0)
+      {
+        return index;
+      }
+    }
+    return NO_BLOCK;
+  }
+
+  /**
+   * decode block
+   *
+   * @param data block
+   * @param callback void(const Sample& sample, byte flags) called for each sample
+   * @return number of samples
+   */
+  template<class Callback>
+  static uint16_t decode(const byte* data, Callback callback)
+  {
+    if (!isValidHeader(data))
+    {
+      return 0;
+    }
+
+    Sample sample;
+    sample.time = getUInt32(data + 4);
+    sample.temperature = getUInt16(data + 8);
+    sample.humidity = getUInt16(data + 10);
+    sample.voltage = getUInt16(data + 12);
+    byte flags = data[14];
+    callback(sample, flags);
+    uint16_t count = 1;
+
+    int32_t delta[CHANNELS] = {};
+    uint16_t pos = 0;
+    for (;;)
+    {
+      int32_t dod[CHANNELS];
+      for (byte c=0; c<CHANNELS; c++)
+      {
+        if (!getCode(data + HEADER_SIZE, pos, dod[c]))
+        {
+          return count;
+        }
+        delta[c] += dod[c];
+      }
+      sample.time += delta[0];
+      sample.temperature += delta[1];
+      sample.humidity += delta[2];
+      sample.voltage += delta[3];
+      callback(sample, flags);
+      count++;
+    }
+  }
+
+  static bool isValidHeader(const byte* header)
+  {
+    return getUInt32(header) != 0xFFFFFFFF && header[15] == getHeaderCheck(header);
+  }
+
+protected:
+  void startBlock(const Sample& sample, byte flags)
+  {
+    uint16_t next = current == NO_BLOCK? 0 : (current + 1) % blocks;
+    if (next % BLOCKS_PER_ROW && !isErased(next))
+    {
+      // remains of an interrupted write, skip to next row
+      next = (next/BLOCKS_PER_ROW + 1)*BLOCKS_PER_ROW % blocks;
+    }
+    eraseNeeded = next % BLOCKS_PER_ROW == 0;
+    current = next;
+    sequence++;
+
+    memset(block, 0xFF, BLOCK_SIZE);
+    putUInt32(block, sequence);
+    putUInt32(block + 4, sample.time);
+    putUInt16(block + 8, sample.temperature);
+    putUInt16(block + 10, sample.humidity);
+    putUInt16(block + 12, sample.voltage);
+    block[14] = flags;
+    block[15] = getHeaderCheck(block);
+
+    getValues(sample, previous);
+    memset(previousDelta, 0, sizeof(previousDelta));
+    blockFlags = flags;
+    bitPos = 0;
+    flushedBits = 0;
+    headerWritten = false;
+    dirty = true;
+    open = true;
+  }
+
+  bool isErased(uint16_t index)
+  {
+    uint32_t data[BLOCK_SIZE/4];
+    flash.read((uint32_t)index*BLOCK_SIZE, data, BLOCK_SIZE);
+    for (byte i=0; i<BLOCK_SIZE/4; i++)
+    {
+      if (data[i] != 0xFFFFFFFF)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void getValues(const Sample& sample, int32_t v[CHANNELS])
+  {
+    v[0] = sample.time;
+    v[1] = sample.temperature;
+    v[2] = sample.humidity;
+    v[3] = sample.voltage;
+  }
+
+  static byte getCodeSize(int32_t v)
+  {
+    if (v == 0) return 1;
+    if (v >= -8 && v < 8) return 2 + 4;
+    if (v >= -64 && v < 64) return 3 + 7;
+    if (v >= -2048 && v < 2048) return 4 + 12;
+    return 4 + 32;
+  }
+
+  void putCode(int32_t v)
+  {
+    if (v == 0)
+    {
+      putBits(0, 1);
+    }
+    else if (v >= -8 && v < 8)
+    {
+      putBits(0x2, 2);
+      putBits(v, 4);
+    }
+    else if (v >= -64 && v < 64)
+    {
+      putBits(0x6, 3);
+      putBits(v, 7);
+    }
+    else if (v >= -2048 && v < 2048)
+    {
+      putBits(0xE, 4);
+      putBits(v, 12);
+    }
+    else
+    {
+      putBits(0xF, 4);
+      putBits(v, 32);
+    }
+  }
+
+  /**
+   * clear bits of erased bit stream
+   */
+  void putBits(uint32_t v, byte count)
+  {
+    byte* stream = block + HEADER_SIZE;
+    for (byte i=count; i>0; i--, bitPos++)
+    {
+      if (!((v >> (i - 1)) & 1))
+      {
+        stream[bitPos >> 3] &= ~(0x80 >> (bitPos & 7));
+      }
+    }
+  }
+
+  /**
+   * @return false at end of block
+   */
+  static bool getCode(const byte* stream, uint16_t& pos, int32_t& v)
+  {
+    static const byte WIDTH[] = { 0, 4, 7, 12, 32 };
+    byte ones = 0;
+    while (ones < 4)
+    {
+      if (pos >= BLOCK_BITS)
+      {
+        return false;
+      }
+      if (!getBit(stream, pos++))
+      {
+        break;
+      }
+      ones++;
+    }
+
+    byte width = WIDTH[ones];
+    if (pos + width > BLOCK_BITS)
+    {
+      return false;
+    }
+    uint32_t u = 0;
+    for (byte i=0; i<width; i++)
+    {
+      u = (u << 1) | getBit(stream, pos++);
+    }
+    if (width == 32)
+    {
+      // all bits set: end marker
+      v = u;
+      return u != 0xFFFFFFFF;
+    }
+    // sign extension
+    v = width && (u & (1UL << (width - 1)))? (int32_t)(u | ~((1UL << width) - 1)) : (int32_t)u;
+    return true;
+  }
+
+  static bool getBit(const byte* stream, uint16_t pos)
+  {
+    return stream[pos >> 3] & (0x80 >> (pos & 7));
+  }
+
+  static byte getHeaderCheck(const byte* header)
+  {
+    byte check = MAGIC;
+    for (byte i=0; i<15; i++)
+    {
+      check = (check << 1 | check >> 7) ^ header[i];
+    }
+    return check;
+  }
+
+  static uint16_t getUInt16(const byte* p)
+  {
+    return p[0] | (p[1] << 8);
+  }
+
+  static uint32_t getUInt32(const byte* p)
+  {
+    return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+
+  static void putUInt16(byte* p, uint16_t v)
+  {
+    p[0] = v;
+    p[1] = v >> 8;
+  }
+
+  static void putUInt32(byte* p, uint32_t v)
+  {
+    putUInt16(p, v);
+    putUInt16(p + 2, v >> 16);
+  }
+
+protected:
+  Flash& flash;
+  alignas(4) byte block[BLOCK_SIZE];
+  int32_t previous[CHANNELS];
+  int32_t previousDelta[CHANNELS];
+  uint32_t sequence = 0;
+  uint16_t blocks = 0;
+  uint16_t current = NO_BLOCK;
+  uint16_t bitPos = 0;      // [bits] next bit in stream
+  uint16_t flushedBits = 0; // [bits] written to flash
+  byte blockFlags = 0;
+  bool open = false;
+  bool dirty = false;
+  bool headerWritten = false;
+  bool eraseNeeded = false;
+  bool full = false;        // block closed, pending sample starts next block
+  Sample pending;
+  byte pendingFlags = 0;
+};
@@ -0,0 +1,114 @@
+/*****************************************************************************
+ *
+ * Manchester Encoder for OOK Bitstream Generation
+ *
+ * file:     ManchesterEncoder.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * converts a byte message into a sequence of Manchester half bits,
+ * using the same options as the Si4432 packet handler
+ *
+ * bit mapping:
+ * - default:  1 -> high/low, 0 -> low/high
+ * - inverted: 1 -> low/high, 0 -> high/low
+ */
+class ManchesterEncoder
+{
+public:
+  ManchesterEncoder() = default;
+
+public:
+  /**
+   * if enabled each bit will be encoded with inverted Manchester polarity, default disabled
+   */
+  void setInverted(bool enabled)
+  {
+    inverted = enabled;
+  }
+
+  /**
+   * if enabled least significant bit of each byte is sent first, default disabled = MSB first
+   */
+  void setLsbFirst(bool enabled)
+  {
+    lsbFirst = enabled;
+  }
+
+  /**
+   * @param data message
+   * @param bit bit index, 0 .. 8*size - 1
+   * @return value of bit in transmit order
+   */
+  bool getBit(const byte* data, size_t bit) const
+  {
+    byte b = data[bit / 8];
+    byte shift = lsbFirst? (bit % 8) : (7 - bit % 8);
+    return (b >> shift) & 1;
+  }
+
+  /**
+   * @param data message
+   * @param halfBit half bit index, 0 .. 16*size - 1
+   * @return output level of half bit (true = carrier on)
+   */
+  bool getLevel(const byte* data, size_t halfBit) const
+  {
+    bool first = getBit(data, halfBit / 2) != inverted;
+    return (halfBit % 2 == 0)? first : !first;
+  }
+
+  /**
+   * render message into an array with one value per half bit
+   *
+   * @param data message
+   * @param size message size [bytes]
+   * @param halfBits output buffer
+   * @param maxHalfBits size of output buffer
+   * @param high value for carrier on
+   * @param low value for carrier off
+   * @return number of half bits written or 0 if output buffer is too small
+   */
+  template<typename T> size_t render(const byte* data, size_t size, T* halfBits, size_t maxHalfBits, T high, T low) const
+  {
+    size_t count = 16*size;
+    if (count > maxHalfBits)
+    {
+      return 0;
+    }
+
+    for (size_t i=0; i<count; i++)
+    {
+      halfBits[i] = getLevel(data, i)? high : low;
+    }
+
+    return count;
+  }
+
+private:
+  bool inverted = false;
+  bool lsbFirst = false;
+};
@@ -50,11 +50,38 @@ public:
     }
   }
 
+  /**
+   * not sampled on purpose, samples and average are kept,
+   * see AcquisitionPlanner for the number of skipped samples
+   */
+  void skip() {}
+
+  /**
+   * sampling failed, the oldest sample is removed to keep the average moving
+   */
+  void fail()
+  {
+    removeOldest();
+  }
+
   void removeOldest()
   {
     if (!samples.empty()) samples.erase(samples.begin());
   }
 
+  size_t size() const
+  {
+    return samples.size();
+  }
+
+  /**
+   * @param index 0 = oldest
+   */
+  float getSample(size_t index) const
+  {
+    return index < samples.size()? samples[index] : 0;
+  }
+
   float getAverage(size_t latest = 0)
   {
     size_t count = samples.size();
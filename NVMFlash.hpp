@@ -0,0 +1,142 @@
+/*****************************************************************************
+ *
+ * SAMD21 NVM Flash Rows for Persistent Data
+ *
+ * file:     NVMFlash.hpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * row erase and page write of a reserved region of the main flash array,
+ * backend for FlashLog
+ *
+ * notes:
+ * - the SAMD21G18A has no RWWEE section, the CPU stalls while the NVM
+ *   controller is busy (row erase ~6 ms, page write ~3 ms)
+ * - the region must be row aligned and outside of the sketch, e.g. a
+ *   const array with __aligned__(256) as used by the FlashStorage library
+ * - partial page writes are used: the page buffer is cleared to 0xFF, so
+ *   unwritten words of the page keep their content
+ */
+class NVMFlash
+{
+public:
+  static const uint16_t PAGE_SIZE = 64; // [bytes]
+  static const uint16_t ROW_SIZE = 4*PAGE_SIZE; // [bytes]
+
+public:
+  /**
+   * @param region start of reserved flash region, row aligned
+   * @param rows size of region [rows]
+   */
+  NVMFlash(const volatile void* region, uint16_t rows) :
+    region((uintptr_t)region),
+    rows(rows)
+  {};
+
+public:
+  uint16_t getRows() const
+  {
+    return rows;
+  }
+
+  const volatile void* getRegion() const
+  {
+    return (const volatile void*)region;
+  }
+
+  void read(uint32_t offset, void* data, uint16_t size) const
+  {
+    memcpy(data, (const void*)(region + offset), size);
+  }
+
+  bool eraseRow(uint16_t row)
+  {
+    if (row >= rows)
+    {
+      return false;
+    }
+
+    return execute(NVMCTRL_CTRLA_CMD_ER, region + (uint32_t)row*ROW_SIZE);
+  }
+
+  /**
+   * @param offset 4 byte aligned
+   * @param data 32 bit words
+   * @param size multiple of 4 bytes, must not cross a page boundary
+   */
+  bool write(uint32_t offset, const void* data, uint16_t size)
+  {
+    if ((offset & 3) || (size & 3) || offset + size > (uint32_t)rows*ROW_SIZE
+     || offset/PAGE_SIZE != (offset + size - 1)/PAGE_SIZE)
+    {
+      return false;
+    }
+
+    // manual page write
+    NVMCTRL->CTRLB.bit.MANW = 1;
+    if (!execute(NVMCTRL_CTRLA_CMD_PBC, 0))
+    {
+      return false;
+    }
+
+    // fill page buffer (32 bit access), write page
+    const uint32_t* src = (const uint32_t*)data;
+    volatile uint32_t* dst = (volatile uint32_t*)(region + offset);
+    for (uint16_t i=0; i<size/4; i++)
+    {
+      dst[i] = src[i];
+    }
+    return execute(NVMCTRL_CTRLA_CMD_WP, region + offset);
+  }
+
+private:
+  bool execute(uint32_t command, uintptr_t address)
+  {
+    while (!NVMCTRL->INTFLAG.bit.READY);
+    NVMCTRL->STATUS.reg = NVMCTRL_STATUS_MASK; // clear errors
+
+    // disable cache while flash content changes
+    bool cacheDisabled = NVMCTRL->CTRLB.bit.CACHEDIS;
+    NVMCTRL->CTRLB.bit.CACHEDIS = 1;
+
+    if (address)
+    {
+      NVMCTRL->ADDR.reg = address/2; // 16 bit word address
+    }
+    NVMCTRL->CTRLA.reg = NVMCTRL_CTRLA_CMDEX_KEY | command;
+    while (!NVMCTRL->INTFLAG.bit.READY);
+
+    NVMCTRL->CTRLB.bit.CACHEDIS = cacheDisabled;
+
+    return !(NVMCTRL->STATUS.reg & (NVMCTRL_STATUS_PROGE | NVMCTRL_STATUS_LOCKE | NVMCTRL_STATUS_NVME));
+  }
+
+private:
+  uintptr_t region;
+  uint16_t rows;
+};
@@ -28,6 +28,10 @@
 
 #pragma once
 
+#ifndef RAMFUNC
+  #define RAMFUNC // execution from RAM, see option HAS_RAMFUNC of SolarDHTConfig.h
+#endif
+
 /**
  * @see https://wmrx00.sourceforge.net/ for specification details
  */
@@ -91,7 +95,7 @@ public:
    * @param hum humidity [%], min 0, max 99
    * @return message size on success [bytes], should be 12/13 bytes, or 0 on error
    */
-  byte encodeTH(uint16_t id, byte channel, byte rollingCode, bool lowBatt, float temp, byte hum)
+  RAMFUNC byte encodeTH(uint16_t id, byte channel, byte rollingCode, bool lowBatt, float temp, byte hum)
   {
     // clear message buffer
     bzero(message, MAX_MESSAGE_SIZE);
@@ -0,0 +1,329 @@
+/*****************************************************************************
+ *
+ * Peak Current Arbitration of High Current Loads
+ *
+ * file:     PowerArbiter.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * keep the sum of the currents of concurrent high current loads (radio TX/RX,
+ * display refresh, sensor heater) below a peak current budget
+ *
+ * A coin cell or a weak harvester output sags under the sum of the load
+ * currents, so loads that would exceed the budget together are serialised.
+ *
+ * At runtime a load is started with request(). If it does not fit next to
+ * the active loads it is marked pending and the caller starts it later, e.g.
+ * after release() of the blocking load. A load exceeding the budget on its
+ * own is granted if no other load is active. start() bypasses the budget for
+ * time critical loads.
+ *
+ * plan() finds the start order of a set of loads with the shortest MCU awake
+ * time under the budget, host/EnergyTool.cpp uses it to validate the order
+ * chosen by the firmware.
+ *
+ * Units: current [mA], time [ms]
+ */
+class PowerArbiter
+{
+public:
+  static const byte MAX_LOADS = 4;
+
+  struct Load
+  {
+    const char* name;
+    float current;   // [mA] peak
+    float duration;  // [ms]
+    float hold;      // [ms] MCU awake after start (e.g. SPI transfer, radio TX until PKSENT)
+    float ready;     // [ms] earliest start
+  };
+
+  struct Plan
+  {
+    byte order[MAX_LOADS];
+    float start[MAX_LOADS];  // [ms] by load index
+    float awake;             // [ms] MCU awake until last hold ends
+    float end;               // [ms] last load ends
+    float peak;              // [mA] max. sum of concurrent loads
+  };
+
+public:
+  PowerArbiter(float budget = 0) : budget(budget) {}
+
+public:
+  /**
+   * @param budget [mA] max. sum of active load currents, 0 for no limit
+   */
+  void setBudget(float budget)
+  {
+    this->budget = budget;
+  }
+
+  float getBudget() const
+  {
+    return budget;
+  }
+
+  /**
+   * @return true if the load may start now, otherwise it is marked pending
+   */
+  bool request(byte load, float current)
+  {
+    if (budget > 0 && active && getActiveCurrent() + current > budget)
+    {
+      pending |= 1 << load;
+      return false;
+    }
+    start(load, current);
+    return true;
+  }
+
+  /**
+   * start load regardless of budget
+   */
+  void start(byte load, float current)
+  {
+    currents[load] = current;
+    active |= 1 << load;
+    pending &= ~(1 << load);
+    float sum = getActiveCurrent();
+    if (sum > peak)
+    {
+      peak = sum;
+    }
+  }
+
+  /**
+   * load has ended, pending loads are not started automatically
+   */
+  void release(byte load)
+  {
+    active &= ~(1 << load);
+  }
+
+  /**
+   * drop pending request
+   */
+  void cancel(byte load)
+  {
+    pending &= ~(1 << load);
+  }
+
+  bool isActive(byte load) const
+  {
+    return active & (1 << load);
+  }
+
+  bool isPending(byte load) const
+  {
+    return pending & (1 << load);
+  }
+
+  /**
+   * @return [mA] sum of active loads
+   */
+  float getActiveCurrent() const
+  {
+    float sum = 0;
+    for (byte i=0; i<MAX_LOADS; i++)
+    {
+      if (active & (1 << i))
+      {
+        sum += currents[i];
+      }
+    }
+    return sum;
+  }
+
+  /**
+   * @return [mA] max. sum of active loads since last reset
+   */
+  float getPeakCurrent() const
+  {
+    return peak;
+  }
+
+  void resetPeak()
+  {
+    peak = getActiveCurrent();
+  }
+
+  /**
+   * find start times with shortest awake time (then shortest end) under the
+   * budget by trying all orders, each load starts at the earliest time
+   * without exceeding the budget next to the loads placed before
+   *
+   * @param budget [mA] 0 for no limit
+   */
+  static Plan plan(const Load* loads, byte count, float budget)
+  {
+    Plan best;
+    best.awake = -1;
+    byte order[MAX_LOADS];
+    for (byte i=0; i<count; i++)
+    {
+      order[i] = i;
+    }
+    do
+    {
+      Plan p = place(loads, count, budget, order);
+      if (best.awake < 0 || p.awake < best.awake || (p.awake == best.awake && p.end < best.end))
+      {
+        best = p;
+      }
+    } while (nextPermutation(order, count));
+    return best;
+  }
+
+  /**
+   * @return [mA] max. sum of concurrent loads of plan
+   */
+  static float getPeak(const Load* loads, byte count, const float* start)
+  {
+    float peak = 0;
+    for (byte i=0; i<count; i++)
+    {
+      // sum at each start time
+      float sum = 0;
+      for (byte j=0; j<count; j++)
+      {
+        if (start[j] <= start[i] && start[i] < start[j] + loads[j].duration)
+        {
+          sum += loads[j].current;
+        }
+      }
+      peak = sum > peak? sum : peak;
+    }
+    return peak;
+  }
+
+private:
+  static Plan place(const Load* loads, byte count, float budget, const byte* order)
+  {
+    Plan p;
+    p.awake = 0;
+    p.end = 0;
+    for (byte n=0; n<count; n++)
+    {
+      byte i = order[n];
+      const Load& load = loads[i];
+      p.order[n] = i;
+
+      // candidates: ready time and end of placed loads
+      float start = -1;
+      for (byte c=0; c<=n; c++)
+      {
+        float t = c < n? p.start[order[c]] + loads[order[c]].duration : load.ready;
+        if (t < load.ready || (start >= 0 && t >= start))
+        {
+          continue;
+        }
+        if (fits(loads, order, n, p.start, load, t, budget))
+        {
+          start = t;
+        }
+      }
+      if (start < 0)
+      {
+        // exceeds budget with any overlap, start after all placed loads
+        start = load.ready > p.end? load.ready : p.end;
+      }
+      p.start[i] = start;
+      p.awake = start + load.hold > p.awake? start + load.hold : p.awake;
+      p.end = start + load.duration > p.end? start + load.duration : p.end;
+    }
+    p.peak = getPeak(loads, count, p.start);
+    return p;
+  }
+
+  /**
+   * @return true if load started at t stays within budget next to the first n placed loads
+   */
+  static bool fits(const Load* loads, const byte* order, byte n, const float* start, const Load& load, float t, float budget)
+  {
+    if (budget <= 0)
+    {
+      return true;
+    }
+    // the current profile only rises at t and at starts of placed loads within [t, t + duration)
+    for (byte c=0; c<=n; c++)
+    {
+      float at = c < n? start[order[c]] : t;
+      if (at < t || at >= t + load.duration)
+      {
+        continue;
+      }
+      float sum = load.current;
+      bool overlap = false;
+      for (byte k=0; k<n; k++)
+      {
+        const Load& placed = loads[order[k]];
+        if (start[order[k]] <= at && at < start[order[k]] + placed.duration)
+        {
+          sum += placed.current;
+          overlap = true;
+        }
+      }
+      if (overlap && sum > budget)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool nextPermutation(byte* a, byte n)
+  {
+    // lexicographic successor, false after the last permutation
+    int i = n - 2;
+    while (i >= 0 && a[i] >= a[i + 1])
+    {
+      i--;
+    }
+    if (i < 0)
+    {
+      return false;
+    }
+    int j = n - 1;
+    while (a[j] <= a[i])
+    {
+      j--;
+    }
+    byte t = a[i]; a[i] = a[j]; a[j] = t;
+    for (int l=i + 1, r=n - 1; l < r; l++, r--)
+    {
+      t = a[l]; a[l] = a[r]; a[r] = t;
+    }
+    return true;
+  }
+
+private:
+  float budget;
+  float currents[MAX_LOADS] = {};
+  byte active = 0;
+  byte pending = 0;
+  float peak = 0;
+};
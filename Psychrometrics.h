@@ -0,0 +1,242 @@
+/*****************************************************************************
+ *
+ * Dew Point and Absolute Humidity in Fixed Point
+ *
+ * file:     Psychrometrics.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * dew point and absolute humidity from temperature and relative humidity
+ *
+ * Magnus formula over water (B = 17.62, C = 243.12 °C):
+ *
+ *   gamma      = ln(RH/100) + B*T/(C + T)
+ *   dew point  = C*gamma/(B - gamma)
+ *   saturation = 611.2 Pa * exp(B*T/(C + T))
+ *   absolute   = saturation*RH/100/(Rv*(T + 273.15)), Rv = 461.5 J/(kg K)
+ *
+ * The Cortex-M0+ has no FPU, logf() and expf() in soft float take several
+ * thousand cycles. Here ln() is split into exponent and mantissa of the
+ * integer humidity, the mantissa part and the temperature terms are linear
+ * interpolated from tables generated at compile time (constexpr series
+ * expansion), all in integer arithmetic with one division per value.
+ *
+ * Range: -40 .. 85 °C (clamped), 0.01 .. 100 %RH
+ * Error: < 0.02 °C dew point, < 0.06 g/m³ absolute humidity vs. Magnus with libm
+ */
+class Psychrometrics
+{
+public:
+  static const int16_t MIN_TEMPERATURE = -4000; // [0.01 °C]
+  static const int16_t MAX_TEMPERATURE = 8500;  // [0.01 °C]
+  static const uint16_t MAX_HUMIDITY = 10000;   // [0.01 %]
+
+private:
+  // compile time index sequence
+  template<int... I> struct Indices {};
+  template<int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+  template<int... I> struct MakeIndices<0, I...> { typedef Indices<I...> Type; };
+
+  static constexpr double B = 17.62;
+  static constexpr double C = 243.12;  // [°C]
+  static constexpr double SATURATION_DENSITY = 611.2*1000/461.5; // [g K/m³] 611.2 Pa/Rv
+
+  static constexpr double expSeries(double x, int n, double term)
+  {
+    return n > 40? term : term + expSeries(x, n + 1, term*x/(n + 1));
+  }
+
+  static constexpr double atanhSeries(double z2, int n, double power)
+  {
+    return n > 40? 0 : power/(2*n + 1) + atanhSeries(z2, n + 1, power*z2);
+  }
+
+  static constexpr double exp(double x)
+  {
+    return expSeries(x, 0, 1);
+  }
+
+  /**
+   * @param x 0.5 .. 2
+   */
+  static constexpr double ln(double x)
+  {
+    return 2*atanhSeries(((x - 1)/(x + 1))*((x - 1)/(x + 1)), 0, (x - 1)/(x + 1));
+  }
+
+  static constexpr double magnus(double t)
+  {
+    return B*t/(C + t);
+  }
+
+  static constexpr int32_t round(double x)
+  {
+    return (int32_t)(x >= 0? x + 0.5 : x - 0.5);
+  }
+
+  static const int TEMPERATURE_STEPS = (MAX_TEMPERATURE - MIN_TEMPERATURE)/100 + 1; // 1 °C per entry
+  static const byte MANTISSA_BITS = 5;                                              // 32 segments
+  static const int MANTISSA_STEPS = (1 << MANTISSA_BITS) + 1;
+
+  template<class> struct TemperatureTable;
+  template<int... I> struct TemperatureTable<Indices<I...>>
+  {
+    // [Q16] B*T/(C + T)
+    static constexpr int32_t magnus[sizeof...(I)] = { round(65536*Psychrometrics::magnus(MIN_TEMPERATURE/100 + I))... };
+    // [0.001 g/m³] saturation vapor density
+    static constexpr int32_t density[sizeof...(I)] = {
+      round(1000*SATURATION_DENSITY*Psychrometrics::exp(Psychrometrics::magnus(MIN_TEMPERATURE/100 + I))/(273.15 + MIN_TEMPERATURE/100 + I))... };
+  };
+
+  template<class> struct MantissaTable;
+  template<int... I> struct MantissaTable<Indices<I...>>
+  {
+    // [Q16] ln(1 + i/32)
+    static constexpr int32_t ln[sizeof...(I)] = { round(65536*Psychrometrics::ln(1 + (double)I/(MANTISSA_STEPS - 1)))... };
+  };
+
+  typedef TemperatureTable<MakeIndices<TEMPERATURE_STEPS>::Type> Temperatures;
+  typedef MantissaTable<MakeIndices<MANTISSA_STEPS>::Type> Mantissas;
+
+  static const int32_t LN2 = 45426;              // [Q16] ln(2)
+  static const int32_t LN_MAX_HUMIDITY = 603609;  // [Q16] ln(10000)
+  static const int32_t B_Q16 = 1154744;           // [Q16] B
+  static const int32_t C_CENTI = 24312;           // [0.01 °C] C
+
+public:
+  /**
+   * @param temperature [0.01 °C]
+   * @param humidity [0.01 %], 0 is treated as 0.01 %
+   * @return dew point [0.01 °C]
+   */
+  static int16_t getDewPoint(int16_t temperature, uint16_t humidity)
+  {
+    uint16_t index, fraction;
+    split(temperature, index, fraction);
+    int32_t gamma = lnHumidity(humidity) + interpolate(Temperatures::magnus, index, fraction);
+
+    // C*gamma/(B - gamma) with gamma in Q12 to stay within 32 bits (|gamma| < 14)
+    int32_t numerator = C_CENTI*(gamma >> 4);
+    int32_t denominator = (B_Q16 - gamma) >> 4;
+    numerator += numerator >= 0? denominator/2 : -denominator/2;
+    return numerator/denominator;
+  }
+
+  /**
+   * @param temperature [0.01 °C]
+   * @param humidity [0.01 %]
+   * @return absolute humidity [0.01 g/m³]
+   */
+  static uint16_t getAbsoluteHumidity(int16_t temperature, uint16_t humidity)
+  {
+    uint16_t index, fraction;
+    split(temperature, index, fraction);
+    if (humidity > MAX_HUMIDITY)
+    {
+      humidity = MAX_HUMIDITY;
+    }
+    // max. 354 g/m³ * 100 % fits in 32 bits
+    uint32_t density = interpolate(Temperatures::density, index, fraction);
+    return (density*humidity + 50000)/100000;
+  }
+
+  /**
+   * @param temperature [°C]
+   * @param humidity [%]
+   * @return dew point [°C]
+   */
+  static float getDewPoint(float temperature, float humidity)
+  {
+    return getDewPoint(toCenti(temperature), (uint16_t)toCenti(humidity))/100.0f;
+  }
+
+  /**
+   * @param temperature [°C]
+   * @param humidity [%]
+   * @return absolute humidity [g/m³]
+   */
+  static float getAbsoluteHumidity(float temperature, float humidity)
+  {
+    return getAbsoluteHumidity(toCenti(temperature), (uint16_t)toCenti(humidity))/100.0f;
+  }
+
+private:
+  static int16_t toCenti(float value)
+  {
+    value = value < -300? -300 : value > 300? 300 : value;
+    return value >= 0? (int16_t)(value*100 + 0.5f) : (int16_t)(value*100 - 0.5f);
+  }
+
+  /**
+   * clamp temperature and split into table index (1 °C) and fraction [0.01 °C]
+   */
+  static void split(int16_t temperature, uint16_t& index, uint16_t& fraction)
+  {
+    if (temperature < MIN_TEMPERATURE)
+    {
+      temperature = MIN_TEMPERATURE;
+    }
+    else if (temperature >= MAX_TEMPERATURE)
+    {
+      temperature = MAX_TEMPERATURE - 1;
+    }
+    uint32_t offset = temperature - MIN_TEMPERATURE;
+    index = (offset*5243) >> 19; // offset/100 without division, exact for offset < 43699
+    fraction = offset - 100*index;
+  }
+
+  static int32_t interpolate(const int32_t* table, uint16_t index, uint16_t fraction)
+  {
+    return table[index] + ((table[index + 1] - table[index])*(int32_t)fraction + 50)/100;
+  }
+
+  /**
+   * @param humidity [0.01 %]
+   * @return [Q16] ln(humidity/100 %)
+   */
+  static int32_t lnHumidity(uint16_t humidity)
+  {
+    if (humidity == 0)
+    {
+      humidity = 1;
+    }
+    else if (humidity > MAX_HUMIDITY)
+    {
+      humidity = MAX_HUMIDITY;
+    }
+    // humidity = 2^e * (1 + m), m in 0 .. 1 as Q16
+    byte e = 31 - __builtin_clz(humidity);
+    uint32_t m = ((uint32_t)humidity << (16 - e)) & 0xFFFF;
+    byte i = m >> (16 - MANTISSA_BITS);
+    int32_t r = m & ((1 << (16 - MANTISSA_BITS)) - 1);
+    int32_t mantissa = Mantissas::ln[i] + (((Mantissas::ln[i + 1] - Mantissas::ln[i])*r) >> (16 - MANTISSA_BITS));
+    return e*LN2 + mantissa - LN_MAX_HUMIDITY;
+  }
+};
+
+template<int... I> constexpr int32_t Psychrometrics::TemperatureTable<Psychrometrics::Indices<I...>>::magnus[sizeof...(I)];
+template<int... I> constexpr int32_t Psychrometrics::TemperatureTable<Psychrometrics::Indices<I...>>::density[sizeof...(I)];
+template<int... I> constexpr int32_t Psychrometrics::MantissaTable<Psychrometrics::Indices<I...>>::ln[sizeof...(I)];
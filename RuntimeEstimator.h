@@ -0,0 +1,259 @@
+/*****************************************************************************
+ *
+ * Remaining Runtime Estimate from Supply Voltage Trend and Load
+ *
+ * file:     RuntimeEstimator.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * battery discharge curve, state of charge vs. open circuit voltage
+ */
+struct BatteryModel
+{
+  static const byte MAX_POINTS = 12;
+
+  const char* name;
+  float capacity;             // [mAh]
+  byte points;
+  float voltage[MAX_POINTS];  // [V] descending
+  float charge[MAX_POINTS];   // [%] remaining at voltage
+
+  /**
+   * @return [%] state of charge, linear interpolation of curve
+   */
+  float getStateOfCharge(float v) const
+  {
+    if (v >= voltage[0])
+    {
+      return charge[0];
+    }
+    for (byte i=1; i<points; i++)
+    {
+      if (v >= voltage[i])
+      {
+        return charge[i] + (charge[i - 1] - charge[i])*(v - voltage[i])/(voltage[i - 1] - voltage[i]);
+      }
+    }
+    return charge[points - 1];
+  }
+
+  /**
+   * @return true if v is within the discharge curve and at least margin above its end
+   */
+  bool isInRange(float v, float margin) const
+  {
+    return v <= voltage[0] && v >= voltage[points - 1] + margin;
+  }
+};
+
+// 50 mAh LiPo at low load (~C/1000)
+static const BatteryModel BATTERY_LIPO_50 = { "LiPo 50 mAh", 50, 11,
+  { 4.20, 4.08, 3.98, 3.90, 3.84, 3.79, 3.75, 3.72, 3.68, 3.60, 3.30 },
+  {  100,   90,   80,   70,   60,   50,   40,   30,   20,   10,    0 } };
+
+// CR2032 at ~20 µA, flat until ~90 % of the capacity is used
+static const BatteryModel BATTERY_CR2032 = { "CR2032", 220, 8,
+  { 3.20, 3.00, 2.95, 2.90, 2.85, 2.75, 2.50, 2.00 },
+  {  100,   95,   80,   50,   25,   10,    3,    0 } };
+
+/**
+ * estimate remaining runtime and net harvest, updated once per wakeup
+ *
+ * The supply voltage is filtered and converted into the remaining charge with
+ * the discharge curve. An exponentially weighted linear regression of the
+ * remaining charge over time gives the net current (positive while
+ * charging), the load current is the average power of the energy meter
+ * divided by the supply voltage and the harvest current is the difference.
+ * The regression needs O(1) memory and time per update: the weighted sums
+ * are shifted to the time of the newest sample and decayed.
+ *
+ * The runtime is the remaining charge divided by the net discharge current,
+ * unlimited while the trend is not negative. Before the trend has enough
+ * history the runtime without harvest (load only) is used.
+ *
+ * The voltage must follow the battery voltage, e.g. a divider from the
+ * battery to an analog input. A regulated supply voltage stays at one end of
+ * the curve, so the runtime is only reported as short after the voltage was
+ * inside the curve with remaining charge.
+ *
+ * Units: time [h], charge [mAh], current [mA], voltage [V], power [mW]
+ */
+class RuntimeEstimator
+{
+public:
+  static constexpr float UNLIMITED = 1e6;           // [h]
+  static constexpr float TREND_TIME_CONSTANT = 24;  // [h] ~1 day, averages day and night
+  static constexpr float MIN_TREND_SPAN = 6;        // [h] history needed for trend
+  static const byte VOLTAGE_WEIGHT = 4;             // voltage average over ~4 wakeups
+  static constexpr float VOLTAGE_MARGIN = 0.05;     // [V] above end of curve, exceeds filtered ADC noise
+
+public:
+  RuntimeEstimator(const BatteryModel& battery) : battery(battery) {}
+
+public:
+  /**
+   * @param voltage [V] battery voltage of this wakeup
+   * @param power [mW] average power of the load
+   * @param elapsed [h] time since last update
+   */
+  void update(float voltage, float power, float elapsed)
+  {
+    if (voltage <= 0)
+    {
+      return;
+    }
+    filteredVoltage = filteredVoltage > 0? filteredVoltage + (voltage - filteredVoltage)/VOLTAGE_WEIGHT : voltage;
+    remaining = battery.getStateOfCharge(filteredVoltage)*battery.capacity/100;
+    if (battery.isInRange(filteredVoltage, VOLTAGE_MARGIN))
+    {
+      tracking = true;
+    }
+    load = power/filteredVoltage;
+
+    // shift sums to time of new sample (t = 0) and decay weights
+    float dt = elapsed;
+    float decay = TREND_TIME_CONSTANT/(TREND_TIME_CONSTANT + dt);
+    sumTT = decay*(sumTT - 2*dt*sumT + dt*dt*sumW);
+    sumTQ = decay*(sumTQ - dt*sumQ);
+    sumT = decay*(sumT - dt*sumW);
+    sumQ = decay*sumQ;
+    sumW = decay*sumW + 1;
+    sumQ += remaining;
+    span += dt;
+
+    float denominator = sumW*sumTT - sumT*sumT;
+    if (span >= MIN_TREND_SPAN && denominator > 0)
+    {
+      net = (sumW*sumTQ - sumT*sumQ)/denominator;
+      valid = true;
+    }
+  }
+
+  /**
+   * @return true if the trend has enough history
+   */
+  bool isValid() const
+  {
+    return valid;
+  }
+
+  /**
+   * @return true if the voltage was inside the discharge curve and the
+   * runtime with trend is shorter than days
+   */
+  bool isRuntimeShorter(float days) const
+  {
+    return valid && tracking && getRuntime() < 24*days;
+  }
+
+  /**
+   * @return [%] state of charge
+   */
+  float getStateOfCharge() const
+  {
+    return 100*remaining/battery.capacity;
+  }
+
+  /**
+   * @return [mAh] remaining charge
+   */
+  float getRemainingCharge() const
+  {
+    return remaining;
+  }
+
+  /**
+   * @return [mA] net battery current, positive while charging
+   */
+  float getNetCurrent() const
+  {
+    return valid? net : -load;
+  }
+
+  /**
+   * @return [mA] average load current
+   */
+  float getLoadCurrent() const
+  {
+    return load;
+  }
+
+  /**
+   * @return [mA] average harvest current
+   */
+  float getHarvestCurrent() const
+  {
+    float harvest = getNetCurrent() + load;
+    return harvest > 0? harvest : 0;
+  }
+
+  /**
+   * @return [h] remaining runtime at the current net discharge, UNLIMITED if not discharging
+   */
+  float getRuntime() const
+  {
+    float discharge = -getNetCurrent();
+    return discharge > 0 && remaining < discharge*UNLIMITED? remaining/discharge : UNLIMITED;
+  }
+
+  /**
+   * @return [h] remaining runtime without harvest
+   */
+  float getRuntimeWithoutHarvest() const
+  {
+    return load > 0 && remaining < load*UNLIMITED? remaining/load : UNLIMITED;
+  }
+
+  /**
+   * @return [d] remaining runtime, max. 9999
+   */
+  uint16_t getRuntimeDays() const
+  {
+    float days = getRuntime()/24;
+    return days < 9999? (uint16_t)days : 9999;
+  }
+
+  const BatteryModel& getBattery() const
+  {
+    return battery;
+  }
+
+private:
+  const BatteryModel& battery;
+  float filteredVoltage = 0;
+  float remaining = 0;    // [mAh]
+  float load = 0;         // [mA]
+  float net = 0;          // [mA]
+  bool valid = false;
+  bool tracking = false;  // voltage was inside curve with remaining charge
+  float span = 0;         // [h]
+  // weighted sums of regression, t <= 0 relative to newest sample
+  float sumW = 0;
+  float sumT = 0;
+  float sumTT = 0;
+  float sumQ = 0;
+  float sumTQ = 0;
+};
@@ -89,11 +89,12 @@ public:
   bool setResolution(uint8_t humidityBits, uint8_t temperatureBits)
   {
     bool success = true;
-    if (humidityBits == 12 && temperatureBits == 14) dhtSensor.setResolution(0);
-    else if (humidityBits == 8 && temperatureBits == 12) dhtSensor.setResolution(1);
-    else if (humidityBits == 10 && temperatureBits == 13) dhtSensor.setResolution(2);
-    else if (humidityBits == 11 && temperatureBits == 11) dhtSensor.setResolution(3);
+    if (humidityBits == 12 && temperatureBits == 14) resolution = 0;
+    else if (humidityBits == 8 && temperatureBits == 12) resolution = 1;
+    else if (humidityBits == 10 && temperatureBits == 13) resolution = 2;
+    else if (humidityBits == 11 && temperatureBits == 11) resolution = 3;
     else success = false;
+    if (success) dhtSensor.setResolution(resolution);
     return success;
   }
 
@@ -120,14 +121,19 @@ public:
     return dhtSensor.getEIDA();
   }
 
+  /**
+   * the humidity conversion includes a temperature conversion, the temperature
+   * is read with readCachedTemperature() without a second conversion
+   */
   bool startAcquisition(AcquisitionType acquisitionType)
   {
+    this->acquisitionType = acquisitionType;
     switch (acquisitionType)
     {
       case ACQ_TYPE_TEMPERATURE:
         return dhtSensor.requestTemperature();
       default:
-        return dhtSensor.requestTemperature();
+        return dhtSensor.requestHumidity();
     }
   }
 
@@ -136,6 +142,17 @@ public:
     return dhtSensor.requestReady();
   }
 
+  /**
+   * @return [µs] max. conversion time of the last acquisition type, datasheet table 2
+   */
+  uint32_t getAcquisitionTime() const
+  {
+    // RES 0..3, humidity includes temperature conversion
+    static const uint16_t TEMPERATURE_TIME[4] = { 10800, 3800, 6200, 2400 };
+    static const uint16_t HUMIDITY_TIME[4] = { 22800, 7400, 11900, 9500 };
+    return acquisitionType == ACQ_TYPE_TEMPERATURE? TEMPERATURE_TIME[resolution] : HUMIDITY_TIME[resolution];
+  }
+
   bool isHumidityReady()
   {
     return dhtSensor.reqHumReady();
@@ -143,7 +160,7 @@ public:
 
   bool isTemperatureReady()
   {
-    return dhtSensor.reqHumReady();
+    return dhtSensor.reqTempReady();
   }
 
   bool readHumidity()
@@ -182,4 +199,6 @@ public:
 
 protected:
   T dhtSensor;
+  uint8_t resolution = 0;
+  AcquisitionType acquisitionType = ACQ_TYPE_COMBINED;
 };
@@ -0,0 +1,45 @@
+/*****************************************************************************
+ *
+ * TCC1 Interrupt Handler of the SYN115 Transmitter
+ *
+ * file:     SYN115_Transmitter.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#include <Arduino.h>
+#include <System.h>
+using namespace SAMD21LPE;
+
+#include "SolarDHTConfig.h"
+
+// only SYN115 builds link the ISR, TCC1 is unused otherwise
+#if HAS_RADIO == 2
+
+#include "SYN115_Transmitter.hpp"
+
+extern "C" void TCC1_Handler()
+{
+  SYN115_Transmitter::handleInterrupt();
+}
+
+#endif
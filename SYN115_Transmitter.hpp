@@ -0,0 +1,352 @@
+/*****************************************************************************
+ *
+ * OOK transmitter driver for SYN115 with TCC/DMA bitstream generation
+ *
+ * file:     SYN115_Transmitter.hpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <wiring_private.h>
+
+#include "DirectMemoryAccess.hpp"
+#include "ManchesterEncoder.h"
+
+/**
+ * application specific driver for a pure OOK transmitter (e.g. SYN115)
+ * providing the subset of the Si4432 driver API used by SolarDHT
+ *
+ * The Manchester bitstream is rendered into a buffer with one TCC compare
+ * value per half bit. TCC1 runs in normal PWM mode with a period of one half
+ * bit and DMA reloads the buffered compare value CCB0 on each overflow, so
+ * the CPU can sleep during the transmission. The transmitter start-up time is
+ * timed with the same TCC in one shot mode.
+ *
+ * wiring:
+ * - data pin: TCC1/WO[0] (e.g. XIAO pin 17, PA30, peripheral function E)
+ * - power pin: transmitter VDD (< 15 mA) or enable input
+ *
+ * SYN115 device features:
+ * - ASK/OOK transmitter 300 .. 450 MHz
+ * - data rate up to 10 kbit/s
+ * - output power up to 10 dBm
+ * - transmit current ~ 3.5 mA (OOK 50 %, 3.0 V)
+ * - auto shutdown when data input stays low
+ * - crystal start-up time < 2 ms
+ */
+class SYN115_Transmitter
+{
+public:
+  static const byte MAX_PACKET_SIZE = 32; // [bytes]
+  static const uint16_t MAX_HALF_BITS = 2*8*MAX_PACKET_SIZE + 2; // compare values incl. 2 trailing entries
+
+  enum IdleMode
+  {
+    SleepMode,
+    Ready
+  };
+
+  enum InterruptStatus
+  {
+    INT_PKSENT  = 0x0004,
+    INT_CHIPRDY = 0x0200
+  };
+
+  typedef void (*Callback)();
+
+public:
+  SYN115_Transmitter(byte dataPin, byte powerPin) :
+    dataPin(dataPin),
+    powerPin(powerPin)
+  {};
+
+public:
+  /**
+   * see Si4432::setManchesterEncoding
+   */
+  void setManchesterEncoding(bool enabled, bool inverted)
+  {
+    manchester = enabled;
+    encoder.setInverted(inverted);
+  }
+
+  /**
+   * see Si4432::setPacketHandling
+   */
+  void setPacketHandling(bool enabled, bool lsbFirst)
+  {
+    (void)enabled; // no packet handler, message must include preamble and sync
+    encoder.setLsbFirst(lsbFirst);
+  }
+
+  /**
+   * @param kbps data rate [kbit/s], Manchester encoding doubles the symbol rate
+   */
+  void setBaudRate(float kbps)
+  {
+    baudRate = kbps;
+  }
+
+  /**
+   * @param ms delay between turnOn() and INT_CHIPRDY, default 18 ms to match Si4432 timing
+   */
+  void setStartupTime(uint16_t ms)
+  {
+    startupTime = ms;
+  }
+
+  /**
+   * @param gclkGen generic clock generator for TCC1, default GCLK0
+   * @param frequency [Hz] of generator, default SystemCoreClock
+   */
+  void setClock(byte gclkGen, uint32_t frequency)
+  {
+    clockGen = gclkGen;
+    clockFrequency = frequency;
+  }
+
+  /**
+   * called from ISR when INT_CHIPRDY or INT_PKSENT becomes pending
+   */
+  void setInterruptCallback(Callback callback)
+  {
+    interruptCallback = callback;
+  }
+
+  void setIdleMode(IdleMode mode)
+  {
+    (void)mode; // transmitter has no idle modes
+  }
+
+  bool init()
+  {
+    getActive() = this;
+
+    pinMode(powerPin, OUTPUT);
+    digitalWrite(powerPin, LOW);
+    pinMode(dataPin, OUTPUT);
+    digitalWrite(dataPin, LOW);
+
+    // enable TCC1 clock
+    PM->APBCMASK.reg |= PM_APBCMASK_TCC1;
+    System::enableClock(GCLK_CLKCTRL_ID_TCC0_TCC1_Val, clockGen);
+
+    NVIC_SetPriority(TCC1_IRQn, 3);
+    NVIC_EnableIRQ(TCC1_IRQn);
+
+    DirectMemoryAccess::instance().enable();
+
+    return true;
+  }
+
+  /**
+   * power up transmitter and report INT_CHIPRDY after start-up time
+   */
+  void turnOn()
+  {
+    digitalWrite(powerPin, HIGH);
+    intStatus = 0;
+
+    // one shot timer for start-up time
+    resetTimer();
+    TCC1->WAVE.reg = TCC_WAVE_WAVEGEN_NFRQ;
+    TCC1->PER.reg = TCC_PER_PER(startupTime*(getClock()/1000) - 1);
+    TCC1->CTRLBSET.reg = TCC_CTRLBSET_ONESHOT;
+    TCC1->INTENSET.reg = TCC_INTENSET_OVF;
+    while (TCC1->SYNCBUSY.reg);
+    TCC1->CTRLA.reg = TCC_CTRLA_PRESCALER_DIV1 | TCC_CTRLA_ENABLE;
+  }
+
+  /**
+   * abort transmission and power down transmitter
+   */
+  void turnOff()
+  {
+    DirectMemoryAccess::instance().abort(DirectMemoryAccess::CHANNEL_RADIO);
+    resetTimer();
+
+    pinMode(dataPin, OUTPUT);
+    digitalWrite(dataPin, LOW);
+    digitalWrite(powerPin, LOW);
+  }
+
+  void boot()
+  {
+    // nothing to configure
+  }
+
+  /**
+   * start non-blocking transmission, INT_PKSENT will be reported when completed
+   *
+   * @return false if packet is too large
+   */
+  bool sendPacket(byte length, const byte* data)
+  {
+    if (length > MAX_PACKET_SIZE)
+    {
+      return false;
+    }
+
+    // render half bits as compare values (CC > PER: on for full period, CC = 0: off)
+    uint32_t halfBitTicks = getClock()/(2000*baudRate);
+    uint16_t high = halfBitTicks;
+    uint16_t low = 0;
+    size_t count;
+    if (manchester)
+    {
+      count = encoder.render(data, length, halfBits, MAX_HALF_BITS - 2, high, low);
+    }
+    else
+    {
+      // NRZ, one full bit per entry
+      halfBitTicks *= 2;
+      high = halfBitTicks;
+      count = 8*length;
+      for (size_t i=0; i<count; i++)
+      {
+        halfBits[i] = encoder.getBit(data, i)? high : low;
+      }
+    }
+    if (count < 2)
+    {
+      return false;
+    }
+
+    // 2 trailing entries: output is off when the last DMA beat completes
+    halfBits[count++] = low;
+    halfBits[count++] = low;
+
+    // normal PWM with buffered compare, first 2 values preloaded, remaining values reloaded by DMA on overflow
+    resetTimer();
+    TCC1->WAVE.reg = TCC_WAVE_WAVEGEN_NPWM;
+    TCC1->PER.reg = TCC_PER_PER(halfBitTicks - 1);
+    TCC1->CC[0].reg = halfBits[0];
+    while (TCC1->SYNCBUSY.reg);
+    TCC1->CCB[0].reg = halfBits[1];
+    while (TCC1->SYNCBUSY.reg);
+    pinPeripheral(dataPin, PIO_TIMER);
+
+    DirectMemoryAccess::instance().start(DirectMemoryAccess::CHANNEL_RADIO, TCC1_DMAC_ID_OVF,
+                                         halfBits + 2, &TCC1->CCB[0].reg, count - 2,
+                                         DMAC_BTCTRL_BEATSIZE_HWORD | DMAC_BTCTRL_SRCINC,
+                                         []{ SYN115_Transmitter::getActive()->transmitComplete(); });
+
+    TCC1->CTRLA.reg = TCC_CTRLA_PRESCALER_DIV1 | TCC_CTRLA_RUNSTDBY | TCC_CTRLA_ENABLE;
+
+    return true;
+  }
+
+  /**
+   * @return pending interrupts, cleared by reading
+   */
+  uint16_t getIntStatus()
+  {
+    noInterrupts();
+    uint16_t status = intStatus;
+    intStatus = 0;
+    interrupts();
+    return status;
+  }
+
+  bool isInterruptPending() const
+  {
+    return intStatus != 0;
+  }
+
+  /**
+   * TCC1 ISR (prio 3)
+   */
+  void timerInterrupt()
+  {
+    TCC1->INTFLAG.reg = TCC_INTFLAG_MASK;
+    resetTimer();
+    raiseInterrupt(INT_CHIPRDY);
+  }
+
+private:
+  void resetTimer()
+  {
+    TCC1->CTRLA.reg &= ~TCC_CTRLA_ENABLE;
+    while (TCC1->SYNCBUSY.reg);
+    TCC1->CTRLA.reg = TCC_CTRLA_SWRST;
+    while (TCC1->SYNCBUSY.reg & TCC_SYNCBUSY_SWRST);
+  }
+
+  void transmitComplete()
+  {
+    resetTimer();
+    pinMode(dataPin, OUTPUT);
+    digitalWrite(dataPin, LOW);
+    raiseInterrupt(INT_PKSENT);
+  }
+
+  void raiseInterrupt(uint16_t flag)
+  {
+    intStatus |= flag;
+    if (interruptCallback)
+    {
+      interruptCallback();
+    }
+  }
+
+  uint32_t getClock() const
+  {
+    return clockFrequency? clockFrequency : SystemCoreClock;
+  }
+
+public:
+  /**
+   * transmitter served by the TCC1 and DMAC ISR, set by init()
+   */
+  static SYN115_Transmitter*& getActive()
+  {
+    static SYN115_Transmitter* active = nullptr;
+    return active;
+  }
+
+  /**
+   * called by TCC1_Handler() of SYN115_Transmitter.cpp
+   */
+  static void handleInterrupt()
+  {
+    if (getActive())
+    {
+      getActive()->timerInterrupt();
+    }
+  }
+
+private:
+  byte dataPin;
+  byte powerPin;
+  bool manchester = false;
+  float baudRate = 1.024; // [kbit/s]
+  uint16_t startupTime = 18; // [ms]
+  byte clockGen = GCLK_CLKCTRL_GEN_GCLK0_Val;
+  uint32_t clockFrequency = 0; // [Hz], 0 = SystemCoreClock
+  volatile uint16_t intStatus = 0;
+  Callback interruptCallback = nullptr;
+  ManchesterEncoder encoder;
+  uint16_t halfBits[MAX_HALF_BITS];
+};
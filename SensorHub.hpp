@@ -0,0 +1,293 @@
+/*****************************************************************************
+ *
+ * Additional I2C Humidity Sensors on Oregon Scientific Channels 2..3
+ *
+ * file:     SensorHub.hpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "Measurement.h"
+
+/**
+ * normalized sensor API of SHT2x_Wrapper and TI_HDC1080 without templates
+ */
+class HubSensor
+{
+public:
+  virtual ~HubSensor() = default;
+
+public:
+  virtual bool isConnected() = 0;
+  virtual bool begin() = 0;
+  virtual bool startAcquisition() = 0;
+  virtual bool isAcquisitionComplete() = 0;
+  virtual bool readTemperature() = 0;
+  virtual bool readHumidity() = 0;
+  virtual float getTemperature() = 0;
+  virtual float getHumidity() = 0;
+};
+
+template<class T> class HubSensorAdapter : public HubSensor
+{
+public:
+  HubSensorAdapter() = default;
+
+public:
+  bool isConnected() override { return sensor.isConnected(); }
+  bool begin() override
+  {
+    // reset and lower resolution for faster measurement, same as main sensor
+    if (!sensor.isConnected())
+    {
+      return false;
+    }
+    sensor.reset();
+    delay(8); // max. soft reset time of Si7021 and HDC1080
+    return sensor.setResolution(11, 11);
+  }
+  bool startAcquisition() override { return sensor.startAcquisition(T::ACQ_TYPE_COMBINED); }
+  bool isAcquisitionComplete() override { return sensor.isAcquisitionComplete(); }
+  bool readTemperature() override { return sensor.readTemperature(); }
+  bool readHumidity() override { return sensor.readHumidity(); }
+  float getTemperature() override { return sensor.getTemperature(); }
+  float getHumidity() override { return sensor.getHumidity(); }
+
+protected:
+  T sensor;
+};
+
+/**
+ * acquire temperature and humidity of several sensors in one wakeup
+ *
+ * Channel 1 is the main sensor of the application, the hub handles channels
+ * 2 and 3. All acquisitions are started back-to-back and read after the
+ * longest conversion, so the sensors share the MCU wakeup and the radio
+ * start-up. Sensors with the same I2C address (Si7021 and HDC1080 both use
+ * 0x40) must be connected to different ports of a TCA9548A I2C mux, the port
+ * is selected before each access.
+ *
+ * Values are averaged per channel like the main sensor.
+ */
+class SensorHub
+{
+public:
+  static const byte FIRST_CHANNEL = 2;
+  static const byte MAX_CHANNELS = 3;      // Oregon Scientific channels 1..3
+  static const byte MUX_ADDRESS = 0x70;    // TCA9548A with A0..A2 low
+  static const byte NO_PORT = 0xFF;
+
+public:
+  SensorHub() = default;
+
+public:
+  /**
+   * add sensor for next channel
+   *
+   * @param port mux port 0..7 or NO_PORT without mux
+   * @return channel number, 0 if all channels are used
+   */
+  byte add(HubSensor& sensor, byte port = NO_PORT)
+  {
+    if (count >= MAX_CHANNELS - 1)
+    {
+      return 0;
+    }
+    Channel& channel = channels[count++];
+    channel.sensor = &sensor;
+    channel.port = port;
+    return FIRST_CHANNEL + count - 1;
+  }
+
+  /**
+   * number of added channels
+   */
+  byte getCount() const
+  {
+    return count;
+  }
+
+  /**
+   * select mux port, skipped if already selected
+   *
+   * @param port mux port 0..7 or NO_PORT to keep selection
+   */
+  void select(byte port)
+  {
+    if (port != NO_PORT && port != selectedPort)
+    {
+      Wire.beginTransmission(MUX_ADDRESS);
+      Wire.write(1 << port);
+      if (Wire.endTransmission() == 0)
+      {
+        selectedPort = port;
+      }
+    }
+  }
+
+  /**
+   * reset and configure all sensors, channels with failed sensors are skipped
+   *
+   * @return number of initialized sensors
+   */
+  byte begin()
+  {
+    byte initialized = 0;
+    for (byte i=0; i<count; i++)
+    {
+      Channel& channel = channels[i];
+      select(channel.port);
+      channel.connected = channel.sensor->begin();
+      if (channel.connected)
+      {
+        initialized++;
+      }
+    }
+    return initialized;
+  }
+
+  /**
+   * start acquisition of all connected sensors
+   *
+   * @return number of started acquisitions
+   */
+  byte startAcquisition()
+  {
+    byte started = 0;
+    for (byte i=0; i<count; i++)
+    {
+      Channel& channel = channels[i];
+      select(channel.port);
+      channel.pending = channel.connected && channel.sensor->startAcquisition();
+      if (channel.pending)
+      {
+        started++;
+      }
+    }
+    return started;
+  }
+
+  /**
+   * @return true if all started acquisitions are complete
+   */
+  bool isAcquisitionComplete()
+  {
+    for (byte i=0; i<count; i++)
+    {
+      Channel& channel = channels[i];
+      if (channel.pending)
+      {
+        select(channel.port);
+        if (!channel.sensor->isAcquisitionComplete())
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * read all started acquisitions and update averages, the oldest sample is
+   * removed if a channel was not updated to keep the average moving
+   */
+  void read()
+  {
+    for (byte i=0; i<count; i++)
+    {
+      Channel& channel = channels[i];
+      bool temperatureUpdated = false;
+      bool humidityUpdated = false;
+      if (channel.pending)
+      {
+        select(channel.port);
+        if (channel.sensor->isAcquisitionComplete())
+        {
+          if (channel.sensor->readTemperature())
+          {
+            channel.temperatures.add(channel.sensor->getTemperature());
+            temperatureUpdated = true;
+          }
+          if (channel.sensor->readHumidity())
+          {
+            channel.humidities.add(channel.sensor->getHumidity());
+            humidityUpdated = true;
+          }
+        }
+        channel.pending = false;
+      }
+      if (!temperatureUpdated)
+      {
+        channel.temperatures.removeOldest();
+      }
+      if (!humidityUpdated)
+      {
+        channel.humidities.removeOldest();
+      }
+    }
+  }
+
+  /**
+   * @param index 0 .. getCount()-1
+   * @return true if channel has samples
+   */
+  bool isValid(byte index) const
+  {
+    return index < count && channels[index].temperatures.size();
+  }
+
+  byte getChannel(byte index) const
+  {
+    return FIRST_CHANNEL + index;
+  }
+
+  float getTemperature(byte index)
+  {
+    return index < count? channels[index].temperatures.getAverage() : 0;
+  }
+
+  float getHumidity(byte index)
+  {
+    return index < count? channels[index].humidities.getAverage() : 0;
+  }
+
+private:
+  struct Channel
+  {
+    HubSensor* sensor = nullptr;
+    byte port = NO_PORT;
+    bool connected = false;
+    bool pending = false;
+    Measurement temperatures;
+    Measurement humidities;
+  };
+
+private:
+  Channel channels[MAX_CHANNELS - 1];
+  byte count = 0;
+  byte selectedPort = NO_PORT;
+};
@@ -0,0 +1,155 @@
+/*****************************************************************************
+ *
+ * Supply Voltage and Temperature Measurement with the Si4432
+ *
+ * file:     Si4432Measurement.hpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <si4432.h>
+
+/**
+ * read the supply voltage with the low battery detector (LBD) and the
+ * temperature with the auxiliary ADC of the Si4432 while the radio is ready,
+ * so that the SAMD21 ADC can stay off on transmit wakeups
+ *
+ * Si4432 features (datasheet 8.3, 8.4):
+ * - battery voltage 1.7 .. 3.25 V with 50 mV resolution (5 bit)
+ * - temperature -64 .. 64 °C with 0.5 °C resolution (8 bit ADC)
+ * - ADC conversion time ~305 µs
+ *
+ * The LBD is enabled in REG_STATE together with the current state bits and
+ * disabled again when reading, the radio driver rewrites REG_STATE on each
+ * state change anyway. The temperature sensor is not trimmed, use
+ * RADIO_TEMP_OFFSET to calibrate.
+ */
+class Si4432Measurement
+{
+public:
+  static const byte REG_STATE                 = 0x07;
+  static const byte REG_ADC_CONFIG            = 0x0F;
+  static const byte REG_ADC_VALUE             = 0x11;
+  static const byte REG_TEMP_SENSOR_CONTROL   = 0x12;
+  static const byte REG_BATTERY_LEVEL         = 0x1B;
+
+  static const byte STATE_ENLBD               = 0x40;
+  static const byte ADC_START                 = 0x80; // write: start, read: done
+  static const byte ADC_SELECT_TEMPERATURE    = 0x00; // adcsel 000, reference bandgap, gain 0
+  static const byte TEMP_RANGE_64_OFFSET      = 0x20; // tsrange 00 (-64 .. 64 °C), entsoffs
+
+  static const uint16_t LBD_TIME              = 250;  // [µs] battery voltage conversion after enabling LBD
+  static const uint16_t MAX_CONVERSION_TIME   = 400;  // [µs]
+
+public:
+  Si4432Measurement(Si4432& radio) : radio(radio) {}
+
+public:
+  /**
+   * start measurement, radio must be ready (crystal on)
+   *
+   * @param temperature also convert temperature
+   */
+  void start(bool temperature)
+  {
+    radio.ChangeRegister((Si4432::Registers)REG_STATE, radio.ReadRegister((Si4432::Registers)REG_STATE) | STATE_ENLBD);
+    if (temperature)
+    {
+      radio.ChangeRegister((Si4432::Registers)REG_TEMP_SENSOR_CONTROL, TEMP_RANGE_64_OFFSET);
+      radio.ChangeRegister((Si4432::Registers)REG_ADC_CONFIG, ADC_START | ADC_SELECT_TEMPERATURE);
+    }
+    withTemperature = temperature;
+    started = micros();
+    pending = true;
+  }
+
+  bool isPending() const
+  {
+    return pending;
+  }
+
+  /**
+   * wait for conversion if necessary, read results and disable LBD
+   *
+   * @return false if not started or ADC timeout
+   */
+  bool read()
+  {
+    if (!pending)
+    {
+      return false;
+    }
+    pending = false;
+
+    // LBD and ADC convert in parallel
+    while (micros() - started < LBD_TIME);
+    bool success = true;
+    temperatureValid = false;
+    if (withTemperature)
+    {
+      do
+      {
+        success = radio.ReadRegister((Si4432::Registers)REG_ADC_CONFIG) & ADC_START;
+      } while (!success && micros() - started < MAX_CONVERSION_TIME);
+      temperature = radio.ReadRegister((Si4432::Registers)REG_ADC_VALUE)*0.5f - 64;
+      temperatureValid = success;
+    }
+    supplyVoltage = 1.7f + 0.05f*(radio.ReadRegister((Si4432::Registers)REG_BATTERY_LEVEL) & 0x1F);
+    radio.ChangeRegister((Si4432::Registers)REG_STATE, radio.ReadRegister((Si4432::Registers)REG_STATE) & ~STATE_ENLBD);
+    return success;
+  }
+
+  /**
+   * @return true if temperature was converted by last read()
+   */
+  bool hasTemperature() const
+  {
+    return temperatureValid;
+  }
+
+  /**
+   * @return [V]
+   */
+  float getSupplyVoltage() const
+  {
+    return supplyVoltage;
+  }
+
+  /**
+   * @return [°C]
+   */
+  float getTemperature() const
+  {
+    return temperature;
+  }
+
+private:
+  Si4432& radio;
+  bool pending = false;
+  bool withTemperature = false;
+  bool temperatureValid = false;
+  uint32_t started = 0;
+  float supplyVoltage = 0;
+  float temperature = 0;
+};
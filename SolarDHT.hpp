@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <wiring_private.h>
 #include <Analog2DigitalConverter.h>
 #include <RealTimeClock.h>
 #include <System.h>
@@ -35,57 +36,110 @@
 using namespace SAMD21LPE;
 
 #include <GD_ePaper.h>
-#include <Fonts/FreeSansBold9pt7b.h>
-#include <Fonts/FreeSans18pt7b.h>
-#include <si4432.h>
-
-#include "Measurement.h"
-#include "OregonScientific.h"
 
-//#define DEBUG
-#define SERIAL_SPEED 115200
+// options first, RAMFUNC is used by the sketch headers
+#include "SolarDHTConfig.h"
 
-#define PIN_UNUSED      0 // TBD
-
-#define PIN_EPD_RST     1 // out
-#define PIN_EPD_DC      2 // out
-#define PIN_EPD_CS      3 // out
-#define PIN_EPD_BUSY    6 // in
-
-#define PIN_RADIO_NIRQ  7 // in
-#define PIN_RADIO_NSDN 18 // out
-#define PIN_RADIO_CS   17 // out
+#if HAS_FONT_SUBSET
+  // generated from the installed library fonts, not part of the repository
+  #ifdef __has_include
+    #if !__has_include("SolarDHTFonts.h")
+      #error "HAS_FONT_SUBSET requires SolarDHTFonts.h, generate it with host/FontSubset.cpp -l <Adafruit GFX library>"
+    #endif
+  #endif
+  #include "SolarDHTFonts.h"
+  #define FONT_VALUE FreeSans18pt7bSubset
+  #define FONT_UNIT  FreeSansBold9pt7bSubset
+#else
+  #include <Fonts/FreeSansBold9pt7b.h>
+  #include <Fonts/FreeSans18pt7b.h>
+  #define FONT_VALUE FreeSans18pt7b
+  #define FONT_UNIT  FreeSansBold9pt7b
+#endif
 
-#define RADIO_TX_POWER  1 // 0..7
+#include "AcquisitionPlanner.h"
+#include "AdcSequencer.hpp"
+#include "ClockManager.hpp"
+#include "CompactFrame.h"
+#include "EnergyMeter.h"
+#include "FlashLog.h"
+#include "HistoryLog.h"
+#include "Measurement.h"
+#include "DisplayUpdate.h"
+#include "Downlink.h"
+#include "NVMFlash.hpp"
+#include "OregonScientific.h"
+#include "PowerArbiter.h"
+#include "Psychrometrics.h"
+#include "RuntimeEstimator.h"
+#include "SensorHub.hpp"
+#include "SHT2x_Wrapper.hpp"
+#include "Si4432Measurement.hpp"
+#include "SYN115_Transmitter.hpp"
+#include "TI_HDC10XX.h"
+#include "TransmitSchedule.h"
+#include <si4432.h>
+#include <type_traits>
 
-#define TEMP_OFFSET   1.3 // [°C] SAMD21 internal temperature immediately after standby is too low
+/**
+ * placeholder of a disabled member, accepts and ignores the constructor arguments
+ */
+struct Disabled
+{
+  template<typename... Args> constexpr Disabled(Args&&...) {}
+};
 
-#define HAS_RADIO       1
-#define HAS_DISPLAY     1
-#define HAS_DHT_SENSOR  2 // 0=NONE, 1=Si7021, 2=HDC1080
+/**
+ * member type T if enabled, Disabled otherwise
+ */
+template<bool ENABLED, class T> using Optional = typename std::conditional<ENABLED, T, Disabled>::type;
 
-#define EXECUTION_TIMEOUT 200 // [ms] max. duration from wakeup to end of transmission
+/**
+ * driver of SolarDHTConfig::SensorType
+ */
+template<SolarDHTConfig::SensorType SENSOR> struct SensorDriver
+{
+  typedef Disabled Type;
+};
 
-#define MIN_DISPLAY_UPDATE_PERIOD 180000 // [ms] 180 s
+template<> struct SensorDriver<SolarDHTConfig::SENSOR_SI7021>
+{
+  typedef SHT2x_Wrapper<Si7021> Type;
+};
 
-#define SUPPLY_VOLTAGE_LOW  2.55 // [V] harvester default seems to be around 2.6 V
-#define SUPPLY_VOLTAGE_HIGH 3.40 // [V]
+template<> struct SensorDriver<SolarDHTConfig::SENSOR_HDC1080>
+{
+  typedef TI_HDC1080 Type;
+};
 
-#if HAS_DHT_SENSOR == 1
-  #include "SHT2x_Wrapper.hpp"
-#elif  HAS_DHT_SENSOR == 2
-  #include "TI_HDC10XX.h"
-#endif
+template<int SENSOR> using HubSensorDriver = HubSensorAdapter<typename SensorDriver<(SolarDHTConfig::SensorType)SENSOR>::Type>;
 
-#ifdef DEBUG
-  #define TRANSMIT_PERIOD 10*1000 // [ms] 10 s test period
-#else
-  #define TRANSMIT_PERIOD 3UL*60*1000 // [ms] 3 min wakeup period
-#endif
+/**
+ * driver of SolarDHTConfig::RadioType with the pins of SolarDHTConfig.h,
+ * the Si4432 driver is also used without radio
+ */
+template<SolarDHTConfig::RadioType RADIO> struct RadioDriver : public Si4432
+{
+  RadioDriver() : Si4432(PIN_RADIO_CS, PIN_RADIO_NSDN, PIN_RADIO_NIRQ) {}
+};
 
+template<> struct RadioDriver<SolarDHTConfig::RADIO_SYN115> : public SYN115_Transmitter
+{
+  RadioDriver() : SYN115_Transmitter(PIN_RADIO_DATA, PIN_RADIO_NSDN) {}
+};
 
+/**
+ * @tparam CONFIG deployment options, see SolarDHTConfig
+ */
+template<const SolarDHTConfig& CONFIG>
 class SolarDHT
 {
+  static_assert(CONFIG.isValid(), "invalid option combination");
+  static_assert(CONFIG.ramfunc == HAS_RAMFUNC, "ramfunc is selected by build flag HAS_RAMFUNC");
+  static_assert(CONFIG.fontSubset == HAS_FONT_SUBSET, "fontSubset is selected by build flag HAS_FONT_SUBSET");
+  static_assert(!CONFIG.runtimeEstimate || PIN_BATTERY_SENSE != 0xFF, "runtime estimate requires PIN_BATTERY_SENSE, VDDIO is regulated");
+  static_assert(DEW_POINT_CHANNEL == 0 || CONFIG.hasSensor(), "DEW_POINT_CHANNEL requires sensor");
+
 public:
   enum RadioState
   {
@@ -93,24 +147,138 @@ public:
     RADIO_ENABLED, // not shutdown
     RADIO_ON,      // clock running
     RADIO_READY,   // configured
-    RADIO_TX       // transmitting
+    RADIO_STANDBY, // configured, crystal off (gap between repeated frames)
+    RADIO_TX,      // transmitting
+    RADIO_RX       // receiving (downlink window)
+  };
+
+  enum PersistentKey
+  {
+    KEY_SAMPLE_0,                         // temperature [0.01 °C] int16 | humidity [0.01 %] uint16 << 16, oldest first
+    KEY_SAMPLE_COUNT = KEY_SAMPLE_0 + 4,  // temperature samples | humidity samples << 8
+    KEY_DISPLAY_VALUES,                   // displayed temperature and humidity, same format as samples
+    KEY_DISPLAY_UPDATE_COUNT,
+    KEY_HEALTH,                           // HEALTH_* flags of last boot
+    KEY_BOOT_COUNT,
+    KEY_DOWNLINK_SEQUENCE,
+    KEY_PERIOD,                           // [s]
+    KEY_CONFIG,                           // TX power | RX every << 8 | display temperature delta [0.1 °C] << 16 | display humidity delta << 24
+    KEY_SUPPLY_LOW,                       // [mV]
+    KEY_ENERGY_TOTAL,                     // [mJ] since first boot
+    KEY_ENERGY_POWER,                     // [mW] rolling average, float
+    PERSISTENT_KEYS
+  };
+
+  enum EnergyState
+  {
+    ENERGY_STANDBY,
+    ENERGY_IDLE_LOW,                          // IDLE2 with low CPU clock
+    ENERGY_IDLE_HIGH,
+    ENERGY_ACTIVE_LOW,                        // CPU active with low CPU clock
+    ENERGY_ACTIVE_HIGH,
+    ENERGY_RADIO,                             // + RadioState
+    ENERGY_SENSOR = ENERGY_RADIO + RADIO_RX + 1, // acquisition in progress
+    ENERGY_DISPLAY,                           // refresh in progress
+    ENERGY_STATES
+  };
+
+  enum PeakLoad
+  {
+    LOAD_RADIO,                               // TX or RX, never deferred
+    LOAD_DISPLAY                              // refresh, deferred until radio is off if budget is exceeded
+  };
+
+  enum Health
+  {
+    HEALTH_DISPLAY = 1,
+    HEALTH_RADIO   = 2,
+    HEALTH_SENSOR  = 4
   };
 
+  typedef RadioDriver<CONFIG.radio> Radio;
+  typedef HistoryLog<NVMFlash> History;
+
+  // tags for dispatch to the implementation of an enabled or disabled option
+  typedef std::integral_constant<bool, CONFIG.hasSensor()> WithSensor;
+  typedef std::integral_constant<bool, CONFIG.sensorHub> WithSensorHub;
+  typedef std::integral_constant<bool, CONFIG.flashLog> WithFlashLog;
+  typedef std::integral_constant<bool, CONFIG.history> WithHistory;
+  typedef std::integral_constant<bool, CONFIG.downlink> WithDownlink;
+  typedef std::integral_constant<bool, CONFIG.energyMeter> WithEnergyMeter;
+  typedef std::integral_constant<bool, CONFIG.runtimeEstimate> WithRuntimeEstimate;
+  typedef std::integral_constant<bool, CONFIG.adcSequence> WithAdcSequence;
+  typedef std::integral_constant<bool, CONFIG.radioMeasurement> WithRadioMeasurement;
+  typedef std::integral_constant<bool, CONFIG.fec> WithFec;
+  typedef std::integral_constant<bool, CONFIG.hasTimer()> WithTimer;
+  typedef std::integral_constant<bool, CONFIG.display> WithDisplay;
+  typedef std::integral_constant<bool, CONFIG.radio == SolarDHTConfig::RADIO_SYN115> IsSyn115;
+
 public:
   const byte GCLKGEN_ID_1K = 6;
 
 private:
   SolarDHT() :
     adc(Analog2DigitalConverter::instance()),
-    radio(PIN_RADIO_CS, PIN_RADIO_NSDN, PIN_RADIO_NIRQ),
+    adcSequencer(getAdcSequencer(WithAdcSequence())),
+    clock(ClockManager::instance()),
+    radioMeasurement(radio),
     radioState(RADIO_OFF),
     rtc(RealTimeClock::instance()),
+    schedule(TRANSMIT_PERIOD),
+    downlink(DOWNLINK_KEY),
+    flash(getFlashLogRegion(WithFlashLog()), FLASH_LOG_ROWS),
+    flashLog(flash),
+    historyFlash(getHistoryRegion(WithHistory()), HISTORY_ROWS),
+    history(historyFlash),
     display(PIN_EPD_CS, PIN_EPD_DC, PIN_EPD_RST, PIN_EPD_BUSY),
-    hasDisplay(HAS_DISPLAY),
-    hasRadio(HAS_RADIO),
-    hasSensor(HAS_DHT_SENSOR > 0)
+    energy(energyCurrents),
+    runtime(BATTERY_MODEL),
+  #if PEAK_CURRENT_BUDGET
+    arbiter(PEAK_CURRENT_BUDGET),
+  #endif
+    humidityPlan(HUMIDITY_EVERY, HUMIDITY_TEMPERATURE_DELTA, HUMIDITY_EXPECTED_DELTA),
+    hasRadio(CONFIG.hasRadio()),
+    hasSensor(CONFIG.hasSensor())
   {};
 
+  static AdcSequencer& getAdcSequencer(std::true_type)
+  {
+    return AdcSequencer::instance();
+  }
+
+  static Disabled getAdcSequencer(std::false_type)
+  {
+    return Disabled();
+  }
+
+  /**
+   * reserved flash region (zeroed by sketch upload, formatted by FlashLog)
+   */
+  static const byte* getFlashLogRegion(std::true_type)
+  {
+    __attribute__((__aligned__(NVMFlash::ROW_SIZE))) static const byte region[FLASH_LOG_ROWS*NVMFlash::ROW_SIZE] = {};
+    return region;
+  }
+
+  static const byte* getFlashLogRegion(std::false_type)
+  {
+    return nullptr;
+  }
+
+  /**
+   * reserved flash region (zeroed by sketch upload, erased by HistoryLog)
+   */
+  static const byte* getHistoryRegion(std::true_type)
+  {
+    __attribute__((__aligned__(NVMFlash::ROW_SIZE))) static const byte region[HISTORY_ROWS*NVMFlash::ROW_SIZE] = {};
+    return region;
+  }
+
+  static const byte* getHistoryRegion(std::false_type)
+  {
+    return nullptr;
+  }
+
 public:
   static SolarDHT& instance()
   {
@@ -121,77 +289,42 @@ public:
 public:
   void setupADC()
   {
-    // enable ADC (48 MHz / 512 -> 93.75 kHz, 8MHz / 64 -> 125 kHz)
-  #if F_CPU == 8000000
-    adc.enable(GCLK_CLKCTRL_GEN_GCLK0_Val, SystemCoreClock, Analog2DigitalConverter::DIV64);
-  #else
-    adc.enable(GCLK_CLKCTRL_GEN_GCLK0_Val, SystemCoreClock, Analog2DigitalConverter::DIV512);
-  #endif
+    // enable ADC (8MHz / 64 -> 125 kHz, independent of CPU clock)
+    adc.enable(ClockManager::GCLKGEN_ID_PERIPHERAL, ClockManager::PERIPHERAL_CLOCK, Analog2DigitalConverter::DIV64);
 
     // configure hardware averaging (2^3 = 8)
     adc.setSampling(0, 3);
 
     // disable ADC until start of conversion (to save power)
     adc.disable();
-  }
 
-  void setupRadio()
-  {
-    // define radio configuration
-    if (hasRadio)
+    if (CONFIG.runtimeEstimate)
     {
-      radio.setModulationType(Si4432::OOK);
-      radio.setManchesterEncoding(true, true); // inverted
-      radio.setPacketHandling(false, true);    // LSB
-      radio.setSendBlocking(false);
-
-      radio.setConfigCallback([]{
-        Si4432& radio = SolarDHT::instance().radio;
-
-        radio.setTransmitPower(RADIO_TX_POWER, false);
-        radio.setFrequency(433.92);
-        radio.setBaudRate(1.4); // OregonScientific::BIT_RATE/1000.0, RTL_433 max. 1400 bits/s
-
-        // antenna rx/tx switch control, GPIO0 = TX, GPIO1 = RX, GPIO2 = unused (e.g. board XL4432-SMT)
-        radio.ChangeRegister(Si4432::REG_GPIO0_CONF, Si4432::GPIO_TX_STATE_OUTPUT); // Tx state output
-        radio.ChangeRegister(Si4432::REG_GPIO1_CONF, Si4432::GPIO_RX_STATE_OUTPUT); // Rx state output
+      pinPeripheral(PIN_BATTERY_SENSE, PIO_ANALOG);
+    }
 
-        // prevent excessive power consumption of the SAMD21 MCU by floating inputs when radio is in shutdown
-        PORT->Group[g_APinDescription[PIN_SPI_MISO].ulPort].PINCFG[g_APinDescription[PIN_SPI_MISO].ulPin].reg |= PORT_PINCFG_PULLEN;
-      });
+    setupAdcSequence(WithAdcSequence());
+  }
 
-      // enable SPI
-      System::enableClock(GCM_SERCOM0_CORE + PERIPH_SPI.getSercomIndex(), GCLK_CLKCTRL_GEN_GCLK0_Val);
-      System::enableClock(GCM_EIC, GCLK_CLKCTRL_GEN_GCLK0_Val); // @todo Why is this needed here? EIC will be enabled a little later anyway.
+  void setupAdcSequence(std::true_type)
+  {
+    // single samples at max. 500 kHz, averaging in software
+    adcSequencer.enable(ClockManager::PERIPHERAL_CLOCK);
+  }
 
-      // enable radio (mainly for verification)
-      uint32_t baud = 4000000; // baud*SERCOM_SPI_FREQ_REF/F_CPU;
-    #ifdef DEBUG
-      Serial.print("initializing Si4432 with SPI baud rate:");
-      Serial.println(baud);
-    #endif
-      bool radioInitialized = radio.init(&SPI, baud);
+  void setupAdcSequence(std::false_type) {}
 
-      // turn off radio (to save power)
-      radioState = RADIO_OFF;
-      radio.turnOff();
+  void setupRadio()
+  {
+    // define radio configuration
+    if (isRadioAvailable())
+    {
+      bool radioInitialized = initRadio(IsSyn115());
 
-      if (radioInitialized)
-      {
-        // enable radio interrupt handling, change EIC GCLKGEN (to save power) and lower priority (to enable SysTick)
-        noInterrupts();
-        pinMode(radio.getIntPin(), INPUT_PULLUP);
-        attachInterrupt(radio.getIntPin(), []{ SolarDHT::instance().radioInterrupt(); }, LOW);
-        //System::enableClock(GCM_EIC, GCLKGEN_ID_1K);
-        NVIC_DisableIRQ(EIC_IRQn);
-        NVIC_SetPriority(EIC_IRQn, 3);
-        NVIC_EnableIRQ(EIC_IRQn);
-        interrupts();
-      }
-      else
+      if (!radioInitialized)
       {
       #ifdef DEBUG
-        Serial.println("initializing Si4432 failed");
+        Serial.println("initializing radio failed");
       #endif
         // 2 yellow blinks on radio init error
         digitalWrite(PIN_LED, LOW);
@@ -208,6 +341,91 @@ public:
     }
   }
 
+  /**
+   * configure SYN115 transmitter
+   *
+   * @return true if initialized
+   */
+  bool initRadio(std::true_type)
+  {
+    radio.setManchesterEncoding(true, true); // inverted
+    radio.setPacketHandling(false, true);    // LSB
+    radio.setBaudRate(1.4); // same as Si4432
+    radio.setInterruptCallback([]{ SolarDHT::instance().radioInterrupt(); });
+    radio.setClock(ClockManager::GCLKGEN_ID_PERIPHERAL, ClockManager::PERIPHERAL_CLOCK);
+
+  #ifdef DEBUG
+    Serial.println("initializing SYN115");
+  #endif
+    bool radioInitialized = radio.init();
+
+    // turn off radio (to save power)
+    setRadioState(RADIO_OFF);
+    radio.turnOff();
+
+    return radioInitialized;
+  }
+
+  /**
+   * configure Si4432 transceiver and enable its interrupt
+   *
+   * @return true if initialized
+   */
+  bool initRadio(std::false_type)
+  {
+    radio.setModulationType(Si4432::OOK);
+    radio.setManchesterEncoding(true, true); // inverted
+    radio.setPacketHandling(false, true);    // LSB
+    radio.setSendBlocking(false);
+
+    radio.setConfigCallback([]{
+      Si4432& radio = SolarDHT::instance().radio;
+
+      radio.setTransmitPower(SolarDHT::instance().radioTxPower, false);
+      radio.setFrequency(433.92);
+      radio.setBaudRate(1.4); // OregonScientific::BIT_RATE/1000.0, RTL_433 max. 1400 bits/s
+
+      // antenna rx/tx switch control, GPIO0 = TX, GPIO1 = RX, GPIO2 = unused (e.g. board XL4432-SMT)
+      radio.ChangeRegister(Si4432::REG_GPIO0_CONF, Si4432::GPIO_TX_STATE_OUTPUT); // Tx state output
+      radio.ChangeRegister(Si4432::REG_GPIO1_CONF, Si4432::GPIO_RX_STATE_OUTPUT); // Rx state output
+
+      // prevent excessive power consumption of the SAMD21 MCU by floating inputs when radio is in shutdown
+      PORT->Group[g_APinDescription[PIN_SPI_MISO].ulPort].PINCFG[g_APinDescription[PIN_SPI_MISO].ulPin].reg |= PORT_PINCFG_PULLEN;
+    });
+
+    // enable SPI
+    clock.attach(GCM_SERCOM0_CORE + PERIPH_SPI.getSercomIndex());
+    clock.attach(GCM_EIC); // @todo Why is this needed here? EIC will be enabled a little later anyway.
+
+    // enable radio (mainly for verification), SPI.begin() selects GCLK0 with SPI_BAUD_RATE
+  #ifdef DEBUG
+    Serial.print("initializing Si4432 with SPI baud rate:");
+    Serial.println(SPI_BAUD_RATE);
+  #endif
+    bool radioInitialized = radio.init(&SPI, SPI_BAUD_RATE);
+    attachSpi();
+
+    // turn off radio (to save power)
+    setRadioState(RADIO_OFF);
+    radio.turnOff();
+
+    if (radioInitialized)
+    {
+      // enable radio interrupt handling, change EIC GCLKGEN (to save power) and lower priority (to enable SysTick)
+      noInterrupts();
+      pinMode(radio.getIntPin(), INPUT_PULLUP);
+      attachInterrupt(radio.getIntPin(), []{ SolarDHT::instance().radioInterrupt(); }, LOW);
+      clock.attach(GCM_EIC);
+      //System::enableClock(GCM_EIC, GCLKGEN_ID_1K);
+      NVIC_DisableIRQ(EIC_IRQn);
+      NVIC_SetPriority(EIC_IRQn, 3);
+      NVIC_EnableIRQ(EIC_IRQn);
+      interrupts();
+    }
+
+    return radioInitialized;
+  }
+
   void setupRTC()
   {
     // configure low power clock generator to run at 1 kHz
@@ -222,173 +440,464 @@ public:
     // enable I2C
     if (hasSensor)
     {
-#if HAS_DHT_SENSOR > 0
-      System::enableClock(GCM_SERCOM0_CORE + PERIPH_WIRE.getSercomIndex(), GCLK_CLKCTRL_GEN_GCLK0_Val);
+      setupSensor(WithSensor());
+    }
+  }
+
+  void setupSensor(std::true_type)
+  {
+  #ifdef DEBUG
+    Serial.println("initializing DHT sensor");
+  #endif
 
+    // init wire, reset sensor and lower resolution for faster measurement
+    bool sensorInitialized = false;
+    beginWire();
+    Wire.setTimeout(10000); // [µs]
+    selectMainSensor(WithSensorHub());
+    if  (sensor.isConnected())
+    {
     #ifdef DEBUG
-      Serial.println("initializing DHT sensor");
+      Serial.println("DHT sensor is connected");
     #endif
-
-      // init wire, reset sensor and lower resolution for faster measurement
-      bool sensorInitialized = false;
-      Wire.begin();
-      Wire.setTimeout(10000); // [µs]
-      if  (sensor.isConnected())
+      sensor.reset();
+      delay(CONFIG.sensor == SolarDHTConfig::SENSOR_SI7021? 6 : 8); // ~5 ms (Si7021) or ~8 ms (HDC1080) for soft reset to complete
+      sensorInitialized = sensor.isConnected() && sensor.setResolution(11, 11); // ~18 ms
+    #ifdef DEBUG
+      if (sensorInitialized)
       {
-      #ifdef DEBUG
-        Serial.println("DHT sensor is connected");
-      #endif
-        sensor.reset();
-      #if HAS_DHT_SENSOR == 1
-        delay(6); // ~5 ms for soft reset to complete
-      #elif HAS_DHT_SENSOR == 2
-        delay(8); // ~8 ms for soft reset to complete
-      #endif
-        sensorInitialized = sensor.isConnected() && sensor.setResolution(11, 11); // ~18 ms
-      #ifdef DEBUG
-        if (sensorInitialized)
-        {
-          bool voltageOK = sensor.isSupplyVoltageOK();
-          Serial.print("DHT sensor voltage OK: ");
-          Serial.println(voltageOK);
-          uint32_t serial = sensor.readSerialIdLow();
-          Serial.print("DHT sensor SNR: ");
-          Serial.println(serial);
-        }
-      #endif
+        bool voltageOK = sensor.isSupplyVoltageOK();
+        Serial.print("DHT sensor voltage OK: ");
+        Serial.println(voltageOK);
+        uint32_t serial = sensor.readSerialIdLow();
+        Serial.print("DHT sensor SNR: ");
+        Serial.println(serial);
       }
+    #endif
+    }
 
-      if (!sensorInitialized)
-      {
-      #ifdef DEBUG
-        Serial.println("initializing DHT sensor failed");
-      #endif
-        // 3 yellow blinks on sensor init error
-        digitalWrite(PIN_LED, LOW);
-        delay(100);
-        digitalWrite(PIN_LED, HIGH);
-        delay(200);
-        digitalWrite(PIN_LED, LOW);
-        delay(100);
-        digitalWrite(PIN_LED, HIGH);
-        delay(200);
-        digitalWrite(PIN_LED, LOW);
-        delay(100);
-        digitalWrite(PIN_LED, HIGH);
+    if (!sensorInitialized)
+    {
+    #ifdef DEBUG
+      Serial.println("initializing DHT sensor failed");
+    #endif
+      // 3 yellow blinks on sensor init error
+      digitalWrite(PIN_LED, LOW);
+      delay(100);
+      digitalWrite(PIN_LED, HIGH);
+      delay(200);
+      digitalWrite(PIN_LED, LOW);
+      delay(100);
+      digitalWrite(PIN_LED, HIGH);
+      delay(200);
+      digitalWrite(PIN_LED, LOW);
+      delay(100);
+      digitalWrite(PIN_LED, HIGH);
 
-        Wire.end();
-        hasSensor = false;
-      }
-#endif
+      Wire.end();
+      hasSensor = false;
+    }
+    else
+    {
+      setupSensorHub(WithSensorHub());
     }
   }
 
-  void setupTimer()
+  void setupSensor(std::false_type) {}
+
+  void setupSensorHub(std::true_type)
   {
-    // configure timer counter to run at 1 kHz
-    //timeout.enable(4, GCLKGEN_ID_1K, 1024, TimerCounter::DIV1, TimerCounter::RES16); // tick=1ms, max. 65.54 s @ 8 MHz
-    timeout.enable(4, GCLK_CLKCTRL_GEN_GCLK0_Val, SystemCoreClock, TimerCounter::DIV1024, TimerCounter::RES16); // tick=128 µs, max. 8389 ms @ 8 MHz
+  #if HUB_SENSOR_2
+    sensorHub.add(hubSensor2, HUB_PORT_2);
+  #endif
+  #if HUB_SENSOR_3
+    sensorHub.add(hubSensor3, HUB_PORT_3);
+  #endif
+    byte initialized = sensorHub.begin();
 
-  #if HAS_RADIO == 0
-    timer.enable(5, GCLK_CLKCTRL_GEN_GCLK0_Val, SystemCoreClock, TimerCounter::DIV1024, TimerCounter::RES16, 1000U, false, 2); // tick=128 µs, max. 8389 ms @ 8 MHz
-    //timer.enable(5, GCLK_CLKCTRL_GEN_GCLK0_Val, SystemCoreClock, TimerCounter::DIV1024, TimerCounter::RES16, 1000U, true, 3); // tick=128 µs, max. 8389 ms @ 8 MHz
-    //timer.enable(5, GCLKGEN_ID_1K, 1024, TimerCounter::DIV1, TimerCounter::RES16, 1000U); // tick=~1 ms
+    // sensors convert in parallel
+    scaleSensorCurrent(1 + initialized, WithEnergyMeter());
+
+  #ifdef DEBUG
+    Serial.print("hub sensors initialized: ");
+    Serial.print(initialized);
+    Serial.print("/");
+    Serial.println(sensorHub.getCount());
   #endif
   }
 
-  void setupDisplay()
+  void setupSensorHub(std::false_type) {}
+
+  void scaleSensorCurrent(byte sensors, std::true_type)
   {
-    // init display (pins, SPI, initial reset)
-    if (hasDisplay)
-    {
-      // configure display
-      display.init();
-      display.setRotation(1); // 1=landscape
-      display.setTextColor(GD_ePaper::COLOR_BLACK);
-    }
+    energy.setCurrent(ENERGY_SENSOR, energy.getCurrent(ENERGY_SENSOR)*sensors);
   }
 
+  void scaleSensorCurrent(byte, std::false_type) {}
+
   /**
-   * setup MCU features for periodic temperature/humidity measurement and transmission
-   * and start inital measurement and transmission
+   * select mux port of main sensor if sensor hub is used
    */
-  void setup()
+  void selectMainSensor(std::true_type)
   {
-  #ifdef DEBUG
-    Serial.print("VTOR:");
-    Serial.println(SCB->VTOR);
-  #endif
-    System::cacheVectorTable();
+    sensorHub.select(HUB_PORT_1);
+  }
 
-    // start RTC counter
-    setupRTC();
+  void selectMainSensor(std::false_type) {}
 
-    // enable and configure radio
-    setupRadio();
+  void setupTimer()
+  {
+    // configure timer counter to run at 1 kHz
+    //timeout.enable(4, GCLKGEN_ID_1K, 1024, TimerCounter::DIV1, TimerCounter::RES16); // tick=1ms, max. 65.54 s @ 8 MHz
+    timeout.enable(4, ClockManager::GCLKGEN_ID_PERIPHERAL, ClockManager::PERIPHERAL_CLOCK, TimerCounter::DIV1024, TimerCounter::RES16); // tick=128 µs, max. 8389 ms @ 8 MHz
 
-    // setup ADC and timeout timer
-    setupADC();
-    setupTimer();
+    setupTimer(WithTimer());
+  }
 
-    // setup temperature and humidity sensor
-    setupSensor();
+  void setupTimer(std::true_type)
+  {
+    timer.enable(5, ClockManager::GCLKGEN_ID_PERIPHERAL, ClockManager::PERIPHERAL_CLOCK, TimerCounter::DIV1024, TimerCounter::RES16, 1000U, false, 2); // tick=128 µs, max. 8389 ms @ 8 MHz
+    //timer.enable(5, GCLK_CLKCTRL_GEN_GCLK0_Val, SystemCoreClock, TimerCounter::DIV1024, TimerCounter::RES16, 1000U, true, 3); // tick=128 µs, max. 8389 ms @ 8 MHz
+    //timer.enable(5, GCLKGEN_ID_1K, 1024, TimerCounter::DIV1, TimerCounter::RES16, 1000U); // tick=~1 ms
+  }
 
-    // setup display
-    setupDisplay();
+  void setupTimer(std::false_type) {}
 
-    // start RTC timer for periodic wakeup
-    rtc.start(TRANSMIT_PERIOD, true, []{ SolarDHT::instance().wakeupInterrupt(); });
+  void setupSchedule()
+  {
+    schedule.setSamplePeriod(CONFIG.samplePeriod);
+    if (!setSensorSerialId(WithSensor()))
+    {
+      // no sensor, use SAMD21 128 bit serial number
+      schedule.setSerialId(*(volatile uint32_t*)0x0080A00C ^ *(volatile uint32_t*)0x0080A040,
+                           *(volatile uint32_t*)0x0080A044 ^ *(volatile uint32_t*)0x0080A048);
+    }
 
-    // perform initial measurement and transmission
-    wakeupInterrupt();
+  #ifdef DEBUG
+    Serial.print("rolling code:");
+    Serial.println(schedule.getRollingCode(), HEX);
+  #endif
   }
 
   /**
-   * RTC ISR (prio 3)
+   * @return false if no sensor is available
    */
-  void wakeupInterrupt()
+  bool setSensorSerialId(std::true_type)
   {
-  #ifndef DEBUG
-    // reenable SysTick after wakeup from STANDBY
-    System::enableSysTick();
-  #endif
-
-    wakeupTime = millis();
+    if (!hasSensor)
+    {
+      return false;
+    }
+    schedule.setSerialId(sensor.readSerialIdHigh(), sensor.readSerialIdLow());
+    return true;
+  }
 
-    digitalWrite(PIN_LED3, LOW);
-    digitalWrite(PIN_LED, HIGH);
+  bool setSensorSerialId(std::false_type)
+  {
+    return false;
+  }
 
-    // start watchdog timer
-    timeout.start(EXECUTION_TIMEOUT, false, []{ SolarDHT::instance().timeoutInterrupt(); });
+  /**
+   * restore measurement windows, display state and downlink configuration
+   */
+  void setupPersistentState()
+  {
+    restoreState(WithFlashLog());
 
-  #ifdef DEBUG
-    Serial.print("WE@"); // watchdog timer enabled
-    Serial.println(millis() - wakeupTime); // 0 ms
-  #endif
+    // find newest history block, first sample starts a new block
+    beginHistory(WithHistory());
+  }
 
-    if (hasRadio)
+  void restoreState(std::true_type)
+  {
+    uint32_t value;
+    if (flashLog.begin())
     {
-      // wakeup radio (takes ~17 ms until radio is ready)
-      radioState = RADIO_ENABLED;
-      radio.turnOn();
+      uint32_t count = 0;
+      flashLog.get(KEY_SAMPLE_COUNT, count);
+      for (byte i=0; i<4; i++)
+      {
+        if (flashLog.get(KEY_SAMPLE_0 + i, value))
+        {
+          if (i < (count & 0xFF)) temperatures.add(unpackTemperature(value));
+          if (i < ((count >> 8) & 0xFF)) humidities.add(unpackHumidity(value));
+        }
+      }
+      temperature = temperatures.getAverage();
+      humidity = humidities.getAverage();
 
-    #ifdef DEBUG
-      Serial.print("RE@"); // radio enabled
-      Serial.println(millis() - wakeupTime); // 1 ms, delta 1 ms
-    #endif
+      // display keeps content without power, avoid refresh with same values
+      if (flashLog.get(KEY_DISPLAY_VALUES, value))
+      {
+        displayTemperature = unpackTemperature(value);
+        displayHumidity = unpackHumidity(value);
+      }
+      if (flashLog.get(KEY_DISPLAY_UPDATE_COUNT, value))
+      {
+        displayUpdateCount = value;
+      }
+
+      restoreDownlink(WithDownlink());
+      restoreEnergy(WithEnergyMeter());
     }
 
-    // read supply voltage
-    readSupplyVoltage();
+    uint32_t bootCount = 0;
+    flashLog.get(KEY_BOOT_COUNT, bootCount);
+    flashLog.set(KEY_BOOT_COUNT, bootCount + 1);
 
-  #if HAS_DHT_SENSOR > 0
-    if (hasSensor)
+  #ifdef DEBUG
+    Serial.print("boot count:");
+    Serial.println(bootCount + 1);
+    if (flashLog.get(KEY_HEALTH, value))
     {
-      // async request humidity (takes ~18 ms with 11 bits resolution)
-      Wire.begin();
-      if (sensor.isConnected())
-      {
-        sensor.startAcquisition(sensor.ACQ_TYPE_COMBINED);
+      Serial.print("health at last boot:");
+      Serial.println(value, HEX);
+    }
+    Serial.print("flash log sequence:");
+    Serial.println(flashLog.getSequence());
+  #endif
+
+    flashLog.set(KEY_HEALTH, (hasDisplay? HEALTH_DISPLAY : 0) | (isRadioAvailable()? HEALTH_RADIO : 0) | (hasSensor? HEALTH_SENSOR : 0));
+  }
+
+  void restoreState(std::false_type) {}
+
+  void restoreDownlink(std::true_type)
+  {
+    // sequence must survive reset to prevent replay
+    uint32_t value;
+    if (flashLog.get(KEY_DOWNLINK_SEQUENCE, value))
+    {
+      downlink.setLastSequence(value);
+    }
+    if (flashLog.get(KEY_PERIOD, value) && value)
+    {
+      schedule.setPeriod(value*1000UL);
+    }
+    if (flashLog.get(KEY_CONFIG, value))
+    {
+      radioTxPower = value & 0x7;
+      downlinkRxEvery = (value >> 8) & 0xFF? (value >> 8) & 0xFF : 1;
+      displayTemperatureDelta = ((value >> 16) & 0xFF)/10.0;
+      displayHumidityDelta = value >> 24;
+    }
+    if (flashLog.get(KEY_SUPPLY_LOW, value))
+    {
+      supplyVoltageLow = value/1000.0;
+    }
+  }
+
+  void restoreDownlink(std::false_type) {}
+
+  void restoreEnergy(std::true_type)
+  {
+    uint32_t value;
+    float power = 0;
+    flashLog.getFloat(KEY_ENERGY_POWER, power);
+    if (flashLog.get(KEY_ENERGY_TOTAL, value))
+    {
+      energy.setTotals(value*1000.0, power);
+    }
+  }
+
+  void restoreEnergy(std::false_type) {}
+
+  void beginHistory(std::true_type)
+  {
+    history.begin();
+  }
+
+  void beginHistory(std::false_type) {}
+
+  void setupDisplay()
+  {
+    // init display (pins, SPI, initial reset)
+    setupDisplay(WithDisplay());
+  }
+
+  void setupDisplay(std::true_type)
+  {
+    // configure display
+    display.init();
+    attachSpi();
+    display.setRotation(1); // 1=landscape
+    display.setTextColor(GD_ePaper::COLOR_BLACK);
+  }
+
+  void setupDisplay(std::false_type) {}
+
+  /**
+   * setup MCU features for periodic temperature/humidity measurement and transmission
+   * and start inital measurement and transmission
+   */
+  void setup()
+  {
+    beginActive();
+
+  #ifdef DEBUG
+    Serial.print("VTOR:");
+    Serial.println(SCB->VTOR);
+  #endif
+    System::cacheVectorTable();
+
+    // flash power reduction in sleep modes, also during IDLE2 while waiting for radio and sensor
+    NVMCTRL->CTRLB.bit.SLEEPPRM = NVM_SLEEP_POWER_DOWN == 1? NVMCTRL_CTRLB_SLEEPPRM_WAKEONACCESS_Val
+                                : NVM_SLEEP_POWER_DOWN == 2? NVMCTRL_CTRLB_SLEEPPRM_WAKEUPINSTANT_Val
+                                : NVMCTRL_CTRLB_SLEEPPRM_DISABLED_Val;
+
+    // fixed peripheral clock, independent of CPU clock scaling
+    clock.enable(CLOCK_LOW_DIVIDER);
+
+    // start RTC counter
+    setupRTC();
+
+    // enable and configure radio
+    setupRadio();
+
+    // setup ADC and timeout timer
+    setupADC();
+    setupTimer();
+
+    // setup temperature and humidity sensor
+    setupSensor();
+
+    // setup display
+    setupDisplay();
+
+    // derive transmit slot and rolling code from serial ID
+    setupSchedule();
+
+    // restore state from before last brown-out
+    setupPersistentState();
+
+    // perform initial measurement and transmission (will start RTC timer for next wakeup)
+    wakeupInterrupt();
+
+    endActive();
+  }
+
+  /**
+   * RTC ISR (prio 3)
+   */
+  RAMFUNC void wakeupInterrupt()
+  {
+  #ifndef DEBUG
+    // reenable SysTick after wakeup from STANDBY
+    System::enableSysTick();
+  #endif
+    beginActive();
+
+    // wait for radio and sensor with low CPU clock
+    setCpuSpeed(ClockManager::SPEED_LOW);
+
+    wakeupTime = millis();
+
+  #if PEAK_CURRENT_BUDGET
+    // display refresh of previous wakeup has completed (period > DISPLAY_REFRESH_FULL)
+    arbiter.release(LOAD_DISPLAY);
+  #endif
+
+    // transmit or sample-only wakeup, restart RTC timer for next wakeup (interval varies if slotted)
+    transmitWakeup = schedule.isTransmitDue();
+    rtc.start(schedule.getNextWakeup(), false, []{ SolarDHT::instance().wakeupInterrupt(); });
+    bool useRadio = isRadioAvailable() && transmitWakeup;
+
+    digitalWrite(PIN_LED3, LOW);
+    digitalWrite(PIN_LED, HIGH);
+
+    // start watchdog timer
+    timeout.start(EXECUTION_TIMEOUT, false, []{ SolarDHT::instance().timeoutInterrupt(); });
+
+  #ifdef DEBUG
+    Serial.print("WE@"); // watchdog timer enabled
+    Serial.println(millis() - wakeupTime); // 0 ms
+  #endif
+
+    if (useRadio)
+    {
+      // wakeup radio (takes ~17 ms until radio is ready)
+      setRadioState(RADIO_ENABLED);
+      radio.turnOn();
+
+    #ifdef DEBUG
+      Serial.print("RE@"); // radio enabled
+      Serial.println(millis() - wakeupTime); // 1 ms, delta 1 ms
+    #endif
+    }
+
+    // read supply voltage, read by the radio on transmit wakeups with radio measurement
+    if (!CONFIG.adcSequence && (!CONFIG.radioMeasurement || !useRadio))
+    {
+      readSupplyVoltage();
+    }
+
+    startSensor(WithSensor());
+
+    if (!useRadio)
+    {
+      // no radio or sample-only wakeup: blocking read sensor and display
+      startAdcSequence(WithAdcSequence());
+      waitForAcquisition(WithTimer());
+      setCpuSpeed(ClockManager::SPEED_HIGH);
+      readSensor();
+
+      // significant change: transmit with the next wakeup to stay on the unit's schedule
+      if (!transmitWakeup && isRadioAvailable() && isTransmitEarly())
+      {
+        schedule.requestTransmit();
+      }
+      updateDisplay();
+      setCpuSpeed(ClockManager::SPEED_LOW);
+    }
+
+  #ifdef DEBUG
+    Serial.print("IC@"); // init completed
+    Serial.println(millis() - wakeupTime); // 2 ms, delta 1 ms (OK)
+  #endif
+
+    if (useRadio)
+    {
+      // do not shutdown completely after exiting ISR (SleepOnExitISR) to keep timer running
+      // @todo and because of long XOSC32K/DFLL48M startup time?
+      //if (SystemCoreClock > 8000000)
+      //{
+      System::setSleepMode(System::IDLE2); // keep only oscillators
+      //System::setSleepMode(System::IDLE0); // only CPU
+      //}
+
+      if (!CONFIG.radioMeasurement)
+      {
+        // convert while CPU sleeps until radio is ready, completes after exiting ISR
+        startAdcSequence(WithAdcSequence());
+      }
+    }
+    else
+    {
+      // no radio or sample-only wakeup, shutdown
+      shutdown();
+
+      // cancel timeout handler
+      timeout.cancel();
+    }
+
+    endActive();
+  }
+
+  /**
+   * async request humidity (takes ~18 ms with 11 bits resolution) or only temperature if humidity is stable
+   */
+  void startSensor(std::true_type)
+  {
+    if (hasSensor)
+    {
+      beginWire();
+      selectMainSensor(WithSensorHub());
+      if (sensor.isConnected())
+      {
+        humidityRequested = humidityPlan.isHumidityDue();
+        sensor.startAcquisition(humidityRequested? sensor.ACQ_TYPE_COMBINED : sensor.ACQ_TYPE_TEMPERATURE);
+        startSensorHub(WithSensorHub());
+        startEnergyState(ENERGY_SENSOR);
       #ifdef DEBUG
         Serial.print("SR@"); // sensor data requested
         Serial.println(millis() - wakeupTime); // 2 ms, delta 1 ms (OK)
@@ -400,143 +909,648 @@ public:
         Serial.println("SR!"); // sensor data request error
       }
       #endif
+    }
+  }
+
+  void startSensor(std::false_type) {}
+
+  void startSensorHub(std::true_type)
+  {
+    sensorHub.startAcquisition();
+  }
+
+  void startSensorHub(std::false_type) {}
+
+  /**
+   * passive waiting with low CPU clock during acquisition without radio,
+   * accounted as MCU idle
+   */
+  void waitForAcquisition(std::true_type)
+  {
+    if (!hasSensor)
+    {
+      return;
+    }
+  #ifdef DEBUG
+    System::setSleepMode(System::IDLE0); // only CPU
+  #else
+    //System::setSleepMode(System::STANDBY);
+    System::setSleepMode(System::IDLE2);
+  #endif
+    //System::disableSysTick();
+    endActive();
+    //timer.wait(sensor.getAcquisitionTime() + 1500); // [µs]
+    timer.wait((sensor.getAcquisitionTime() + 1500)/1000); // [ms]
+    // hub sensors are started after the main sensor and may convert humidity
+    for (byte i=0; i<5 && !isSensorHubComplete(WithSensorHub()); i++)
+    {
+      timer.wait(1);
+    }
+    beginActive();
+    //System::enableSysTick();
+  }
+
+  void waitForAcquisition(std::false_type) {}
+
+  /**
+   * init I2C with fixed baud rate, Wire.begin() selects GCLK0 and calculates
+   * the baud rate with SystemCoreClock (underflows at low speed)
+   */
+  void beginWire()
+  {
+    if (CONFIG.hasSensor())
+    {
+      Wire.begin();
+      clock.attach(GCM_SERCOM0_CORE + PERIPH_WIRE.getSercomIndex());
+      ClockManager::setWireBaud(ClockManager::getSercom(PERIPH_WIRE.getSercomIndex()), WIRE_BAUD_RATE);
+    }
+  }
+
+  /**
+   * select radio SPI settings and reconnect SPI to the peripheral generator
+   *
+   * SPI.beginTransaction() reconfigures the SERCOM with GCLK0 whenever the
+   * settings change, e.g. between display and radio. Call after each display
+   * or radio init and after each display transfer, so that the radio
+   * transactions find their settings unchanged and run at SPI_BAUD_RATE.
+   * A display transaction may still start with GCLK0, but at max. its
+   * requested baud rate.
+   */
+  void attachSpi()
+  {
+    SPI.beginTransaction(SPISettings(SPI_BAUD_RATE, MSBFIRST, SPI_MODE0));
+    SPI.endTransaction();
+    clock.attach(GCM_SERCOM0_CORE + PERIPH_SPI.getSercomIndex());
+    ClockManager::setSpiBaud(ClockManager::getSercom(PERIPH_SPI.getSercomIndex()), SPI_BAUD_RATE);
+  }
+
+  /**
+   * switch CPU clock if clock scaling is enabled
+   */
+  void setCpuSpeed(ClockManager::Speed speed)
+  {
+    if (CONFIG.clockScaling)
+    {
+      byte mcuState = getMcuEnergyState();
+      clock.setSpeed(speed);
+      changeEnergyState(mcuState, getMcuEnergyState());
+    }
+  }
+
+  void setRadioState(RadioState state)
+  {
+    changeEnergyState(ENERGY_RADIO + radioState, ENERGY_RADIO + state);
+    radioState = state;
+
+  #if PEAK_CURRENT_BUDGET
+    // radio timing is fixed, other loads have to yield
+    arbiter.release(LOAD_RADIO);
+    if (state == RADIO_TX || state == RADIO_RX)
+    {
+      arbiter.start(LOAD_RADIO, energyCurrents[ENERGY_RADIO + state]);
+    }
   #endif
+  }
+
+  /**
+   * [µs] timestamp from SysTick, valid while awake
+   */
+  static uint32_t getMicros()
+  {
+    uint32_t ms, ticks;
+    do
+    {
+      ms = millis();
+      ticks = SysTick->VAL;
+    } while (ms != millis());
+    return ms*1000 + (SysTick->LOAD - ticks)*1000/(SysTick->LOAD + 1);
+  }
+
+  byte getMcuEnergyState() const
+  {
+    bool high = clock.getSpeed() == ClockManager::SPEED_HIGH;
+    if (activeDepth)
+    {
+      return high? ENERGY_ACTIVE_HIGH : ENERGY_ACTIVE_LOW;
+    }
+    return high? ENERGY_IDLE_HIGH : ENERGY_IDLE_LOW;
+  }
+
+  void changeEnergyState(byte from, byte to)
+  {
+    changeEnergyState(from, to, WithEnergyMeter());
+  }
+
+  void changeEnergyState(byte from, byte to, std::true_type)
+  {
+    if (awake)
+    {
+      energy.change(from, to, getMicros());
+    }
+  }
+
+  void changeEnergyState(byte, byte, std::false_type) {}
+
+  void startEnergyState(byte state)
+  {
+    startEnergyState(state, WithEnergyMeter());
+  }
+
+  void startEnergyState(byte state, std::true_type)
+  {
+    if (awake)
+    {
+      energy.start(state, getMicros());
+    }
+  }
+
+  void startEnergyState(byte, std::false_type) {}
+
+  void stopEnergyState(byte state)
+  {
+    stopEnergyState(state, WithEnergyMeter());
+  }
+
+  void stopEnergyState(byte state, std::true_type)
+  {
+    energy.stop(state, getMicros());
+  }
+
+  void stopEnergyState(byte, std::false_type) {}
+
+  /**
+   * account state that continues after shutdown (e.g. display refresh)
+   */
+  void addEnergyState(byte state, uint32_t ms)
+  {
+    addEnergyState(state, ms, WithEnergyMeter());
+  }
+
+  void addEnergyState(byte state, uint32_t ms, std::true_type)
+  {
+    energy.add(state, (uint64_t)ms*1000);
+  }
+
+  void addEnergyState(byte, uint32_t, std::false_type) {}
+
+  /**
+   * account CPU active at ISR entry, standby ends with first ISR after shutdown
+   */
+  void beginActive()
+  {
+    endStandby(WithEnergyMeter());
+    byte mcuState = getMcuEnergyState();
+    activeDepth++;
+    changeEnergyState(mcuState, getMcuEnergyState());
+  }
+
+  void endStandby(std::true_type)
+  {
+    if (!awake)
+    {
+      energy.add(ENERGY_STANDBY, (uint64_t)(rtc.getElapsed() - standbyStart)*1000);
+      awake = true;
+    }
+  }
+
+  void endStandby(std::false_type) {}
+
+  /**
+   * account CPU idle at ISR exit
+   */
+  void endActive()
+  {
+    byte mcuState = getMcuEnergyState();
+    if (activeDepth)
+    {
+      activeDepth--;
+    }
+    changeEnergyState(mcuState, getMcuEnergyState());
+  }
+
+  /**
+   * close energy cycle (standby before wakeup and awake time) before standby
+   */
+  void closeEnergyCycle(std::true_type)
+  {
+    if (!awake)
+    {
+      return;
+    }
+    uint32_t now = getMicros();
+    energy.stop(getMcuEnergyState(), now);
+    energy.stop(ENERGY_RADIO + radioState, now);
+    energy.stop(ENERGY_SENSOR, now);
+    awake = false;
+
+    uint32_t elapsed = rtc.getElapsed();
+    energy.endCycle(now, (uint64_t)(elapsed - cycleStart)*1000, supplyVoltage);
+    updateRuntime((elapsed - cycleStart)/3600000.0f, WithRuntimeEstimate());
+    cycleStart = elapsed;
+    standbyStart = elapsed;
+
+  #ifdef DEBUG
+    Serial.print("EN:"); // energy of last cycle [µJ], average power [mW], time per state [ms]
+    Serial.print(energy.getCycleEnergy(), 1);
+    Serial.print(" ");
+    Serial.print(energy.getAveragePower(), 4);
+    for (byte state=0; state<ENERGY_STATES; state++)
+    {
+      Serial.print(state? "," : " ");
+      Serial.print(energy.getCycleTime(state)/1000.0, 1);
+    }
+    Serial.println();
+  #endif
+  }
+
+  void closeEnergyCycle(std::false_type) {}
+
+  /**
+   * @param elapsed [h] since last update
+   */
+  void updateRuntime(float elapsed, std::true_type)
+  {
+    runtime.update(readBatteryVoltage(), energy.getAveragePower(), elapsed);
+
+  #ifdef DEBUG
+    Serial.print("RT:"); // state of charge [%], net current [mA], harvest current [mA], remaining runtime [d]
+    Serial.print(runtime.getStateOfCharge(), 0);
+    Serial.print(" ");
+    Serial.print(runtime.getNetCurrent(), 4);
+    Serial.print(" ");
+    Serial.print(runtime.getHarvestCurrent(), 4);
+    Serial.print(" ");
+    Serial.println(runtime.getRuntimeDays());
+  #endif
+  }
+
+  void updateRuntime(float, std::false_type) {}
+
+  void readSupplyVoltage()
+  {
+    supplyVoltage = adc.read(ADC_INPUTCTRL_MUXPOS_SCALEDIOVCC_Val);
+  }
+
+  /**
+   * @return [V] battery voltage at PIN_BATTERY_SENSE, the supply voltage (VDDIO) is regulated
+   */
+  float readBatteryVoltage()
+  {
+    return adc.read(g_APinDescription[PIN_BATTERY_SENSE].ulADCChannelNumber)*BATTERY_SENSE_DIVIDER;
+  }
+
+  /**
+   * complete the radio measurement started after radio configuration
+   *
+   * @return true if the radio converted the temperature
+   */
+  bool readRadioMeasurement()
+  {
+    return readRadioMeasurement(WithRadioMeasurement());
+  }
+
+  bool readRadioMeasurement(std::true_type)
+  {
+    if (radioMeasurement.isPending())
+    {
+      radioMeasurement.read();
+      supplyVoltage = radioMeasurement.getSupplyVoltage();
+    #ifdef DEBUG
+      Serial.print("RM:"); // supply voltage [V], temperature [°C] from radio
+      Serial.print(supplyVoltage);
+      Serial.print(" ");
+      Serial.println(radioMeasurement.hasTemperature()? radioMeasurement.getTemperature() : NAN);
+    #endif
+      return radioMeasurement.hasTemperature();
+    }
+    return false;
+  }
+
+  bool readRadioMeasurement(std::false_type)
+  {
+    return false;
+  }
+
+  float getRadioTemperature() const
+  {
+    return getRadioTemperature(WithRadioMeasurement());
+  }
+
+  float getRadioTemperature(std::true_type) const
+  {
+    return radioMeasurement.getTemperature();
+  }
+
+  float getRadioTemperature(std::false_type) const
+  {
+    return 0;
+  }
+
+  /**
+   * start conversion of supply voltage and, without sensor, MCU temperature
+   */
+  void startAdcSequence(std::true_type)
+  {
+  #ifdef DEBUG
+    adcSequenceStart = getMicros();
+  #endif
+    adcSequencer.start(!hasSensor, []{ SolarDHT::instance().adcSequenceComplete(); });
+  }
+
+  void startAdcSequence(std::false_type) {}
+
+  /**
+   * DMAC ISR (prio 3)
+   */
+  void adcSequenceComplete()
+  {
+    supplyVoltage = adcSequencer.getSupplyVoltage();
+    if (!hasSensor)
+    {
+      mcuTemperature = adcSequencer.getTemperature();
+    }
+
+  #ifdef DEBUG
+    Serial.print("AD@"); // ADC sequence completed
+    Serial.print(millis() - wakeupTime);
+    Serial.print(" ");
+    Serial.print(getMicros() - adcSequenceStart); // [µs] ADC on
+    Serial.print(" ");
+    Serial.println(adcSequencer.getSamples()); // samples per input of next sequence
+  #endif
+  }
+
+  void waitAdcSequence(std::true_type)
+  {
+    adcSequencer.wait();
+  }
+
+  void waitAdcSequence(std::false_type) {}
+
+  RAMFUNC void readSensor()
+  {
+    waitAdcSequence(WithAdcSequence());
+
+    if (!readMainSensor(WithSensor()))
+    {
+      // no sensor, read SAMD21 or radio temperature and update temperature average
+      float currentTemp;
+      if (readRadioMeasurement())
+      {
+        currentTemp = getRadioTemperature() + RADIO_TEMP_OFFSET;
+      }
+      else
+      {
+        currentTemp = (CONFIG.adcSequence? mcuTemperature : adc.read(ADC_INPUTCTRL_MUXPOS_TEMP_Val)) + TEMP_OFFSET;
+      }
+      temperatures.add(currentTemp);
+      temperature = temperatures.getAverage();
+
+      // use tens and hundreds of millivolts of Vcc as pseudo humidity
+      humidity = round((supplyVoltage*10 - floor(supplyVoltage*10))*100);
     }
 
-    if (!hasRadio)
+  #if DEW_POINT_CHANNEL || DISPLAY_DEW_POINT
+    if (hasSensor)
     {
-      // no radio: blocking read sensor and display
-  #if HAS_RADIO == 0 && HAS_DHT_SENSOR == 2
-      // passive waiting during acquisition
+      // derived from the averages in fixed point, soft float logf() would take ~10x longer
+      dewPoint = Psychrometrics::getDewPoint(temperature, humidity);
+      absoluteHumidity = Psychrometrics::getAbsoluteHumidity(temperature, humidity);
+    #if DEW_POINT_CHANNEL
+      dewPointFrame = true;
+    #endif
     #ifdef DEBUG
-      System::setSleepMode(System::IDLE0); // only CPU
-    #else
-      //System::setSleepMode(System::STANDBY);
-      System::setSleepMode(System::IDLE2);
+      Serial.print("DP:");
+      Serial.print(dewPoint);
+      Serial.print(" ");
+      Serial.println(absoluteHumidity);
     #endif
-      //System::disableSysTick();
-      //timer.wait(sensor.getAcquisitionTime() + 1500); // [µs]
-      timer.wait((sensor.getAcquisitionTime() + 1500)/1000); // [ms]
-      //System::enableSysTick();
-  #endif
-      readSensor();
-      updateDisplay();
     }
-
-  #ifdef DEBUG
-    Serial.print("IC@"); // init completed
-    Serial.println(millis() - wakeupTime); // 2 ms, delta 1 ms (OK)
   #endif
 
-    if (hasRadio)
-    {
-      // do not shutdown completely after exiting ISR (SleepOnExitISR) to keep timer running
-      // @todo and because of long XOSC32K/DFLL48M startup time?
-      //if (SystemCoreClock > 8000000)
-      //{
-      System::setSleepMode(System::IDLE2); // keep only oscillators
-      //System::setSleepMode(System::IDLE0); // only CPU
-      //}
-    }
-    else
+    // history keeps the transmitted values only to preserve its time span
+    if (transmitWakeup)
     {
-      // no radio, shutdown
-      shutdown();
-
-      // cancel timeout handler
-      timeout.cancel();
+      recordHistory(WithHistory());
     }
   }
 
-  void readSupplyVoltage()
+  /**
+   * read sensor and update temperature and humidity averages
+   *
+   * @return false if no sensor is available
+   */
+  bool readMainSensor(std::true_type)
   {
-    supplyVoltage = adc.read(ADC_INPUTCTRL_MUXPOS_SCALEDIOVCC_Val);
-  }
+    if (!hasSensor)
+    {
+      return false;
+    }
 
-  void readSensor()
-  {
-  #if HAS_DHT_SENSOR > 0
-    if (hasSensor)
+    // radio startup or waitForAcquisition() covers the conversion, no waiting should be necessary
+    int available = 20; // ~15 ms for 11 bit humidity request
+    selectMainSensor(WithSensorHub());
+    while (!sensor.isAcquisitionComplete() && (available-- > 0))
     {
-      // when used with radio no waiting should be necessary
-      int available = 20; // ~15 ms for 11 bit humidity request
-      while (!sensor.isAcquisitionComplete() && (available-- > 0))
-      {
-        delay(1);
-      }
+      delay(1);
+    }
+    waitSensorHub(WithSensorHub());
+    stopEnergyState(ENERGY_SENSOR);
 
-      bool temperatureUpdated = false;
-      bool humidityUpdated = false;
-      if (available)
+    bool temperatureUpdated = false;
+    bool humidityUpdated = false;
+    if (available)
+    {
+    #ifdef DEBUG
+      Serial.print("RHA@");
+      Serial.println(millis() - wakeupTime);  // 35 ms, delta 33 ms (OK)
+    #endif
+      if (sensor.readTemperature())
       {
+        // update temperature
+        float currentTemp = sensor.getTemperature();
+        temperatures.add(currentTemp);
+        temperature = temperatures.getAverage();
+        temperatureUpdated = true;
       #ifdef DEBUG
-        Serial.print("RHA@");
-        Serial.println(millis() - wakeupTime);  // 35 ms, delta 33 ms (OK)
-      #endif
-        if (sensor.readTemperature())
-        {
-          // update temperature
-          float currentTemp = sensor.getTemperature();
-          temperatures.add(currentTemp);
-          temperature = temperatures.getAverage();
-          temperatureUpdated = true;
-        #ifdef DEBUG
-          Serial.print("RT@");
-          Serial.println(millis() - wakeupTime);  // 35 ms, delta 33 ms (OK)
-        #endif
-        }
-        if (sensor.readHumidity())
-        {
-          // update humidity
-          float currentHumidity = sensor.getHumidity();
-          humidities.add(currentHumidity);
-          humidity = humidities.getAverage();
-          humidityUpdated = true;
-        #ifdef DEBUG
-          Serial.print("RH@");
-          Serial.println(millis() - wakeupTime);  // 35 ms, delta 33 ms (OK)
-        #endif
-        }
-      #ifdef DEBUG
-        Serial.print("RHT@");
+        Serial.print("RT@");
         Serial.println(millis() - wakeupTime);  // 35 ms, delta 33 ms (OK)
       #endif
       }
-      else
+      if (humidityRequested && sensor.readHumidity())
       {
+        // update humidity
+        float currentHumidity = sensor.getHumidity();
+        humidities.add(currentHumidity);
+        humidity = humidities.getAverage();
+        humidityUpdated = true;
+        humidityPlan.addHumidity(currentHumidity, sensor.getTemperature());
       #ifdef DEBUG
-        Serial.print("RTTO@");
-        Serial.println(millis() - wakeupTime);  // 20 ms, delta 18 ms (OK)
+        Serial.print("RH@");
+        Serial.println(millis() - wakeupTime);  // 35 ms, delta 33 ms (OK)
       #endif
       }
+    #ifdef DEBUG
+      Serial.print("RHT@");
+      Serial.println(millis() - wakeupTime);  // 35 ms, delta 33 ms (OK)
+    #endif
+    }
+    else
+    {
+    #ifdef DEBUG
+      Serial.print("RTTO@");
+      Serial.println(millis() - wakeupTime);  // 20 ms, delta 18 ms (OK)
+    #endif
+    }
 
-      // remove oldest sample if not updated to keep average moving
-      // @TODO add dummy instead
-      if (!temperatureUpdated)
-      {
-        temperatures.removeOldest();
-        temperature = temperatures.getAverage();
-      }
-      if (!humidityUpdated)
+    // remove oldest sample if read failed to keep average moving, keep average if not sampled
+    // @TODO add dummy instead
+    if (!temperatureUpdated)
+    {
+      temperatures.fail();
+      temperature = temperatures.getAverage();
+    }
+    if (!humidityUpdated && humidityRequested)
+    {
+      humidities.fail();
+      humidity = humidities.getAverage();
+      humidityPlan.setFailed();
+    }
+    else if (!humidityUpdated)
+    {
+      humidities.skip();
+      if (temperatureUpdated)
       {
-        humidities.removeOldest();
-        humidity = humidities.getAverage();
+        humidityPlan.addTemperature(sensor.getTemperature());
       }
     }
-    else
+  #ifdef DEBUG
+    Serial.print("HP:"); // humidity requested, acquisitions without humidity, average change per acquisition [%]
+    Serial.print(humidityRequested);
+    Serial.print(" ");
+    Serial.print(humidityPlan.getSkipped());
+    Serial.print(" ");
+    Serial.println(humidityPlan.getRate(), 2);
   #endif
+
+    readSensorHub(WithSensorHub());
+    return true;
+  }
+
+  bool readMainSensor(std::false_type)
+  {
+    return false;
+  }
+
+  /**
+   * hub sensors started right after main sensor
+   */
+  void waitSensorHub(std::true_type)
+  {
+    int hubAvailable = 5;
+    while (!sensorHub.isAcquisitionComplete() && (hubAvailable-- > 0))
     {
-      // no sensor, read SAMD21 temperature and update temperature average
-      float currentTemp = adc.read(ADC_INPUTCTRL_MUXPOS_TEMP_Val) + TEMP_OFFSET;
-      temperatures.add(currentTemp);
-      temperature = temperatures.getAverage();
+      delay(1);
+    }
+    selectMainSensor(WithSensorHub());
+  }
 
-      // use tens and hundreds of millivolts of Vcc as pseudo humidity
-      humidity = round((supplyVoltage*10 - floor(supplyVoltage*10))*100);
+  void waitSensorHub(std::false_type) {}
+
+  bool isSensorHubComplete(std::true_type)
+  {
+    return sensorHub.isAcquisitionComplete();
+  }
+
+  bool isSensorHubComplete(std::false_type)
+  {
+    return true;
+  }
+
+  void readSensorHub(std::true_type)
+  {
+    sensorHub.read();
+    hubFrame = 0;
+  #ifdef DEBUG
+    for (byte i=0; i<sensorHub.getCount(); i++)
+    {
+      Serial.print("CH");
+      Serial.print(sensorHub.getChannel(i));
+      Serial.print(":");
+      Serial.print(sensorHub.getTemperature(i));
+      Serial.print(" ");
+      Serial.println(sensorHub.getHumidity(i));
+    }
+  #endif
+  }
+
+  void readSensorHub(std::false_type) {}
+
+  /**
+   * @return true if the averaged values changed significantly since the last
+   * transmission, checked on sample-only wakeups
+   */
+  bool isTransmitEarly() const
+  {
+    return TRANSMIT_TEMPERATURE_DELTA > 0 && transmitUpdateCount
+        && (fabs(temperature - transmitTemperature) >= TRANSMIT_TEMPERATURE_DELTA
+            || fabs(humidity - transmitHumidity) >= TRANSMIT_HUMIDITY_DELTA);
+  }
+
+  /**
+   * append averaged sample to history
+   */
+  void recordHistory(std::true_type)
+  {
+    typename History::Sample sample;
+    uint32_t time = getTime();
+    sample.time = time? time : rtc.getElapsed()/1000;
+    sample.temperature = round(temperature*10);
+    sample.humidity = round(humidity*10);
+    sample.voltage = round(supplyVoltage*100);
+    history.append(sample, time? History::FLAG_EPOCH : 0);
+  }
+
+  void recordHistory(std::false_type) {}
+
+  /**
+   * print all history blocks, oldest first, as hex lines "H:<block>"
+   */
+  void dumpHistory(Stream& stream)
+  {
+    dumpHistory(stream, WithHistory());
+  }
+
+  void dumpHistory(Stream& stream, std::true_type)
+  {
+    if (!history.getBlocks())
+    {
+      history.begin();
+    }
+    uint16_t current = history.getCurrentBlock();
+    if (current == History::NO_BLOCK)
+    {
+      return;
+    }
+    byte block[History::BLOCK_SIZE];
+    for (uint16_t i=1; i<=history.getBlocks(); i++)
+    {
+      if (history.readBlock((current + i) % history.getBlocks(), block))
+      {
+        stream.print("H:");
+        for (byte j=0; j<History::BLOCK_SIZE; j++)
+        {
+          if (block[j] < 0x10) stream.print('0');
+          stream.print(block[j], HEX);
+        }
+        stream.println();
+      }
     }
   }
 
-  void transmitSensorData()
+  void dumpHistory(Stream&, std::false_type) {}
+
+  RAMFUNC void transmitSensorData()
   {
   #ifdef DEBUG
     Serial.print("RO@");
@@ -544,10 +1558,22 @@ public:
   #endif
     //digitalWrite(PIN_LED3, LOW);
 
+    // compute burst: radio configuration, sensor readout, encoding and rendering
+    setCpuSpeed(ClockManager::SPEED_HIGH);
+
+    if (CONFIG.downlink)
+    {
+      // packet handler may have been enabled for downlink
+      radio.setPacketHandling(false, true);
+    }
+
     // config radio
-    radio.setIdleMode(Si4432::Ready);
+    radio.setIdleMode(Radio::Ready);
     radio.boot();
-    radioState = RADIO_READY;
+    setRadioState(RADIO_READY);
+
+    // supply voltage and, without sensor, temperature from the radio, converts during sensor readout
+    startRadioMeasurement(WithRadioMeasurement());
 
   #ifdef DEBUG
     Serial.print("RC@");
@@ -556,23 +1582,180 @@ public:
 
     // get temperature
     readSensor();
+    readRadioMeasurement();
 
+  #ifdef DEBUG
+    uint32_t encodeStart = micros();
+  #endif
     // encode and transmit temperature in Oregon Scientific 3.0 format (takes ~108 ms), encode fractional part of supply voltage as humidity
-    bool lowBattery = supplyVoltage >= SUPPLY_VOLTAGE_LOW && supplyVoltage < SUPPLY_VOLTAGE_HIGH;
-    byte txLen = oregon.encodeTH(0xF824, 1, 0x12, lowBattery, temperature, (byte)round(humidity));
-    byte* txBuf = oregon.getMessage();
-    radio.setIdleMode(Si4432::SleepMode);
+    byte txLen = encodeFrame(1, temperature, humidity);
+  #ifdef DEBUG
+    uint32_t encodeCycles = (micros() - encodeStart)*(SystemCoreClock/1000000);
+  #endif
+    transmitTemperature = temperature;
+    transmitHumidity = humidity;
+    transmitUpdateCount++;
+    byte* txBuf = getFrame();
+    frameSize = txLen;
+    repeatsLeft = CONFIG.transmitRepeats;
+    radio.setIdleMode(Radio::SleepMode);
     radio.sendPacket(txLen, txBuf);
-    radioState = RADIO_TX;
+    setRadioState(RADIO_TX);
 
   #ifdef DEBUG
     Serial.print("TS@");
     Serial.println(millis() - wakeupTime);   // 22 ms, delta 0 ms (OK)
+    Serial.print("CY:"); // encoder cycles, compare HAS_RAMFUNC 0 and 1
+    Serial.println(encodeCycles);
   #endif
 
     // update display while transmit is in progress (~ 25 ms)
     updateDisplay();
+
+    // wait for end of transmission with low CPU clock
+    setCpuSpeed(ClockManager::SPEED_LOW);
+  }
+
+  void startRadioMeasurement(std::true_type)
+  {
+    radioMeasurement.start(!hasSensor);
+  }
+
+  void startRadioMeasurement(std::false_type) {}
+
+  /**
+   * @return false if radio is not configured or failed to initialize
+   */
+  bool isRadioAvailable() const
+  {
+    return CONFIG.hasRadio() && hasRadio;
+  }
+
+  /**
+   * @return true if supply voltage is low or, with runtime estimate,
+   * estimated runtime is shorter than RUNTIME_WARNING
+   */
+  bool isLowBattery() const
+  {
+    return isRuntimeShort(WithRuntimeEstimate())
+        || (supplyVoltage >= supplyVoltageLow && supplyVoltage < SUPPLY_VOLTAGE_HIGH);
+  }
+
+  bool isRuntimeShort(std::true_type) const
+  {
+    return runtime.isRuntimeShorter(RUNTIME_WARNING);
+  }
+
+  bool isRuntimeShort(std::false_type) const
+  {
+    return false;
+  }
+
+  /**
+   * encode Oregon Scientific frame or, with option fec, compact frame with
+   * error correction
+   *
+   * @return frame size [bytes]
+   */
+  RAMFUNC byte encodeFrame(byte channel, float temp, float hum)
+  {
+    return encodeFrame(channel, temp, hum, WithFec());
+  }
+
+  byte encodeFrame(byte channel, float temp, float hum, std::true_type)
+  {
+    return compactFrame.encodeTH(channel, schedule.getRollingCode(), isLowBattery(), temp, (byte)round(hum));
+  }
+
+  byte encodeFrame(byte channel, float temp, float hum, std::false_type)
+  {
+    return oregon.encodeTH(0xF824, channel, schedule.getRollingCode(), isLowBattery(), temp, (byte)round(hum));
+  }
+
+  byte* getFrame()
+  {
+    return getFrame(WithFec());
+  }
+
+  byte* getFrame(std::true_type)
+  {
+    return compactFrame.getMessage();
+  }
+
+  byte* getFrame(std::false_type)
+  {
+    return oregon.getMessage();
+  }
+
+  /**
+   * transmit next hub channel back-to-back with the previous frame
+   *
+   * @return true if a frame was sent
+   */
+  bool sendHubFrame(std::true_type)
+  {
+    while (hubFrame < sensorHub.getCount() && !sensorHub.isValid(hubFrame))
+    {
+      hubFrame++;
+    }
+    if (hubFrame >= sensorHub.getCount())
+    {
+      return false;
+    }
+
+    byte txLen = encodeFrame(sensorHub.getChannel(hubFrame), sensorHub.getTemperature(hubFrame), sensorHub.getHumidity(hubFrame));
+    hubFrame++;
+    frameSize = txLen;
+    repeatsLeft = CONFIG.transmitRepeats;
+
+    // restart watchdog for next frame
+    timeout.start(EXECUTION_TIMEOUT + TransmitSchedule::getAirTime(txLen, OregonScientific::BIT_RATE), false, []{ SolarDHT::instance().timeoutInterrupt(); });
+    radio.sendPacket(txLen, getFrame());
+
+  #ifdef DEBUG
+    Serial.print("TH@"); // hub frame sent
+    Serial.println(millis() - wakeupTime);
+  #endif
+
+    return true;
+  }
+
+  bool sendHubFrame(std::false_type)
+  {
+    return false;
+  }
+
+#if DEW_POINT_CHANNEL
+  /**
+   * transmit dew point as temperature and absolute humidity [g/m³] as humidity
+   * of channel DEW_POINT_CHANNEL back-to-back with the previous frame
+   *
+   * @return true if a frame was sent
+   */
+  bool sendDewPointFrame()
+  {
+    if (!dewPointFrame)
+    {
+      return false;
+    }
+    dewPointFrame = false;
+
+    byte txLen = encodeFrame(DEW_POINT_CHANNEL, dewPoint, absoluteHumidity < 99? absoluteHumidity : 99);
+    frameSize = txLen;
+    repeatsLeft = CONFIG.transmitRepeats;
+
+    // restart watchdog for next frame
+    timeout.start(EXECUTION_TIMEOUT + TransmitSchedule::getAirTime(txLen, OregonScientific::BIT_RATE), false, []{ SolarDHT::instance().timeoutInterrupt(); });
+    radio.sendPacket(txLen, getFrame());
+
+  #ifdef DEBUG
+    Serial.print("TD@"); // dew point frame sent
+    Serial.println(millis() - wakeupTime);
+  #endif
+
+    return true;
   }
+#endif
 
   void displaySensorData()
   {
@@ -584,7 +1767,7 @@ public:
 
     display.newScreen();
 
-    display.setFont(&FreeSans18pt7b);
+    display.setFont(&FONT_VALUE);
     sprintf(text, "%.1f", temperature);
     display.getTextBounds(text, 0, 0, &tbx, &tby, &tbw, &tbh);
     display.setCursor(RIGHT_ALIGN - tbw, display.height()/2 - MARGIN);
@@ -598,76 +1781,172 @@ public:
     display.setCursor(RIGHT_ALIGN - tbw, display.height() - MARGIN);
     display.print(text);
 
-    display.setCursor(RIGHT_ALIGN + MARGIN, display.height() - MARGIN);
-    display.print("%");
+    display.setCursor(RIGHT_ALIGN + MARGIN, display.height() - MARGIN);
+    display.print("%");
+
+    display.setFont(&FONT_UNIT);
+    display.setCursor(RIGHT_ALIGN + MARGIN, display.height()/2 - MARGIN - 15);
+    display.print("o"); // no degree letter available in font, use lower case o
+
+  #if DISPLAY_ENERGY
+    displayPower(RIGHT_ALIGN + MARGIN, display.height()/2 - MARGIN + 4, WithEnergyMeter());
+  #endif
+  #if DISPLAY_RUNTIME
+    displayRuntime(RIGHT_ALIGN + MARGIN, display.height()/2 - MARGIN + 14, WithRuntimeEstimate());
+  #endif
+  #if DISPLAY_DEW_POINT
+    // dew point [°C] with built-in 6x8 font top right, warning if condensation is near
+    if (hasSensor)
+    {
+      display.setFont();
+      display.setCursor(RIGHT_ALIGN + MARGIN, 0);
+      sprintf(text, "%.0f%s", dewPoint, temperature - dewPoint < CONDENSATION_SPREAD? "!" : "");
+      display.print(text);
+    }
+  #endif
+
+  #ifdef DEBUG
+    Serial.print("UD@"); // updating display
+    Serial.println(millis() - wakeupTime);
+  #endif
+  }
+
+  /**
+   * average power [µW] with built-in 6x8 font between the units
+   */
+  void displayPower(int x, int y, std::true_type)
+  {
+    char text[8];
+    display.setFont();
+    display.setCursor(x, y);
+    uint32_t power = round(energy.getAveragePower()*1000);
+    sprintf(text, "%uuW", (unsigned)(power < 9999? power : 9999));
+    display.print(text);
+  }
+
+  void displayPower(int, int, std::false_type) {}
+
+  /**
+   * estimated runtime [d] below average power
+   */
+  void displayRuntime(int x, int y, std::true_type)
+  {
+    char text[8];
+    display.setFont();
+    display.setCursor(x, y);
+    sprintf(text, "%ud", (unsigned)runtime.getRuntimeDays());
+    display.print(text);
+  }
+
+  void displayRuntime(int, int, std::false_type) {}
+
+  /**
+   * refresh display with rendered screen, deferred while the radio would exceed
+   * the peak current budget together with the display
+   */
+  void refreshDisplay(std::true_type)
+  {
+  #if PEAK_CURRENT_BUDGET
+    if (!arbiter.request(LOAD_DISPLAY, DISPLAY_PEAK_CURRENT))
+    {
+    #ifdef DEBUG
+      Serial.print("RP@"); // display refresh pending
+      Serial.println(millis() - wakeupTime);
+    #endif
+      return;
+    }
+  #endif
+
+    display.updateScreen(true); // reset display, send page image to display, refresh display and power down
+    attachSpi();
+    addEnergyState(ENERGY_DISPLAY, displayRefreshTime);
+  }
 
-    display.setFont(&FreeSansBold9pt7b);
-    display.setCursor(RIGHT_ALIGN + MARGIN, display.height()/2 - MARGIN - 15);
-    display.print("o"); // no degree letter available in font, use lower case o
+  void refreshDisplay(std::false_type) {}
+
+  void updateDisplay()
+  {
+    updateDisplay(WithDisplay());
 
   #ifdef DEBUG
-    Serial.print("UD@"); // updating display
-    Serial.println(millis() - wakeupTime);
+    Serial.print("T:");
+    Serial.println(temperature);
+    Serial.print("H:");
+    Serial.println(humidity);
   #endif
-
-    display.updateScreen(true); // reset display, send page image to display, refresh display and power down
   }
 
-  void updateDisplay()
+  void updateDisplay(std::true_type)
   {
-    if (hasDisplay)
+    // @TODO update at least once per day?
+    // @TODO display sensor data tendency
+    // @TODO display sensor error
+    // @TODO display transmitter error
+
+    // update display on significant change but not more frequently than every 180 s
+    uint32_t now = rtc.getElapsed();
+    if (DisplayUpdate::isDue(temperature, humidity, displayTemperature, displayHumidity,
+                             displayTemperatureDelta, displayHumidityDelta, now, displayUpdated, MIN_DISPLAY_UPDATE_PERIOD))
     {
-      // @TODO update at least once per day?
-      // @TODO display sensor data tendency
-      // @TODO display sensor error
-      // @TODO display transmitter error
-
-      // update display on significant change but not more frequently than every 180 s
-      uint32_t now = rtc.getElapsed();
-      if ((abs(temperature - displayTemperature) >= 0.5
-        || abs(humidity - displayHumidity) >= 3)
-        && now >= displayUpdated
-        && (now - displayUpdated) >= MIN_DISPLAY_UPDATE_PERIOD)
-      {
-        // full refresh (~4000 ms) every 6th refresh, otherwise partial refresh (~1500 ms)
-        display.setPartialRefresh(displayUpdateCount % 6 != 0);
+      // full refresh (~4000 ms) every 6th refresh, otherwise partial refresh (~1500 ms)
+      bool partial = DisplayUpdate::isPartialRefresh(displayUpdateCount);
+      display.setPartialRefresh(partial);
+
+      // update display content ~25 ms
+      displaySensorData();
+      displayRefreshTime = partial? DISPLAY_REFRESH_PARTIAL : DISPLAY_REFRESH_FULL;
+      refreshDisplay(WithDisplay());
+
+      displayTemperature = temperature;
+      displayHumidity = humidity;
+      displayUpdated = now;
+      displayUpdateCount++;
+    }
 
-        // update display content ~25 ms
-        displaySensorData();
+  #ifdef DEBUG
+    Serial.print("now:");
+    Serial.println(now);
+    Serial.print("displayUpdated:");
+    Serial.println(displayUpdated);
+    Serial.print("period:");
+    Serial.println(MIN_DISPLAY_UPDATE_PERIOD);
+    Serial.print("delta:");
+    Serial.println(now - displayUpdated);
+  #endif
+  }
 
-        displayTemperature = temperature;
-        displayHumidity = humidity;
-        displayUpdated = now;
-        displayUpdateCount++;
-      }
+  void updateDisplay(std::false_type) {}
 
+  /**
+   * send display to deep sleep if unexpectedly active
+   *
+   * notes:
+   * - display will stay in deep sleep until an update is performed
+   * - display will be automatically send to deep sleep after an update
+   */
+  void sleepDisplay(std::true_type)
+  {
+    if (!display.isSleeping())
+    {
     #ifdef DEBUG
-      Serial.print("now:");
-      Serial.println(now);
-      Serial.print("displayUpdated:");
-      Serial.println(displayUpdated);
-      Serial.print("period:");
-      Serial.println(MIN_DISPLAY_UPDATE_PERIOD);
-      Serial.print("delta:");
-      Serial.println(now - displayUpdated);
+      Serial.print("SD@"); // shutdown display
+      Serial.println(millis() - wakeupTime);
     #endif
+      display.sleep();
+      attachSpi();
     }
-
-  #ifdef DEBUG
-    Serial.print("T:");
-    Serial.println(temperature);
-    Serial.print("H:");
-    Serial.println(humidity);
-  #endif
   }
 
+  void sleepDisplay(std::false_type) {}
+
   /**
    * EIC ISR (prio 3)
    */
-  void radioInterrupt()
+  RAMFUNC void radioInterrupt()
   {
-    // ISR is sometimes called when interrupt pin is not stable, so check again
-    bool interrupt = !digitalRead(radio.getIntPin());
+    beginActive();
+
+    bool interrupt = isRadioInterruptPending(IsSyn115());
 
   #ifdef DEBUG
     Serial.print("RI:");
@@ -681,19 +1960,51 @@ public:
       switch (radioState)
       {
         case RADIO_ENABLED:
-          if (intStatus & Si4432::INT_CHIPRDY)
+          if (intStatus & Radio::INT_CHIPRDY)
           {
             // radio on, transmit temperature
-            radioState = RADIO_ON;
+            setRadioState(RADIO_ON);
             transmitSensorData();
           }
           break;
 
         case RADIO_TX:
-          if (intStatus & Si4432::INT_PKSENT)
+          if (intStatus & Radio::INT_PKSENT)
           {
+            // repeat frame after random gap without restarting radio
+            if (CONFIG.transmitRepeats && startRepeatGap())
+            {
+              break;
+            }
+
+            // transmit next sensor channel without restarting radio
+            if (sendHubFrame(WithSensorHub()))
+            {
+              break;
+            }
+
+          #if DEW_POINT_CHANNEL
+            // transmit dew point channel without restarting radio
+            if (sendDewPointFrame())
+            {
+              break;
+            }
+          #endif
+
+            // maintenance mode, transmit next history chunk
+            if (sendHistoryChunk(WithHistory()))
+            {
+              break;
+            }
+
+            // transmit completed, listen for downlink
+            if (startDownlinkWindow(WithDownlink()))
+            {
+              break;
+            }
+
             // transmit completed, turn radio off and shut down
-            radioState = RADIO_READY;
+            setRadioState(RADIO_READY);
             shutdown();
 
             // cancel timeout handler
@@ -701,11 +2012,239 @@ public:
           }
           break;
 
+        case RADIO_RX:
+          receiveInterrupt(intStatus, WithDownlink());
+          break;
+
         default:
           // ignore
           break;
       }
     }
+
+    endActive();
+  }
+
+  /**
+   * @return true if TCC/DMAC ISR signaled an event of the SYN115 transmitter
+   */
+  bool isRadioInterruptPending(std::true_type)
+  {
+    return radio.isInterruptPending();
+  }
+
+  /**
+   * ISR is sometimes called when interrupt pin is not stable, so check again
+   */
+  bool isRadioInterruptPending(std::false_type)
+  {
+    return !digitalRead(radio.getIntPin());
+  }
+
+  /**
+   * switch radio to RX after transmit every n-th wakeup
+   *
+   * The gateway is expected to start sending the preamble of a downlink frame
+   * right after receiving the uplink frame. The RX window is closed if no
+   * preamble is detected within DOWNLINK_RX_WINDOW.
+   *
+   * @return true if RX window was opened
+   */
+  bool startDownlinkWindow(std::true_type)
+  {
+    if (++downlinkCycle < downlinkRxEvery)
+    {
+      return false;
+    }
+    downlinkCycle = 0;
+
+    radio.setPacketHandling(true, true);
+    radio.startListening();
+    radio.ChangeRegister(Si4432::REG_INT_ENABLE2, 0x40); // additionally enable valid preamble interrupt
+    setRadioState(RADIO_RX);
+
+    // replace watchdog with RX window timeout
+    timeout.start(DOWNLINK_RX_WINDOW, false, []{ SolarDHT::instance().downlinkTimeout(); });
+
+  #ifdef DEBUG
+    Serial.print("RX@"); // downlink window opened
+    Serial.println(millis() - wakeupTime);
+  #endif
+
+    return true;
+  }
+
+  bool startDownlinkWindow(std::false_type)
+  {
+    return false;
+  }
+
+  /**
+   * handle radio interrupt during downlink window
+   */
+  void receiveInterrupt(uint16_t intStatus, std::true_type)
+  {
+    if (intStatus & Radio::INT_PKVALID)
+    {
+      // downlink frame received, apply and shut down
+      receiveDownlink();
+      setRadioState(RADIO_READY);
+      shutdown();
+      timeout.cancel();
+    }
+    else if (intStatus & Radio::INT_CRCERROR)
+    {
+      // invalid frame, shut down
+      setRadioState(RADIO_READY);
+      shutdown();
+      timeout.cancel();
+    }
+    else if (intStatus & Radio::INT_PREAVAL)
+    {
+      // preamble detected, extend RX window until frame is complete
+      timeout.start(DOWNLINK_FRAME_TIMEOUT, false, []{ SolarDHT::instance().downlinkTimeout(); });
+    }
+  }
+
+  void receiveInterrupt(uint16_t, std::false_type) {}
+
+  /**
+   * read, verify and apply downlink frame
+   */
+  void receiveDownlink()
+  {
+    byte frame[Downlink::MAX_FRAME_SIZE];
+    byte size = 0;
+    radio.getPacketReceived(&size, frame);
+
+    Downlink::Config config;
+    if (size <= Downlink::MAX_FRAME_SIZE && downlink.parse(frame, size, schedule.getRollingCode(), config))
+    {
+      applyConfig(config);
+    }
+  #ifdef DEBUG
+    else
+    {
+      Serial.println("downlink frame rejected");
+    }
+  #endif
+  }
+
+  /**
+   * apply configuration without reboot, takes effect with next wakeup
+   */
+  void applyConfig(const Downlink::Config& config)
+  {
+    if (config.has(Downlink::TAG_PERIOD) && config.period)
+    {
+      schedule.setPeriod(config.period*1000UL);
+    }
+    if (config.has(Downlink::TAG_TX_POWER))
+    {
+      radioTxPower = config.txPower;
+    }
+    if (config.has(Downlink::TAG_SUPPLY_LOW))
+    {
+      supplyVoltageLow = config.supplyLow/1000.0;
+    }
+    if (config.has(Downlink::TAG_DISPLAY_TEMP))
+    {
+      displayTemperatureDelta = config.displayTemp/10.0;
+    }
+    if (config.has(Downlink::TAG_DISPLAY_HUM))
+    {
+      displayHumidityDelta = config.displayHum;
+    }
+    if (config.has(Downlink::TAG_TIME))
+    {
+      timeOffset = config.time - rtc.getElapsed()/1000;
+    }
+    if (config.has(Downlink::TAG_RX_EVERY) && config.rxEvery)
+    {
+      downlinkRxEvery = config.rxEvery;
+    }
+    if (config.has(Downlink::TAG_HISTORY))
+    {
+      // start maintenance mode with next transmission
+      startHistoryDump(config.historyBlocks, WithHistory());
+    }
+
+    // persist with next shutdown
+    persistNow = CONFIG.flashLog;
+
+  #ifdef DEBUG
+    Serial.print("downlink config applied:");
+    Serial.println(config.present, HEX);
+  #endif
+  }
+
+  void startHistoryDump(uint16_t blocks, std::true_type)
+  {
+    historyDumpBlocks = min(blocks, history.getBlocks());
+    historyDumpChunk = 0;
+  }
+
+  void startHistoryDump(uint16_t, std::false_type) {}
+
+  /**
+   * TC ISR (prio 0), end of downlink RX window
+   */
+  void downlinkTimeout()
+  {
+    beginActive();
+    setRadioState(RADIO_READY);
+    shutdown();
+    endActive();
+  }
+
+  /**
+   * wait a random gap before repeating the last sensor frame
+   *
+   * The radio stays configured in standby, so the repetition needs no
+   * start-up, boot and encoding, only the crystal start-up (< 1 ms) that
+   * TX performs automatically. Keeping the crystal running during the
+   * gap would cost more than restarting it.
+   *
+   * @return true if a repetition is pending
+   */
+  bool startRepeatGap()
+  {
+    if (!repeatsLeft)
+    {
+      return false;
+    }
+    repeatsLeft--;
+    setRadioState(RADIO_STANDBY);
+    timeout.start(schedule.getRepeatGap(), false, []{ SolarDHT::instance().repeatFrame(); });
+    return true;
+  }
+
+  /**
+   * TC ISR (prio 0), end of repeat gap, reload FIFO and transmit frame again
+   */
+  void repeatFrame()
+  {
+    beginActive();
+
+    // restart watchdog for repetition
+    timeout.start(EXECUTION_TIMEOUT + TransmitSchedule::getAirTime(frameSize, OregonScientific::BIT_RATE), false, []{ SolarDHT::instance().timeoutInterrupt(); });
+    radio.sendPacket(frameSize, getFrame());
+    setRadioState(RADIO_TX);
+
+  #ifdef DEBUG
+    Serial.print("TR@"); // frame repeated
+    Serial.println(millis() - wakeupTime);
+  #endif
+
+    endActive();
+  }
+
+  /**
+   * @return seconds since epoch, 0 if not synchronized
+   */
+  uint32_t getTime()
+  {
+    return timeOffset? timeOffset + rtc.getElapsed()/1000 : 0;
   }
 
   /**
@@ -713,24 +2252,27 @@ public:
    */
   void shutdown()
   {
-    // turn off radio
-    if (hasRadio)
+    setCpuSpeed(ClockManager::SPEED_HIGH);
+
+    // ADC and DMA must not be left running, e.g. after timeout
+    waitAdcSequence(WithAdcSequence());
+
+    // turn off radio, already off after sample-only wakeup
+    if (isRadioAvailable() && radioState != RADIO_OFF)
     {
       radio.turnOff();
+      setRadioState(RADIO_OFF);
     }
 
-    // send display to deep sleep if unexpectedly active
-    // notes:
-    // - display will stay in deep sleep until an update is performed
-    // - display will be automatically send to deep sleep after an update
-    if (hasDisplay && !display.isSleeping())
+  #if PEAK_CURRENT_BUDGET
+    // display refresh deferred during radio session
+    if (arbiter.isPending(LOAD_DISPLAY))
     {
-    #ifdef DEBUG
-      Serial.print("SD@"); // shutdown display
-      Serial.println(millis() - wakeupTime);
-    #endif
-      display.sleep();
+      refreshDisplay(WithDisplay());
     }
+  #endif
+
+    sleepDisplay(WithDisplay());
 
     // turn I2C (SERCOM) off
     if (hasSensor)
@@ -738,10 +2280,22 @@ public:
       Wire.end();
     }
 
+    // write state to flash, not after sample-only wakeups to limit flash wear
+    if (transmitWakeup)
+    {
+      persistState();
+    }
+
+    // energy of this wakeup
+    closeEnergyCycle(WithEnergyMeter());
+
     // disable LEDs
     digitalWrite(PIN_LED, HIGH);
     digitalWrite(PIN_LED3, HIGH);
 
+    // wake up with low CPU clock (OSC8M starts faster than DFLL48M)
+    setCpuSpeed(ClockManager::SPEED_LOW);
+
   #ifndef DEBUG
     // disable SysTick before entering STANDBY
     System::disableSysTick();
@@ -754,6 +2308,169 @@ public:
   #endif
   }
 
+  /**
+   * stage current state and commit changes to flash every n-th wakeup
+   * if the supply voltage is high enough
+   */
+  void persistState()
+  {
+    persistState(WithFlashLog());
+
+    // full block on next wakeup, partial block every n-th wakeup
+    flushHistory(WithHistory());
+  }
+
+  void persistState(std::true_type)
+  {
+    for (byte i=0; i<4; i++)
+    {
+      if (i < temperatures.size() || i < humidities.size())
+      {
+        flashLog.set(KEY_SAMPLE_0 + i, packSample(temperatures.getSample(i), humidities.getSample(i)));
+      }
+    }
+    flashLog.set(KEY_SAMPLE_COUNT, temperatures.size() | (humidities.size() << 8));
+    if (displayUpdateCount)
+    {
+      flashLog.set(KEY_DISPLAY_VALUES, packSample(displayTemperature, displayHumidity));
+      flashLog.set(KEY_DISPLAY_UPDATE_COUNT, displayUpdateCount);
+    }
+    persistDownlink(WithDownlink());
+    persistEnergy(WithEnergyMeter());
+
+    if (flashLog.isDirty() && (++persistCycle >= FLASH_LOG_COMMIT_EVERY || persistNow) && supplyVoltage >= FLASH_LOG_MIN_VOLTAGE)
+    {
+      // flash write blocks CPU for up to ~50 ms, prevent reentry by watchdog
+      timeout.cancel();
+
+      bool committed = flashLog.commit();
+      persistCycle = 0;
+      persistNow = !committed;
+
+    #ifdef DEBUG
+      Serial.print("FC@"); // flash log committed
+      Serial.print(millis() - wakeupTime);
+      Serial.print(" ");
+      Serial.println(committed);
+    #endif
+    }
+  }
+
+  void persistState(std::false_type) {}
+
+  void persistDownlink(std::true_type)
+  {
+    flashLog.set(KEY_DOWNLINK_SEQUENCE, downlink.getLastSequence());
+    flashLog.set(KEY_PERIOD, schedule.getPeriod()/1000);
+    flashLog.set(KEY_CONFIG, radioTxPower | (downlinkRxEvery << 8) | ((uint32_t)round(displayTemperatureDelta*10) << 16) | ((uint32_t)displayHumidityDelta << 24));
+    flashLog.set(KEY_SUPPLY_LOW, round(supplyVoltageLow*1000));
+  }
+
+  void persistDownlink(std::false_type) {}
+
+  void persistEnergy(std::true_type)
+  {
+    flashLog.set(KEY_ENERGY_TOTAL, energy.getTotalEnergy()/1000);
+    flashLog.setFloat(KEY_ENERGY_POWER, energy.getAveragePower());
+  }
+
+  void persistEnergy(std::false_type) {}
+
+  void flushHistory(std::true_type)
+  {
+    if (history.isDirty() && (history.isFull() || ++historyCycle >= HISTORY_FLUSH_EVERY) && supplyVoltage >= FLASH_LOG_MIN_VOLTAGE)
+    {
+      timeout.cancel();
+      history.flush();
+      historyCycle = 0;
+    }
+  }
+
+  void flushHistory(std::false_type) {}
+
+  /**
+   * transmit next chunk of history block in maintenance mode
+   *
+   * chunk frame: preamble (2), sync (1), chunk index (2), data (16), checksum (1)
+   * chunk index = 4*block ring index + part
+   *
+   * @return true if a chunk was sent
+   */
+  bool sendHistoryChunk(std::true_type)
+  {
+    if (!historyDumpBlocks)
+    {
+      return false;
+    }
+
+    // limit transmit duration per wakeup
+    if (historyDumpSent >= 4*HISTORY_DUMP_MAX_BLOCKS)
+    {
+      historyDumpSent = 0;
+      return false;
+    }
+
+    uint16_t index = history.getRecentBlock(historyDumpBlocks - 1); // oldest requested first
+    byte block[History::BLOCK_SIZE];
+    if (index == History::NO_BLOCK || !history.readBlock(index, block))
+    {
+      historyDumpBlocks = 0;
+      return false;
+    }
+
+    const byte CHUNK_SIZE = History::BLOCK_SIZE/4;
+    byte frame[2 + 1 + 2 + CHUNK_SIZE + 1];
+    uint16_t chunk = 4*index + historyDumpChunk;
+    frame[0] = 0xFF;
+    frame[1] = 0xFF;
+    frame[2] = 0xA5;
+    frame[3] = chunk;
+    frame[4] = chunk >> 8;
+    memcpy(frame + 5, block + historyDumpChunk*CHUNK_SIZE, CHUNK_SIZE);
+    byte sum = 0;
+    for (byte i=2; i<sizeof(frame) - 1; i++)
+    {
+      sum += frame[i];
+    }
+    frame[sizeof(frame) - 1] = sum;
+
+    historyDumpSent++;
+    if (++historyDumpChunk == 4)
+    {
+      historyDumpChunk = 0;
+      if (!--historyDumpBlocks)
+      {
+        historyDumpSent = 0;
+      }
+    }
+
+    // restart watchdog for next chunk
+    timeout.start(EXECUTION_TIMEOUT + TransmitSchedule::getAirTime(sizeof(frame), OregonScientific::BIT_RATE), false, []{ SolarDHT::instance().timeoutInterrupt(); });
+    radio.sendPacket(sizeof(frame), frame);
+
+    return true;
+  }
+
+  bool sendHistoryChunk(std::false_type)
+  {
+    return false;
+  }
+
+  static uint32_t packSample(float temperature, float humidity)
+  {
+    return (uint16_t)(int16_t)round(temperature*100) | ((uint32_t)round(humidity*100) << 16);
+  }
+
+  static float unpackTemperature(uint32_t value)
+  {
+    return (int16_t)(value & 0xFFFF)/100.0;
+  }
+
+  static float unpackHumidity(uint32_t value)
+  {
+    return (value >> 16)/100.0;
+  }
+
   /**
    * TC ISR (prio 0)
    */
@@ -763,41 +2480,98 @@ public:
   #ifdef DEBUG
     Serial.println("timeout, shutting down");
   #endif
+    beginActive();
     digitalWrite(PIN_LED, LOW);
     uint32_t start = rtc.getElapsed();
     while (rtc.getElapsed() - start < 50);
 
     // timeout, abort all operations by shutting down
     shutdown();
+    endActive();
   }
 
 public:
+  // [mA] current per EnergyState
+  static constexpr float energyCurrents[ENERGY_STATES] = { ENERGY_CURRENTS };
+
   Analog2DigitalConverter& adc;
-  OregonScientific oregon;
-  Si4432 radio;
-#if HAS_DHT_SENSOR == 1
-  SHT2x_Wrapper<Si7021> sensor;
-#elif HAS_DHT_SENSOR == 2
-  TI_HDC1080 sensor;
-#endif
+  Optional<CONFIG.adcSequence, AdcSequencer&> adcSequencer;
+  ClockManager& clock;
+  Optional<CONFIG.fec, CompactFrame> compactFrame;
+  Optional<!CONFIG.fec, OregonScientific> oregon;
+  Radio radio;
+  Optional<CONFIG.radioMeasurement, Si4432Measurement> radioMeasurement;
+  typename SensorDriver<CONFIG.sensor>::Type sensor;
+  Optional<CONFIG.sensorHub, SensorHub> sensorHub;
+  byte hubFrame = 0; // next hub channel index to transmit
+  Optional<CONFIG.sensorHub && HUB_SENSOR_2, HubSensorDriver<HUB_SENSOR_2>> hubSensor2;
+  Optional<CONFIG.sensorHub && HUB_SENSOR_3, HubSensorDriver<HUB_SENSOR_3>> hubSensor3;
   RadioState radioState;
   RealTimeClock& rtc;
+  TransmitSchedule schedule;
   TimerCounter timeout;
-#if HAS_RADIO == 0
-  TimerCounter timer;
+  Optional<CONFIG.downlink, Downlink> downlink;
+  Optional<CONFIG.flashLog, NVMFlash> flash;
+  Optional<CONFIG.flashLog, FlashLog<NVMFlash, PERSISTENT_KEYS>> flashLog;
+  byte persistCycle = 0;
+  bool persistNow = false;
+  Optional<CONFIG.history, NVMFlash> historyFlash;
+  Optional<CONFIG.history, History> history;
+  byte historyCycle = 0;
+  uint16_t historyDumpBlocks = 0; // remaining blocks in maintenance mode
+  uint16_t historyDumpSent = 0;   // chunks sent in current wakeup
+  byte historyDumpChunk = 0;
+  Optional<CONFIG.hasTimer(), TimerCounter> timer;
+  Optional<CONFIG.display, GDEW0102T4> display;
+  Optional<CONFIG.energyMeter, EnergyMeter<ENERGY_STATES>> energy;
+  uint32_t standbyStart = 0; // [ms] RTC
+  uint32_t cycleStart = 0;   // [ms] RTC
+  Optional<CONFIG.runtimeEstimate, RuntimeEstimator> runtime;
+#if PEAK_CURRENT_BUDGET
+  PowerArbiter arbiter;
 #endif
-  GDEW0102T4 display;
+  bool awake = true;
+  byte activeDepth = 0;      // ISR nesting
   Measurement humidities;
   Measurement temperatures;
+  AcquisitionPlanner humidityPlan;
+  bool humidityRequested = true;
   float supplyVoltage = 0;
+  float mcuTemperature = 0;
+#ifdef DEBUG
+  uint32_t adcSequenceStart = 0; // [µs]
+#endif
   float temperature = 0;
   float displayTemperature = -999;
   float humidity = 0;
   float displayHumidity = 0;
+#if DEW_POINT_CHANNEL || DISPLAY_DEW_POINT
+  float dewPoint = 0;          // [°C]
+  float absoluteHumidity = 0;  // [g/m³]
+#endif
+#if DEW_POINT_CHANNEL
+  bool dewPointFrame = false;  // dew point frame pending in this radio session
+#endif
   uint32_t wakeupTime = 0;
+  bool transmitWakeup = true;
+  byte frameSize = 0;        // [bytes] last sensor frame
+  byte repeatsLeft = 0;      // repetitions of last sensor frame
+  float transmitTemperature = 0;
+  float transmitHumidity = 0;
+  uint16_t transmitUpdateCount = 0;
+  uint32_t timeOffset = 0; // [s] epoch time at RTC start, 0 if not synchronized
+  float supplyVoltageLow = SUPPLY_VOLTAGE_LOW;
+  float displayTemperatureDelta = DISPLAY_TEMPERATURE_DELTA;
+  float displayHumidityDelta = DISPLAY_HUMIDITY_DELTA;
+  byte radioTxPower = RADIO_TX_POWER;
+  byte downlinkRxEvery = DOWNLINK_RX_EVERY;
+  byte downlinkCycle = 0;
   uint32_t displayUpdated = MIN_DISPLAY_UPDATE_PERIOD/3; // [ms] -> will delay 1st update
   uint16_t displayUpdateCount = 0;
-  bool hasDisplay;
+  uint16_t displayRefreshTime = 0; // [ms] busy after refresh of rendered screen
+  static constexpr bool hasDisplay = CONFIG.display;
   bool hasRadio;
   bool hasSensor;
 };
+
+template<const SolarDHTConfig& CONFIG> constexpr float SolarDHT<CONFIG>::energyCurrents[];
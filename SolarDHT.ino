@@ -31,7 +31,7 @@ using namespace SAMD21LPE;
 
 #include "SolarDHT.hpp"
 
-SolarDHT& solarDHT = SolarDHT::instance();
+SolarDHT<SOLARDHT_CONFIG>& solarDHT = SolarDHT<SOLARDHT_CONFIG>::instance();
 
 void setup()
 {
@@ -44,7 +44,23 @@ void setup()
   delay(5000);
   Serial.begin(SERIAL_SPEED);
   while(!Serial);
+
+  // dump measurement history
+  solarDHT.dumpHistory(Serial);
 #else
+  #if HAS_HISTORY && HISTORY_USB_WAIT > 0 && F_CPU == 48000000L
+  // maintenance: dump measurement history if a USB host opens the serial port shortly after power up
+  Serial.begin(SERIAL_SPEED);
+  uint32_t start = millis();
+  while (!Serial && millis() - start < HISTORY_USB_WAIT);
+  if (Serial)
+  {
+    solarDHT.dumpHistory(Serial);
+    Serial.flush();
+  }
+  Serial.end();
+  #endif
+
   // disable non essential MCU modules (including USB)
   System::reducePowerConsumption();
 #endif
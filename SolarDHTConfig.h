@@ -0,0 +1,359 @@
+/*****************************************************************************
+ *
+ * Compile-time Configuration of SolarDHT Deployments
+ *
+ * file:     SolarDHTConfig.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/*
+ * Options marked with #ifndef can be overridden with build flags
+ * (e.g. -DHAS_RADIO=0) to build a deployment variant without editing this
+ * file, see SOLARDHT_VARIANTS and host/footprint.sh.
+ */
+
+//#define DEBUG
+#define SERIAL_SPEED 115200
+
+#define PIN_UNUSED      0 // TBD
+
+#define PIN_EPD_RST     1 // out
+#define PIN_EPD_DC      2 // out
+#define PIN_EPD_CS      3 // out
+#define PIN_EPD_BUSY    6 // in
+
+#define PIN_RADIO_NIRQ  7 // in
+#define PIN_RADIO_NSDN 18 // out
+#define PIN_RADIO_CS   17 // out
+#define PIN_RADIO_DATA 17 // out, SYN115 only (TCC1/WO[0])
+
+#ifndef PIN_BATTERY_SENSE
+  #define PIN_BATTERY_SENSE 0xFF // analog in, battery voltage divider for HAS_RUNTIME_ESTIMATE, 0xFF=NONE
+#endif
+#define BATTERY_SENSE_DIVIDER 5.0 // battery voltage / input voltage, input max. 1.0 V (INT1V)
+
+#ifndef RADIO_TX_POWER
+  #define RADIO_TX_POWER  1 // 0..7
+#endif
+
+#define TEMP_OFFSET   1.3 // [°C] SAMD21 internal temperature immediately after standby is too low
+#define RADIO_TEMP_OFFSET 0.0 // [°C] Si4432 temperature sensor calibration (HAS_RADIO_MEASUREMENT)
+
+#ifndef HAS_RADIO
+  #define HAS_RADIO       1 // 0=NONE, 1=Si4432, 2=SYN115
+#endif
+#ifndef HAS_DISPLAY
+  #define HAS_DISPLAY     1
+#endif
+#ifndef HAS_DHT_SENSOR
+  #define HAS_DHT_SENSOR  2 // 0=NONE, 1=Si7021, 2=HDC1080
+#endif
+#ifndef HAS_DOWNLINK
+  #define HAS_DOWNLINK    0 // 0=NONE, 1=RX window after transmit (Si4432 only, requires HAS_FLASH_LOG to keep the sequence against replay)
+#endif
+#ifndef HAS_FLASH_LOG
+  #define HAS_FLASH_LOG   1 // 0=NONE, 1=persist state in flash across brown-outs
+#endif
+#ifndef HAS_HISTORY
+  #define HAS_HISTORY     1 // 0=NONE, 1=compressed measurement history in flash
+#endif
+#ifndef HAS_CLOCK_SCALING
+  #define HAS_CLOCK_SCALING 1 // 0=NONE, 1=low CPU clock while waiting, high CPU clock for compute bursts
+#endif
+#ifndef HAS_ENERGY_METER
+  #define HAS_ENERGY_METER  1 // 0=NONE, 1=accumulate time per power state and estimate energy per wakeup
+#endif
+#ifndef HAS_ADC_SEQUENCE
+  #define HAS_ADC_SEQUENCE  1 // 0=blocking ADC reads, 1=asynchronous ADC sequence with DMA while CPU sleeps
+#endif
+#ifndef HAS_SENSOR_HUB
+  #define HAS_SENSOR_HUB    0 // 0=NONE, 1=additional sensors on channels 2..3, transmitted in the same radio session
+#endif
+#ifndef HAS_FEC
+  #define HAS_FEC           0 // 0=Oregon Scientific frames, 1=compact frames with error correction (not decoded by rtl_433)
+#endif
+#ifndef HAS_RUNTIME_ESTIMATE
+  #define HAS_RUNTIME_ESTIMATE 0 // 0=NONE, 1=estimate remaining runtime from battery voltage trend (PIN_BATTERY_SENSE) and energy meter
+#endif
+#ifndef HAS_RAMFUNC
+  #define HAS_RAMFUNC       0 // 0=NONE, 1=execute wakeup hot path (RAMFUNC) from RAM, see RAMFUNC_BUDGET, not measured yet
+#endif
+#ifndef HAS_RADIO_MEASUREMENT
+  #define HAS_RADIO_MEASUREMENT 0 // 0=SAMD21 ADC, 1=supply voltage (50 mV steps) and fallback temperature from Si4432 on transmit wakeups
+#endif
+#ifndef HAS_FONT_SUBSET
+  #define HAS_FONT_SUBSET   0 // 0=complete Adafruit GFX fonts, 1=glyph subsets of SolarDHTFonts.h generated by host/FontSubset.cpp (not checked in)
+#endif
+#ifndef NVM_SLEEP_POWER_DOWN
+  #define NVM_SLEEP_POWER_DOWN 0 // NVMCTRL SLEEPPRM: 0=flash powered in sleep, 1=power down and wake on first flash access, 2=power down and wake with CPU, not measured yet
+#endif
+
+#define EXECUTION_TIMEOUT 200 // [ms] max. duration from wakeup to end of transmission
+
+#define MIN_DISPLAY_UPDATE_PERIOD 180000 // [ms] 180 s
+
+#define SUPPLY_VOLTAGE_LOW  2.55 // [V] harvester default seems to be around 2.6 V
+#define SUPPLY_VOLTAGE_HIGH 3.40 // [V]
+
+#define BATTERY_MODEL   BATTERY_LIPO_50 // discharge curve of RuntimeEstimator.h
+#define RUNTIME_WARNING 14 // [d] report low battery if estimated runtime is shorter
+
+#define DISPLAY_TEMPERATURE_DELTA 0.5 // [°C] min. change for display update
+#define DISPLAY_HUMIDITY_DELTA    3   // [%] min. change for display update
+
+#define DOWNLINK_RX_EVERY     10 // open RX window every n-th wakeup
+#define DOWNLINK_RX_WINDOW     5 // [ms] max. wait for preamble after transmit
+#define DOWNLINK_FRAME_TIMEOUT 400 // [ms] max. frame duration after preamble detection
+// 128 bit key of the deployment, build flag only, e.g. -DDOWNLINK_KEY=0x01234567,0x89ABCDEF,0x01234567,0x89ABCDEF
+#if HAS_DOWNLINK && !defined(DOWNLINK_KEY)
+  #error "HAS_DOWNLINK requires the key of the deployment as build flag DOWNLINK_KEY"
+#elif !defined(DOWNLINK_KEY)
+  #define DOWNLINK_KEY 0, 0, 0, 0 // unused
+#endif
+
+#define FLASH_LOG_ROWS         16  // [rows] 4 KB of flash, each row is erased ~once per day
+#define FLASH_LOG_COMMIT_EVERY 10  // write changed state to flash every n-th wakeup
+#define FLASH_LOG_MIN_VOLTAGE  2.8 // [V] min. supply voltage for flash write
+
+#define HISTORY_ROWS           160 // [rows] 40 KB of flash, ~4 weeks at 3 min period
+#define HISTORY_FLUSH_EVERY    10  // write partial history block every n-th wakeup
+#ifndef HISTORY_USB_WAIT
+  #define HISTORY_USB_WAIT     0   // [ms] wait for USB host after power up to dump history, 0=disabled, e.g. 1000 for maintenance builds
+#endif
+#define HISTORY_DUMP_MAX_BLOCKS 40 // max. history blocks transmitted per wakeup in maintenance mode
+
+#ifndef HUB_SENSOR_2
+  #define HUB_SENSOR_2 2    // 0=NONE, 1=Si7021, 2=HDC1080
+#endif
+#ifndef HUB_SENSOR_3
+  #define HUB_SENSOR_3 0    // 0=NONE, 1=Si7021, 2=HDC1080
+#endif
+#define HUB_PORT_1   0    // TCA9548A I2C mux port of main sensor, 0xFF=no mux
+#define HUB_PORT_2   1    // TCA9548A I2C mux port of channel 2 sensor, 0xFF=no mux
+#define HUB_PORT_3   2    // TCA9548A I2C mux port of channel 3 sensor, 0xFF=no mux
+
+#define CLOCK_LOW_DIVIDER 8 // OSC8M divider for waiting phases (1 MHz)
+#define RAMFUNC_BUDGET 4096 // [bytes] max. RAM for RAMFUNC code, checked by host/footprint.sh
+#define SPI_BAUD_RATE  4000000 // [baud]
+#define WIRE_BAUD_RATE  100000 // [baud]
+
+// [mA] current per EnergyState at F_CPU 48 MHz: standby, idle low/high clock, active low/high clock,
+// radio off/enabled/on/ready/standby/TX/RX, sensor acquisition, display busy
+#define ENERGY_CURRENTS 0.002, 0.12, 1.76, 0.26, 3.78, 0.0, 0.40, 0.85, 0.85, 0.001, 28.0, 18.5, 0.19, 1.5
+#define DISPLAY_REFRESH_PARTIAL 1500 // [ms] display busy after partial refresh
+#define DISPLAY_REFRESH_FULL    4000 // [ms] display busy after full refresh
+#define DISPLAY_ENERGY          0    // show average power [µW] between units
+#define DISPLAY_RUNTIME         0    // show estimated runtime [d] between units
+#define DISPLAY_DEW_POINT       0    // show dew point [°C] top right, "!" if temperature is close to dew point
+#define CONDENSATION_SPREAD     2.0  // [°C] min. distance of temperature to dew point without condensation warning
+#define FONT_VALUE_GLYPHS       "%-.0123456789C" // glyphs printed with FreeSans18pt7b, subset of HAS_FONT_SUBSET
+#define FONT_UNIT_GLYPHS        "o"              // glyphs printed with FreeSansBold9pt7b, subset of HAS_FONT_SUBSET
+
+#ifndef TRANSMIT_PERIOD
+#ifdef DEBUG
+  #define TRANSMIT_PERIOD 10*1000 // [ms] 10 s test period
+#else
+  #define TRANSMIT_PERIOD 3UL*60*1000 // [ms] 3 min wakeup period
+#endif
+#endif
+#ifndef SAMPLE_PERIOD
+  #define SAMPLE_PERIOD 60UL*1000 // [ms] sample-only wakeups between transmissions, 0 or >= TRANSMIT_PERIOD to sample only when transmitting
+#endif
+#define TRANSMIT_TEMPERATURE_DELTA 1.0 // [°C] transmit early on sample-only wakeup if changed since last transmission, 0 to disable
+#define TRANSMIT_HUMIDITY_DELTA    5   // [%] transmit early on sample-only wakeup if changed since last transmission
+#ifndef HUMIDITY_EVERY
+  #define HUMIDITY_EVERY 5 // max. acquisitions per humidity conversion, temperature-only otherwise, 1 to always convert humidity
+#endif
+#define HUMIDITY_TEMPERATURE_DELTA 0.3 // [°C] convert humidity if temperature changed since last humidity conversion
+#define HUMIDITY_EXPECTED_DELTA    1.0 // [%] convert humidity if expected change reaches delta (average change per acquisition)
+#ifndef TRANSMIT_REPEATS
+  #define TRANSMIT_REPEATS 0 // repetitions of each sensor frame in the same radio session, ~+9 mJ each
+#endif
+#ifndef DEW_POINT_CHANNEL
+  #define DEW_POINT_CHANNEL 0 // 0=OFF, 2..3=transmit dew point [°C] and absolute humidity [g/m³] as additional channel
+#endif
+#ifndef PEAK_CURRENT_BUDGET
+  #define PEAK_CURRENT_BUDGET 30 // [mA] max. sum of radio and display current, 0=unlimited, defer display refresh until radio is off if exceeded
+#endif
+#define DISPLAY_PEAK_CURRENT    6.0  // [mA] display charge pump during refresh (estimate)
+
+// place function in RAM: copied with the initialized data at start-up, executes
+// without flash wait states; long_call because RAM is out of BL range of flash
+#if HAS_RAMFUNC && defined(__arm__)
+  #define RAMFUNC __attribute__((section(".data.ramfunc"), noinline, long_call))
+#else
+  #define RAMFUNC
+#endif
+
+#if HAS_CLOCK_SCALING && defined(DEBUG)
+  // USB serial requires GCLK0 at 48 MHz
+  #undef HAS_CLOCK_SCALING
+  #define HAS_CLOCK_SCALING 0
+#endif
+
+/**
+ * deployment options as typed constants
+ *
+ * SolarDHT is a class template on the configuration, so that every variant
+ * can be instantiated in one host build (host/VariantTest.cpp). Options are
+ * used in plain if statements wherever the code of both branches compiles,
+ * so the optimizer removes the code of unused features and peripherals.
+ * Driver types, members and calls into them are selected with tag dispatch
+ * and are only instantiated if the option is enabled. Build flags without a
+ * field (e.g. DEBUG, RAMFUNC, fonts, DEW_POINT_CHANNEL, HUB_SENSOR_*) stay
+ * preprocessor options.
+ *
+ * Invalid combinations are rejected at compile time by isValid().
+ */
+struct SolarDHTConfig
+{
+  enum RadioType
+  {
+    RADIO_NONE,
+    RADIO_SI4432,
+    RADIO_SYN115
+  };
+
+  enum SensorType
+  {
+    SENSOR_NONE,
+    SENSOR_SI7021,
+    SENSOR_HDC1080
+  };
+
+  const char* name;
+  RadioType radio;
+  bool display;
+  SensorType sensor;
+  bool downlink;
+  bool flashLog;
+  bool history;
+  bool clockScaling;
+  bool energyMeter;
+  bool adcSequence;
+  bool sensorHub;
+  bool fec;
+  bool runtimeEstimate;
+  bool radioMeasurement;
+  bool ramfunc;
+  bool fontSubset;
+  uint32_t samplePeriod;  // [ms]
+  byte transmitRepeats;
+
+  constexpr SolarDHTConfig(const char* name, RadioType radio, bool display, SensorType sensor, bool downlink, bool flashLog,
+                           bool history, bool clockScaling, bool energyMeter, bool adcSequence, bool sensorHub, bool fec,
+                           bool runtimeEstimate, bool radioMeasurement, bool ramfunc, bool fontSubset, uint32_t samplePeriod,
+                           byte transmitRepeats) :
+    name(name), radio(radio), display(display), sensor(sensor), downlink(downlink), flashLog(flashLog),
+    history(history), clockScaling(clockScaling), energyMeter(energyMeter), adcSequence(adcSequence), sensorHub(sensorHub),
+    fec(fec), runtimeEstimate(runtimeEstimate), radioMeasurement(radioMeasurement), ramfunc(ramfunc), fontSubset(fontSubset),
+    samplePeriod(samplePeriod), transmitRepeats(transmitRepeats)
+  {}
+
+  constexpr bool hasRadio() const
+  {
+    return radio != RADIO_NONE;
+  }
+
+  constexpr bool hasSensor() const
+  {
+    return sensor != SENSOR_NONE;
+  }
+
+  /**
+   * @return true if TC5 is needed for passive waiting during acquisition,
+   * on each wakeup without radio (no radio, sample-only or radio failed)
+   */
+  constexpr bool hasTimer() const
+  {
+    return hasSensor();
+  }
+
+  /**
+   * @return nullptr or reason why the combination of options is invalid
+   */
+  constexpr const char* getError() const
+  {
+    return radio > RADIO_SYN115?                     "unknown radio type" :
+           sensor > SENSOR_HDC1080?                  "unknown sensor type" :
+           downlink && radio != RADIO_SI4432?        "downlink requires Si4432 transceiver" :
+           downlink && !flashLog?                    "downlink requires flash log" :
+           sensorHub && sensor == SENSOR_NONE?       "sensor hub requires main sensor" :
+           fec && !hasRadio()?                       "FEC requires radio" :
+           runtimeEstimate && !energyMeter?          "runtime estimate requires energy meter" :
+           radioMeasurement && radio != RADIO_SI4432? "radio measurement requires Si4432 transceiver" :
+           !hasRadio() && !display?                  "neither radio nor display" :
+           nullptr;
+  }
+
+  constexpr bool isValid() const
+  {
+    return getError() == nullptr;
+  }
+};
+
+/**
+ * configuration of this build
+ */
+constexpr SolarDHTConfig SOLARDHT_CONFIG("build", (SolarDHTConfig::RadioType)HAS_RADIO, HAS_DISPLAY, (SolarDHTConfig::SensorType)HAS_DHT_SENSOR,
+                                         HAS_DOWNLINK, HAS_FLASH_LOG, HAS_HISTORY, HAS_CLOCK_SCALING, HAS_ENERGY_METER,
+                                         HAS_ADC_SEQUENCE, HAS_SENSOR_HUB, HAS_FEC, HAS_RUNTIME_ESTIMATE,
+                                         HAS_RADIO_MEASUREMENT, HAS_RAMFUNC, HAS_FONT_SUBSET, SAMPLE_PERIOD, TRANSMIT_REPEATS);
+
+static_assert(!SOLARDHT_CONFIG.downlink || SOLARDHT_CONFIG.radio == SolarDHTConfig::RADIO_SI4432, "downlink requires Si4432 transceiver");
+static_assert(!SOLARDHT_CONFIG.downlink || SOLARDHT_CONFIG.flashLog, "downlink requires flash log");
+static_assert(!SOLARDHT_CONFIG.sensorHub || SOLARDHT_CONFIG.hasSensor(), "sensor hub requires main sensor");
+static_assert(!SOLARDHT_CONFIG.fec || SOLARDHT_CONFIG.hasRadio(), "FEC requires radio");
+static_assert(!SOLARDHT_CONFIG.runtimeEstimate || SOLARDHT_CONFIG.energyMeter, "runtime estimate requires energy meter");
+static_assert(!HAS_RUNTIME_ESTIMATE || PIN_BATTERY_SENSE != 0xFF, "runtime estimate requires PIN_BATTERY_SENSE, VDDIO is regulated");
+static_assert(SOLARDHT_CONFIG.isValid(), "invalid option combination");
+static_assert(RADIO_TX_POWER <= 7, "RADIO_TX_POWER: 0..7");
+static_assert(DEW_POINT_CHANNEL == 0 || (DEW_POINT_CHANNEL >= 2 && DEW_POINT_CHANNEL <= 3), "DEW_POINT_CHANNEL: 0, 2..3");
+static_assert(DEW_POINT_CHANNEL == 0 || SOLARDHT_CONFIG.hasSensor(), "DEW_POINT_CHANNEL requires sensor");
+static_assert(DEW_POINT_CHANNEL == 0 || !HAS_SENSOR_HUB || DEW_POINT_CHANNEL > 1 + (HUB_SENSOR_2 > 0) + (HUB_SENSOR_3 > 0),
+              "DEW_POINT_CHANNEL is used by sensor hub");
+static_assert(NVM_SLEEP_POWER_DOWN <= 2, "NVM_SLEEP_POWER_DOWN: 0..2");
+static_assert(PEAK_CURRENT_BUDGET >= 0, "PEAK_CURRENT_BUDGET: >= 0");
+static_assert(HUMIDITY_EVERY >= 1 && HUMIDITY_EVERY <= 255, "HUMIDITY_EVERY: 1..255");
+static_assert(TRANSMIT_PERIOD > EXECUTION_TIMEOUT, "TRANSMIT_PERIOD must exceed EXECUTION_TIMEOUT");
+
+/**
+ * deployment variants, host/ConfigTool.cpp converts them to build flags and
+ * host/VariantTest.cpp instantiates SolarDHT for each of them
+ *
+ * Named objects, because a template argument must not be an array element.
+ */
+//                                              name            radio                         display sensor                          downlink flash  history scaling energy adc    hub    fec    runtime meas   ramfunc font   sample repeats
+constexpr SolarDHTConfig VARIANT_DEFAULT(     "default",      SolarDHTConfig::RADIO_SI4432, true,  SolarDHTConfig::SENSOR_HDC1080, false,   true,  true,   true,   true,  true,  false, false, false,  false, false,  false, 60000, 0);
+constexpr SolarDHTConfig VARIANT_MINIMAL(     "minimal",      SolarDHTConfig::RADIO_SI4432, false, SolarDHTConfig::SENSOR_HDC1080, false,   false, false,  false,  false, false, false, false, false,  true,  false,  false, 0,     0);
+constexpr SolarDHTConfig VARIANT_TRANSMITTER( "transmitter",  SolarDHTConfig::RADIO_SYN115, false, SolarDHTConfig::SENSOR_HDC1080, false,   true,  false,  true,   false, true,  false, false, false,  false, false,  false, 60000, 0);
+constexpr SolarDHTConfig VARIANT_DISPLAY_ONLY("display-only", SolarDHTConfig::RADIO_NONE,   true,  SolarDHTConfig::SENSOR_HDC1080, false,   true,  false,  true,   false, true,  false, false, false,  false, false,  false, 60000, 0);
+constexpr SolarDHTConfig VARIANT_DOWNLINK(    "downlink",     SolarDHTConfig::RADIO_SI4432, true,  SolarDHTConfig::SENSOR_SI7021,  true,    true,  true,   true,   true,  true,  false, false, false,  false, false,  false, 60000, 0);
+constexpr SolarDHTConfig VARIANT_MULTI_ZONE(  "multi-zone",   SolarDHTConfig::RADIO_SI4432, false, SolarDHTConfig::SENSOR_HDC1080, false,   true,  true,   true,   true,  true,  true,  false, false,  false, false,  false, 60000, 0);
+constexpr SolarDHTConfig VARIANT_CODED(       "coded",        SolarDHTConfig::RADIO_SI4432, false, SolarDHTConfig::SENSOR_HDC1080, false,   true,  false,  true,   true,  true,  false, true,  false,  false, false,  false, 60000, 1);
+
+constexpr const SolarDHTConfig* SOLARDHT_VARIANTS[] = {
+  &VARIANT_DEFAULT, &VARIANT_MINIMAL, &VARIANT_TRANSMITTER, &VARIANT_DISPLAY_ONLY, &VARIANT_DOWNLINK, &VARIANT_MULTI_ZONE, &VARIANT_CODED
+};
@@ -0,0 +1,272 @@
+/*****************************************************************************
+ *
+ * Periodic Wakeup and Transmit Schedule
+ *
+ * file:     TransmitSchedule.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * wakeup schedule of the RTC timer, shared by the firmware and the host simulation
+ *
+ * The first wakeup is performed immediately at power up, the following
+ * wakeups are scheduled by the RTC timer with a resolution of 1 s. The radio
+ * transmission starts after the radio start-up time.
+ *
+ * Without a serial ID all units wake up exactly every period after power up,
+ * so units powered up together will collide forever. With a serial ID the
+ * schedule is slotted:
+ * - the 2nd wakeup is shifted by a phase offset of -period/2 .. +period/2
+ * - each following wakeup k is shifted by a jitter j(k) of -MAX_JITTER .. +MAX_JITTER
+ *   relative to its nominal slot, so the interval is period + j(k) - j(k-1)
+ *   and the phase stays bounded
+ * - the rolling code is derived from the same hash
+ * Phase offset, jitter sequence and rolling code are unique per serial ID and
+ * require no extra wakeups.
+ *
+ * With a sample period shorter than the period, sample-only wakeups are
+ * inserted between the transmit wakeups (dual rate). The transmit wakeups
+ * keep their slots, the last sample interval before a transmit wakeup is
+ * stretched up to 1.5 sample periods instead of adding a short one.
+ * An early transmission requested on a sample-only wakeup is deferred to the
+ * next wakeup, which becomes a transmit wakeup, and the following transmit
+ * slots are counted from there, so the unit never transmits between its
+ * wakeups and no regular transmission follows shortly after the early one.
+ *
+ * Repeated frames within one radio session are separated by a random gap of
+ * MIN_REPEAT_GAP .. MAX_REPEAT_GAP, so two units colliding once do not
+ * collide with each repetition.
+ */
+class TransmitSchedule
+{
+public:
+  static const uint16_t RTC_RESOLUTION = 1000; // [ms]
+  static const uint16_t RADIO_STARTUP_TIME = 22; // [ms] wakeup to start of transmission (Si4432)
+  static const byte MAX_JITTER = 2; // [RTC ticks] +/- jitter per wakeup
+  static const byte DEFAULT_ROLLING_CODE = 0x12;
+  static const uint16_t MIN_REPEAT_GAP = 50;  // [ms]
+  static const uint16_t MAX_REPEAT_GAP = 500; // [ms] range >> air time, so colliding copies drift apart
+
+public:
+  TransmitSchedule(uint32_t period) : period(period) {};
+
+public:
+  /**
+   * enable slotted schedule
+   *
+   * @param high upper 32 bits of serial ID (e.g. sensor readSerialIdHigh())
+   * @param low lower 32 bits of serial ID (e.g. sensor readSerialIdLow())
+   */
+  void setSerialId(uint32_t high, uint32_t low)
+  {
+    hash = mix(((uint64_t)high << 32) | low);
+    random = hash | 1;
+    slotted = true;
+    firstInterval = true;
+    jitter = 0;
+  }
+
+  bool isSlotted() const
+  {
+    return slotted;
+  }
+
+  /**
+   * @return Oregon Scientific rolling code, unique per serial ID if slotted
+   */
+  byte getRollingCode() const
+  {
+    byte code = hash >> 56;
+    return slotted? (code? code : DEFAULT_ROLLING_CODE) : DEFAULT_ROLLING_CODE;
+  }
+
+  /**
+   * @param period nominal wakeup period [ms], takes effect with next interval
+   */
+  void setPeriod(uint32_t period)
+  {
+    this->period = period;
+  }
+
+  /**
+   * @return nominal wakeup period [ms]
+   */
+  uint32_t getPeriod() const
+  {
+    return period;
+  }
+
+  /**
+   * @param samplePeriod period of sample-only wakeups between transmit
+   * wakeups [ms], 0 to sample with each transmit wakeup only
+   */
+  void setSamplePeriod(uint32_t samplePeriod)
+  {
+    this->samplePeriod = samplePeriod;
+  }
+
+  uint32_t getSamplePeriod() const
+  {
+    return samplePeriod;
+  }
+
+  /**
+   * @return true if the current wakeup (scheduled by the last call of
+   * getNextWakeup()) is a transmit wakeup, always true without sample period
+   */
+  bool isTransmitDue() const
+  {
+    return transmitDue;
+  }
+
+  /**
+   * turn the next wakeup into a transmit wakeup, call on a sample-only wakeup
+   * after getNextWakeup()
+   *
+   * The remaining interval until the scheduled transmit wakeup is dropped, the
+   * next transmit interval (incl. jitter) starts at the early transmit wakeup.
+   */
+  void requestTransmit()
+  {
+    transmitDue = true;
+  }
+
+  /**
+   * advance to next wakeup, transmit or sample-only
+   *
+   * @return delay until next wakeup [ms], multiple of RTC resolution
+   */
+  uint32_t getNextWakeup()
+  {
+    uint32_t sample = quantize(samplePeriod);
+    if (!sample || sample >= quantize(period))
+    {
+      transmitDue = true;
+      return getNextInterval();
+    }
+
+    if (transmitDue)
+    {
+      untilTransmit = getNextInterval();
+    }
+    if (untilTransmit < sample + sample/2)
+    {
+      transmitDue = true;
+      return untilTransmit;
+    }
+    transmitDue = false;
+    untilTransmit -= sample;
+    return sample;
+  }
+
+  /**
+   * @return delay until next transmit wakeup [ms], multiple of RTC resolution
+   */
+  uint32_t getNextInterval()
+  {
+    if (!slotted)
+    {
+      return quantize(period);
+    }
+
+    int32_t ticks = quantize(period)/RTC_RESOLUTION;
+    int32_t interval;
+    if (firstInterval)
+    {
+      // phase offset -period/2 .. +period/2
+      firstInterval = false;
+      interval = ticks/2 + (int32_t)((uint32_t)(hash >> 32) % (uint32_t)ticks);
+    }
+    else
+    {
+      // bounded jitter relative to nominal slot
+      int32_t next = (int32_t)(nextRandom() % (2*MAX_JITTER + 1)) - MAX_JITTER;
+      interval = ticks + next - jitter;
+      jitter = next;
+    }
+
+    return (interval > 0? interval : 1)*RTC_RESOLUTION;
+  }
+
+  /**
+   * @return random gap before next repetition of a frame [ms]
+   */
+  uint16_t getRepeatGap()
+  {
+    return MIN_REPEAT_GAP + nextRandom() % (MAX_REPEAT_GAP - MIN_REPEAT_GAP + 1);
+  }
+
+  /**
+   * @return transmit duration [ms]
+   *
+   * @param size message size [bytes]
+   * @param bitRate [bit/s]
+   */
+  static float getAirTime(byte size, uint32_t bitRate)
+  {
+    return 8000.0f*size/bitRate;
+  }
+
+protected:
+  static uint32_t quantize(uint32_t interval)
+  {
+    return (interval + RTC_RESOLUTION/2)/RTC_RESOLUTION*RTC_RESOLUTION;
+  }
+
+  /**
+   * 64 bit finalizer (SplitMix64)
+   */
+  static uint64_t mix(uint64_t x)
+  {
+    x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+  }
+
+  /**
+   * xorshift32
+   */
+  uint32_t nextRandom()
+  {
+    uint32_t x = random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random = x;
+    return x;
+  }
+
+protected:
+  uint32_t period;
+  uint32_t samplePeriod = 0;
+  uint32_t untilTransmit = 0; // [ms]
+  bool transmitDue = true;
+  uint64_t hash = 0;
+  uint32_t random = 1;
+  int32_t jitter = 0; // [RTC ticks] offset of current wakeup relative to nominal slot
+  bool slotted = false;
+  bool firstInterval = true;
+};
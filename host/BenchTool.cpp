@@ -0,0 +1,536 @@
+/*****************************************************************************
+ *
+ * Micro-Benchmark of the Sketch Headers on the Host
+ *
+ * file:     BenchTool.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -Ishim -o bench_tool BenchTool.cpp
+ *
+ * usage:
+ *   ./bench_tool                   (run all benchmarks)
+ *   ./bench_tool -f encode         (only benchmarks containing "encode")
+ *   ./bench_tool -f fec            (compact frame encoder and Viterbi decoder)
+ *   ./bench_tool -f psychro        (dew point and absolute humidity, fixed point vs. libm)
+ *   ./bench_tool -s bench.txt      (save results as baseline)
+ *   ./bench_tool -c bench.txt      (compare with baseline, exit code 1 on regression,
+ *                                   2 if the instructions cannot be counted)
+ *
+ * Reports the time [ns/op] and, if the Linux perf counters are accessible,
+ * the retired instructions per operation of the host CPU. The instruction
+ * count is nearly independent of the machine load and is used for the
+ * baseline comparison. The time is too noisy for a tolerance of a few
+ * percent, so a comparison without counters (perf_event_paranoid, container)
+ * or with a baseline saved without counters is an error. Both are relative
+ * host costs: they catch regressions and compare alternatives but are no
+ * cycle counts of the Cortex-M0+ (no hardware divide, no FPU, soft float).
+ *
+ * The display benchmark runs SolarDHT::displaySensorData() of the default
+ * variant on the display shim (host/shim/GD_ePaper.h), which records the
+ * printed text with fixed width fonts instead of rasterizing the glyphs.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include <Arduino.h>
+
+#include "../SolarDHT.hpp"
+
+struct Options
+{
+  long iterations = 1000000;
+  const char* filter = nullptr;
+  const char* save = nullptr;
+  const char* compare = nullptr;
+  float tolerance = 5; // [%]
+};
+
+struct Result
+{
+  std::string name;
+  double ns;            // per operation
+  double instructions;  // per operation, < 0 if not available
+};
+
+/**
+ * retired user space instructions of the calling thread
+ */
+class InstructionCounter
+{
+public:
+  InstructionCounter()
+  {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+
+  ~InstructionCounter()
+  {
+    if (fd >= 0)
+    {
+      close(fd);
+    }
+  }
+
+  bool isAvailable() const
+  {
+    return fd >= 0;
+  }
+
+  void start()
+  {
+    if (fd >= 0)
+    {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  long long stop()
+  {
+    long long count = -1;
+    if (fd >= 0)
+    {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd, &count, sizeof(count)) != sizeof(count))
+      {
+        count = -1;
+      }
+    }
+    return count;
+  }
+
+private:
+  int fd;
+};
+
+/**
+ * keep result of benchmarked operation
+ */
+template<class T> static inline void keep(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+class Bench
+{
+public:
+  Bench(const Options& options) : options(options) {}
+
+public:
+  bool isSelected(const std::string& name) const
+  {
+    return !options.filter || name.find(options.filter) != std::string::npos;
+  }
+
+  template<class F> void run(const std::string& name, F operation)
+  {
+    if (!isSelected(name))
+    {
+      return;
+    }
+
+    // warm up caches and branch predictors
+    for (long i=0; i<options.iterations/10; i++)
+    {
+      operation(i);
+    }
+
+    counter.start();
+    auto start = std::chrono::steady_clock::now();
+    for (long i=0; i<options.iterations; i++)
+    {
+      operation(i);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long instructions = counter.stop();
+
+    Result result = { name, 1e9*elapsed/options.iterations, instructions >= 0? (double)instructions/options.iterations : -1 };
+    if (result.instructions >= 0)
+    {
+      printf("%-40s %10.1f %12.1f\n", name.c_str(), result.ns, result.instructions);
+    }
+    else
+    {
+      printf("%-40s %10.1f %12s\n", name.c_str(), result.ns, "n/a");
+    }
+    results.push_back(result);
+  }
+
+  const std::vector<Result>& getResults() const
+  {
+    return results;
+  }
+
+  bool hasInstructions() const
+  {
+    return counter.isAvailable();
+  }
+
+private:
+  const Options& options;
+  InstructionCounter counter;
+  std::vector<Result> results;
+};
+
+static void benchMeasurement(Bench& bench)
+{
+  Measurement measurement;
+  bench.run("measurement add", [&](long i)
+  {
+    measurement.add(20 + (i & 7)*0.1f);
+  });
+
+  float average = 0;
+  bench.run("measurement getAverage", [&](long)
+  {
+    average += measurement.getAverage();
+    keep(average);
+  });
+
+  bench.run("measurement getAverage latest 2", [&](long)
+  {
+    average += measurement.getAverage(2);
+    keep(average);
+  });
+}
+
+static void benchEncoder(Bench& bench)
+{
+  const uint16_t IDS[] = { 0x1D20, 0x1D30, 0xF824, 0xF8B4 };
+  const float TEMPERATURES[] = { -12.3f, -0.4f, 0.0f, 7.5f, 21.6f, 35.0f, 99.9f, 150.0f };
+
+  for (uint16_t id : IDS)
+  {
+    for (int option=0; option<8; option++)
+    {
+      OregonScientific oregon;
+      oregon.setInvertBits(option & 1);
+      oregon.setFlipInputNibbles(option & 2);
+      oregon.setFlipOutputNibbles(option & 4);
+
+      char name[64];
+      snprintf(name, sizeof(name), "encodeTH %04X OS%d inv%d in%d out%d", id, (id == 0x1D20 || id == 0x1D30)? 2 : 3,
+               option & 1, (option >> 1) & 1, (option >> 2) & 1);
+      bench.run(name, [&](long i)
+      {
+        byte size = oregon.encodeTH(id, 1 + i % 3, 0x5A, i & 1, TEMPERATURES[i & 7], i % 100);
+        keep(size);
+        keep(oregon.getMessage()[0]);
+      });
+    }
+  }
+}
+
+static void benchDisplay(Bench& bench)
+{
+  // random walk around the displayed values, 1 s per decision
+  float temperature = 20, humidity = 50;
+  uint32_t updated = 0;
+  bench.run("display isDue", [&](long i)
+  {
+    temperature += (i & 1)? 0.05f : -0.04f;
+    humidity += (i & 2)? 0.3f : -0.25f;
+    uint32_t now = i*1000;
+    bool due = DisplayUpdate::isDue(temperature, humidity, 20, 50, 0.5f, 3, now, updated, 180000);
+    if (due)
+    {
+      updated = now;
+    }
+    keep(due);
+  });
+
+  bench.run("display isPartialRefresh", [&](long i)
+  {
+    bool partial = DisplayUpdate::isPartialRefresh(i);
+    keep(partial);
+  });
+
+  // rendering of the default variant without refresh
+  typedef SolarDHT<VARIANT_DEFAULT> Sketch;
+  Sketch& sketch = Sketch::instance();
+  bench.run("display displaySensorData", [&](long i)
+  {
+    sketch.temperature = -20 + (i & 511)*0.1f;
+    sketch.humidity = (i & 127)*0.8f;
+    sketch.displaySensorData();
+    keep(sketch.display);
+  });
+}
+
+static void benchFec(Bench& bench)
+{
+  CompactFrame frame;
+  bench.run("fec encodeTH", [&](long i)
+  {
+    byte size = frame.encodeTH(1 + i % 3, 0x5A, i & 1, -20 + (i & 511)*0.1f, i % 100);
+    keep(size);
+    keep(frame.getMessage()[CompactFrame::PREAMBLE_SIZE + 1]);
+  });
+
+  // decode with 4 bit errors
+  frame.encodeTH(1, 0x5A, false, 21.5f, 50);
+  byte code[CompactFrame::CODE_SIZE];
+  for (byte i=0; i<CompactFrame::CODE_SIZE; i++)
+  {
+    code[i] = frame.getMessage()[CompactFrame::PREAMBLE_SIZE + 1 + i];
+  }
+  code[1] ^= 0x01;
+  code[4] ^= 0x10;
+  code[7] ^= 0x40;
+  code[12] ^= 0x02;
+  CompactFrame::Data data;
+  bench.run("fec decode 4 errors", [&](long)
+  {
+    bool valid = frame.decode(code, data);
+    keep(valid);
+    keep(data.temp);
+  });
+}
+
+/**
+ * reference: Magnus formula with libm in double
+ */
+static double getDewPointLibm(double temperature, double humidity)
+{
+  double gamma = log(humidity/100) + 17.62*temperature/(243.12 + temperature);
+  return 243.12*gamma/(17.62 - gamma);
+}
+
+static double getAbsoluteHumidityLibm(double temperature, double humidity)
+{
+  double saturation = 611.2*exp(17.62*temperature/(243.12 + temperature));
+  return 1000*saturation*humidity/100/(461.5*(temperature + 273.15));
+}
+
+static void benchPsychrometrics(Bench& bench)
+{
+  // the host has an FPU, on the Cortex-M0+ logf()/expf() in soft float cost a multiple of the host ratio
+  float dewPoint = 0, absoluteHumidity = 0;
+  bench.run("psychrometrics dew point fixed", [&](long i)
+  {
+    dewPoint += Psychrometrics::getDewPoint((int16_t)(-4000 + (i & 8191)*3/2), (uint16_t)(100 + (i*37 & 8191)));
+    keep(dewPoint);
+  });
+
+  bench.run("psychrometrics dew point libm", [&](long i)
+  {
+    float temperature = -40 + (i & 8191)*0.015f, humidity = 1 + (i*37 & 8191)*0.01f;
+    float gamma = logf(humidity/100) + 17.62f*temperature/(243.12f + temperature);
+    dewPoint += 243.12f*gamma/(17.62f - gamma);
+    keep(dewPoint);
+  });
+
+  bench.run("psychrometrics absolute fixed", [&](long i)
+  {
+    absoluteHumidity += Psychrometrics::getAbsoluteHumidity((int16_t)(-4000 + (i & 8191)*3/2), (uint16_t)(100 + (i*37 & 8191)));
+    keep(absoluteHumidity);
+  });
+
+  bench.run("psychrometrics absolute libm", [&](long i)
+  {
+    float temperature = -40 + (i & 8191)*0.015f, humidity = 1 + (i*37 & 8191)*0.01f;
+    absoluteHumidity += 611.2f*expf(17.62f*temperature/(243.12f + temperature))*humidity*(1000/100/461.5f)/(temperature + 273.15f);
+    keep(absoluteHumidity);
+  });
+
+  if (!bench.isSelected("psychrometrics"))
+  {
+    return;
+  }
+
+  // accuracy over the full range, 0.05 °C and 0.1 % steps
+  double maxDewPoint = 0, maxAbsolute = 0, maxRelative = 0;
+  for (int t=Psychrometrics::MIN_TEMPERATURE; t<Psychrometrics::MAX_TEMPERATURE; t+=5)
+  {
+    for (int h=10; h<=Psychrometrics::MAX_HUMIDITY; h+=10)
+    {
+      double dewPointError = fabs(Psychrometrics::getDewPoint((int16_t)t, (uint16_t)h)/100.0 - getDewPointLibm(t/100.0, h/100.0));
+      double reference = getAbsoluteHumidityLibm(t/100.0, h/100.0);
+      double absoluteError = fabs(Psychrometrics::getAbsoluteHumidity((int16_t)t, (uint16_t)h)/100.0 - reference);
+      maxDewPoint = std::max(maxDewPoint, dewPointError);
+      maxAbsolute = std::max(maxAbsolute, absoluteError);
+      if (reference >= 1)
+      {
+        maxRelative = std::max(maxRelative, absoluteError/reference);
+      }
+    }
+  }
+  printf("psychrometrics max. error vs. libm: dew point %.3f °C, absolute %.3f g/m³ (%.2f%% above 1 g/m³)\n",
+         maxDewPoint, maxAbsolute, 100*maxRelative);
+}
+
+static bool saveResults(const char* path, const Bench& bench)
+{
+  FILE* file = fopen(path, "w");
+  if (!file)
+  {
+    perror(path);
+    return false;
+  }
+  for (const Result& r : bench.getResults())
+  {
+    fprintf(file, "%.2f %.2f %s\n", r.ns, r.instructions, r.name.c_str());
+  }
+  fclose(file);
+  return true;
+}
+
+/**
+ * @return number of regressions, -1 on error
+ */
+static int compareResults(const char* path, const Bench& bench, float tolerance)
+{
+  FILE* file = fopen(path, "r");
+  if (!file)
+  {
+    perror(path);
+    return -1;
+  }
+  std::map<std::string, Result> baseline;
+  char line[256];
+  while (fgets(line, sizeof(line), file))
+  {
+    Result r;
+    int offset = 0;
+    if (sscanf(line, "%lf %lf %n", &r.ns, &r.instructions, &offset) == 2)
+    {
+      r.name = line + offset;
+      while (!r.name.empty() && (r.name.back() == '\n' || r.name.back() == '\r'))
+      {
+        r.name.pop_back();
+      }
+      baseline[r.name] = r;
+    }
+  }
+  fclose(file);
+
+  int regressions = 0;
+  for (const Result& r : bench.getResults())
+  {
+    auto base = baseline.find(r.name);
+    if (base == baseline.end())
+    {
+      continue;
+    }
+    if (base->second.instructions < 0)
+    {
+      fprintf(stderr, "%s: %s saved without instruction count\n", path, r.name.c_str());
+      return -1;
+    }
+    double before = base->second.instructions;
+    double change = before > 0? 100*(r.instructions - before)/before : 0;
+    if (change > tolerance)
+    {
+      printf("REGRESSION %-40s %+6.1f%% instr\n", r.name.c_str(), change);
+      regressions++;
+    }
+  }
+  printf("%d regressions (tolerance %.1f%%)\n", regressions, tolerance);
+  return regressions;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: bench_tool [options]\n"
+    "  -n <count>    iterations per benchmark, default 1000000\n"
+    "  -f <text>     only benchmarks with name containing text\n"
+    "  -s <file>     save results as baseline\n"
+    "  -c <file>     compare instructions with baseline, exit code 1 on regression,\n"
+    "                2 without perf instruction counter\n"
+    "  -t <percent>  regression tolerance, default 5\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:f:s:c:t:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n': options.iterations = atol(optarg); break;
+      case 'f': options.filter = optarg; break;
+      case 's': options.save = optarg; break;
+      case 'c': options.compare = optarg; break;
+      case 't': options.tolerance = atof(optarg); break;
+      default: usage(); return 1;
+    }
+  }
+  if (options.iterations <= 0)
+  {
+    usage();
+    return 1;
+  }
+
+  Bench bench(options);
+  if (!bench.hasInstructions())
+  {
+    if (options.compare)
+    {
+      fprintf(stderr, "perf instruction counter not available (perf_event_paranoid?), cannot compare with baseline\n");
+      return 2;
+    }
+    printf("perf instruction counter not available (perf_event_paranoid?), time only\n");
+  }
+
+  printf("relative host cost per operation, no Cortex-M0+ cycles\n");
+  printf("%-40s %10s %12s\n", "benchmark", "host ns", "host instr");
+  benchMeasurement(bench);
+  benchEncoder(bench);
+  benchDisplay(bench);
+  benchFec(bench);
+  benchPsychrometrics(bench);
+
+  if (options.save && !saveResults(options.save, bench))
+  {
+    return 1;
+  }
+  if (options.compare)
+  {
+    int regressions = compareResults(options.compare, bench, options.tolerance);
+    return regressions < 0? 2 : regressions > 0? 1 : 0;
+  }
+  return 0;
+}
@@ -0,0 +1,137 @@
+/*****************************************************************************
+ *
+ * Compact Frame Decoder
+ *
+ * file:     CompactFrameDecoder.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "../CompactFrame.h"
+
+/**
+ * find and decode compact frames (CompactFrame.h, option HAS_FEC) in a
+ * demodulated bit stream
+ *
+ * The demodulator may lose the first preamble bits, so the sync byte is
+ * searched at each bit offset within the preamble length. It is accepted with
+ * 1 bit error because it is not protected by the code.
+ */
+class CompactFrameDecoder
+{
+public:
+  CompactFrameDecoder() = default;
+
+public:
+  /**
+   * see CompactFrame::setCoding
+   */
+  void setCoding(bool enabled)
+  {
+    frame.setCoding(enabled);
+  }
+
+  /**
+   * see CompactFrame::setInterleaving
+   */
+  void setInterleaving(bool enabled)
+  {
+    frame.setInterleaving(enabled);
+  }
+
+  /**
+   * if enabled least significant bit of each byte is received first, default enabled
+   */
+  void setLsbFirst(bool enabled)
+  {
+    lsbFirst = enabled;
+  }
+
+  /**
+   * @param bits bit stream in air order
+   * @param data decoded values
+   * @return true if a frame with valid CRC was found
+   */
+  bool decodeBits(const std::vector<bool>& bits, CompactFrame::Data& data)
+  {
+    // search sync in preamble range, bit errors in the preamble are tolerated
+    byte codeSize = frame.getCodeSize();
+    for (size_t offset = 0; offset <= 8*(CompactFrame::PREAMBLE_SIZE + 1) && offset + 8*(1 + codeSize) <= bits.size(); offset++)
+    {
+      if (distance(getByte(bits, offset), CompactFrame::SYNC) > 1)
+      {
+        continue;
+      }
+      byte code[CompactFrame::CODE_SIZE];
+      for (byte i=0; i<codeSize; i++)
+      {
+        code[i] = getByte(bits, offset + 8*(1 + i));
+      }
+      if (frame.decode(code, data))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @return number of code bits corrected in last decoded frame
+   */
+  byte getCorrected() const
+  {
+    return frame.getCorrected();
+  }
+
+private:
+  byte getByte(const std::vector<bool>& bits, size_t offset) const
+  {
+    byte b = 0;
+    for (byte j=0; j<8; j++)
+    {
+      if (bits[offset + j])
+      {
+        b |= lsbFirst? (1 << j) : (0x80 >> j);
+      }
+    }
+    return b;
+  }
+
+  static byte distance(byte a, byte b)
+  {
+    byte d = 0;
+    for (byte x = a ^ b; x; x >>= 1)
+    {
+      d += x & 1;
+    }
+    return d;
+  }
+
+private:
+  CompactFrame frame;
+  bool lsbFirst = true;
+};
@@ -0,0 +1,132 @@
+/*****************************************************************************
+ *
+ * List and Validate the SolarDHT Deployment Variants
+ *
+ * file:     ConfigTool.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o config_tool ConfigTool.cpp
+ *
+ * usage:
+ *   ./config_tool                  (list variants with options)
+ *   ./config_tool -n               (variant names, one per line)
+ *   ./config_tool -f transmitter   (build flags of variant, used by footprint.sh)
+ *
+ * All variants of SOLARDHT_VARIANTS are validated at compile time.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+#include "ArduinoHost.h"
+#include "../SolarDHTConfig.h"
+
+static constexpr unsigned VARIANTS = sizeof(SOLARDHT_VARIANTS)/sizeof(SOLARDHT_VARIANTS[0]);
+
+static constexpr bool allValid(unsigned i = 0)
+{
+  return i >= VARIANTS || (SOLARDHT_VARIANTS[i]->isValid() && allValid(i + 1));
+}
+
+static_assert(allValid(), "invalid deployment variant in SOLARDHT_VARIANTS");
+
+static void printFlags(const SolarDHTConfig& c)
+{
+  printf("-DHAS_RADIO=%d -DHAS_DISPLAY=%d -DHAS_DHT_SENSOR=%d -DHAS_DOWNLINK=%d -DHAS_FLASH_LOG=%d -DHAS_HISTORY=%d "
+         "-DHAS_CLOCK_SCALING=%d -DHAS_ENERGY_METER=%d -DHAS_ADC_SEQUENCE=%d -DHAS_SENSOR_HUB=%d -DHAS_FEC=%d "
+         "-DHAS_RUNTIME_ESTIMATE=%d -DHAS_RADIO_MEASUREMENT=%d -DHAS_RAMFUNC=%d -DHAS_FONT_SUBSET=%d -DSAMPLE_PERIOD=%uUL "
+         "-DTRANSMIT_REPEATS=%u\n",
+         c.radio, c.display, c.sensor, c.downlink, c.flashLog, c.history, c.clockScaling, c.energyMeter, c.adcSequence, c.sensorHub,
+         c.fec, c.runtimeEstimate, c.radioMeasurement, c.ramfunc, c.fontSubset, (unsigned)c.samplePeriod, c.transmitRepeats);
+}
+
+static void printVariant(const SolarDHTConfig& c)
+{
+  static const char* RADIOS[] = { "none", "Si4432", "SYN115" };
+  static const char* SENSORS[] = { "none", "Si7021", "HDC1080" };
+  printf("%-14s %-7s %-7s %-8s %-8s %-5s %-7s %-7s %-6s %-6s %-4s %-4s %-7s %-4s %-7s %-4s %6u %u\n", c.name, RADIOS[c.radio],
+         c.display? "yes" : "-", SENSORS[c.sensor], c.downlink? "yes" : "-", c.flashLog? "yes" : "-", c.history? "yes" : "-",
+         c.clockScaling? "yes" : "-", c.energyMeter? "yes" : "-", c.adcSequence? "yes" : "-", c.sensorHub? "yes" : "-",
+         c.fec? "yes" : "-", c.runtimeEstimate? "yes" : "-", c.radioMeasurement? "yes" : "-", c.ramfunc? "yes" : "-",
+         c.fontSubset? "yes" : "-", (unsigned)c.samplePeriod/1000, c.transmitRepeats);
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: config_tool [options]\n"
+    "  -n         variant names\n"
+    "  -f <name>  build flags of variant\n");
+}
+
+int main(int argc, char* argv[])
+{
+  const char* flagsOf = nullptr;
+  bool names = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "nf:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n': names = true; break;
+      case 'f': flagsOf = optarg; break;
+      default: usage(); return 1;
+    }
+  }
+
+  if (flagsOf)
+  {
+    for (const SolarDHTConfig* c : SOLARDHT_VARIANTS)
+    {
+      if (!strcmp(c->name, flagsOf))
+      {
+        printFlags(*c);
+        return 0;
+      }
+    }
+    fprintf(stderr, "unknown variant %s\n", flagsOf);
+    return 1;
+  }
+
+  if (names)
+  {
+    for (const SolarDHTConfig* c : SOLARDHT_VARIANTS)
+    {
+      printf("%s\n", c->name);
+    }
+    return 0;
+  }
+
+  printf("%-14s %-7s %-7s %-8s %-8s %-5s %-7s %-7s %-6s %-6s %-4s %-4s %-7s %-4s %-7s %-4s %6s %s\n", "variant", "radio", "display",
+         "sensor", "downlink", "flash", "history", "scaling", "energy", "adcseq", "hub", "fec", "runtime", "meas", "ramfunc", "font",
+         "sample", "repeats");
+  for (const SolarDHTConfig* c : SOLARDHT_VARIANTS)
+  {
+    printVariant(*c);
+  }
+  return 0;
+}
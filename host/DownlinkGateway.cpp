@@ -0,0 +1,250 @@
+/*****************************************************************************
+ *
+ * Gateway Stand-in for Downlink Configuration Frames
+ *
+ * file:     DownlinkGateway.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o downlink_gateway DownlinkGateway.cpp
+ *
+ * usage:
+ *   ./downlink_gateway -k <key> -r 5A -s 7 -p 300 -P 2 -t now   (print frame as hex)
+ *   ./downlink_gateway -r 5A -s 7 -p 300 -L 1000 -e 1e-3         (simulated link)
+ *
+ * The key is the build flag DOWNLINK_KEY of the firmware as 32 hex digits,
+ * e.g. -DDOWNLINK_KEY=0x01234567,0x89ABCDEF,0x01234567,0x89ABCDEF is
+ * -k 0123456789ABCDEF0123456789ABCDEF.
+ *
+ * The simulated link runs the node side of the protocol (Downlink::parse and
+ * the RX window timing of SolarDHT) against the gateway over a channel with
+ * random bit errors, gateway reaction latency and replayed frames, with a
+ * random key if none is given.
+ */
+
+#include <cstdio>
+#include <ctime>
+#include <random>
+#include <unistd.h>
+
+#include "ArduinoHost.h"
+#include "../Downlink.h"
+
+struct LinkOptions
+{
+  uint32_t trials = 0;
+  double bitErrorRate = 0;
+  uint32_t rxWindow = 5;       // [ms] DOWNLINK_RX_WINDOW
+  uint32_t maxLatency = 8;     // [ms] gateway reaction time after end of uplink frame
+  uint32_t rxEvery = 10;       // DOWNLINK_RX_EVERY
+};
+
+static bool parseKey(const char* hex, uint32_t key[4])
+{
+  if (strlen(hex) != 32)
+  {
+    return false;
+  }
+  for (byte i=0; i<4; i++)
+  {
+    char word[9] = {};
+    memcpy(word, hex + 8*i, 8);
+    key[i] = strtoul(word, nullptr, 16);
+  }
+  return true;
+}
+
+/**
+ * node side: RX window every n-th wakeup, frame must arrive within window and pass verification
+ */
+static void simulateLink(const uint32_t key[4], byte rollingCode, uint16_t sequence, const Downlink::Config& config, const LinkOptions& options)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> uniform(0, 1);
+
+  Downlink gateway(key[0], key[1], key[2], key[3]);
+  Downlink node(key[0], key[1], key[2], key[3]);
+
+  uint32_t wakeups = 0, windows = 0, preambles = 0, accepted = 0, corrupted = 0, replays = 0, replaysAccepted = 0;
+  byte lastFrame[Downlink::MAX_FRAME_SIZE];
+  byte lastSize = 0;
+  for (uint32_t t=0; t<options.trials; t++)
+  {
+    // gateway answers each uplink frame with a new sequence number
+    byte frame[Downlink::MAX_FRAME_SIZE];
+    byte size = gateway.create(rollingCode, sequence + t, config, frame);
+
+    wakeups++;
+    if (wakeups % options.rxEvery)
+    {
+      continue;
+    }
+    windows++;
+
+    // gateway preamble must start within RX window
+    if (uniform(rng)*options.maxLatency > options.rxWindow)
+    {
+      continue;
+    }
+    preambles++;
+
+    // channel with random bit errors
+    bool errors = false;
+    for (byte i=0; i<size; i++)
+    {
+      for (byte b=0; b<8; b++)
+      {
+        if (uniform(rng) < options.bitErrorRate)
+        {
+          frame[i] ^= 1 << b;
+          errors = true;
+        }
+      }
+    }
+    corrupted += errors;
+
+    Downlink::Config received;
+    if (node.parse(frame, size, rollingCode, received))
+    {
+      accepted++;
+      if (received.present != config.present)
+      {
+        printf("error: config mismatch\n");
+      }
+    }
+
+    // replay previous frame, must be rejected
+    if (lastSize)
+    {
+      replays++;
+      replaysAccepted += node.parse(lastFrame, lastSize, rollingCode, received);
+    }
+    memcpy(lastFrame, frame, size);
+    lastSize = size;
+  }
+
+  printf("wakeups:          %u\n", wakeups);
+  printf("RX windows:       %u\n", windows);
+  printf("preamble in time: %u\n", preambles);
+  printf("corrupted:        %u\n", corrupted);
+  printf("accepted:         %u\n", accepted);
+  printf("replays accepted: %u/%u\n", replaysAccepted, replays);
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: downlink_gateway [options]\n"
+    "  -k <hex>   128 bit key (32 hex digits) of build flag DOWNLINK_KEY, required for frames\n"
+    "  -r <hex>   rolling code of target node\n"
+    "  -s <n>     sequence number\n"
+    "  -p <s>     transmit period\n"
+    "  -P <n>     TX power 0 .. 7\n"
+    "  -v <mV>    low supply voltage threshold\n"
+    "  -T <n>     display temperature delta [0.1 °C]\n"
+    "  -U <n>     display humidity delta [%%]\n"
+    "  -t <s>     time [s since epoch] or 'now'\n"
+    "  -w <n>     downlink RX window every n-th wakeup\n"
+    "  -H <n>     transmit n most recent history blocks (maintenance mode)\n"
+    "  -L <n>     simulate link with n uplink frames instead of printing the frame\n"
+    "  -e <ber>   bit error rate of simulated link\n");
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t key[4] = {};
+  bool hasKey = false;
+  byte rollingCode = 0x12;
+  uint16_t sequence = 1;
+  Downlink::Config config;
+  LinkOptions link;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "k:r:s:p:P:v:T:U:t:w:H:L:e:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'k':
+        if (!parseKey(optarg, key)) { usage(); return 1; }
+        hasKey = true;
+        break;
+      case 'r': rollingCode = strtoul(optarg, nullptr, 16); break;
+      case 's': sequence = atoi(optarg); break;
+      case 'p': config.period = atoi(optarg); config.present |= 1 << Downlink::TAG_PERIOD; break;
+      case 'P': config.txPower = atoi(optarg); config.present |= 1 << Downlink::TAG_TX_POWER; break;
+      case 'v': config.supplyLow = atoi(optarg); config.present |= 1 << Downlink::TAG_SUPPLY_LOW; break;
+      case 'T': config.displayTemp = atoi(optarg); config.present |= 1 << Downlink::TAG_DISPLAY_TEMP; break;
+      case 'U': config.displayHum = atoi(optarg); config.present |= 1 << Downlink::TAG_DISPLAY_HUM; break;
+      case 't':
+        config.time = strcmp(optarg, "now")? strtoul(optarg, nullptr, 10) : (uint32_t)time(nullptr);
+        config.present |= 1 << Downlink::TAG_TIME;
+        break;
+      case 'w':
+        config.rxEvery = atoi(optarg); config.present |= 1 << Downlink::TAG_RX_EVERY;
+        link.rxEvery = config.rxEvery? config.rxEvery : 1;
+        break;
+      case 'H': config.historyBlocks = atoi(optarg); config.present |= 1 << Downlink::TAG_HISTORY; break;
+      case 'L': link.trials = atoi(optarg); break;
+      case 'e': link.bitErrorRate = atof(optarg); break;
+      default: usage(); return 1;
+    }
+  }
+
+  if (link.trials)
+  {
+    if (!hasKey)
+    {
+      std::random_device random;
+      for (uint32_t& k : key)
+      {
+        k = random();
+      }
+    }
+    simulateLink(key, rollingCode, sequence, config, link);
+    return 0;
+  }
+
+  if (!hasKey)
+  {
+    fprintf(stderr, "error: key of the deployment (-k) required\n");
+    return 1;
+  }
+
+  Downlink gateway(key[0], key[1], key[2], key[3]);
+  byte frame[Downlink::MAX_FRAME_SIZE];
+  byte size = gateway.create(rollingCode, sequence, config, frame);
+  if (!size)
+  {
+    fprintf(stderr, "error: config items exceed frame size\n");
+    return 1;
+  }
+  for (byte i=0; i<size; i++)
+  {
+    printf("%02X", frame[i]);
+  }
+  printf("\n");
+
+  return 0;
+}
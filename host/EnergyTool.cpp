@@ -0,0 +1,498 @@
+/*****************************************************************************
+ *
+ * Estimate Charge per Wakeup with and without CPU Clock Scaling
+ *
+ * file:     EnergyTool.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o energy_tool EnergyTool.cpp
+ *
+ * usage:
+ *   ./energy_tool                  (compare fixed and scaled CPU clock for the Si4432 wakeup cycle)
+ *   ./energy_tool -d 0.1 -t 18     (display update every 10th wakeup, 18 mA TX current)
+ *   ./energy_tool -v               (charge per phase)
+ *   ./energy_tool -s 30            (sample-only wakeups every 30 s between transmissions)
+ *   ./energy_tool -R 1             (each frame repeated once in the same radio session)
+ *
+ * The phases follow SolarDHT::wakeupInterrupt() and transmitSensorData().
+ * Cycle counts are estimates for the Cortex-M0+ with soft float, peripheral
+ * currents are rounded datasheet values. Calibrate both with a bench meter.
+ * The e-paper refresh after rendering does not depend on the CPU clock and is
+ * not included.
+ *
+ * The dual rate table compares sample-only wakeups (sensor without radio,
+ * SAMPLE_PERIOD) between transmit wakeups with transmitting every sample and
+ * with transmitting every period only, using the scaled 48/low clocks.
+ *
+ * The repetition table compares repeating the frame in the same radio
+ * session (TRANSMIT_REPEATS, radio standby and CPU idle during the random
+ * gap) with a radio restart (start-up, config, encode, transmit) per copy.
+ *
+ * The RAM execution table compares the wakeup hot path (RAMFUNC) in flash and
+ * in RAM, each with and without flash power reduction in IDLE2. Wait states,
+ * flash read and idle currents are estimates (EnergyModel::Parameters), the
+ * firmware prints the encoder cycles with DEBUG (CY:) for calibration.
+ *
+ * The peak current table plans the high current loads of a transmit wakeup
+ * with display update (PowerArbiter::plan) for several PEAK_CURRENT_BUDGET
+ * values: start times, max. sum of concurrent load currents and the MCU idle
+ * charge of the longer awake time. The sensor heater is not used by the
+ * firmware and shows how a third load is staggered.
+ *
+ * The supply measurement table compares the sources of the supply voltage
+ * (and of the fallback temperature without sensor) on transmit wakeups:
+ * blocking SAMD21 ADC reads at wakeup, the ADC sequence converting while the
+ * radio starts (HAS_ADC_SEQUENCE) and the Si4432 battery detector and ADC
+ * converting during the sensor read (HAS_RADIO_MEASUREMENT). ADC times and
+ * currents are estimates.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "ArduinoHost.h"
+#include "../EnergyModel.h"
+#include "../PowerArbiter.h"
+#include "../TransmitSchedule.h"
+
+struct Options
+{
+  float period = 180;       // [s]
+  float displayRatio = 0.2; // fraction of wakeups with display update
+  float airTime = 108;      // [ms] Oregon Scientific frame at 1.4 kbit/s
+  float txCurrent = 28;     // [mA] Si4432 OOK average at 4 dBm (README: 11 mJ per wakeup)
+  float lowClock = 1;       // [MHz] OSC8M / CLOCK_LOW_DIVIDER
+  float voltage = 3.0;      // [V]
+  float samplePeriod = 60;  // [s] sample-only wakeups
+  unsigned repeats = 0;     // frame repetitions per radio session
+  bool verbose = false;
+};
+
+enum PhaseIndex
+{
+  PHASE_WAKEUP,
+  PHASE_STARTUP,
+  PHASE_CONFIG,
+  PHASE_ENCODE,
+  PHASE_RENDER,
+  PHASE_TX,
+  PHASE_REPEAT,
+  PHASE_SHUTDOWN,
+  PHASES
+};
+
+enum SamplePhaseIndex
+{
+  SAMPLE_WAKEUP,
+  SAMPLE_ACQUISITION,
+  SAMPLE_READ,
+  SAMPLE_SHUTDOWN,
+  SAMPLE_PHASES
+};
+
+static void buildPhases(const Options& options, EnergyModel::Phase phases[PHASES])
+{
+  const float RADIO_READY = 0.85;  // [mA] Si4432 crystal running
+  const float SENSOR = 0.19;       // [mA] HDC1080 conversion
+  const float GAP = (TransmitSchedule::MIN_REPEAT_GAP + TransmitSchedule::MAX_REPEAT_GAP)/2.0f; // [ms] average
+  float repeat = options.repeats*(GAP + options.airTime);
+  const float RADIO_STANDBY = 0.001; // [mA] Si4432 configured, crystal off
+  float repeatCurrent = repeat > 0? options.repeats*(GAP*RADIO_STANDBY + options.airTime*options.txCurrent)/repeat : 0;
+
+  // ram: fraction of cycles in RAMFUNC code, the drivers (SPI, I2C, RTC) stay in flash
+  //                      name              [ms]            cycles                            [mA]                       compute overlap ram
+  phases[PHASE_WAKEUP]   = { "wakeup",       0.3,            12000,                            0,                         false, true,   0.5 };
+  phases[PHASE_STARTUP]  = { "radio start",  17,             4000,                             RADIO_READY/2 + SENSOR,    false, false,  0   };
+  phases[PHASE_CONFIG]   = { "config+read",  0.8,            45000,                            RADIO_READY,               true,  false,  0.3 };
+  phases[PHASE_ENCODE]   = { "encode",       0,              15000,                            RADIO_READY,               true,  false,  1   };
+  phases[PHASE_RENDER]   = { "render",       0,              1200000*options.displayRatio,     0,                         true,  true,   0   };
+  phases[PHASE_TX]       = { "transmit",     options.airTime, 3000,                            options.txCurrent,         false, false,  0   };
+  phases[PHASE_REPEAT]   = { "repeat",       repeat,         3000.0f*options.repeats,          repeatCurrent,             false, false,  0   };
+  phases[PHASE_SHUTDOWN] = { "shutdown",     0.2,            8000,                             0,                         true,  false,  0   };
+}
+
+/**
+ * sample-only wakeup: no radio, sensor conversion with the CPU in IDLE2 at
+ * low clock (TC5 wait of SolarDHT::waitForAcquisition()), read at high
+ * clock, no display update and no flash
+ */
+static void buildSamplePhases(EnergyModel::Phase phases[SAMPLE_PHASES])
+{
+  const float SENSOR = 0.19;       // [mA] HDC1080 conversion
+  const float ACQUISITION = 9;     // [ms] HDC1080 11 bit temperature and humidity 7.5 ms + 1.5 ms margin
+
+  //                          name              [ms]         cycles  [mA]    compute overlap ram
+  phases[SAMPLE_WAKEUP]      = { "wakeup",       0.3,         12000,  0,      false, true,   0.5 };
+  phases[SAMPLE_ACQUISITION] = { "acquisition",  ACQUISITION, 4000,   SENSOR, false, false,  0   };
+  phases[SAMPLE_READ]        = { "read",         0.6,         30000,  0,      true,  false,  0.3 };
+  phases[SAMPLE_SHUTDOWN]    = { "shutdown",     0.2,         8000,   0,      true,  false,  0   };
+}
+
+static void printDualRate(const Options& options, const EnergyModel::Phase* phases, const EnergyModel::Clocks& clocks)
+{
+  EnergyModel model;
+  EnergyModel::Phase samplePhases[SAMPLE_PHASES];
+  buildSamplePhases(samplePhases);
+
+  float period = options.period*1000;        // [ms]
+  float sample = options.samplePeriod*1000;  // [ms]
+  float transmitCharge = model.evaluate(phases, PHASES, clocks).getCharge();
+  float sampleCharge = model.evaluate(samplePhases, SAMPLE_PHASES, clocks).getCharge();
+  float standby = model.parameters.standby;
+
+  struct Rate
+  {
+    char name[32];
+    float transmitPeriod; // [ms]
+    float samplePeriod;   // [ms]
+  };
+  Rate rates[3] = {
+    { "", period, period },
+    { "", sample, sample },
+    { "", period, sample },
+  };
+  snprintf(rates[0].name, sizeof(rates[0].name), "tx every %.0f s", options.period);
+  snprintf(rates[1].name, sizeof(rates[1].name), "tx every %.0f s", options.samplePeriod);
+  snprintf(rates[2].name, sizeof(rates[2].name), "sample %.0f s, tx %.0f s", options.samplePeriod, options.period);
+
+  printf("\ndual rate (scaled 48/low): transmit wakeup %.1f µJ, sample-only wakeup %.1f µJ\n",
+         transmitCharge*options.voltage, sampleCharge*options.voltage);
+  printf("%-24s %9s %9s %8s %9s\n", "schedule", "samples/h", "tx/h", "avg", "vs. tx");
+  printf("%-24s %9s %9s %8s %9s\n", "", "", "", "[µA]", "every");
+
+  // reference: transmit each sample at the sample rate
+  float reference = (transmitCharge + sample*standby)/sample;
+  for (const Rate& rate : rates)
+  {
+    // charge per transmit period: 1 transmit wakeup, sample-only wakeups in between, standby
+    float samples = rate.transmitPeriod/rate.samplePeriod;
+    float charge = transmitCharge + (samples - 1)*sampleCharge + rate.transmitPeriod*standby;
+    float current = charge/rate.transmitPeriod;
+    printf("%-24s %9.0f %9.0f %8.2f %8.0f%%\n", rate.name, 3600000/rate.samplePeriod, 3600000/rate.transmitPeriod,
+           1000*current, 100*current/reference);
+  }
+}
+
+static void printResult(const char* name, const EnergyModel::Result& r, const Options& options, float reference)
+{
+  float charge = r.getCharge();
+  printf("%-18s %8.1f %8.2f %9.1f %9.1f %9.1f %8.1f %6.1f%% %4u\n", name, r.awake, r.active, r.mcu, r.peripheral,
+         charge*options.voltage, charge/options.period, 100*(reference - charge)/reference, r.switches);
+}
+
+static void printRepetition(const Options& options, const char* name, const EnergyModel::Clocks& clocks)
+{
+  EnergyModel model;
+  Options o = options;
+  o.repeats = 0;
+  o.displayRatio = 0;
+  EnergyModel::Phase phases[PHASES];
+  buildPhases(o, phases);
+  phases[PHASE_STARTUP].peripheral -= 0.19; // no sensor acquisition
+  float restart = model.evaluate(phases, PHASES, clocks).getCharge();
+
+  printf("\nrepetition (%s, gap %u..%u ms), radio restart per copy %.1f µJ\n", name, TransmitSchedule::MIN_REPEAT_GAP,
+         TransmitSchedule::MAX_REPEAT_GAP, restart*options.voltage);
+  printf("%-8s %9s %8s %9s %9s\n", "repeats", "wakeup", "avg", "same", "restart");
+  printf("%-8s %9s %8s %9s %9s\n", "", "[µJ]", "[µA]", "session", "radio");
+  float single = 0;
+  for (unsigned repeats=0; repeats<=3; repeats++)
+  {
+    o = options;
+    o.repeats = repeats;
+    buildPhases(o, phases);
+    float charge = model.evaluate(phases, PHASES, clocks, options.period*1000).getCharge();
+    if (!repeats)
+    {
+      single = charge;
+    }
+    // additional charge relative to a single frame
+    printf("%-8u %9.1f %8.2f %8.0f%% %8.0f%%\n", repeats, charge*options.voltage, charge/options.period,
+           100*(charge - single)/single, 100*repeats*restart/single);
+  }
+}
+
+/**
+ * execution of the RAMFUNC hot path from RAM (HAS_RAMFUNC) and flash power
+ * reduction in sleep (NVM_SLEEP_POWER_DOWN)
+ */
+static void printRamExecution(const Options& options, const char* name, const EnergyModel::Clocks& clocks)
+{
+  EnergyModel model;
+  EnergyModel::Phase phases[PHASES];
+  buildPhases(options, phases);
+
+  float cycles = 0, ramCycles = 0;
+  for (const EnergyModel::Phase& phase : phases)
+  {
+    cycles += phase.cycles;
+    ramCycles += phase.cycles*phase.ram;
+  }
+
+  struct Variant
+  {
+    const char* name;
+    bool ramCode;
+    bool nvmAwake;
+  };
+  const Variant variants[] = {
+    { "flash, NVM awake", false, true },
+    { "flash",            false, false },
+    { "RAM, NVM awake",   true,  true },
+    { "RAM",              true,  false },
+  };
+
+  printf("\nRAM execution (%s), %.0f of %.0f cycles per wakeup in RAMFUNC code, flash stall %.0f%%\n", name, ramCycles, cycles,
+         100*model.parameters.flashStall);
+  printf("%-18s %9s %8s %9s %8s %7s\n", "code, NVM in sleep", "active", "awake", "wakeup", "avg", "saved");
+  printf("%-18s %9s %8s %9s %8s %7s\n", "", "[ms]", "[ms]", "[µJ]", "[µA]", "");
+  float reference = 0;
+  for (const Variant& variant : variants)
+  {
+    EnergyModel::Clocks c = clocks;
+    c.ramCode = variant.ramCode;
+    c.nvmAwake = variant.nvmAwake;
+    EnergyModel::Result result = model.evaluate(phases, PHASES, c, options.period*1000);
+    float charge = result.getCharge();
+    if (reference == 0)
+    {
+      reference = charge;
+    }
+    printf("%-18s %9.3f %8.2f %9.1f %8.3f %6.2f%%\n", variant.name, result.active, result.awake, charge*options.voltage,
+           charge/options.period, 100*(reference - charge)/reference);
+  }
+}
+
+/**
+ * order of radio, display refresh and sensor heater under a peak current budget (PEAK_CURRENT_BUDGET)
+ */
+static void printPeakCurrent(const Options& options, const EnergyModel::Clocks& clocks)
+{
+  const float DISPLAY_PEAK = 6.0;  // [mA] DISPLAY_PEAK_CURRENT, partial refresh 1500 ms
+  const float RENDER = 25;         // [ms] display content, overlaps transmit
+  const float SPI_TRANSFER = 15;   // [ms] display reset and page image
+  const float RX_WINDOW = 5;       // [ms] DOWNLINK_RX_WINDOW
+  const float RX_CURRENT = 18.5;   // [mA] Si4432 RX
+  const float HEATER = 9.5;        // [mA] SHT2x heater, level 1
+
+  // time 0 is the start of the transmission
+  const PowerArbiter::Load loads[] = {
+    // name       [mA]               [ms]             hold [ms]        ready [ms]
+    { "transmit", options.txCurrent, options.airTime, options.airTime, 0               },
+    { "RX",       RX_CURRENT,        RX_WINDOW,       RX_WINDOW,       options.airTime },
+    { "display",  DISPLAY_PEAK,      1500,            SPI_TRANSFER,    RENDER          },
+    { "heater",   HEATER,            1000,            0.5,             0               },
+  };
+  const byte LOADS = sizeof(loads)/sizeof(loads[0]);
+  const float budgets[] = { 0, 50, 40, 30, 20 };
+
+  EnergyModel model;
+  const EnergyModel::Parameters& p = model.parameters;
+  float idle = p.idleBase + p.idlePerMHz*clocks.low + (clocks.dfll? p.dfll : 0); // [mA]
+
+  printf("\npeak current (transmit %.0f mA %.0f ms, RX %.1f mA %.0f ms, display %.0f mA, heater %.1f mA)\n", options.txCurrent,
+         options.airTime, RX_CURRENT, RX_WINDOW, DISPLAY_PEAK, HEATER);
+  printf("%-8s %7s %8s %8s %8s  %s\n", "budget", "peak", "awake", "end", "extra", "start [ms]");
+  printf("%-8s %7s %8s %8s %8s ", "[mA]", "[mA]", "[ms]", "[ms]", "[µJ]");
+  for (const PowerArbiter::Load& load : loads)
+  {
+    printf(" %8s", load.name);
+  }
+  printf("\n");
+  float reference = 0;
+  for (float budget : budgets)
+  {
+    PowerArbiter::Plan plan = PowerArbiter::plan(loads, LOADS, budget);
+    if (budget == 0)
+    {
+      reference = plan.awake;
+      printf("%-8s", "none");
+    }
+    else
+    {
+      printf("%-8.0f", budget);
+    }
+    printf(" %7.1f %8.1f %8.0f %8.1f ", plan.peak, plan.awake, plan.end, (plan.awake - reference)*idle*options.voltage);
+    for (byte i=0; i<LOADS; i++)
+    {
+      printf(" %8.1f", plan.start[i]);
+    }
+    printf("\n");
+  }
+}
+
+/**
+ * supply voltage and fallback temperature from SAMD21 ADC or Si4432 (HAS_RADIO_MEASUREMENT)
+ */
+static void printSupplyMeasurement(const Options& options, const EnergyModel::Clocks& clocks)
+{
+  const float ADC_CURRENT = 0.35;  // [mA] SAMD21 ADC and bandgap reference, estimate
+  const float ADC_READ = 1.0;      // [ms] blocking read incl. reference start-up, per input, estimate
+  const float ADC_SEQUENCE = 0.25; // [ms] DMA sequence per input, overlaps radio start-up
+  const float LBD_TIME = 0.25;     // [ms] Si4432 battery voltage
+  const float RADIO_ADC = 0.4;     // [ms] Si4432 temperature conversion, LBD in parallel
+  const float SENSOR_READ = 0.6;   // [ms] sensor read after radio config, overlaps the Si4432 conversion
+
+  struct Variant
+  {
+    const char* name;
+    byte phase;       // phase executing the additional cycles
+    float cycles;     // additional CPU cycles per input
+    float blocking;   // [ms] SAMD21 ADC blocking at wakeup per input
+    float sequence;   // [ms] SAMD21 ADC overlapping radio start-up per input
+    float radio;      // [ms] Si4432 supply voltage conversion
+    float radioTemp;  // [ms] Si4432 supply voltage and temperature conversion
+  };
+  const Variant variants[] = {
+    { "SAMD21 ADC",   PHASE_WAKEUP,  1500, ADC_READ, 0,            0,        0         },
+    { "ADC sequence", PHASE_STARTUP, 800,  0,        ADC_SEQUENCE, 0,        0         },
+    { "Si4432",       PHASE_CONFIG,  1200, 0,        0,            LBD_TIME, RADIO_ADC }, // SPI register access
+  };
+
+  EnergyModel model;
+  printf("\nsupply measurement (transmit wakeup, ADC %.2f mA)\n", ADC_CURRENT);
+  printf("%-14s %17s  %17s\n", "", "with sensor", "without sensor");
+  printf("%-14s %8s %8s  %8s %8s\n", "source", "awake", "wakeup", "awake", "wakeup");
+  printf("%-14s %8s %8s  %8s %8s\n", "", "[ms]", "[µJ]", "[ms]", "[µJ]");
+  for (const Variant& variant : variants)
+  {
+    printf("%-14s", variant.name);
+    for (int inputs=1; inputs<=2; inputs++)
+    {
+      // 1 input: supply voltage, 2 inputs: supply voltage and temperature without sensor
+      EnergyModel::Phase phases[PHASES];
+      buildPhases(options, phases);
+      EnergyModel::Phase& wakeup = phases[PHASE_WAKEUP];
+      EnergyModel::Phase& startup = phases[PHASE_STARTUP];
+      EnergyModel::Phase& config = phases[PHASE_CONFIG];
+      float adc = inputs*variant.blocking;
+      wakeup.peripheral = (wakeup.peripheral*wakeup.duration + adc*ADC_CURRENT)/(wakeup.duration + adc);
+      wakeup.duration += adc;
+      startup.peripheral += ADC_CURRENT*inputs*variant.sequence/startup.duration;
+      phases[variant.phase].cycles += inputs*variant.cycles;
+      float overlap = SENSOR_READ;
+      if (inputs > 1)
+      {
+        // no sensor conversion and read, only encoding overlaps the Si4432 conversion
+        startup.peripheral -= 0.19;
+        config.duration -= SENSOR_READ;
+        overlap = phases[PHASE_ENCODE].cycles/(1000*clocks.high);
+      }
+      float radio = inputs > 1? variant.radioTemp : variant.radio;
+      config.duration += radio > overlap? radio - overlap : 0;
+      EnergyModel::Result result = model.evaluate(phases, PHASES, clocks, options.period*1000);
+      float charge = result.getCharge();
+      printf(" %8.2f %8.1f ", result.awake, charge*options.voltage);
+    }
+    printf("\n");
+  }
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: energy_tool [options]\n"
+    "  -p <s>     wakeup period, default 180\n"
+    "  -d <r>     fraction of wakeups with display update, default 0.2\n"
+    "  -a <ms>    air time, default 108\n"
+    "  -t <mA>    average TX current, default 28\n"
+    "  -l <MHz>   low CPU clock, default 1\n"
+    "  -V <V>     supply voltage, default 3.0\n"
+    "  -s <s>     sample period of dual rate table, default 60\n"
+    "  -R <n>     frame repetitions per radio session, default 0\n"
+    "  -v         charge per phase\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int opt;
+  while ((opt = getopt(argc, argv, "p:d:a:t:l:V:s:R:vh")) != -1)
+  {
+    switch (opt)
+    {
+      case 'p': options.period = atof(optarg); break;
+      case 'd': options.displayRatio = atof(optarg); break;
+      case 'a': options.airTime = atof(optarg); break;
+      case 't': options.txCurrent = atof(optarg); break;
+      case 'l': options.lowClock = atof(optarg); break;
+      case 'V': options.voltage = atof(optarg); break;
+      case 's': options.samplePeriod = atof(optarg); break;
+      case 'R': options.repeats = atoi(optarg); break;
+      case 'v': options.verbose = true; break;
+      default: usage(); return 1;
+    }
+  }
+  if (options.period <= 0 || options.lowClock <= 0 || options.samplePeriod <= 0 || options.samplePeriod > options.period)
+  {
+    usage();
+    return 1;
+  }
+
+  EnergyModel model;
+  EnergyModel::Phase phases[PHASES];
+  buildPhases(options, phases);
+
+  struct Config
+  {
+    const char* name;
+    EnergyModel::Clocks clocks;
+  };
+  const Config configs[] = {
+    { "fixed 48 MHz",     { 48, 48, false, true, false, false } },
+    { "fixed 8 MHz",      { 8, 8, false, false, false, false } },
+    { "scaled 48/low",    { 48, options.lowClock, true, true, false, false } },
+    { "scaled 8/low",     { 8, options.lowClock, true, false, false, false } },
+  };
+
+  float reference = model.evaluate(phases, PHASES, configs[0].clocks, options.period*1000).getCharge();
+  printf("%-18s %8s %8s %9s %9s %9s %8s %7s %4s\n", "config", "awake", "active", "MCU", "periph", "wakeup", "avg", "saved", "sw");
+  printf("%-18s %8s %8s %9s %9s %9s %8s %7s %4s\n", "", "[ms]", "[ms]", "[µC]", "[µC]", "[µJ]", "[µA]", "", "");
+  for (const Config& config : configs)
+  {
+    float charge[PHASES];
+    EnergyModel::Result result = model.evaluate(phases, PHASES, config.clocks, options.period*1000, charge);
+    printResult(config.name, result, options, reference);
+    if (options.verbose)
+    {
+      for (int i=0; i<PHASES; i++)
+      {
+        printf("  %-16s %5.0f MHz %9.1f µC\n", phases[i].name, EnergyModel::getClock(phases[i], config.clocks), charge[i]);
+      }
+      printf("  %-16s %9s %9.1f µC\n", "standby", "", result.standby);
+    }
+  }
+
+  printDualRate(options, phases, configs[2].clocks);
+  printRepetition(options, configs[2].name, configs[2].clocks);
+  printRepetition(options, configs[3].name, configs[3].clocks);
+  printRamExecution(options, configs[2].name, configs[2].clocks);
+  printPeakCurrent(options, configs[2].clocks);
+  printSupplyMeasurement(options, configs[2].clocks);
+
+  return 0;
+}
@@ -0,0 +1,353 @@
+/*****************************************************************************
+ *
+ * Channel Simulation of the Compact Frame with Forward Error Correction
+ *
+ * file:     FecTool.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o fec_tool FecTool.cpp
+ *
+ * usage:
+ *   ./fec_tool                     (delivery ratio vs. SNR, default burst model)
+ *   ./fec_tool -p 0 -s 2:12:0.5    (random bit errors only, SNR 2..12 dB)
+ *   ./fec_tool -p 0.005 -l 16      (frequent long bursts)
+ *
+ * Channel model: the frame bits in air order pass a Gilbert-Elliott channel.
+ * In the good state a bit is flipped with the probability of the hard
+ * decision of a Manchester chip pair, p = Q(sqrt(SNR)) with the SNR at the
+ * decision, in the bad state (interference burst) with 0.5. A burst starts
+ * with the given probability per bit and has a geometric length.
+ *
+ * Schemes: Oregon Scientific 3.0 frame (checksum), the same sent twice,
+ * compact frame without code (CRC-8), with convolutional code and with code
+ * and interleaving (CompactFrame.h). A frame is delivered if the decoded
+ * values equal the sent values, a valid checksum with wrong values is counted
+ * as undetected error.
+ *
+ * The summary lists the SNR needed for the target delivery ratio, the gain
+ * over the Oregon Scientific frame in dB and in Si4432 TX power steps (~3 dB
+ * each) and the air time relative to the Oregon Scientific frame, which is
+ * the TX charge at the same TX power.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+#include "ArduinoHost.h"
+#include "../OregonScientific.h"
+#include "CompactFrameDecoder.h"
+#include "OregonScientificDecoder.h"
+
+struct Options
+{
+  uint32_t frames = 10000;   // per SNR
+  float snrFrom = 0;         // [dB]
+  float snrTo = 14;          // [dB]
+  float snrStep = 1;         // [dB]
+  float burstRate = 0.0002f; // burst start probability per bit
+  float burstLength = 8;     // [bits] mean
+  float target = 95;         // [%] delivery ratio
+  uint32_t seed = 4711;
+};
+
+enum Scheme
+{
+  OREGON,
+  OREGON_X2,
+  COMPACT,
+  FEC,
+  FEC_INTERLEAVED,
+  SCHEMES
+};
+
+static const char* SCHEME_NAMES[SCHEMES] = { "oregon", "oregon x2", "compact", "fec", "fec+il" };
+
+/**
+ * Gilbert-Elliott bit error channel
+ */
+class Channel
+{
+public:
+  Channel(uint32_t seed, float burstRate, float burstLength) :
+    rng(seed), burstRate(burstRate), burstEnd(burstLength > 1? 1/burstLength : 1)
+  {}
+
+public:
+  void setSnr(float db)
+  {
+    float snr = powf(10, db/10);
+    errorRate = 0.5f*erfcf(sqrtf(snr/2));
+  }
+
+  float getErrorRate() const
+  {
+    return errorRate;
+  }
+
+  void transmit(const byte* frame, byte size, std::vector<bool>& bits)
+  {
+    bits.resize(8*size);
+    for (size_t i=0; i<bits.size(); i++)
+    {
+      bool bit = (frame[i/8] >> (i%8)) & 1; // LSB first
+      if (burst)
+      {
+        burst = uniform(rng) >= burstEnd;
+      }
+      else
+      {
+        burst = uniform(rng) < burstRate;
+      }
+      bits[i] = bit != (uniform(rng) < (burst? 0.5f : errorRate));
+    }
+  }
+
+private:
+  std::mt19937 rng;
+  std::uniform_real_distribution<float> uniform{0, 1};
+  float burstRate;
+  float burstEnd;
+  float errorRate = 0;
+  bool burst = false;
+};
+
+struct Result
+{
+  uint32_t delivered[SCHEMES] = {};
+  uint32_t undetected[SCHEMES] = {};
+};
+
+static bool equals(const OregonScientificDecoder::Frame& a, const OregonScientificDecoder::Frame& b)
+{
+  return a.id == b.id && a.channel == b.channel && a.rollingCode == b.rollingCode && a.lowBatt == b.lowBatt
+      && fabsf(a.temp - b.temp) < 0.051f && a.hum == b.hum;
+}
+
+static bool equals(const CompactFrame::Data& a, const OregonScientificDecoder::Frame& b)
+{
+  return a.channel == b.channel && a.rollingCode == b.rollingCode && a.lowBatt == b.lowBatt
+      && fabsf(a.temp - b.temp) < 0.051f && a.hum == b.hum;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: fec_tool [options]\n"
+    "  -n <count>         frames per SNR, default 10000\n"
+    "  -s <from:to:step>  SNR range [dB], default 0:14:1\n"
+    "  -p <probability>   burst start probability per bit, default 0.0002\n"
+    "  -l <bits>          mean burst length, default 8\n"
+    "  -t <percent>       target delivery ratio, default 95\n"
+    "  -r <seed>          random seed\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:p:l:t:r:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n': options.frames = atoi(optarg); break;
+      case 's':
+        if (sscanf(optarg, "%f:%f:%f", &options.snrFrom, &options.snrTo, &options.snrStep) != 3)
+        {
+          usage();
+          return 1;
+        }
+        break;
+      case 'p': options.burstRate = atof(optarg); break;
+      case 'l': options.burstLength = atof(optarg); break;
+      case 't': options.target = atof(optarg); break;
+      case 'r': options.seed = atoi(optarg); break;
+      default: usage(); return 1;
+    }
+  }
+  if (options.frames == 0 || options.snrStep <= 0 || options.snrTo < options.snrFrom)
+  {
+    usage();
+    return 1;
+  }
+
+  OregonScientific oregon;
+  OregonScientificDecoder oregonDecoder;
+  oregonDecoder.setLsbFirst(true);
+
+  CompactFrame compactFrames[3];
+  CompactFrameDecoder compactDecoders[3];
+  for (int i=0; i<3; i++)
+  {
+    // COMPACT, FEC, FEC_INTERLEAVED
+    compactFrames[i].setCoding(i > 0);
+    compactDecoders[i].setCoding(i > 0);
+    compactFrames[i].setInterleaving(i > 1);
+    compactDecoders[i].setInterleaving(i > 1);
+  }
+
+  Channel channel(options.seed, options.burstRate, options.burstLength);
+  std::mt19937 rng(options.seed + 1);
+  std::vector<bool> bits;
+  double decodeTime[SCHEMES] = {};
+  uint32_t decodeCount[SCHEMES] = {};
+  byte frameSize[SCHEMES] = {};
+
+  std::vector<float> snrs;
+  std::vector<Result> results;
+  printf("%6s %9s", "SNR", "BER");
+  for (int s=0; s<SCHEMES; s++)
+  {
+    printf(" %10s", SCHEME_NAMES[s]);
+  }
+  printf("   [%% delivered]\n");
+
+  for (float snr = options.snrFrom; snr <= options.snrTo + 1e-3f; snr += options.snrStep)
+  {
+    channel.setSnr(snr);
+    Result result;
+    for (uint32_t f=0; f<options.frames; f++)
+    {
+      OregonScientificDecoder::Frame sent = { 0xF824, (byte)(1 + rng() % 3), (byte)rng(), rng() % 8 == 0,
+                                              -20 + 0.1f*(rng() % 600), (byte)(rng() % 100) };
+
+      // Oregon Scientific, once and repeated
+      byte size = oregon.encodeTH(sent.id, sent.channel, sent.rollingCode, sent.lowBatt, sent.temp, sent.hum);
+      frameSize[OREGON] = size;
+      frameSize[OREGON_X2] = 2*size;
+      bool delivered = false;
+      for (int r=0; r<2; r++)
+      {
+        channel.transmit(oregon.getMessage(), size, bits);
+        OregonScientificDecoder::Frame received;
+        auto start = std::chrono::steady_clock::now();
+        bool valid = oregonDecoder.decodeBits(bits, received);
+        decodeTime[OREGON] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        decodeCount[OREGON]++;
+        bool ok = valid && equals(received, sent);
+        if (valid && !ok)
+        {
+          result.undetected[r == 0? OREGON : OREGON_X2]++;
+        }
+        if (r == 0 && ok)
+        {
+          result.delivered[OREGON]++;
+        }
+        delivered |= ok;
+      }
+      if (delivered)
+      {
+        result.delivered[OREGON_X2]++;
+      }
+
+      // compact frame variants
+      for (int i=0; i<3; i++)
+      {
+        Scheme scheme = (Scheme)(COMPACT + i);
+        size = compactFrames[i].encodeTH(sent.channel, sent.rollingCode, sent.lowBatt, sent.temp, sent.hum);
+        frameSize[scheme] = size;
+        channel.transmit(compactFrames[i].getMessage(), size, bits);
+        CompactFrame::Data received;
+        auto start = std::chrono::steady_clock::now();
+        bool valid = compactDecoders[i].decodeBits(bits, received);
+        decodeTime[scheme] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        decodeCount[scheme]++;
+        bool ok = valid && equals(received, sent);
+        if (ok)
+        {
+          result.delivered[scheme]++;
+        }
+        else if (valid)
+        {
+          result.undetected[scheme]++;
+        }
+      }
+    }
+
+    printf("%6.1f %9.2e", snr, channel.getErrorRate());
+    for (int s=0; s<SCHEMES; s++)
+    {
+      printf(" %10.2f", 100.0*result.delivered[s]/options.frames);
+    }
+    printf("\n");
+    snrs.push_back(snr);
+    results.push_back(result);
+  }
+
+  // summary
+  printf("\n%-10s %6s %8s %12s %9s %8s %10s %12s\n", "scheme", "bytes", "air [ms]", "SNR@target", "gain [dB]", "TX steps",
+         "TX charge", "undetected");
+  float reference = NAN;
+  for (int s=0; s<SCHEMES; s++)
+  {
+    float required = NAN;
+    uint32_t undetected = 0;
+    for (size_t i=0; i<results.size(); i++)
+    {
+      undetected += results[i].undetected[s];
+      if (std::isnan(required) && 100.0*results[i].delivered[s]/options.frames >= options.target)
+      {
+        required = snrs[i];
+      }
+    }
+    if (s == OREGON)
+    {
+      reference = required;
+    }
+    float gain = reference - required;
+    float airTime = 8000.0f*frameSize[s]/1400; // [ms] at 1.4 kbit/s
+    float charge = (float)frameSize[s]/frameSize[OREGON];
+    char requiredText[16] = "-", gainText[16] = "-", stepsText[16] = "-";
+    if (!std::isnan(required))
+    {
+      snprintf(requiredText, sizeof(requiredText), "%.1f", required);
+    }
+    if (!std::isnan(gain))
+    {
+      snprintf(gainText, sizeof(gainText), "%.1f", gain);
+      snprintf(stepsText, sizeof(stepsText), "%.0f", floorf(gain/3));
+    }
+    printf("%-10s %6u %8.1f %12s %9s %8s %9.0f%% %12u\n", SCHEME_NAMES[s], frameSize[s], airTime, requiredText, gainText, stepsText,
+           100*charge, undetected);
+  }
+  printf("SNR@target: lowest SNR with >= %.1f%% delivered, TX charge: air time relative to oregon at the same TX power\n",
+         options.target);
+
+  printf("\n%-10s %12s\n", "scheme", "decode [us]");
+  for (int s=0; s<SCHEMES; s++)
+  {
+    if (decodeCount[s])
+    {
+      printf("%-10s %12.2f\n", SCHEME_NAMES[s], 1e6*decodeTime[s]/decodeCount[s]);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*****************************************************************************
+ *
+ * File-backed Flash Image for Host Tools
+ *
+ * file:     FileFlash.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * host replacement for NVMFlash with the same interface and NOR semantics
+ * (erase sets bits, write clears bits), stored in an image file
+ *
+ * For power loss tests a byte budget can be set: a write exceeding the
+ * budget is only partially performed and an erase without budget is skipped.
+ */
+class FileFlash
+{
+public:
+  static const uint16_t PAGE_SIZE = 64; // [bytes]
+  static const uint16_t ROW_SIZE = 4*PAGE_SIZE; // [bytes]
+
+public:
+  /**
+   * @param path image file, created with all bits 0 (like the reserved region after upload) if missing
+   * @param rows size of region [rows]
+   */
+  FileFlash(const char* path, uint16_t rows) :
+    path(path ? path : ""),
+    image(rows*ROW_SIZE, 0),
+    eraseCounts(rows, 0)
+  {
+    if (!this->path.empty())
+    {
+      FILE* f = fopen(path, "rb");
+      if (f)
+      {
+        size_t n = fread(image.data(), 1, image.size(), f);
+        (void)n;
+        fclose(f);
+      }
+    }
+  }
+
+public:
+  uint16_t getRows() const
+  {
+    return eraseCounts.size();
+  }
+
+  void read(uint32_t offset, void* data, uint16_t size)
+  {
+    memcpy(data, image.data() + offset, size);
+    bytesRead += size;
+  }
+
+  bool eraseRow(uint16_t row)
+  {
+    if (row >= getRows())
+    {
+      return false;
+    }
+    if (!consume(ROW_SIZE))
+    {
+      return false;
+    }
+    memset(image.data() + row*ROW_SIZE, 0xFF, ROW_SIZE);
+    eraseCounts[row]++;
+    return save();
+  }
+
+  bool write(uint32_t offset, const void* data, uint16_t size)
+  {
+    if ((offset & 3) || (size & 3) || offset + size > image.size()
+     || offset/PAGE_SIZE != (offset + size - 1)/PAGE_SIZE)
+    {
+      return false;
+    }
+    const byte* src = (const byte*)data;
+    for (uint16_t i=0; i<size; i++)
+    {
+      if (!consume(1))
+      {
+        save();
+        return false;
+      }
+      image[offset + i] &= src[i];
+    }
+    return save();
+  }
+
+  /**
+   * @param bytes bytes that can still be written before power loss, < 0: unlimited
+   */
+  void setBudget(int64_t bytes)
+  {
+    budget = bytes;
+  }
+
+  uint32_t getEraseCount(uint16_t row) const
+  {
+    return eraseCounts[row];
+  }
+
+  uint64_t getBytesRead() const
+  {
+    return bytesRead;
+  }
+
+  void resetBytesRead()
+  {
+    bytesRead = 0;
+  }
+
+private:
+  bool consume(int64_t bytes)
+  {
+    if (budget < 0)
+    {
+      return true;
+    }
+    if (budget < bytes)
+    {
+      budget = 0;
+      return false;
+    }
+    budget -= bytes;
+    return true;
+  }
+
+  bool save()
+  {
+    if (path.empty())
+    {
+      return true;
+    }
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+    {
+      return false;
+    }
+    bool ok = fwrite(image.data(), 1, image.size(), f) == image.size();
+    fclose(f);
+    return ok;
+  }
+
+private:
+  std::string path;
+  std::vector<byte> image;
+  std::vector<uint32_t> eraseCounts;
+  int64_t budget = -1;
+  uint64_t bytesRead = 0;
+};
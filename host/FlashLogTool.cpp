@@ -0,0 +1,245 @@
+/*****************************************************************************
+ *
+ * Inspect and Simulate the Persistent Flash Log
+ *
+ * file:     FlashLogTool.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o flash_log_tool FlashLogTool.cpp
+ *
+ * usage:
+ *   ./flash_log_tool -f flash.bin -d              (dump flash image, e.g. read with bossac/openocd)
+ *   ./flash_log_tool -s 100000 -c 10 -P 0.05      (simulate wakeups with power loss during commit)
+ *
+ * The simulation stages values like SolarDHT::persistState() every wakeup
+ * (4 sample slots, counters and energy), commits every n-th wakeup and optionally
+ * cuts power at a random byte of a commit. After each power loss the log is
+ * restored with FlashLog::begin() and every key must hold either the value
+ * before or the value of the interrupted commit.
+ */
+
+#include <cstdio>
+#include <random>
+#include <unistd.h>
+
+#include "ArduinoHost.h"
+#include "FileFlash.h"
+#include "../FlashLog.h"
+
+static const byte KEYS = 15; // SolarDHT::PERSISTENT_KEYS
+
+typedef FlashLog<FileFlash, KEYS> Log;
+
+struct Options
+{
+  const char* path = nullptr;
+  uint16_t rows = 16;              // FLASH_LOG_ROWS
+  bool dump = false;
+  uint32_t wakeups = 0;
+  uint32_t commitEvery = 10;       // FLASH_LOG_COMMIT_EVERY
+  double powerLoss = 0;            // probability per commit
+  uint32_t period = 180;           // [s]
+  uint32_t endurance = 25000;      // min. erase cycles of SAMD21 NVM
+};
+
+static void dump(FileFlash& flash)
+{
+  Log log(flash);
+  flash.resetBytesRead();
+  bool restored = log.begin();
+  printf("active row:   %u\n", log.getActiveRow());
+  printf("sequence:     %u\n", log.getSequence());
+  printf("free records: %u\n", log.getFreeRecords());
+  printf("boot read:    %llu bytes\n", (unsigned long long)flash.getBytesRead());
+  if (!restored)
+  {
+    printf("no values (blank image formatted)\n");
+    return;
+  }
+  for (byte key=0; key<KEYS; key++)
+  {
+    uint32_t value;
+    if (log.get(key, value))
+    {
+      printf("key %2u: 0x%08X %d\n", key, value, (int32_t)value);
+    }
+  }
+}
+
+static int simulate(FileFlash& flash, const Options& options)
+{
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  std::uniform_int_distribution<int> budget(0, Log::ROW_SIZE + (KEYS + 1)*Log::RECORD_SIZE);
+
+  Log* log = new Log(flash);
+  log->begin();
+
+  uint32_t committed[KEYS] = {}; // last persistent values
+  uint32_t staged[KEYS] = {};
+  uint32_t commits = 0, powerLosses = 0, failures = 0;
+  uint64_t bootBytes = 0;
+  uint32_t boots = 1;
+  for (uint32_t w=1; w<=options.wakeups; w++)
+  {
+    // changes per wakeup: one new sample slot, sample count, occasionally display and config
+    staged[w % 4] = rng();
+    staged[4] = (w % 4) | ((w % 4) << 8);
+    staged[13] = w*8; // energy total [mJ] and average power
+    staged[14] = rng();
+    if (w % 20 == 0) staged[5] = rng(), staged[6]++;
+    if (w % 500 == 0) staged[9]++, staged[11] = rng();
+    for (byte key=0; key<KEYS; key++)
+    {
+      log->set(key, staged[key]);
+    }
+
+    if (w % options.commitEvery)
+    {
+      continue;
+    }
+
+    // power loss during commit
+    bool powerLoss = uniform(rng) < options.powerLoss;
+    if (powerLoss)
+    {
+      flash.setBudget(budget(rng));
+    }
+    bool ok = log->commit();
+    flash.setBudget(-1);
+    commits++;
+
+    if (powerLoss)
+    {
+      powerLosses++;
+
+      // reboot
+      delete log;
+      log = new Log(flash);
+      flash.resetBytesRead();
+      log->begin();
+      bootBytes += flash.getBytesRead();
+      boots++;
+
+      for (byte key=0; key<KEYS; key++)
+      {
+        uint32_t value = 0;
+        log->get(key, value);
+        if (value != committed[key] && value != staged[key])
+        {
+          failures++;
+          printf("error: wakeup %u key %u restored 0x%08X, expected 0x%08X or 0x%08X\n", w, key, value, committed[key], staged[key]);
+        }
+        committed[key] = value;
+        staged[key] = value;
+      }
+    }
+    else if (ok)
+    {
+      memcpy(committed, staged, sizeof(committed));
+    }
+  }
+
+  uint32_t maxErase = 0;
+  uint64_t sumErase = 0;
+  for (uint16_t row=0; row<flash.getRows(); row++)
+  {
+    maxErase = std::max(maxErase, flash.getEraseCount(row));
+    sumErase += flash.getEraseCount(row);
+  }
+  double days = (double)options.wakeups*options.period/86400;
+
+  printf("wakeups:          %u (%.1f days)\n", options.wakeups, days);
+  printf("commits:          %u\n", commits);
+  printf("row switches:     %u\n", log->getSequence() - 1);
+  printf("erases per row:   max %u, avg %.1f\n", maxErase, (double)sumErase/flash.getRows());
+  if (maxErase)
+  {
+    printf("lifetime:         %.1f years at %u erase cycles\n", options.endurance*days/maxErase/365, options.endurance);
+  }
+  printf("power losses:     %u\n", powerLosses);
+  printf("boot read:        %.0f bytes avg\n", (double)bootBytes/std::max(1u, boots - 1));
+  printf("restore failures: %u\n", failures);
+
+  delete log;
+  return failures? 2 : 0;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: flash_log_tool [options]\n"
+    "  -f <file>  flash image file, default in memory\n"
+    "  -r <n>     rows, default 16\n"
+    "  -d         dump log content\n"
+    "  -s <n>     simulate n wakeups\n"
+    "  -c <n>     commit every n-th wakeup, default 10\n"
+    "  -P <p>     power loss probability per commit, default 0\n"
+    "  -p <s>     wakeup period for lifetime estimate, default 180\n"
+    "  -E <n>     erase endurance, default 25000\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int opt;
+  while ((opt = getopt(argc, argv, "f:r:ds:c:P:p:E:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'f': options.path = optarg; break;
+      case 'r': options.rows = std::max(2, atoi(optarg)); break;
+      case 'd': options.dump = true; break;
+      case 's': options.wakeups = atoi(optarg); break;
+      case 'c': options.commitEvery = std::max(1, atoi(optarg)); break;
+      case 'P': options.powerLoss = atof(optarg); break;
+      case 'p': options.period = atoi(optarg); break;
+      case 'E': options.endurance = atoi(optarg); break;
+      default: usage(); return 1;
+    }
+  }
+  if (!options.dump && !options.wakeups)
+  {
+    usage();
+    return 1;
+  }
+
+  FileFlash flash(options.path, options.rows);
+  if (options.wakeups)
+  {
+    int result = simulate(flash, options);
+    if (result)
+    {
+      return result;
+    }
+  }
+  if (options.dump)
+  {
+    dump(flash);
+  }
+
+  return 0;
+}
@@ -0,0 +1,424 @@
+/*****************************************************************************
+ *
+ * Discrete Event Simulation of many SolarDHT Nodes sharing one Channel
+ *
+ * file:     FleetSimulator.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -pthread -o fleet_simulator FleetSimulator.cpp
+ *
+ * usage:
+ *   ./fleet_simulator -n 10,50,100,500 -p 180 -b 1024,1400 -H 24
+ *   ./fleet_simulator -n 50 -u 0 -S     (units powered up together, fixed vs. slotted schedule)
+ *   ./fleet_simulator -n 100,500 -R 0,1,2   (frame repetitions in the same radio session)
+ *   ./fleet_simulator -n 50,100 -S -s 60 -e 10 -E   (early transmits, immediate vs. deferred to next wakeup)
+ *
+ * Each sweep point (node count x period x bit rate x schedule x run) is an independent
+ * simulation, the sweep points are distributed over all cores. The output is
+ * a CSV table with the packet delivery ratio (PDR) per sweep point. With
+ * repetitions a reading is delivered if at least one copy is delivered, the
+ * reading delivery ratio is listed separately.
+ *
+ * With a sample period (-s) sample-only wakeups are inserted between the
+ * transmit wakeups and each sample-only wakeup requests an early transmission
+ * with the given probability (-e). An immediate early transmission is sent on
+ * the sample-only wakeup without changing the schedule, a deferred one is sent
+ * on the next wakeup (TransmitSchedule::requestTransmit()) like the firmware.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "ArduinoHost.h"
+#include "../OregonScientific.h"
+#include "../TransmitSchedule.h"
+
+struct Parameters
+{
+  uint32_t nodes;
+  uint32_t period;    // [ms]
+  uint32_t bitRate;   // [bit/s]
+  bool slotted;       // schedule derived from serial ID
+  uint32_t repeats;   // frame repetitions per wakeup
+  bool deferred;      // early transmit on next wakeup instead of sample-only wakeup
+  uint32_t run;
+};
+
+struct Options
+{
+  std::vector<uint32_t> nodes = { 10, 50, 100, 500 };
+  std::vector<uint32_t> periods = { 180 };   // [s]
+  std::vector<uint32_t> bitRates = { 1400 }; // [bit/s]
+  uint32_t runs = 4;
+  float hours = 24;
+  float driftPpm = 10000;   // OSCULP32K standard deviation [ppm]
+  float captureRatio = 6;   // [dB]
+  float sensitivity = -100; // [dBm]
+  float minPower = -95;     // [dBm] received power range of nodes
+  float maxPower = -50;     // [dBm]
+  float powerUpSpread = -1; // [s], < 0: one period
+  std::vector<bool> schedules = { false }; // slotted
+  std::vector<uint32_t> repeats = { 0 };
+  uint32_t samplePeriod = 0;  // [s]
+  float earlyRate = 0;        // [%] of sample-only wakeups requesting early transmit
+  std::vector<bool> early = { true }; // deferred
+  uint32_t threads = std::thread::hardware_concurrency();
+};
+
+struct Result
+{
+  Parameters parameters;
+  uint64_t sent = 0;
+  uint64_t delivered = 0;
+  uint64_t collided = 0;
+  uint64_t readings = 0;
+  uint64_t readingsDelivered = 0;
+  uint64_t early = 0;
+};
+
+/**
+ * virtual node with SolarDHT schedule and Oregon Scientific framing
+ */
+class VirtualNode
+{
+public:
+  VirtualNode(uint32_t period, uint32_t samplePeriod, double powerUp, double drift, float power, uint64_t serialId, bool slotted) :
+    schedule(period),
+    power(power),
+    drift(drift),
+    wakeup(powerUp)
+  {
+    if (slotted)
+    {
+      schedule.setSerialId(serialId >> 32, serialId & 0xFFFFFFFF);
+    }
+    schedule.setSamplePeriod(samplePeriod);
+    rollingCode = schedule.getRollingCode();
+  }
+
+public:
+  /**
+   * advance schedule over sample-only wakeups until the next transmission
+   *
+   * @param early true if the sample-only wakeup requests an early transmission
+   * @param deferred early transmission on next wakeup instead of now
+   * @param isEarly true if the transmission was requested early
+   * @return start time of next transmission [s]
+   */
+  template<typename Early>
+  double nextTransmission(uint32_t bitRate, Early early, bool deferred, double& airTime, bool& isEarly)
+  {
+    byte size = oregon.encodeTH(0xF824, 1, rollingCode, false, 21.5, 50);
+    airTime = TransmitSchedule::getAirTime(size, bitRate)/1000.0;
+    isEarly = false;
+    while (true)
+    {
+      double start = wakeup + TransmitSchedule::RADIO_STARTUP_TIME/1000.0*(1 + drift);
+      bool transmit = schedule.isTransmitDue();
+      wakeup += schedule.getNextWakeup()/1000.0*(1 + drift);
+      if (transmit)
+      {
+        return start;
+      }
+      if (early() && !schedule.isTransmitDue())
+      {
+        isEarly = true;
+        if (!deferred)
+        {
+          return start;
+        }
+        schedule.requestTransmit();
+      }
+    }
+  }
+
+  /**
+   * @return start time of repetition [s] after the previous copy
+   */
+  double nextRepetition(double previousEnd)
+  {
+    return previousEnd + schedule.getRepeatGap()/1000.0*(1 + drift);
+  }
+
+public:
+  TransmitSchedule schedule;
+  OregonScientific oregon;
+  float power; // [dBm]
+  byte rollingCode;
+
+private:
+  double drift;
+  double wakeup; // [s]
+};
+
+struct Transmission
+{
+  double start;
+  double end;
+  uint32_t node;
+  uint64_t reading;     // index of reading, same for all copies
+  uint32_t copy;        // 0 = first transmission of reading
+  float power;          // [mW]
+  float interference;   // [mW] sum of overlapping transmissions
+
+  bool operator>(const Transmission& other) const
+  {
+    return start > other.start;
+  }
+};
+
+static Result simulate(const Options& options, const Parameters& parameters)
+{
+  std::mt19937_64 rng(parameters.run*7919 + parameters.nodes*31 + parameters.period + parameters.bitRate);
+  std::normal_distribution<double> drift(0, options.driftPpm*1e-6);
+  std::uniform_real_distribution<float> power(options.minPower, options.maxPower);
+  double spread = options.powerUpSpread < 0? parameters.period/1000.0 : options.powerUpSpread;
+  std::uniform_real_distribution<double> powerUp(0, spread);
+
+  std::vector<VirtualNode> nodes;
+  nodes.reserve(parameters.nodes);
+  for (uint32_t n=0; n<parameters.nodes; n++)
+  {
+    double p = powerUp(rng);
+    double d = drift(rng);
+    float dBm = power(rng);
+    nodes.emplace_back(parameters.period, options.samplePeriod*1000, p, d, dBm, rng(), parameters.slotted);
+  }
+
+  // event queue with next transmission of each node
+  std::priority_queue<Transmission, std::vector<Transmission>, std::greater<Transmission>> events;
+  std::vector<bool> delivered; // per reading
+  std::bernoulli_distribution change(options.earlyRate/100);
+  uint64_t early = 0;
+  auto schedule = [&](uint32_t n)
+  {
+    double airTime;
+    bool isEarly;
+    double start = nodes[n].nextTransmission(parameters.bitRate, [&]{ return change(rng); }, parameters.deferred, airTime, isEarly);
+    early += isEarly;
+    uint64_t reading = delivered.size();
+    delivered.push_back(false);
+    float mW = powf(10, nodes[n].power/10);
+    events.push(Transmission{ start, start + airTime, n, reading, 0, mW, 0 });
+    for (uint32_t r=1; r<=parameters.repeats; r++)
+    {
+      start = nodes[n].nextRepetition(start + airTime);
+      events.push(Transmission{ start, start + airTime, n, reading, r, mW, 0 });
+    }
+  };
+  for (uint32_t n=0; n<parameters.nodes; n++)
+  {
+    schedule(n);
+  }
+
+  Result result;
+  result.parameters = parameters;
+  double duration = options.hours*3600;
+  double captureRatio = powf(10, options.captureRatio/10);
+  double noise = powf(10, (options.sensitivity - options.captureRatio)/10);
+  std::vector<Transmission> active;
+
+  auto finalize = [&](const Transmission& t)
+  {
+    result.sent++;
+    if (t.interference > 0) result.collided++;
+    if (t.power >= captureRatio*(t.interference + noise))
+    {
+      result.delivered++;
+      if (!delivered[t.reading])
+      {
+        delivered[t.reading] = true;
+        result.readingsDelivered++;
+      }
+    }
+  };
+
+  while (!events.empty() && events.top().start < duration)
+  {
+    Transmission t = events.top();
+    events.pop();
+    if (!t.copy)
+    {
+      // first copy of reading, schedule next wakeup
+      result.readings++;
+      schedule(t.node);
+    }
+
+    // finalize completed transmissions
+    for (size_t i=0; i<active.size(); )
+    {
+      if (active[i].end <= t.start)
+      {
+        finalize(active[i]);
+        active[i] = active.back();
+        active.pop_back();
+      }
+      else
+      {
+        i++;
+      }
+    }
+
+    // overlapping transmissions interfere with each other (capture effect by power ratio)
+    for (Transmission& a : active)
+    {
+      a.interference += t.power;
+      t.interference += a.power;
+    }
+    active.push_back(t);
+  }
+  for (const Transmission& a : active)
+  {
+    finalize(a);
+  }
+
+  result.early = early;
+  return result;
+}
+
+static std::vector<uint32_t> parseList(const char* arg)
+{
+  std::vector<uint32_t> values;
+  std::string s(arg);
+  size_t pos = 0;
+  while (pos < s.size())
+  {
+    size_t end = s.find(',', pos);
+    if (end == std::string::npos) end = s.size();
+    values.push_back(std::stoul(s.substr(pos, end - pos)));
+    pos = end + 1;
+  }
+  return values;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: fleet_simulator [options]\n"
+    "  -n <list>  node counts, default 10,50,100,500\n"
+    "  -p <list>  transmit periods [s], default 180\n"
+    "  -b <list>  bit rates [bit/s], default 1400\n"
+    "  -r <n>     runs per sweep point, default 4\n"
+    "  -H <h>     simulated time [h], default 24\n"
+    "  -d <ppm>   clock drift standard deviation, default 10000\n"
+    "  -c <dB>    capture ratio, default 6\n"
+    "  -u <s>     power up spread, default one period\n"
+    "  -S         compare fixed and slotted schedule (TransmitSchedule::setSerialId)\n"
+    "  -R <list>  frame repetitions per wakeup, default 0\n"
+    "  -s <s>     sample period, default 0 (sample with transmit only)\n"
+    "  -e <%%>     early transmit requests per sample-only wakeup, default 0\n"
+    "  -E         compare immediate and deferred early transmit, default deferred\n"
+    "  -t <n>     threads, default all cores\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:p:b:r:H:d:c:u:SR:s:e:Et:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n': options.nodes = parseList(optarg); break;
+      case 'p': options.periods = parseList(optarg); break;
+      case 'b': options.bitRates = parseList(optarg); break;
+      case 'r': options.runs = std::max(1, atoi(optarg)); break;
+      case 'H': options.hours = atof(optarg); break;
+      case 'd': options.driftPpm = atof(optarg); break;
+      case 'c': options.captureRatio = atof(optarg); break;
+      case 'u': options.powerUpSpread = atof(optarg); break;
+      case 'S': options.schedules = { false, true }; break;
+      case 'R': options.repeats = parseList(optarg); break;
+      case 's': options.samplePeriod = atoi(optarg); break;
+      case 'e': options.earlyRate = atof(optarg); break;
+      case 'E': options.early = { false, true }; break;
+      case 't': options.threads = std::max(1, atoi(optarg)); break;
+      default: usage(); return 1;
+    }
+  }
+
+  std::vector<Parameters> sweep;
+  for (uint32_t n : options.nodes)
+    for (uint32_t p : options.periods)
+      for (uint32_t b : options.bitRates)
+        for (bool s : options.schedules)
+          for (uint32_t rep : options.repeats)
+            for (bool e : options.early)
+              for (uint32_t r=0; r<options.runs; r++)
+                sweep.push_back(Parameters{ n, p*1000, b, s, rep, e, r });
+
+  // distribute sweep points over worker threads
+  std::vector<Result> results(sweep.size());
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  for (uint32_t t=0; t<std::max(1u, options.threads); t++)
+  {
+    workers.emplace_back([&]
+    {
+      size_t i;
+      while ((i = next++) < sweep.size())
+      {
+        results[i] = simulate(options, sweep[i]);
+      }
+    });
+  }
+  for (std::thread& w : workers)
+  {
+    w.join();
+  }
+
+  // aggregate runs
+  printf("nodes,period_s,bit_rate,schedule,sent,collided,delivered,pdr,repeats,readings,readings_delivered,reading_pdr,early,early_transmit\n");
+  for (size_t i=0; i<results.size(); i+=options.runs)
+  {
+    Result sum = results[i];
+    for (uint32_t r=1; r<options.runs; r++)
+    {
+      sum.sent += results[i + r].sent;
+      sum.collided += results[i + r].collided;
+      sum.delivered += results[i + r].delivered;
+      sum.readings += results[i + r].readings;
+      sum.readingsDelivered += results[i + r].readingsDelivered;
+      sum.early += results[i + r].early;
+    }
+    printf("%u,%u,%u,%s,%llu,%llu,%llu,%.4f,%u,%llu,%llu,%.4f,%llu,%s\n", sum.parameters.nodes, sum.parameters.period/1000,
+           sum.parameters.bitRate, sum.parameters.slotted? "slotted" : "fixed",
+           (unsigned long long)sum.sent, (unsigned long long)sum.collided, (unsigned long long)sum.delivered,
+           sum.sent? (double)sum.delivered/sum.sent : 0.0, sum.parameters.repeats,
+           (unsigned long long)sum.readings, (unsigned long long)sum.readingsDelivered,
+           sum.readings? (double)sum.readingsDelivered/sum.readings : 0.0, (unsigned long long)sum.early,
+           sum.parameters.deferred? "deferred" : "immediate");
+  }
+
+  return 0;
+}
@@ -0,0 +1,500 @@
+/*****************************************************************************
+ *
+ * Glyph Subsets of Adafruit GFX Fonts for the ePaper Layout
+ *
+ * file:     FontSubset.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o font_subset FontSubset.cpp
+ *
+ * usage:
+ *   ./font_subset -l ~/Arduino/libraries/Adafruit_GFX_Library > ../SolarDHTFonts.h
+ *                                    (subsets of the SolarDHT fonts, then build with HAS_FONT_SUBSET 1)
+ *   ./font_subset -l <lib> -c ../SolarDHTFonts.h
+ *                                    (check existing subsets against the library fonts)
+ *   ./font_subset Fonts/FreeSans12pt7b.h=0123456789   (subset of any font header)
+ *
+ * The fonts of displaySensorData() are FreeSans18pt7b with FONT_VALUE_GLYPHS
+ * and FreeSansBold9pt7b with FONT_UNIT_GLYPHS (SolarDHTConfig.h).
+ *
+ * Adafruit GFX indexes the glyph table with c - first, so a subset covers the
+ * range from the first to the last used character. Unused characters in the
+ * range get an empty glyph that only keeps the advance, their bitmaps are
+ * dropped. The lookup stays a direct index and the fonts work with the
+ * unmodified library.
+ *
+ * Each subset is rendered against the full font, glyph by glyph and for all
+ * strings printed by the layout (temperatures -40.0 .. 85.0 °C, humidities
+ * 0 .. 100 %, units), and must match pixel for pixel including the cursor
+ * advance. The exit code is 1 on mismatch.
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "ArduinoHost.h"
+#include "../SolarDHTConfig.h"
+
+/**
+ * Adafruit GFX font (gfxfont.h) as parsed from a font header
+ */
+struct Font
+{
+  struct Glyph
+  {
+    uint16_t bitmapOffset;
+    uint8_t width;
+    uint8_t height;
+    uint8_t xAdvance;
+    int8_t xOffset;
+    int8_t yOffset;
+  };
+
+  std::string name;
+  std::vector<uint8_t> bitmaps;
+  std::vector<Glyph> glyphs;
+  uint16_t first = 0;
+  uint16_t last = 0;
+  uint8_t yAdvance = 0;
+
+  bool contains(char c) const
+  {
+    return (uint8_t)c >= first && (uint8_t)c <= last;
+  }
+
+  const Glyph& getGlyph(char c) const
+  {
+    return glyphs[(uint8_t)c - first];
+  }
+
+  size_t getSize() const
+  {
+    return bitmaps.size() + glyphs.size()*sizeof(Glyph) + 10; // GFXfont: 2 pointers, first, last, yAdvance
+  }
+};
+
+/**
+ * 1 bit canvas with the text baseline in the middle
+ */
+struct Canvas
+{
+  static const int WIDTH = 512;
+  static const int HEIGHT = 128;
+
+  std::vector<bool> pixels = std::vector<bool>(WIDTH*HEIGHT);
+  int cursor = 0;
+
+  bool operator==(const Canvas& other) const
+  {
+    return cursor == other.cursor && pixels == other.pixels;
+  }
+
+  void set(int x, int y)
+  {
+    x += 8;
+    y += HEIGHT/2;
+    if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT)
+    {
+      pixels[y*WIDTH + x] = true;
+    }
+  }
+};
+
+static std::string readFile(const char* path)
+{
+  FILE* f = fopen(path, "rb");
+  if (!f)
+  {
+    perror(path);
+    exit(1);
+  }
+  std::string text;
+  char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+  {
+    text.append(buffer, n);
+  }
+  fclose(f);
+  return text;
+}
+
+static std::string stripComments(const std::string& text)
+{
+  std::string result;
+  for (size_t i=0; i<text.size(); i++)
+  {
+    if (text.compare(i, 2, "//") == 0)
+    {
+      i = text.find('\n', i);
+      if (i == std::string::npos)
+      {
+        break;
+      }
+    }
+    else if (text.compare(i, 2, "/*") == 0)
+    {
+      i = text.find("*/", i);
+      if (i == std::string::npos)
+      {
+        break;
+      }
+      i++;
+      continue;
+    }
+    result += text[i];
+  }
+  return result;
+}
+
+/**
+ * @return numbers of the brace initializer following key, identifiers and casts are skipped
+ */
+static std::vector<long> parseInitializer(const std::string& text, const std::string& key)
+{
+  std::vector<long> numbers;
+  size_t pos = text.find(key);
+  if (pos == std::string::npos)
+  {
+    return numbers;
+  }
+  pos = text.find('{', pos);
+  int depth = 0;
+  for (size_t i=pos; i<text.size(); i++)
+  {
+    char c = text[i];
+    if (c == '{')
+    {
+      depth++;
+    }
+    else if (c == '}' && --depth == 0)
+    {
+      break;
+    }
+    else if (isalpha(c) || c == '_')
+    {
+      while (i + 1 < text.size() && (isalnum(text[i + 1]) || text[i + 1] == '_'))
+      {
+        i++;
+      }
+    }
+    else if (isdigit(c) || (c == '-' && i + 1 < text.size() && isdigit(text[i + 1])))
+    {
+      char* end;
+      numbers.push_back(strtol(text.c_str() + i, &end, 0));
+      i = end - text.c_str() - 1;
+    }
+  }
+  return numbers;
+}
+
+/**
+ * parse font <name> from header text in the format of the Adafruit fontconvert tool
+ */
+static bool parseFont(const std::string& source, const std::string& name, Font& font)
+{
+  std::string text = stripComments(source);
+  std::vector<long> bitmaps = parseInitializer(text, name + "Bitmaps[]");
+  std::vector<long> glyphs = parseInitializer(text, name + "Glyphs[]");
+  std::vector<long> header = parseInitializer(text, "GFXfont " + name + " ");
+  if (bitmaps.empty() || glyphs.empty() || glyphs.size() % 6 || header.size() < 3)
+  {
+    return false;
+  }
+  font.name = name;
+  for (long b : bitmaps)
+  {
+    font.bitmaps.push_back((uint8_t)b);
+  }
+  for (size_t i=0; i<glyphs.size(); i+=6)
+  {
+    font.glyphs.push_back({ (uint16_t)glyphs[i], (uint8_t)glyphs[i + 1], (uint8_t)glyphs[i + 2], (uint8_t)glyphs[i + 3],
+                            (int8_t)glyphs[i + 4], (int8_t)glyphs[i + 5] });
+  }
+  font.first = header[header.size() - 3];
+  font.last = header[header.size() - 2];
+  font.yAdvance = header[header.size() - 1];
+  return font.glyphs.size() == (size_t)(font.last - font.first + 1);
+}
+
+/**
+ * Adafruit_GFX::write() and drawChar() for custom fonts without newline
+ */
+static void render(const Font& font, const std::string& text, Canvas& canvas)
+{
+  for (char c : text)
+  {
+    if (!font.contains(c))
+    {
+      continue;
+    }
+    const Font::Glyph& glyph = font.getGlyph(c);
+    size_t offset = glyph.bitmapOffset;
+    uint8_t bits = 0, bit = 0;
+    for (int y=0; y<glyph.height; y++)
+    {
+      for (int x=0; x<glyph.width; x++)
+      {
+        if (!(bit++ & 7))
+        {
+          bits = offset < font.bitmaps.size()? font.bitmaps[offset++] : 0;
+        }
+        if (bits & 0x80)
+        {
+          canvas.set(canvas.cursor + glyph.xOffset + x, glyph.yOffset + y);
+        }
+        bits <<= 1;
+      }
+    }
+    canvas.cursor += glyph.xAdvance;
+  }
+}
+
+static Font createSubset(const Font& full, const std::string& glyphs)
+{
+  Font subset;
+  subset.name = full.name + "Subset";
+  subset.yAdvance = full.yAdvance;
+  subset.first = 0xFF;
+  for (char c : glyphs)
+  {
+    if (full.contains(c))
+    {
+      subset.first = (uint8_t)c < subset.first? (uint8_t)c : subset.first;
+      subset.last = (uint8_t)c > subset.last? (uint8_t)c : subset.last;
+    }
+  }
+  for (uint16_t c=subset.first; c<=subset.last; c++)
+  {
+    const Font::Glyph& glyph = full.getGlyph((char)c);
+    if (glyphs.find((char)c) == std::string::npos)
+    {
+      subset.glyphs.push_back({ 0, 0, 0, glyph.xAdvance, 0, 0 });
+      continue;
+    }
+    // bytes of glyph: bits are packed without padding per row
+    size_t size = (glyph.width*glyph.height + 7)/8;
+    subset.glyphs.push_back({ (uint16_t)subset.bitmaps.size(), glyph.width, glyph.height, glyph.xAdvance, glyph.xOffset, glyph.yOffset });
+    subset.bitmaps.insert(subset.bitmaps.end(), full.bitmaps.begin() + glyph.bitmapOffset, full.bitmaps.begin() + glyph.bitmapOffset + size);
+  }
+  return subset;
+}
+
+static void writeFont(const Font& font, const std::string& source, const std::string& glyphs)
+{
+  printf("\n// %s, glyphs \"%s\" of %s\n", font.name.c_str(), glyphs.c_str(), source.c_str());
+  printf("const uint8_t %sBitmaps[] PROGMEM = {", font.name.c_str());
+  for (size_t i=0; i<font.bitmaps.size(); i++)
+  {
+    printf("%s0x%02X%s", i % 12? " " : "\n  ", font.bitmaps[i], i + 1 < font.bitmaps.size()? "," : "");
+  }
+  printf(" };\n\n");
+  printf("const GFXglyph %sGlyphs[] PROGMEM = {\n", font.name.c_str());
+  for (size_t i=0; i<font.glyphs.size(); i++)
+  {
+    const Font::Glyph& g = font.glyphs[i];
+    int c = font.first + i;
+    printf("  { %5u, %3u, %3u, %3u, %4d, %4d }%s // 0x%02X '%c'\n", g.bitmapOffset, g.width, g.height, g.xAdvance, g.xOffset, g.yOffset,
+           i + 1 < font.glyphs.size()? "," : " ", c, c);
+  }
+  printf("};\n\n");
+  printf("const GFXfont %s PROGMEM = {\n", font.name.c_str());
+  printf("  (uint8_t  *)%sBitmaps,\n", font.name.c_str());
+  printf("  (GFXglyph *)%sGlyphs,\n", font.name.c_str());
+  printf("  0x%02X, 0x%02X, %u };\n", font.first, font.last, font.yAdvance);
+}
+
+/**
+ * strings printed by displaySensorData() with the glyphs of the subset
+ */
+static std::vector<std::string> getLayoutStrings(const std::string& glyphs)
+{
+  std::vector<std::string> strings;
+  char text[8];
+  for (int t=-400; t<=850; t++)
+  {
+    sprintf(text, "%.1f", t/10.0f);
+    strings.push_back(text);
+  }
+  for (int h=0; h<=100; h++)
+  {
+    sprintf(text, "%d", h);
+    strings.push_back(text);
+  }
+  for (char c : glyphs)
+  {
+    strings.push_back(std::string(1, c));
+  }
+  strings.push_back(glyphs);
+
+  // only strings within the subset, other strings are not printed with this font
+  std::vector<std::string> result;
+  for (const std::string& s : strings)
+  {
+    if (s.find_first_not_of(glyphs) == std::string::npos)
+    {
+      result.push_back(s);
+    }
+  }
+  return result;
+}
+
+/**
+ * @return number of strings rendered differently
+ */
+static unsigned compare(const Font& full, const Font& subset, const std::string& glyphs, unsigned& strings)
+{
+  unsigned mismatches = 0;
+  std::vector<std::string> texts = getLayoutStrings(glyphs);
+  strings = texts.size();
+  for (const std::string& text : texts)
+  {
+    Canvas expected, actual;
+    render(full, text, expected);
+    render(subset, text, actual);
+    if (!(expected == actual))
+    {
+      fprintf(stderr, "%s: \"%s\" differs from %s\n", subset.name.c_str(), text.c_str(), full.name.c_str());
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: font_subset [options] [font.h=glyphs ...]\n"
+    "  -l <dir>   Adafruit GFX library, subsets of FreeSans18pt7b (FONT_VALUE_GLYPHS) and FreeSansBold9pt7b (FONT_UNIT_GLYPHS)\n"
+    "  -c <file>  check subsets in file instead of writing them to stdout\n");
+}
+
+int main(int argc, char* argv[])
+{
+  const char* library = nullptr;
+  const char* check = nullptr;
+  int opt;
+  while ((opt = getopt(argc, argv, "l:c:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'l': library = optarg; break;
+      case 'c': check = optarg; break;
+      default: usage(); return 1;
+    }
+  }
+
+  struct Request
+  {
+    std::string path;
+    std::string glyphs;
+  };
+  std::vector<Request> requests;
+  if (library)
+  {
+    requests.push_back({ std::string(library) + "/Fonts/FreeSans18pt7b.h", FONT_VALUE_GLYPHS });
+    requests.push_back({ std::string(library) + "/Fonts/FreeSansBold9pt7b.h", FONT_UNIT_GLYPHS });
+  }
+  for (int i=optind; i<argc; i++)
+  {
+    const char* separator = strrchr(argv[i], '=');
+    if (!separator || !separator[1])
+    {
+      usage();
+      return 1;
+    }
+    requests.push_back({ std::string(argv[i], separator - argv[i]), separator + 1 });
+  }
+  if (requests.empty())
+  {
+    usage();
+    return 1;
+  }
+
+  std::string checkText = check? readFile(check) : "";
+  if (!check)
+  {
+    printf("/*\n * glyph subsets of Adafruit GFX fonts for displaySensorData(), generated by host/FontSubset.cpp\n");
+    printf(" *\n * The font data is derived from GNU FreeFont, see the license of the Adafruit GFX library.\n */\n\n");
+    printf("#pragma once\n");
+  }
+
+  int status = 0;
+  size_t fullSize = 0, subsetSize = 0;
+  for (const Request& request : requests)
+  {
+    // font name is the file name without extension
+    std::string name = request.path.substr(request.path.find_last_of('/') + 1);
+    name = name.substr(0, name.find('.'));
+    Font full;
+    if (!parseFont(readFile(request.path.c_str()), name, full))
+    {
+      fprintf(stderr, "%s: font %s not found or invalid\n", request.path.c_str(), name.c_str());
+      return 1;
+    }
+    for (char c : request.glyphs)
+    {
+      if (!full.contains(c))
+      {
+        fprintf(stderr, "%s: glyph '%c' not in font\n", name.c_str(), c);
+        status = 1;
+      }
+    }
+
+    Font subset = createSubset(full, request.glyphs);
+    if (check)
+    {
+      Font stored;
+      if (!parseFont(checkText, subset.name, stored))
+      {
+        fprintf(stderr, "%s: font %s not found or invalid\n", check, subset.name.c_str());
+        return 1;
+      }
+      subset = stored;
+    }
+    else
+    {
+      std::string source = request.path.substr(request.path.find_last_of('/') + 1);
+      writeFont(subset, source, request.glyphs);
+    }
+
+    unsigned strings;
+    unsigned mismatches = compare(full, subset, request.glyphs, strings);
+    status = mismatches? 1 : status;
+    fullSize += full.getSize();
+    subsetSize += subset.getSize();
+    fprintf(stderr, "%-24s %3zu glyphs %6zu bytes -> %-8s %3zu glyphs %6zu bytes, %u strings %s\n", full.name.c_str(), full.glyphs.size(),
+            full.getSize(), ("\"" + request.glyphs + "\"").c_str(), subset.glyphs.size(), subset.getSize(), strings,
+            mismatches? "DIFFER" : "match");
+  }
+  fprintf(stderr, "flash: %zu -> %zu bytes\n", fullSize, subsetSize);
+  return status;
+}
@@ -0,0 +1,478 @@
+/*****************************************************************************
+ *
+ * Encode, Decode and Benchmark the Compressed Measurement History
+ *
+ * file:     HistoryTool.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o history_tool HistoryTool.cpp
+ *
+ * usage:
+ *   ./history_tool -g 28                 (encode synthetic 4 week trace, report compression and speed)
+ *   ./history_tool -i trace.csv          (same for CSV trace: time [s],temperature [°C],humidity [%],voltage [V])
+ *   ./history_tool -d < serial.log       (decode "H:" block lines from USB serial or
+ *                                         "C:" chunk lines from OregonDecode -H to CSV)
+ *   ./history_tool -g 28 -p 60 -a        (humidity conversions and error of AcquisitionPlanner on trace)
+ *   ./history_tool -g 28 -p 60 -a -e     (same with temperature swings and humidity steps)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "ArduinoHost.h"
+#include "FileFlash.h"
+#include "../AcquisitionPlanner.h"
+#include "../HistoryLog.h"
+
+typedef HistoryLog<FileFlash> History;
+
+static const byte CHUNK_SYNC = 0xA5;
+static const byte CHUNK_SIZE = 16;    // [bytes] data per radio chunk
+static const byte CHUNK_FRAME_SIZE = 2 + 1 + 2 + CHUNK_SIZE + 1; // preamble, sync, index, data, checksum
+
+struct Options
+{
+  float days = 0;
+  const char* input = nullptr;
+  bool decode = false;
+  uint16_t rows = 128;    // HISTORY_ROWS
+  uint32_t period = 180;  // [s]
+  uint32_t repeat = 20;
+  bool planner = false;
+  bool events = false;
+};
+
+/**
+ * transient of an event: rise with time constant up to the duration, then decay
+ *
+ * @param t [s] since start of event
+ * @return 0 .. 1
+ */
+static double getTransient(double t, double rise, double duration, double decay)
+{
+  if (t < 0)
+  {
+    return 0;
+  }
+  double peak = 1 - exp(-std::min(t, duration)/rise);
+  return t < duration? peak : peak*exp(-(t - duration)/decay);
+}
+
+/**
+ * synthetic trace: diurnal temperature with weather drift, anticorrelated
+ * humidity, supply voltage charged by day, moving average of 4 samples and
+ * quantization like SolarDHT
+ *
+ * With events each day has at a random time
+ * - a ventilation: temperature -3 °C and humidity -10 % within ~5 min, recovery ~1 h
+ * - a shower: humidity +20 % and temperature +1 °C within ~3 min, decay ~45 min
+ * - a humidity step of +-6 % at constant temperature (weather front), decay ~6 h
+ */
+static std::vector<History::Sample> generateTrace(const Options& options)
+{
+  std::mt19937 rng(7);
+  std::normal_distribution<double> noise(0, 1);
+  std::uniform_int_distribution<int> jitter(-2, 2);
+
+  std::vector<History::Sample> trace;
+  double weather = 0, humidityDrift = 0, voltage = 3.0;
+  double t[4] = {}, h[4] = {};
+  uint32_t time = 0;
+  size_t n = options.days*86400/options.period;
+
+  // event times per day: ventilation, shower, weather front
+  std::uniform_real_distribution<double> uniform(0, 86400);
+  std::vector<double> events[3];
+  for (uint32_t d=0; options.events && d<=options.days + 1; d++)
+  {
+    for (std::vector<double>& e : events)
+    {
+      e.push_back(86400.0*d + uniform(rng));
+    }
+  }
+
+  for (size_t i=0; i<n; i++)
+  {
+    double day = fmod(time/86400.0, 1.0);
+    double ventilation = 0, shower = 0, front = 0;
+    uint32_t today = time/86400;
+    for (uint32_t d = today? today - 1 : 0; options.events && d<=today; d++)
+    {
+      ventilation += getTransient(time - events[0][d], 300, 900, 3600);
+      shower += getTransient(time - events[1][d], 180, 600, 2700);
+      front += (d % 2? 6 : -6)*getTransient(time - events[2][d], 180, 1800, 21600);
+    }
+    weather += 0.02*noise(rng);
+    humidityDrift += 0.05*noise(rng);
+    double sun = std::max(0.0, sin(2*M_PI*(day - 0.25)));
+    t[i % 4] = 12 + 6*sin(2*M_PI*(day - 0.375)) + weather - 3*ventilation + shower + 0.04*noise(rng);
+    h[i % 4] = std::min(100.0, std::max(0.0, 65 - 15*sin(2*M_PI*(day - 0.375)) - 2*weather + humidityDrift - 10*ventilation
+                                                + 20*shower + front + 0.3*noise(rng)));
+    voltage = std::min(3.45, std::max(2.5, voltage + 0.004*sun - 0.0008));
+    size_t count = std::min<size_t>(i + 1, 4);
+    double ta = 0, ha = 0;
+    for (size_t k=0; k<count; k++) ta += t[k], ha += h[k];
+
+    History::Sample s;
+    s.time = time;
+    s.temperature = round(10*ta/count);
+    s.humidity = round(10*ha/count);
+    s.voltage = round(100*(voltage + 0.005*noise(rng)));
+    trace.push_back(s);
+
+    time += options.period + jitter(rng);
+  }
+  return trace;
+}
+
+static std::vector<History::Sample> readTrace(const char* path)
+{
+  std::vector<History::Sample> trace;
+  FILE* f = fopen(path, "r");
+  if (!f)
+  {
+    perror(path);
+    return trace;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), f))
+  {
+    double time, temperature, humidity, voltage;
+    if (sscanf(line, "%lf,%lf,%lf,%lf", &time, &temperature, &humidity, &voltage) == 4)
+    {
+      History::Sample s;
+      s.time = time;
+      s.temperature = round(temperature*10);
+      s.humidity = round(humidity*10);
+      s.voltage = round(voltage*100);
+      trace.push_back(s);
+    }
+  }
+  fclose(f);
+  return trace;
+}
+
+static void printSample(const History::Sample& s, byte flags)
+{
+  printf("%u,%.1f,%.1f,%.2f,%s\n", s.time, s.temperature/10.0, s.humidity/10.0, s.voltage/100.0,
+         flags & History::FLAG_EPOCH? "epoch" : "uptime");
+}
+
+/**
+ * encode trace, verify round trip and report compression ratio and speed
+ */
+static int benchmark(const std::vector<History::Sample>& trace, const Options& options)
+{
+  if (trace.empty())
+  {
+    fprintf(stderr, "error: empty trace\n");
+    return 1;
+  }
+
+  // encode
+  double encodeTime = 0;
+  uint32_t blocksUsed = 0;
+  for (uint32_t r=0; r<options.repeat; r++)
+  {
+    FileFlash flash(nullptr, options.rows);
+    History history(flash);
+    history.begin();
+    auto start = std::chrono::steady_clock::now();
+    for (const History::Sample& s : trace)
+    {
+      history.append(s);
+      if (history.isFull())
+      {
+        history.flush();
+      }
+    }
+    while (history.isDirty() && history.flush());
+    encodeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    blocksUsed = history.getSequence();
+  }
+
+  // decode latest ring content and verify
+  FileFlash flash(nullptr, options.rows);
+  History history(flash);
+  history.begin();
+  for (const History::Sample& s : trace)
+  {
+    history.append(s);
+    if (history.isFull())
+    {
+      history.flush();
+    }
+  }
+  while (history.isDirty() && history.flush());
+
+  std::vector<std::vector<byte>> blocks;
+  for (uint16_t n=history.getBlocks(); n>0; n--)
+  {
+    uint16_t index = history.getRecentBlock(n - 1);
+    if (index != History::NO_BLOCK)
+    {
+      std::vector<byte> block(History::BLOCK_SIZE);
+      history.readBlock(index, block.data());
+      blocks.push_back(block);
+    }
+  }
+
+  std::vector<History::Sample> decoded;
+  double decodeTime = 0;
+  for (uint32_t r=0; r<options.repeat; r++)
+  {
+    decoded.clear();
+    auto start = std::chrono::steady_clock::now();
+    for (const std::vector<byte>& block : blocks)
+    {
+      History::decode(block.data(), [&](const History::Sample& s, byte) { decoded.push_back(s); });
+    }
+    decodeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  size_t offset = trace.size() - decoded.size();
+  uint32_t errors = 0;
+  for (size_t i=0; i<decoded.size(); i++)
+  {
+    const History::Sample& a = trace[offset + i];
+    const History::Sample& b = decoded[i];
+    if (a.time != b.time || a.temperature != b.temperature || a.humidity != b.humidity || a.voltage != b.voltage)
+    {
+      errors++;
+    }
+  }
+
+  double bytesPerSample = (double)blocksUsed*History::BLOCK_SIZE/trace.size();
+  double span = trace.size() > 1? (trace.back().time - trace.front().time)/86400.0 : 0;
+  double samplesPerDay = span > 0? trace.size()/span : 0;
+  printf("samples:         %zu (%.1f days)\n", trace.size(), span);
+  printf("blocks:          %u of %u bytes\n", blocksUsed, History::BLOCK_SIZE);
+  printf("bytes/sample:    %.2f (raw 10, ratio %.1fx)\n", bytesPerSample, 10/bytesPerSample);
+  printf("samples/block:   %.1f\n", (double)trace.size()/blocksUsed);
+  if (samplesPerDay > 0)
+  {
+    printf("ring capacity:   %.1f days in %u rows\n", (double)history.getBlocks()*History::BLOCK_SIZE/bytesPerSample/samplesPerDay, options.rows);
+  }
+  printf("encode:          %.1f ns/sample\n", 1e9*encodeTime/options.repeat/trace.size());
+  printf("decode:          %.1f ns/sample\n", 1e9*decodeTime/options.repeat/std::max<size_t>(1, decoded.size()));
+  printf("retained:        %zu samples\n", decoded.size());
+  printf("mismatches:      %u\n", errors);
+
+  return errors? 2 : 0;
+}
+
+/**
+ * replay trace with AcquisitionPlanner: humidity is held between conversions,
+ * report ratio of humidity conversions, share of each trigger and error vs.
+ * converting every time, deltas 0 (-) only convert every n-th acquisition
+ */
+static int simulatePlanner(const std::vector<History::Sample>& trace)
+{
+  if (trace.empty())
+  {
+    fprintf(stderr, "error: empty trace\n");
+    return 1;
+  }
+
+  struct Variant
+  {
+    byte every;
+    float temperatureDelta; // [°C]
+    float humidityDelta;    // [%]
+  };
+  const Variant variants[] = {
+    { 1,  0.3, 1.0 },
+    { 3,  0.3, 1.0 },
+    { 5,  0,   0   },
+    { 5,  0.3, 1.0 },  // default
+    { 10, 0,   0   },
+    { 10, 0.3, 1.0 },
+    { 10, 0.5, 2.0 },
+    { 20, 0,   0   },
+    { 20, 1.0, 3.0 },
+  };
+
+  printf("%-6s %8s %8s %11s %8s %8s %8s %9s %9s\n", "every", "T delta", "H delta", "conversions", "by every", "by T", "by H",
+         "avg err", "max err");
+  printf("%-6s %8s %8s %11s %8s %8s %8s %9s %9s\n", "", "[°C]", "[%]", "", "", "", "", "[%]", "[%]");
+  for (const Variant& v : variants)
+  {
+    AcquisitionPlanner planner(v.every, v.temperatureDelta > 0? v.temperatureDelta : 1e6f, v.humidityDelta > 0? v.humidityDelta : 1e6f);
+    size_t conversions = 0;
+    size_t triggers[AcquisitionPlanner::TRIGGER_HUMIDITY + 1] = {};
+    double sum = 0, max = 0;
+    float held = 0;
+    for (const History::Sample& s : trace)
+    {
+      float temperature = s.temperature/10.0f;
+      float humidity = s.humidity/10.0f;
+      AcquisitionPlanner::Trigger trigger = planner.getTrigger();
+      if (trigger != AcquisitionPlanner::TRIGGER_NONE)
+      {
+        planner.addHumidity(humidity, temperature);
+        held = humidity;
+        conversions++;
+        triggers[trigger]++;
+      }
+      else
+      {
+        planner.addTemperature(temperature);
+      }
+      double error = fabs(held - humidity);
+      sum += error;
+      max = std::max(max, error);
+    }
+    char temperatureDelta[16] = "-", humidityDelta[16] = "-";
+    if (v.temperatureDelta > 0) snprintf(temperatureDelta, sizeof(temperatureDelta), "%.1f", v.temperatureDelta);
+    if (v.humidityDelta > 0) snprintf(humidityDelta, sizeof(humidityDelta), "%.1f", v.humidityDelta);
+    printf("%-6u %8s %8s %10.1f%% %7.1f%% %7.1f%% %7.1f%% %9.2f %9.1f\n", v.every, temperatureDelta, humidityDelta,
+           100.0*conversions/trace.size(), 100.0*triggers[AcquisitionPlanner::TRIGGER_EVERY]/trace.size(),
+           100.0*triggers[AcquisitionPlanner::TRIGGER_TEMPERATURE]/trace.size(),
+           100.0*triggers[AcquisitionPlanner::TRIGGER_HUMIDITY]/trace.size(), sum/trace.size(), max);
+  }
+  return 0;
+}
+
+static bool parseHex(const char* hex, std::vector<byte>& data)
+{
+  data.clear();
+  for (; isxdigit(hex[0]) && isxdigit(hex[1]); hex += 2)
+  {
+    char b[3] = { hex[0], hex[1], 0 };
+    data.push_back(strtoul(b, nullptr, 16));
+  }
+  return !data.empty();
+}
+
+/**
+ * decode block lines (USB serial) and chunk lines (radio) from stdin
+ */
+static int decodeDump()
+{
+  std::vector<std::vector<byte>> blocks;
+  std::map<uint16_t, std::vector<byte>> chunked; // ring index -> block
+  std::map<uint16_t, byte> chunkMask;
+  char line[512];
+  while (fgets(line, sizeof(line), stdin))
+  {
+    std::vector<byte> data;
+    if (!strncmp(line, "H:", 2) && parseHex(line + 2, data) && data.size() == History::BLOCK_SIZE)
+    {
+      blocks.push_back(data);
+    }
+    else if (!strncmp(line, "C:", 2) && parseHex(line + 2, data) && data.size() == CHUNK_FRAME_SIZE && data[2] == CHUNK_SYNC)
+    {
+      byte sum = 0;
+      for (byte i=2; i<CHUNK_FRAME_SIZE - 1; i++) sum += data[i];
+      if (sum != data[CHUNK_FRAME_SIZE - 1])
+      {
+        continue;
+      }
+      uint16_t chunk = data[3] | (data[4] << 8);
+      std::vector<byte>& block = chunked[chunk/4];
+      block.resize(History::BLOCK_SIZE);
+      memcpy(block.data() + (chunk % 4)*CHUNK_SIZE, data.data() + 5, CHUNK_SIZE);
+      chunkMask[chunk/4] |= 1 << (chunk % 4);
+    }
+  }
+
+  // complete chunked blocks, ordered by block sequence
+  std::map<uint32_t, std::vector<byte>> ordered;
+  for (auto& c : chunked)
+  {
+    if (chunkMask[c.first] == 0xF && History::isValidHeader(c.second.data()))
+    {
+      uint32_t sequence = c.second[0] | (c.second[1] << 8) | (c.second[2] << 16) | ((uint32_t)c.second[3] << 24);
+      ordered[sequence] = c.second;
+    }
+  }
+  for (auto& o : ordered)
+  {
+    blocks.push_back(o.second);
+  }
+
+  printf("time,temperature,humidity,voltage,time_base\n");
+  uint32_t samples = 0;
+  for (const std::vector<byte>& block : blocks)
+  {
+    samples += History::decode(block.data(), printSample);
+  }
+  fprintf(stderr, "%zu blocks, %u samples\n", blocks.size(), samples);
+  return 0;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: history_tool [options]\n"
+    "  -g <days>  encode synthetic trace\n"
+    "  -i <file>  encode CSV trace (time [s],temperature [°C],humidity [%%],voltage [V])\n"
+    "  -d         decode H:/C: lines from stdin to CSV\n"
+    "  -r <n>     flash rows, default 128\n"
+    "  -p <s>     period of synthetic trace, default 180\n"
+    "  -R <n>     benchmark repetitions, default 20\n"
+    "  -a         replay trace with acquisition planner instead of encoding\n"
+    "  -e         add temperature swings and humidity steps to synthetic trace\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int opt;
+  while ((opt = getopt(argc, argv, "g:i:dr:p:R:aeh")) != -1)
+  {
+    switch (opt)
+    {
+      case 'g': options.days = atof(optarg); break;
+      case 'i': options.input = optarg; break;
+      case 'd': options.decode = true; break;
+      case 'r': options.rows = std::max(1, atoi(optarg)); break;
+      case 'p': options.period = std::max(1, atoi(optarg)); break;
+      case 'R': options.repeat = std::max(1, atoi(optarg)); break;
+      case 'a': options.planner = true; break;
+      case 'e': options.events = true; break;
+      default: usage(); return 1;
+    }
+  }
+
+  if (options.decode)
+  {
+    return decodeDump();
+  }
+  if (options.input || options.days > 0)
+  {
+    std::vector<History::Sample> trace = options.input? readTrace(options.input) : generateTrace(options);
+    return options.planner? simulatePlanner(trace) : benchmark(trace, options);
+  }
+
+  usage();
+  return 1;
+}
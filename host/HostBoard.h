@@ -0,0 +1,391 @@
+/*****************************************************************************
+ *
+ * Peripheral Model and Event Loop to Run the Sketch on the Host Shims
+ *
+ * file:     HostBoard.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <Analog2DigitalConverter.h>
+
+#include "../ClockManager.hpp"
+#include "../DirectMemoryAccess.hpp"
+#include "../NVMFlash.hpp"
+#include "../SYN115_Transmitter.hpp"
+
+/**
+ * external device with its own event timing (e.g. a radio model behind the
+ * SPI shim), synchronized by the board model with each host time advance
+ */
+class HostDevice
+{
+public:
+  virtual ~HostDevice() = default;
+
+public:
+  /**
+   * catch up with the host time, sample input pins and drive output pins
+   */
+  virtual void sync() = 0;
+
+  /**
+   * @return [µs] host time of the next internal event, HostBoard::NONE if idle
+   */
+  virtual uint64_t getNextEvent() const = 0;
+};
+
+/**
+ * peripherals of the directory shim that the sketch drives through
+ * registers, modelled on the host time:
+ * - DMAC: a valid descriptor completes after its beats, the ADC channel
+ *   fills the samples with the values of Analog2DigitalConverter::setValue()
+ *   (scan order from INPUTCTRL), the radio channel takes one TCC1 period per
+ *   beat; completion sets INTSTATUS and pends DMAC_IRQn
+ * - TCC1: one shot in normal frequency mode raises OVF and pends TCC1_IRQn
+ *   after PER + 1 ticks of the peripheral clock
+ *
+ * An attached HostDevice is synchronized with the model.
+ *
+ * run() serves pending IRQs and level triggered pin interrupts like the NVIC
+ * and EIC, then advances the host time to the next timer or model deadline.
+ * Interrupts never preempt, the sketch is expected to poll NVIC pending
+ * flags where it busy waits (e.g. AdcSequencer::wait()).
+ */
+class HostBoard
+{
+public:
+  static const uint32_t ADC_CONVERSION_TIME = 18; // [µs] per beat
+  static const uint64_t NONE = ~0ULL;
+
+private:
+  HostBoard() = default;
+
+public:
+  static HostBoard& instance()
+  {
+    static HostBoard board;
+    return board;
+  }
+
+public:
+  /**
+   * hook the model into the host time of the shim
+   */
+  void install()
+  {
+    getHostModel() = []{ HostBoard::instance().model(); };
+  }
+
+  /**
+   * @param device synchronized with the host time, null to detach
+   */
+  void attach(HostDevice* device)
+  {
+    this->device = device;
+    if (device)
+    {
+      device->sync();
+    }
+  }
+
+  /**
+   * cancel all timers, pending interrupts and transfers, e.g. between sketch instances
+   */
+  void reset()
+  {
+    HostTimer::cancelAll();
+    for (byte irq=0; irq<HOST_IRQS; irq++)
+    {
+      getHostNvic().pending[irq] = false;
+    }
+    for (byte pin=0; pin<HOST_PINS; pin++)
+    {
+      getHostPin(pin).interrupt = nullptr;
+    }
+    for (byte channel=0; channel<DirectMemoryAccess::CHANNELS; channel++)
+    {
+      DmacDescriptor* descriptor = getDescriptor(channel);
+      if (descriptor)
+      {
+        descriptor->BTCTRL.reg = 0;
+      }
+      dmaDeadlines[channel] = NONE;
+    }
+    DMAC->INTSTATUS.reg = 0;
+    oneShotDeadline = NONE;
+    oneShotState = ONE_SHOT_IDLE;
+  }
+
+  /**
+   * serve interrupts and advance the host time until the given time
+   *
+   * @param until [µs] host time
+   * @return number of ISR calls
+   */
+  uint32_t run(uint64_t until)
+  {
+    uint32_t calls = 0;
+    for (;;)
+    {
+      // pick up registers and pins written by the ISR
+      model();
+      if (serveInterrupt())
+      {
+        calls++;
+        continue;
+      }
+
+      HostTimer* timer = HostTimer::getNext();
+      uint64_t modelDeadline = getNextDeadline();
+      uint64_t next = timer && timer->deadline < modelDeadline? timer->deadline : modelDeadline;
+      if (next == NONE || next > until)
+      {
+        if (until > getHostTime())
+        {
+          advanceHostTime(until - getHostTime());
+        }
+        return calls;
+      }
+
+      if (timer && timer->deadline == next)
+      {
+        HostTimer::fireNext();
+        calls++;
+      }
+      else
+      {
+        advanceHostTime(next > getHostTime()? next - getHostTime() : 1);
+      }
+    }
+  }
+
+  /**
+   * @return number of completed radio DMA transfers (SYN115 packets)
+   */
+  uint32_t getTransmissions() const
+  {
+    return transmissions;
+  }
+
+  /**
+   * make the reserved flash region writable, the sketch places it in .rodata
+   */
+  static void unprotect(const NVMFlash& flash)
+  {
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)flash.getRegion() & ~(page - 1);
+    uintptr_t end = ((uintptr_t)flash.getRegion() + (uintptr_t)flash.getRows()*NVMFlash::ROW_SIZE + page - 1) & ~(page - 1);
+    mprotect((void*)start, end - start, PROT_READ | PROT_WRITE);
+  }
+
+  /**
+   * disabled flash member of a variant
+   */
+  template<class T> static void unprotect(const T&) {}
+
+private:
+  enum OneShotState
+  {
+    ONE_SHOT_IDLE,
+    ONE_SHOT_RUNNING,
+    ONE_SHOT_EXPIRED
+  };
+
+private:
+  static DmacDescriptor* getDescriptor(byte channel)
+  {
+    DmacDescriptor* descriptors = (DmacDescriptor*)DMAC->BASEADDR.reg;
+    return descriptors? descriptors + channel : nullptr;
+  }
+
+  /**
+   * @return [µs] time of next model event, NONE if idle
+   */
+  uint64_t getNextDeadline() const
+  {
+    uint64_t next = oneShotState == ONE_SHOT_RUNNING? oneShotDeadline : NONE;
+    if (device && device->getNextEvent() < next)
+    {
+      next = device->getNextEvent();
+    }
+    for (byte channel=0; channel<DirectMemoryAccess::CHANNELS; channel++)
+    {
+      if (dmaDeadlines[channel] < next)
+      {
+        next = dmaDeadlines[channel];
+      }
+    }
+    return next;
+  }
+
+  /**
+   * @return true if an ISR was called
+   */
+  bool serveInterrupt()
+  {
+    HostNvic& nvic = getHostNvic();
+    if (nvic.pending[DMAC_IRQn])
+    {
+      nvic.pending[DMAC_IRQn] = false;
+      DirectMemoryAccess::instance().handleInterrupt();
+      DMAC->INTSTATUS.reg = 0;
+      return true;
+    }
+    if (nvic.pending[TCC1_IRQn])
+    {
+      nvic.pending[TCC1_IRQn] = false;
+      SYN115_Transmitter::handleInterrupt();
+      return true;
+    }
+    for (byte pin=0; pin<HOST_PINS; pin++)
+    {
+      HostPin& p = getHostPin(pin);
+      if (p.interrupt && p.interruptMode == LOW && p.level == LOW)
+      {
+        p.interrupt();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void model()
+  {
+    uint64_t now = getHostTime();
+
+    if (device)
+    {
+      device->sync();
+    }
+
+    // TCC1 one shot
+    bool oneShot = (TCC1->CTRLA.reg & TCC_CTRLA_ENABLE) && (TCC1->WAVE.reg & TCC_WAVE_WAVEGEN_Msk) == TCC_WAVE_WAVEGEN_NFRQ;
+    if (!oneShot)
+    {
+      oneShotState = ONE_SHOT_IDLE;
+    }
+    else if (oneShotState == ONE_SHOT_IDLE)
+    {
+      oneShotState = ONE_SHOT_RUNNING;
+      oneShotDeadline = now + getTicksDuration(TCC1->PER.reg + 1ULL);
+    }
+    if (oneShotState == ONE_SHOT_RUNNING && now >= oneShotDeadline)
+    {
+      oneShotState = ONE_SHOT_EXPIRED;
+      TCC1->INTFLAG.reg.raise(TCC_INTFLAG_OVF);
+      if (TCC1->INTENSET.reg & TCC_INTENSET_OVF)
+      {
+        NVIC_SetPendingIRQ(TCC1_IRQn);
+      }
+    }
+
+    // DMAC channels
+    for (byte channel=0; channel<DirectMemoryAccess::CHANNELS; channel++)
+    {
+      DmacDescriptor* descriptor = getDescriptor(channel);
+      if (!descriptor || !(descriptor->BTCTRL.reg & DMAC_BTCTRL_VALID))
+      {
+        dmaDeadlines[channel] = NONE;
+        continue;
+      }
+      if (dmaDeadlines[channel] == NONE)
+      {
+        uint64_t beats = descriptor->BTCNT.reg;
+        dmaDeadlines[channel] = now + (channel == DirectMemoryAccess::CHANNEL_ADC? beats*ADC_CONVERSION_TIME
+                                                                                 : getTicksDuration(beats*(TCC1->PER.reg + 1ULL)));
+      }
+      if (now >= dmaDeadlines[channel])
+      {
+        if (channel == DirectMemoryAccess::CHANNEL_ADC)
+        {
+          convert(*descriptor);
+        }
+        else
+        {
+          transmissions++;
+        }
+        descriptor->BTCTRL.reg &= ~DMAC_BTCTRL_VALID;
+        dmaDeadlines[channel] = NONE;
+        DMAC->INTSTATUS.reg |= 1 << channel;
+        NVIC_SetPendingIRQ(DMAC_IRQn);
+      }
+    }
+  }
+
+  /**
+   * @return [µs] duration of peripheral clock ticks
+   */
+  static uint64_t getTicksDuration(uint64_t ticks)
+  {
+    return (ticks*1000000 + ClockManager::PERIPHERAL_CLOCK - 1)/ClockManager::PERIPHERAL_CLOCK;
+  }
+
+  /**
+   * fill the destination of an ADC scan sequence with 12 bit results, INT1V reference
+   */
+  static void convert(const DmacDescriptor& descriptor)
+  {
+    Analog2DigitalConverter& adc = Analog2DigitalConverter::instance();
+    uint32_t inputCtrl = ADC->INPUTCTRL.reg;
+    byte inputs = ((inputCtrl >> 16) & 0xF) + 1;
+    byte first = inputCtrl & 0x1F;
+    uint16_t beats = descriptor.BTCNT.reg;
+    uint16_t* samples = (uint16_t*)descriptor.DSTADDR.reg - beats;
+    for (uint16_t i=0; i<beats; i++)
+    {
+      byte input = first + i%inputs;
+      float value = adc.getValue(input);
+      float lsb;
+      switch (input)
+      {
+        case ADC_INPUTCTRL_MUXPOS_TEMP_Val:
+          // temperature log row of the shim: 2730 at 25 °C, 3321 at 85 °C
+          lsb = 2730 + (value - 25)*(3321 - 2730)/60;
+          break;
+        case ADC_INPUTCTRL_MUXPOS_SCALEDCOREVCC_Val:
+        case ADC_INPUTCTRL_MUXPOS_SCALEDIOVCC_Val:
+          lsb = value/4*4095;
+          break;
+        default:
+          lsb = value*4095;
+          break;
+      }
+      // 1 LSB noise
+      lsb += (i/inputs) & 1? 0.5f : -0.5f;
+      samples[i] = lsb < 0? 0 : lsb > 4095? 4095 : (uint16_t)lsb;
+    }
+  }
+
+private:
+  uint64_t dmaDeadlines[DirectMemoryAccess::CHANNELS] = { NONE, NONE };
+  uint64_t oneShotDeadline = NONE;
+  OneShotState oneShotState = ONE_SHOT_IDLE;
+  uint32_t transmissions = 0;
+  HostDevice* device = nullptr;
+};
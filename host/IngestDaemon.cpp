@@ -0,0 +1,775 @@
+/*****************************************************************************
+ *
+ * Gateway Ingestion of Sensor Frames into a Memory Mapped Time Series Store
+ *
+ * file:     IngestDaemon.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o ingest_daemon IngestDaemon.cpp
+ *
+ * usage:
+ *   rtl_sdr -f 433920000 -s 2000000 - | ./oregon_decode - | ./ingest_daemon -d store
+ *   ./ingest_daemon -d store -u 4330       (frames as UDP datagrams)
+ *   ./ingest_daemon -d store -q            (latest value of each node)
+ *   ./ingest_daemon -B 1000000 -n 500      (ingest benchmark with synthetic traffic)
+ *
+ * Input lines (stdin) or datagrams (UDP) contain one frame each, either as
+ * printed by oregon_decode ("id=F824 ch=1 rc=5A batt=ok temp=21.5 hum=50"),
+ * as hex string of OregonScientific::getMessage() or, for UDP only, as the
+ * raw message bytes. A line may start with "time=<s>" (epoch time, e.g.
+ * from a replay), otherwise the receive time is used.
+ *
+ * Frames of the same node with the same content within the dedup window
+ * (-w) are repeats (TRANSMIT_REPEATS, several receivers) and dropped.
+ *
+ * A node is identified by model ID, channel and rolling code. Oregon
+ * Scientific sensors choose a new rolling code after a battery change, so an
+ * unknown rolling code is mapped to an existing node of the same model ID and
+ * channel that is overdue (silent for more than 1.5 periods, less than -m)
+ * and whose last temperature is closest to the frame, within the tolerance
+ * (-T) and at least 0.5 °C closer than any other overdue node. Otherwise a
+ * new node is created. The rolling code of SolarDHT is
+ * derived from its serial ID and does not change.
+ *
+ * Each node has a time series file in the store directory, see
+ * TimeSeriesStore.h. The node registry is rebuilt from the file headers at
+ * start, no other state is kept.
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "ArduinoHost.h"
+#include "../OregonScientific.h"
+#include "OregonScientificDecoder.h"
+#include "TimeSeriesStore.h"
+
+struct Options
+{
+  const char* directory = "store";
+  uint32_t capacity = 65536;  // [samples] per node, ~4.5 months at 3 min period
+  double window = 2;          // [s] dedup window
+  double period = 180;        // [s] transmit period of the nodes
+  double maxSilence = 86400;  // [s] max. silence of node for rolling code change
+  float tolerance = 2;        // [°C] max. temperature change for rolling code change
+  uint16_t udpPort = 0;
+  bool verbose = false;
+  bool query = false;
+  uint32_t benchmarkFrames = 0;
+  uint32_t benchmarkNodes = 500;
+  byte benchmarkRepeats = 2;
+};
+
+/**
+ * node registry with deduplication, appends new samples to the store
+ */
+class Ingest
+{
+public:
+  enum Result
+  {
+    STORED,
+    NEW_NODE,
+    REMAPPED,
+    DUPLICATE,
+    FAILED
+  };
+
+  struct Statistics
+  {
+    uint32_t frames = 0;
+    uint32_t invalid = 0;
+    uint32_t stored = 0;
+    uint32_t duplicates = 0;
+    uint32_t newNodes = 0;
+    uint32_t remapped = 0;
+    uint32_t ambiguous = 0;  // unknown rolling code with several similar candidates
+  };
+
+public:
+  Ingest(TimeSeriesStore& store, const Options& options) : store(store), options(options)
+  {
+    for (auto& entry : store.getFiles())
+    {
+      TimeSeriesFile& file = *entry.second;
+      const TimeSeriesFile::Header& header = file.getHeader();
+      Node& node = getNode(header.node);
+      node.file = &file;
+      TimeSeriesFile::Sample sample;
+      if (file.getLatest(sample))
+      {
+        node.lastTime = sample.time;
+        node.lastTemp = (int16_t)lroundf(sample.temp*10);
+        node.lastHum = sample.hum;
+        node.lastLowBatt = sample.lowBatt;
+      }
+      keys[getKey(header.id, header.channel, header.rollingCode)] = header.node;
+      groups[getGroup(header.id, header.channel)].push_back(header.node);
+      nextNode = std::max(nextNode, (uint16_t)(header.node + 1));
+    }
+  }
+
+public:
+  /**
+   * @param time [s] receive time
+   * @param node stable node ID if stored
+   */
+  Result add(const OregonScientificDecoder::Frame& frame, double time, uint16_t& node)
+  {
+    statistics.frames++;
+    Result result = STORED;
+    auto key = keys.find(getKey(frame.id, frame.channel, frame.rollingCode));
+    if (key != keys.end())
+    {
+      node = key->second;
+    }
+    else
+    {
+      result = resolve(frame, time, node);
+      if (result == FAILED)
+      {
+        return FAILED;
+      }
+    }
+
+    Node& state = nodes[node];
+    int16_t temp = (int16_t)lroundf(frame.temp*10);
+    if (state.lastTime >= 0 && time - state.lastTime < options.window && temp == state.lastTemp
+        && frame.hum == state.lastHum && frame.lowBatt == state.lastLowBatt)
+    {
+      statistics.duplicates++;
+      return DUPLICATE;
+    }
+    state.lastTime = time;
+    state.lastTemp = temp;
+    state.lastHum = frame.hum;
+    state.lastLowBatt = frame.lowBatt;
+
+    TimeSeriesFile::Sample sample = { (uint32_t)time, frame.temp, frame.hum, frame.lowBatt };
+    state.file->append(sample);
+    statistics.stored++;
+    return result;
+  }
+
+  /**
+   * count line or datagram without valid frame
+   */
+  void addInvalid()
+  {
+    statistics.invalid++;
+  }
+
+  const Statistics& getStatistics() const
+  {
+    return statistics;
+  }
+
+private:
+  static const int MIN_DISTANCE_MARGIN = 5; // [0.1 °C] min. temperature distance of best to second candidate
+
+  struct Node
+  {
+    TimeSeriesFile* file = nullptr;
+    double lastTime = -1;  // [s]
+    int16_t lastTemp = 0;  // [0.1 °C]
+    byte lastHum = 0;
+    bool lastLowBatt = false;
+  };
+
+private:
+  static uint32_t getKey(uint16_t id, byte channel, byte rollingCode)
+  {
+    return ((uint32_t)id << 16) | (channel << 8) | rollingCode;
+  }
+
+  static uint32_t getGroup(uint16_t id, byte channel)
+  {
+    return ((uint32_t)id << 8) | channel;
+  }
+
+  Node& getNode(uint16_t node)
+  {
+    if (node >= nodes.size())
+    {
+      nodes.resize(node + 1);
+    }
+    return nodes[node];
+  }
+
+  /**
+   * map unknown rolling code to overdue node or create new node
+   */
+  Result resolve(const OregonScientificDecoder::Frame& frame, double time, uint16_t& node)
+  {
+    std::vector<uint16_t>& group = groups[getGroup(frame.id, frame.channel)];
+    // closest temperature of overdue nodes, ambiguous if the second closest is nearly as close
+    int16_t temp = (int16_t)lroundf(frame.temp*10);
+    int best = 10*options.tolerance + 1, second = best;
+    for (uint16_t n : group)
+    {
+      const Node& state = nodes[n];
+      double silence = time - state.lastTime;
+      int distance = abs(temp - state.lastTemp);
+      if (state.lastTime >= 0 && silence > 1.5*options.period && silence < options.maxSilence && distance < second)
+      {
+        if (distance < best)
+        {
+          second = best;
+          best = distance;
+          node = n;
+        }
+        else
+        {
+          second = distance;
+        }
+      }
+    }
+    bool found = best <= 10*options.tolerance;
+    bool ambiguous = found && second - best < MIN_DISTANCE_MARGIN;
+
+    Result result;
+    if (found && !ambiguous)
+    {
+      TimeSeriesFile::Header& header = nodes[node].file->getHeader();
+      keys.erase(getKey(header.id, header.channel, header.rollingCode));
+      header.rollingCode = frame.rollingCode;
+      header.remaps++;
+      statistics.remapped++;
+      result = REMAPPED;
+    }
+    else
+    {
+      if (ambiguous)
+      {
+        statistics.ambiguous++;
+      }
+      if (nextNode == 0xFFFF)
+      {
+        fprintf(stderr, "too many nodes\n");
+        return FAILED;
+      }
+      node = nextNode;
+      TimeSeriesFile* file = store.get(node);
+      if (!file)
+      {
+        return FAILED;
+      }
+      nextNode++;
+      TimeSeriesFile::Header& header = file->getHeader();
+      header.id = frame.id;
+      header.channel = frame.channel;
+      header.rollingCode = frame.rollingCode;
+      getNode(node).file = file;
+      group.push_back(node);
+      statistics.newNodes++;
+      result = NEW_NODE;
+    }
+    keys[getKey(frame.id, frame.channel, frame.rollingCode)] = node;
+    return result;
+  }
+
+private:
+  TimeSeriesStore& store;
+  const Options& options;
+  std::vector<Node> nodes;                           // by node ID
+  std::unordered_map<uint32_t, uint16_t> keys;       // model ID, channel, rolling code -> node ID
+  std::unordered_map<uint32_t, std::vector<uint16_t>> groups; // model ID, channel -> node IDs
+  uint16_t nextNode = 1;
+  Statistics statistics;
+};
+
+static int hexValue(char c)
+{
+  return c >= '0' && c <= '9'? c - '0' : c >= 'A' && c <= 'F'? c - 'A' + 10 : c >= 'a' && c <= 'f'? c - 'a' + 10 : -1;
+}
+
+/**
+ * parse frame line, see file header
+ *
+ * @param time [s] set if the line has a time prefix
+ * @return false if the line contains no valid frame
+ */
+static bool parseLine(const OregonScientificDecoder& decoder, const char* line, OregonScientificDecoder::Frame& frame, double& time)
+{
+  int offset = 0;
+  if (sscanf(line, " time=%lf %n", &time, &offset) == 1)
+  {
+    line += offset;
+  }
+  while (*line == ' ')
+  {
+    line++;
+  }
+
+  if (!strncmp(line, "id=", 3))
+  {
+    unsigned id, channel, rollingCode, hum;
+    char batt[8];
+    if (sscanf(line, "id=%x ch=%u rc=%x batt=%7s temp=%f hum=%u", &id, &channel, &rollingCode, batt, &frame.temp, &hum) != 6
+        || channel < 1 || channel > 3 || hum > 99)
+    {
+      return false;
+    }
+    frame.id = id;
+    frame.channel = channel;
+    frame.rollingCode = rollingCode;
+    frame.lowBatt = !strcmp(batt, "low");
+    frame.hum = hum;
+    return true;
+  }
+
+  byte message[16];
+  size_t size = 0;
+  while (size < sizeof(message))
+  {
+    int hi = hexValue(line[0]);
+    int lo = hi >= 0? hexValue(line[1]) : -1;
+    if (lo < 0)
+    {
+      break;
+    }
+    message[size++] = (hi << 4) | lo;
+    line += 2;
+  }
+  return size && decoder.decodeMessage(message, size, frame);
+}
+
+static double now()
+{
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  return tv.tv_sec + tv.tv_usec/1e6;
+}
+
+static void printResult(Ingest::Result result, const OregonScientificDecoder::Frame& frame, double time, uint16_t node)
+{
+  static const char* RESULTS[] = { "stored", "new node", "remapped", "duplicate", "failed" };
+  printf("time=%u node=%u id=%04X ch=%u rc=%02X batt=%s temp=%.1f hum=%u %s\n", (uint32_t)time, node, frame.id, frame.channel,
+         frame.rollingCode, frame.lowBatt? "low" : "ok", frame.temp, frame.hum, RESULTS[result]);
+}
+
+static void printStatistics(const Ingest& ingest)
+{
+  const Ingest::Statistics& s = ingest.getStatistics();
+  fprintf(stderr, "frames %u, invalid %u, stored %u, duplicates %u, new nodes %u, remapped %u, ambiguous %u\n",
+          s.frames + s.invalid, s.invalid, s.stored, s.duplicates, s.newNodes, s.remapped, s.ambiguous);
+}
+
+static void ingestFrame(const Options& options, Ingest& ingest, const OregonScientificDecoder::Frame& frame, double time)
+{
+  uint16_t node = 0;
+  Ingest::Result result = ingest.add(frame, time, node);
+  if (options.verbose || result == Ingest::NEW_NODE || result == Ingest::REMAPPED)
+  {
+    printResult(result, frame, time, node);
+    fflush(stdout);
+  }
+}
+
+static volatile sig_atomic_t stopped = 0;
+
+static void stop(int)
+{
+  stopped = 1;
+}
+
+static int ingestStream(const Options& options, Ingest& ingest, FILE* in)
+{
+  OregonScientificDecoder decoder;
+  char line[256];
+  while (!stopped && fgets(line, sizeof(line), in))
+  {
+    OregonScientificDecoder::Frame frame;
+    double time = -1;
+    if (!parseLine(decoder, line, frame, time))
+    {
+      ingest.addInvalid();
+      continue;
+    }
+    ingestFrame(options, ingest, frame, time >= 0? time : now());
+  }
+  return 0;
+}
+
+static int ingestUdp(const Options& options, Ingest& ingest)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0)
+  {
+    perror("socket");
+    return 1;
+  }
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(options.udpPort);
+  if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0)
+  {
+    perror("bind");
+    close(fd);
+    return 1;
+  }
+
+  OregonScientificDecoder decoder;
+  while (!stopped)
+  {
+    char datagram[256];
+    ssize_t size = recv(fd, datagram, sizeof(datagram) - 1, 0);
+    if (size <= 0)
+    {
+      continue; // interrupted by signal
+    }
+    datagram[size] = 0;
+
+    // text line or raw message bytes
+    bool text = true;
+    for (ssize_t i=0; i<size; i++)
+    {
+      text = text && ((datagram[i] >= ' ' && datagram[i] < 0x7F) || datagram[i] == '\n' || datagram[i] == '\r');
+    }
+    OregonScientificDecoder::Frame frame;
+    double time = -1;
+    bool valid = text? parseLine(decoder, datagram, frame, time) : decoder.decodeMessage((const byte*)datagram, size, frame);
+    if (!valid)
+    {
+      ingest.addInvalid();
+      continue;
+    }
+    ingestFrame(options, ingest, frame, time >= 0? time : now());
+  }
+  close(fd);
+  return 0;
+}
+
+static void query(const TimeSeriesStore& store)
+{
+  printf("%5s %4s %2s %2s %6s %10s %6s %4s %4s %8s\n", "node", "id", "ch", "rc", "remaps", "time", "temp", "hum", "batt", "samples");
+  for (auto& entry : store.getFiles())
+  {
+    const TimeSeriesFile& file = *entry.second;
+    const TimeSeriesFile::Header& header = file.getHeader();
+    TimeSeriesFile::Sample sample;
+    if (file.getLatest(sample))
+    {
+      printf("%5u %04X %2u %02X %6u %10u %6.1f %4u %4s %8u\n", header.node, header.id, header.channel, header.rollingCode,
+             header.remaps, sample.time, sample.temp, sample.hum, sample.lowBatt? "low" : "ok", file.getSize());
+    }
+  }
+}
+
+/**
+ * synthetic traffic: nodes with random phase transmit every period with
+ * repeats, battery changes with new rolling code and 5 .. 30 min downtime
+ */
+static int benchmark(const Options& options)
+{
+  static const uint16_t IDS[] = { 0xF824, 0xF8B4, 0x1D20, 0x1D30 };
+  static const float BATTERY_CHANGE = 0.001f; // probability per transmission
+
+  if (options.benchmarkNodes > 4*3*255)
+  {
+    fprintf(stderr, "max. %u nodes with unique rolling codes\n", 4*3*255);
+    return 1;
+  }
+
+  struct SimNode
+  {
+    uint16_t id;
+    byte channel;
+    byte rollingCode;
+    float temp;
+    byte hum;
+    double next;  // [s]
+  };
+  struct Traffic
+  {
+    double time;
+    std::string line;
+    uint32_t source;  // index of simulated node
+  };
+
+  std::mt19937 rng(4711);
+  std::uniform_real_distribution<float> uniform(0, 1);
+  std::vector<SimNode> nodes;
+  std::vector<bool> used(4*3*256);
+  for (uint32_t n=0; n<options.benchmarkNodes; n++)
+  {
+    SimNode node;
+    uint32_t key;
+    do
+    {
+      key = rng() % used.size();
+    } while (used[key] || (key & 0xFF) == 0);
+    used[key] = true;
+    node.id = IDS[(key >> 8)/3];
+    node.channel = 1 + (key >> 8) % 3;
+    node.rollingCode = key & 0xFF;
+    node.temp = -10 + 45*uniform(rng);
+    node.hum = 20 + rng() % 70;
+    node.next = options.period*uniform(rng);
+    nodes.push_back(node);
+  }
+
+  // generate hex lines in time order
+  OregonScientific oregon;
+  std::vector<Traffic> traffic;
+  traffic.reserve(options.benchmarkFrames);
+  uint32_t transmissions = 0, batteryChanges = 0;
+  while (traffic.size() < options.benchmarkFrames)
+  {
+    SimNode* node = &nodes[0];
+    for (SimNode& n : nodes)
+    {
+      node = n.next < node->next? &n : node;
+    }
+    if (uniform(rng) < BATTERY_CHANGE)
+    {
+      // free rolling code in same model ID and channel group
+      uint32_t model = node->id == IDS[0]? 0 : node->id == IDS[1]? 1 : node->id == IDS[2]? 2 : 3;
+      uint32_t group = (3*model + node->channel - 1) << 8;
+      uint32_t key;
+      do
+      {
+        key = group | (rng() & 0xFF);
+      } while (used[key] || (key & 0xFF) == 0);
+      used[group | node->rollingCode] = false;
+      used[key] = true;
+      node->rollingCode = key & 0xFF;
+      node->next += 300 + 1500*uniform(rng);
+      batteryChanges++;
+      continue;
+    }
+
+    node->temp += 0.2f*(uniform(rng) - 0.5f);
+    byte size = oregon.encodeTH(node->id, node->channel, node->rollingCode, false, node->temp, node->hum);
+    std::string hex;
+    for (byte i=0; i<size; i++)
+    {
+      char digits[3];
+      sprintf(digits, "%02X", oregon.getMessage()[i]);
+      hex += digits;
+    }
+    transmissions++;
+    double time = 1e9 + node->next;
+    for (byte copy=0; copy<=options.benchmarkRepeats && traffic.size() < options.benchmarkFrames; copy++)
+    {
+      char prefix[32];
+      sprintf(prefix, "time=%.3f ", time);
+      traffic.push_back({ time, prefix + hex, (uint32_t)(node - &nodes[0]) });
+      time += 0.05 + 0.45*uniform(rng);
+    }
+    node->next += options.period*(0.98 + 0.04*uniform(rng));
+  }
+
+  char directory[] = "/tmp/ingest-bench-XXXXXX";
+  if (!mkdtemp(directory))
+  {
+    perror("mkdtemp");
+    return 1;
+  }
+  uint32_t nodeCount = 0;
+  {
+    TimeSeriesStore store(directory, options.capacity);
+    if (!store.open())
+    {
+      return 1;
+    }
+    Ingest ingest(store, options);
+    OregonScientificDecoder decoder;
+
+    // decode only
+    std::vector<OregonScientificDecoder::Frame> frames(traffic.size());
+    std::vector<double> times(traffic.size());
+    auto start = std::chrono::steady_clock::now();
+    uint32_t invalid = 0;
+    for (size_t i=0; i<traffic.size(); i++)
+    {
+      invalid += !parseLine(decoder, traffic[i].line.c_str(), frames[i], times[i]);
+    }
+    double decodeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // ingest only
+    std::vector<uint16_t> assigned(traffic.size());
+    start = std::chrono::steady_clock::now();
+    for (size_t i=0; i<traffic.size(); i++)
+    {
+      ingest.add(frames[i], times[i], assigned[i]);
+    }
+    double ingestTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // node ID changes of simulated nodes (ambiguous or wrong rolling code mapping)
+    std::vector<uint16_t> sourceNode(nodes.size());
+    uint32_t changes = 0;
+    for (size_t i=0; i<traffic.size(); i++)
+    {
+      uint16_t& expected = sourceNode[traffic[i].source];
+      changes += expected && expected != assigned[i];
+      expected = assigned[i];
+    }
+
+    // latest value of all nodes
+    start = std::chrono::steady_clock::now();
+    uint32_t lookups = 0;
+    volatile float sum = 0;
+    for (int r=0; r<100; r++)
+    {
+      for (auto& entry : store.getFiles())
+      {
+        TimeSeriesFile::Sample sample = {};
+        entry.second->getLatest(sample);
+        sum += sample.temp;
+        lookups++;
+      }
+    }
+    double lookupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const Ingest::Statistics& s = ingest.getStatistics();
+    nodeCount = store.getFiles().size();
+    printf("nodes:          %u, %u battery changes\n", options.benchmarkNodes, batteryChanges);
+    printf("frames:         %zu (%u readings, %u repeats each), %u invalid\n", traffic.size(), transmissions, options.benchmarkRepeats, invalid);
+    printf("stored:         %u, duplicates %u\n", s.stored, s.duplicates);
+    printf("node IDs:       %u (new %u, remapped %u, ambiguous %u), %u changes of simulated nodes\n", nodeCount, s.newNodes,
+           s.remapped, s.ambiguous, changes);
+    printf("decode:         %.2f Mframes/s (%.0f ns/frame)\n", traffic.size()/decodeTime/1e6, 1e9*decodeTime/traffic.size());
+    printf("ingest:         %.2f Mframes/s (%.0f ns/frame)\n", traffic.size()/ingestTime/1e6, 1e9*ingestTime/traffic.size());
+    printf("latest lookup:  %.0f ns\n", 1e9*lookupTime/lookups);
+  }
+
+  // remove benchmark store
+  for (uint32_t n=1; n<=nodeCount; n++)
+  {
+    std::string path = std::string(directory) + "/node-" + std::to_string(n) + ".ts";
+    unlink(path.c_str());
+  }
+  rmdir(directory);
+  return 0;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: ingest_daemon [options] [file | -]\n"
+    "  -d <dir>      store directory, default store\n"
+    "  -c <n>        samples per node file (new files), default 65536\n"
+    "  -w <s>        dedup window, default 2\n"
+    "  -p <s>        transmit period of the nodes, default 180\n"
+    "  -m <s>        max. silence for rolling code change, default 86400\n"
+    "  -T <degC>     max. temperature change for rolling code change, default 2\n"
+    "  -u <port>     receive UDP datagrams instead of stdin\n"
+    "  -v            print each frame\n"
+    "  -q            print latest value of each node and exit\n"
+    "  -B <n>        benchmark with n synthetic frames\n"
+    "  -n <nodes>    nodes of benchmark, default 500\n"
+    "  -R <n>        repeats per reading of benchmark, default 2\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int opt;
+  while ((opt = getopt(argc, argv, "d:c:w:p:m:T:u:vqB:n:R:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'd': options.directory = optarg; break;
+      case 'c': options.capacity = atol(optarg); break;
+      case 'w': options.window = atof(optarg); break;
+      case 'p': options.period = atof(optarg); break;
+      case 'm': options.maxSilence = atof(optarg); break;
+      case 'T': options.tolerance = atof(optarg); break;
+      case 'u': options.udpPort = atoi(optarg); break;
+      case 'v': options.verbose = true; break;
+      case 'q': options.query = true; break;
+      case 'B': options.benchmarkFrames = atol(optarg); break;
+      case 'n': options.benchmarkNodes = atol(optarg); break;
+      case 'R': options.benchmarkRepeats = atoi(optarg); break;
+      default: usage(); return 1;
+    }
+  }
+  if (options.capacity == 0 || options.period <= 0 || options.benchmarkNodes == 0)
+  {
+    usage();
+    return 1;
+  }
+
+  if (options.benchmarkFrames)
+  {
+    return benchmark(options);
+  }
+
+  TimeSeriesStore store(options.directory, options.capacity);
+  if (!store.open())
+  {
+    return 1;
+  }
+  if (options.query)
+  {
+    query(store);
+    return 0;
+  }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = stop;
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+
+  Ingest ingest(store, options);
+  int result;
+  if (options.udpPort)
+  {
+    result = ingestUdp(options, ingest);
+  }
+  else
+  {
+    const char* input = optind < argc? argv[optind] : "-";
+    FILE* in = strcmp(input, "-")? fopen(input, "r") : stdin;
+    if (!in)
+    {
+      perror(input);
+      return 1;
+    }
+    result = ingestStream(options, ingest, in);
+    if (in != stdin)
+    {
+      fclose(in);
+    }
+  }
+  printStatistics(ingest);
+  return result;
+}
@@ -0,0 +1,519 @@
+/*****************************************************************************
+ *
+ * OOK/Manchester Demodulator for rtl_sdr I/Q Samples
+ *
+ * file:     OOKDemodulator.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define OOK_X86 1
+#endif
+
+#include "ArduinoHost.h"
+
+/**
+ * streaming OOK demodulator with Manchester bit recovery
+ *
+ * processing chain:
+ * - magnitude (I² + Q²) of unsigned 8 bit I/Q pairs (.cu8), summed over D samples (decimation)
+ * - slicing against an adaptive noise floor threshold into a packed level bitmap
+ * - run length extraction, frame segmentation on long gaps
+ * - half bit length estimation from the preamble and Manchester decoding
+ *
+ * Magnitude and slicing use SSE2 or AVX2 kernels selected at runtime.
+ */
+class OOKDemodulator
+{
+public:
+  enum Kernel
+  {
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+  };
+
+  typedef std::function<void(const std::vector<bool>& bits)> FrameCallback;
+
+public:
+  /**
+   * @param sampleRate [Hz]
+   * @param bitRate nominal data rate [bit/s], used for gap detection and plausibility
+   */
+  OOKDemodulator(uint32_t sampleRate, uint32_t bitRate) :
+    bitRate(bitRate)
+  {
+    // ~24 decimated samples per half bit, power of 2 between 8 and 64
+    decimation = 8;
+    while (decimation < 64 && sampleRate/(2.0*bitRate)/(2*decimation) >= 24)
+    {
+      decimation *= 2;
+    }
+    halfBitNominal = sampleRate/(2.0*bitRate)/decimation;
+    setKernel(detectKernel());
+  }
+
+public:
+  static Kernel detectKernel()
+  {
+  #ifdef OOK_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse2")) return KERNEL_SSE2;
+  #endif
+    return KERNEL_SCALAR;
+  }
+
+  void setKernel(Kernel k)
+  {
+    kernel = k;
+  }
+
+  Kernel getKernel() const
+  {
+    return kernel;
+  }
+
+  uint32_t getDecimation() const
+  {
+    return decimation;
+  }
+
+  /**
+   * @param invert Manchester polarity, true: 1 -> low/high (Si4432 inverted option)
+   */
+  void setManchesterInverted(bool invert)
+  {
+    inverted = invert;
+  }
+
+  /**
+   * @param factor threshold above noise floor (power ratio), default 3 (~5 dB)
+   */
+  void setThresholdFactor(uint32_t factor)
+  {
+    thresholdFactor = factor;
+  }
+
+  void setFrameCallback(FrameCallback callback)
+  {
+    frameCallback = callback;
+  }
+
+  /**
+   * process I/Q samples, may be called with arbitrary block sizes
+   *
+   * @param iq interleaved unsigned 8 bit I/Q samples
+   * @param size [bytes]
+   */
+  void process(const uint8_t* iq, size_t size)
+  {
+    // complete pending decimation block
+    size_t blockBytes = 2*decimation;
+    while (size)
+    {
+      if (!pending.empty() || size < blockBytes)
+      {
+        size_t n = std::min(size, blockBytes - pending.size());
+        pending.insert(pending.end(), iq, iq + n);
+        iq += n;
+        size -= n;
+        if (pending.size() == blockBytes)
+        {
+          uint32_t m;
+          magnitude(pending.data(), 1, &m);
+          slice(&m, 1);
+          pending.clear();
+        }
+        continue;
+      }
+
+      // bulk processing in chunks
+      size_t blocks = std::min(size/blockBytes, (size_t)CHUNK);
+      magnitude(iq, blocks, chunk);
+      slice(chunk, blocks);
+      iq += blocks*blockBytes;
+      size -= blocks*blockBytes;
+    }
+  }
+
+  /**
+   * terminate current frame (e.g. at end of input)
+   */
+  void flush()
+  {
+    if (level && runLength)
+    {
+      runs.push_back(runLength);
+    }
+    level = false;
+    runLength = 0;
+    endFrame();
+  }
+
+private:
+  static const size_t CHUNK = 4096; // [decimated samples]
+
+  // --- magnitude kernels: sum of I² + Q² over decimation block ---
+
+  void magnitude(const uint8_t* iq, size_t blocks, uint32_t* out)
+  {
+    switch (kernel)
+    {
+    #ifdef OOK_X86
+      case KERNEL_AVX2: magnitudeAVX2(iq, blocks, out); break;
+      case KERNEL_SSE2: magnitudeSSE2(iq, blocks, out); break;
+    #endif
+      default: magnitudeScalar(iq, blocks, out); break;
+    }
+  }
+
+  void magnitudeScalar(const uint8_t* iq, size_t blocks, uint32_t* out) const
+  {
+    for (size_t b=0; b<blocks; b++)
+    {
+      uint32_t sum = 0;
+      for (uint32_t k=0; k<decimation; k++)
+      {
+        int i = iq[0] - 127;
+        int q = iq[1] - 127;
+        sum += i*i + q*q;
+        iq += 2;
+      }
+      out[b] = sum;
+    }
+  }
+
+#ifdef OOK_X86
+  void magnitudeSSE2(const uint8_t* iq, size_t blocks, uint32_t* out) const
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi16(127);
+    for (size_t b=0; b<blocks; b++)
+    {
+      // 16 bytes = 8 I/Q pairs per iteration
+      __m128i acc = zero;
+      for (uint32_t k=0; k<decimation; k+=8)
+      {
+        __m128i v = _mm_loadu_si128((const __m128i*)iq);
+        __m128i lo = _mm_sub_epi16(_mm_unpacklo_epi8(v, zero), offset);
+        __m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(v, zero), offset);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(lo, lo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(hi, hi));
+        iq += 16;
+      }
+      acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+      acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+      out[b] = _mm_cvtsi128_si32(acc);
+    }
+  }
+
+  __attribute__((target("avx2"))) void magnitudeAVX2(const uint8_t* iq, size_t blocks, uint32_t* out) const
+  {
+    const __m256i offset = _mm256_set1_epi16(127);
+    if (decimation >= 16)
+    {
+      for (size_t b=0; b<blocks; b++)
+      {
+        // 32 bytes = 16 I/Q pairs per iteration
+        __m256i acc = _mm256_setzero_si256();
+        for (uint32_t k=0; k<decimation; k+=16)
+        {
+          __m256i lo = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)iq)), offset);
+          __m256i hi = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(iq + 16))), offset);
+          acc = _mm256_add_epi32(acc, _mm256_madd_epi16(lo, lo));
+          acc = _mm256_add_epi32(acc, _mm256_madd_epi16(hi, hi));
+          iq += 32;
+        }
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+        out[b] = _mm_cvtsi128_si32(s);
+      }
+    }
+    else
+    {
+      magnitudeSSE2(iq, blocks, out);
+    }
+  }
+#endif
+
+  // --- slicing kernels: compare against threshold, 1 bit per decimated sample ---
+
+  void slice(const uint32_t* mag, size_t count)
+  {
+    updateThreshold(mag, count);
+
+    size_t words = (count + 63)/64;
+    if (levels.size() < words)
+    {
+      levels.resize(words);
+    }
+    switch (kernel)
+    {
+    #ifdef OOK_X86
+      case KERNEL_AVX2: sliceAVX2(mag, count, levels.data()); break;
+      case KERNEL_SSE2: sliceSSE2(mag, count, levels.data()); break;
+    #endif
+      default: sliceScalar(mag, count, levels.data()); break;
+    }
+
+    extractRuns(levels.data(), count);
+  }
+
+  void sliceScalar(const uint32_t* mag, size_t count, uint64_t* out) const
+  {
+    for (size_t w=0; w*64<count; w++)
+    {
+      uint64_t bits = 0;
+      size_t n = std::min((size_t)64, count - w*64);
+      for (size_t i=0; i<n; i++)
+      {
+        bits |= (uint64_t)(mag[w*64 + i] > threshold) << i;
+      }
+      out[w] = bits;
+    }
+  }
+
+#ifdef OOK_X86
+  void sliceSSE2(const uint32_t* mag, size_t count, uint64_t* out) const
+  {
+    // magnitude sums are < 2^31, signed compare is safe
+    const __m128i t = _mm_set1_epi32((int32_t)threshold);
+    size_t full = count & ~(size_t)63;
+    for (size_t w=0; w*64<full; w++)
+    {
+      uint64_t bits = 0;
+      const uint32_t* m = mag + w*64;
+      for (byte i=0; i<64; i+=4)
+      {
+        __m128i c = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)(m + i)), t);
+        bits |= (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(c)) << i;
+      }
+      out[w] = bits;
+    }
+    if (full < count)
+    {
+      sliceScalar(mag + full, count - full, out + full/64);
+    }
+  }
+
+  __attribute__((target("avx2"))) void sliceAVX2(const uint32_t* mag, size_t count, uint64_t* out) const
+  {
+    const __m256i t = _mm256_set1_epi32((int32_t)threshold);
+    size_t full = count & ~(size_t)63;
+    for (size_t w=0; w*64<full; w++)
+    {
+      uint64_t bits = 0;
+      const uint32_t* m = mag + w*64;
+      for (byte i=0; i<64; i+=8)
+      {
+        __m256i c = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)(m + i)), t);
+        bits |= (uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(c)) << i;
+      }
+      out[w] = bits;
+    }
+    if (full < count)
+    {
+      sliceScalar(mag + full, count - full, out + full/64);
+    }
+  }
+#endif
+
+  /**
+   * track noise floor with mean of chunks without signal
+   */
+  void updateThreshold(const uint32_t* mag, size_t count)
+  {
+    uint64_t sum = 0;
+    for (size_t i=0; i<count; i++)
+    {
+      sum += mag[i];
+    }
+    uint32_t mean = sum/count;
+    if (!noiseFloor)
+    {
+      noiseFloor = std::max(mean, decimation);
+    }
+    else if (!level && runLength > count && mean < 2*noiseFloor)
+    {
+      noiseFloor = (7*noiseFloor + mean)/8;
+    }
+    threshold = std::max(noiseFloor*thresholdFactor, decimation*MIN_POWER);
+  }
+
+  // --- run length extraction and Manchester decoding ---
+
+  void extractRuns(const uint64_t* bits, size_t count)
+  {
+    uint32_t gap = 6*halfBitNominal;
+    for (size_t i=0; i<count; )
+    {
+      // find next level change in current word
+      uint64_t w = bits[i/64] >> (i % 64);
+      uint64_t changes = level? ~w : w;
+      size_t remaining = std::min((size_t)64 - i % 64, count - i);
+      size_t same = changes? __builtin_ctzll(changes) : 64;
+      if (same >= remaining)
+      {
+        runLength += remaining;
+        i += remaining;
+      }
+      else
+      {
+        runLength += same;
+        i += same;
+        if (level || !runs.empty())
+        {
+          runs.push_back(runLength);
+        }
+        level = !level;
+        runLength = 0;
+      }
+
+      // long off period terminates frame
+      if (!level && runLength > gap && !runs.empty())
+      {
+        endFrame();
+      }
+    }
+  }
+
+  /**
+   * Manchester decode runs of alternating level, starting with high
+   */
+  void endFrame()
+  {
+    removeGlitches();
+
+    if (runs.size() > 16 && frameCallback)
+    {
+      // estimate half bit length from preamble (single half bits)
+      uint32_t sum = 0;
+      for (byte i=1; i<=8; i++)
+      {
+        sum += runs[i];
+      }
+      float halfBit = sum/8.0f;
+      if (halfBit > 0.6f*halfBitNominal && halfBit < 1.8f*halfBitNominal)
+      {
+        std::vector<bool> halfBits;
+        bool high = true;
+        for (uint32_t r : runs)
+        {
+          int n = (int)(r/halfBit + 0.5f);
+          if (n < 1 || n > 2) break;
+          for (int k=0; k<n; k++)
+          {
+            halfBits.push_back(high);
+          }
+          high = !high;
+        }
+
+        // trailing low half bit of a final 0 bit is not distinguishable from idle
+        if (!halfBits.empty() && halfBits.back())
+        {
+          halfBits.push_back(false);
+        }
+
+        // first half of 1st bit is low if the preamble starts with a low/high half bit pair,
+        // the preamble bit value is not known here, so use the phase that decodes more bits
+        std::vector<bool> bits = decodeManchester(halfBits, 0);
+        std::vector<bool> shifted = decodeManchester(halfBits, 1);
+        frameCallback(shifted.size() > bits.size()? shifted : bits);
+      }
+    }
+    runs.clear();
+  }
+
+  /**
+   * @param phase 1 to insert a leading low half bit
+   */
+  std::vector<bool> decodeManchester(const std::vector<bool>& halfBits, byte phase) const
+  {
+    std::vector<bool> bits;
+    for (size_t i=0; i+1<halfBits.size()+phase; i+=2)
+    {
+      bool first = (i < phase)? false : halfBits[i - phase];
+      bool second = halfBits[i + 1 - phase];
+      if (first == second) break; // Manchester violation
+      bits.push_back(first != inverted);
+    }
+    return bits;
+  }
+
+  /**
+   * merge runs that are too short to be a half bit with their neighbours
+   * and drop leading runs that do not look like a preamble
+   */
+  void removeGlitches()
+  {
+    uint32_t minRun = 0.35f*halfBitNominal;
+    for (size_t i=1; i+1<runs.size(); )
+    {
+      if (runs[i] < minRun)
+      {
+        runs[i - 1] += runs[i] + runs[i + 1];
+        runs.erase(runs.begin() + i, runs.begin() + i + 2);
+      }
+      else
+      {
+        i++;
+      }
+    }
+
+    size_t first = 0;
+    while (first + 1 < runs.size() && (runs[first] < minRun || runs[first + 1] > 2.5f*halfBitNominal))
+    {
+      first += 2;
+    }
+    runs.erase(runs.begin(), runs.begin() + std::min(first, runs.size()));
+  }
+
+private:
+  static const uint32_t MIN_POWER = 16; // min. threshold per sample (I² + Q²)
+
+private:
+  Kernel kernel = KERNEL_SCALAR;
+  uint32_t bitRate;
+  uint32_t decimation;
+  float halfBitNominal; // [decimated samples]
+  bool inverted = true;
+  uint32_t thresholdFactor = 3;
+  uint32_t noiseFloor = 0;
+  uint32_t threshold = 0;
+  bool level = false;
+  size_t runLength = 0;
+  std::vector<uint32_t> runs;
+  std::vector<uint8_t> pending;
+  std::vector<uint64_t> levels;
+  uint32_t chunk[CHUNK];
+  FrameCallback frameCallback;
+};
@@ -0,0 +1,374 @@
+/*****************************************************************************
+ *
+ * Oregon Scientific Receiver for rtl_sdr I/Q Recordings
+ *
+ * file:     OregonDecode.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o oregon_decode OregonDecode.cpp
+ *
+ * usage:
+ *   rtl_sdr -f 433920000 -s 2000000 - | ./oregon_decode -
+ *   ./oregon_decode capture.cu8
+ *   ./oregon_decode -g 100 > synthetic.cu8   (generate capture with 100 frames)
+ *   ./oregon_decode -B 1000                  (throughput benchmark with 1000 frames)
+ *   ./oregon_decode -H capture.cu8 | ./history_tool -d   (decode history chunks of maintenance mode)
+ *   ./oregon_decode -F capture.cu8           (decode compact frames of option HAS_FEC)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unistd.h>
+
+#include "ArduinoHost.h"
+#include "../OregonScientific.h"
+#include "../ManchesterEncoder.h"
+#include "CompactFrameDecoder.h"
+#include "OOKDemodulator.h"
+#include "OregonScientificDecoder.h"
+
+struct Options
+{
+  uint32_t sampleRate = 2000000; // [Hz]
+  uint32_t bitRate = 1400;       // [bit/s], Si4432 setting
+  bool manchesterInverted = true;
+  bool lsbFirst = true;
+  bool invertBits = false;
+  bool flipInputNibbles = true;
+  bool flipOutputNibbles = false;
+  uint32_t generateFrames = 0;
+  uint32_t benchmarkFrames = 0;
+  float snr = 20; // [dB]
+  bool history = false;
+  bool compact = false;
+  const char* input = "-";
+};
+
+/**
+ * synthesize I/Q capture with frames from OregonScientific::encodeTH()
+ * with random gaps, carrier frequency offset and gaussian noise
+ *
+ * @param sent encoded messages in order of transmission
+ */
+static std::vector<uint8_t> generateCapture(const Options& options, uint32_t frames, std::vector<std::vector<byte>>& sent)
+{
+  std::mt19937 rng(4711);
+  std::normal_distribution<float> noise(0, 4);
+  std::uniform_real_distribution<float> uniform(0, 1);
+
+  OregonScientific oregon;
+  CompactFrame compactFrame;
+  oregon.setInvertBits(options.invertBits);
+  oregon.setFlipInputNibbles(options.flipInputNibbles);
+  oregon.setFlipOutputNibbles(options.flipOutputNibbles);
+
+  ManchesterEncoder manchester;
+  manchester.setInverted(options.manchesterInverted);
+  manchester.setLsbFirst(options.lsbFirst);
+
+  float amplitude = 4*sqrtf(2)*powf(10, options.snr/20);
+  float samplesPerHalfBit = options.sampleRate/(2.0f*options.bitRate);
+  float phase = 0;
+  float phaseStep = 2*M_PI*10000/options.sampleRate; // 10 kHz offset
+
+  std::vector<uint8_t> iq;
+  auto addSample = [&](bool on)
+  {
+    float i = noise(rng);
+    float q = noise(rng);
+    if (on)
+    {
+      i += amplitude*cosf(phase);
+      q += amplitude*sinf(phase);
+    }
+    phase += phaseStep;
+    iq.push_back((uint8_t)std::min(255.0f, std::max(0.0f, 127.5f + i)));
+    iq.push_back((uint8_t)std::min(255.0f, std::max(0.0f, 127.5f + q)));
+  };
+
+  for (uint32_t f=0; f<frames; f++)
+  {
+    OregonScientificDecoder::Frame frame;
+    frame.id = 0xF824;
+    frame.channel = 1 + f % 3;
+    frame.rollingCode = 0x12 + f;
+    frame.lowBatt = f % 7 == 0;
+    frame.temp = -20 + 0.1f*(rng() % 600);
+    frame.hum = rng() % 100;
+
+    // idle gap 20 .. 120 ms
+    uint32_t gap = options.sampleRate*(0.02f + 0.1f*uniform(rng));
+    for (uint32_t s=0; s<gap; s++) addSample(false);
+
+    byte size = options.compact? compactFrame.encodeTH(frame.channel, frame.rollingCode, frame.lowBatt, frame.temp, frame.hum)
+                               : oregon.encodeTH(frame.id, frame.channel, frame.rollingCode, frame.lowBatt, frame.temp, frame.hum);
+    const byte* message = options.compact? compactFrame.getMessage() : oregon.getMessage();
+    sent.push_back(std::vector<byte>(message, message + size));
+    size_t start = iq.size()/2;
+    for (size_t h=0; h<16u*size; h++)
+    {
+      bool on = manchester.getLevel(message, h);
+      size_t end = start + (size_t)((h + 1)*samplesPerHalfBit);
+      while (iq.size()/2 < end) addSample(on);
+    }
+  }
+
+  // trailing gap
+  for (uint32_t s=0; s<options.sampleRate/10; s++) addSample(false);
+
+  return iq;
+}
+
+static void printFrame(const OregonScientificDecoder::Frame& frame)
+{
+  printf("id=%04X ch=%u rc=%02X batt=%s temp=%.1f hum=%u\n", frame.id, frame.channel, frame.rollingCode,
+         frame.lowBatt? "low" : "ok", frame.temp, frame.hum);
+}
+
+/**
+ * find history chunk frame (SolarDHT::sendHistoryChunk) in bit stream,
+ * preamble and alignment handling as in OregonScientificDecoder::decodeBits()
+ */
+static bool decodeHistoryChunk(const std::vector<bool>& bits, bool lsbFirst, std::vector<byte>& frame)
+{
+  const size_t CHUNK_FRAME_SIZE = 22; // preamble (2), sync (1), index (2), data (16), checksum (1)
+
+  size_t preambleEnd = 0;
+  while (preambleEnd < bits.size() && bits[preambleEnd])
+  {
+    preambleEnd++;
+  }
+
+  size_t first = preambleEnd > 15? preambleEnd - 15 : 0;
+  for (size_t offset = first; offset <= preambleEnd; offset++)
+  {
+    std::vector<byte> bytes;
+    for (size_t i = offset; i + 8 <= bits.size() && bytes.size() < CHUNK_FRAME_SIZE; i += 8)
+    {
+      byte b = 0;
+      for (byte j=0; j<8; j++)
+      {
+        if (bits[i + j])
+        {
+          b |= lsbFirst? (1 << j) : (0x80 >> j);
+        }
+      }
+      bytes.push_back(b);
+    }
+
+    // sync may follow 0 .. 2 complete preamble bytes
+    for (size_t k=0; k<=2 && k + CHUNK_FRAME_SIZE - 2 <= bytes.size(); k++)
+    {
+      if (bytes[k] != 0xA5)
+      {
+        continue;
+      }
+      byte sum = 0;
+      for (size_t i=k; i<k + CHUNK_FRAME_SIZE - 3; i++)
+      {
+        sum += bytes[i];
+      }
+      if (sum == bytes[k + CHUNK_FRAME_SIZE - 3])
+      {
+        frame.assign(2, 0xFF);
+        frame.insert(frame.end(), bytes.begin() + k, bytes.begin() + k + CHUNK_FRAME_SIZE - 2);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: oregon_decode [options] [file.cu8 | -]\n"
+    "  -s <Hz>     sample rate, default 2000000\n"
+    "  -b <bit/s>  nominal bit rate, default 1400\n"
+    "  -m          Manchester not inverted\n"
+    "  -M          most significant bit first\n"
+    "  -x          inverted bits (OregonScientific::setInvertBits)\n"
+    "  -n          no input nibble flip (OregonScientific::setFlipInputNibbles)\n"
+    "  -o          output nibble flip (OregonScientific::setFlipOutputNibbles)\n"
+    "  -k <kernel> scalar, sse2 or avx2, default auto\n"
+    "  -g <n>      write synthetic capture with n frames to stdout\n"
+    "  -B <n>      benchmark with synthetic capture of n frames\n"
+    "  -r <dB>     SNR of synthetic capture, default 20\n"
+    "  -H          print history chunks of maintenance mode as C:<hex> lines\n"
+    "  -F          compact frames with error correction (CompactFrame.h) instead of Oregon Scientific\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int kernel = -1;
+  int opt;
+  while ((opt = getopt(argc, argv, "s:b:mMxnok:g:B:r:HFh")) != -1)
+  {
+    switch (opt)
+    {
+      case 's': options.sampleRate = atoi(optarg); break;
+      case 'b': options.bitRate = atoi(optarg); break;
+      case 'm': options.manchesterInverted = false; break;
+      case 'M': options.lsbFirst = false; break;
+      case 'x': options.invertBits = true; break;
+      case 'n': options.flipInputNibbles = false; break;
+      case 'o': options.flipOutputNibbles = true; break;
+      case 'k':
+        kernel = !strcmp(optarg, "avx2")? OOKDemodulator::KERNEL_AVX2 : !strcmp(optarg, "sse2")? OOKDemodulator::KERNEL_SSE2 : OOKDemodulator::KERNEL_SCALAR;
+        break;
+      case 'g': options.generateFrames = atoi(optarg); break;
+      case 'B': options.benchmarkFrames = atoi(optarg); break;
+      case 'r': options.snr = atof(optarg); break;
+      case 'H': options.history = true; break;
+      case 'F': options.compact = true; break;
+      default: usage(); return 1;
+    }
+  }
+  if (optind < argc)
+  {
+    options.input = argv[optind];
+  }
+
+  std::vector<std::vector<byte>> sent;
+  if (options.generateFrames)
+  {
+    std::vector<uint8_t> iq = generateCapture(options, options.generateFrames, sent);
+    fwrite(iq.data(), 1, iq.size(), stdout);
+    return 0;
+  }
+
+  OregonScientificDecoder decoder;
+  decoder.setInvertBits(options.invertBits);
+  decoder.setFlipInputNibbles(options.flipInputNibbles);
+  decoder.setFlipOutputNibbles(options.flipOutputNibbles);
+  decoder.setLsbFirst(options.lsbFirst);
+  CompactFrameDecoder compactDecoder;
+  compactDecoder.setLsbFirst(options.lsbFirst);
+
+  OOKDemodulator demodulator(options.sampleRate, options.bitRate);
+  demodulator.setManchesterInverted(options.manchesterInverted);
+  if (kernel >= 0)
+  {
+    demodulator.setKernel((OOKDemodulator::Kernel)kernel);
+  }
+
+  // benchmark: decoded frames encoded again for comparison with the sent messages
+  OregonScientific oregon;
+  oregon.setInvertBits(options.invertBits);
+  oregon.setFlipInputNibbles(options.flipInputNibbles);
+  oregon.setFlipOutputNibbles(options.flipOutputNibbles);
+  CompactFrame compactFrame;
+  std::vector<std::vector<byte>> received;
+
+  uint32_t decoded = 0;
+  bool quiet = options.benchmarkFrames > 0;
+  demodulator.setFrameCallback([&](const std::vector<bool>& bits)
+  {
+    OregonScientificDecoder::Frame frame;
+    CompactFrame::Data data;
+    std::vector<byte> chunk;
+    if (options.compact && compactDecoder.decodeBits(bits, data))
+    {
+      decoded++;
+      if (quiet)
+      {
+        byte size = compactFrame.encodeTH(data.channel, data.rollingCode, data.lowBatt, data.temp, data.hum);
+        received.push_back(std::vector<byte>(compactFrame.getMessage(), compactFrame.getMessage() + size));
+      }
+      else
+      {
+        printf("fec ch=%u rc=%02X batt=%s temp=%.1f hum=%u corrected=%u\n", data.channel, data.rollingCode,
+               data.lowBatt? "low" : "ok", data.temp, data.hum, compactDecoder.getCorrected());
+      }
+    }
+    else if (!options.compact && decoder.decodeBits(bits, frame))
+    {
+      decoded++;
+      if (quiet)
+      {
+        byte size = oregon.encodeTH(frame.id, frame.channel, frame.rollingCode, frame.lowBatt, frame.temp, frame.hum);
+        received.push_back(std::vector<byte>(oregon.getMessage(), oregon.getMessage() + size));
+      }
+      else
+      {
+        printFrame(frame);
+      }
+    }
+    else if (options.history && decodeHistoryChunk(bits, options.lsbFirst, chunk))
+    {
+      printf("C:");
+      for (byte b : chunk) printf("%02X", b);
+      printf("\n");
+    }
+  });
+
+  if (options.benchmarkFrames)
+  {
+    std::vector<uint8_t> iq = generateCapture(options, options.benchmarkFrames, sent);
+    auto start = std::chrono::steady_clock::now();
+    demodulator.process(iq.data(), iq.size());
+    demodulator.flush();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double samples = iq.size()/2.0;
+    static const char* kernels[] = { "scalar", "sse2", "avx2" };
+    printf("kernel:      %s\n", kernels[demodulator.getKernel()]);
+    printf("decimation:  %u\n", demodulator.getDecimation());
+    printf("samples:     %.0f (%.1f s)\n", samples, samples/options.sampleRate);
+    // decoded frames in order of transmission, byte for byte
+    uint32_t identical = 0;
+    for (size_t i=0; i<received.size() && i<sent.size(); i++)
+    {
+      identical += received[i] == sent[i];
+    }
+    printf("frames:      %u/%zu decoded, %u identical\n", decoded, sent.size(), identical);
+    printf("throughput:  %.1f Msps, %.0fx real time\n", samples/elapsed/1e6, samples/options.sampleRate/elapsed);
+    return identical == sent.size() && received.size() == sent.size()? 0 : 2;
+  }
+
+  FILE* in = strcmp(options.input, "-")? fopen(options.input, "rb") : stdin;
+  if (!in)
+  {
+    perror(options.input);
+    return 1;
+  }
+  std::vector<uint8_t> buffer(1 << 18);
+  size_t n;
+  while ((n = fread(buffer.data(), 1, buffer.size(), in)) > 0)
+  {
+    demodulator.process(buffer.data(), n);
+    fflush(stdout);
+  }
+  demodulator.flush();
+  if (in != stdin)
+  {
+    fclose(in);
+  }
+
+  return 0;
+}
@@ -0,0 +1,230 @@
+/*****************************************************************************
+ *
+ * Oregon Scientfic Protocol Decoder
+ *
+ * file:     OregonScientificDecoder.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "ArduinoHost.h"
+
+/**
+ * decoder for the TH frames created by OregonScientific::encodeTH()
+ *
+ * The options must match the encoder options. The input is the bit stream in
+ * air order (after Manchester decoding), leading preamble bits may be missing.
+ */
+class OregonScientificDecoder
+{
+public:
+  struct Frame
+  {
+    uint16_t id;
+    byte channel;     // 1 .. 3
+    byte rollingCode;
+    bool lowBatt;
+    float temp;       // [°C]
+    byte hum;         // [%]
+  };
+
+public:
+  OregonScientificDecoder() = default;
+
+public:
+  /**
+   * see OregonScientific::setInvertBits
+   */
+  void setInvertBits(bool enabled)
+  {
+    invertBits = enabled;
+  }
+
+  /**
+   * see OregonScientific::setFlipInputNibbles
+   */
+  void setFlipInputNibbles(bool enabled)
+  {
+    flipInputNibbles = enabled;
+  }
+
+  /**
+   * see OregonScientific::setFlipOutputNibbles
+   */
+  void setFlipOutputNibbles(bool enabled)
+  {
+    flipOutputNibbles = enabled;
+  }
+
+  /**
+   * if enabled the bit stream is least significant bit first, default enabled (Si4432 packet handler option)
+   */
+  void setLsbFirst(bool enabled)
+  {
+    lsbFirst = enabled;
+  }
+
+  /**
+   * decode frame from bit stream
+   *
+   * @param bits bit stream in air order
+   * @param frame decoded frame
+   * @return true if a frame with valid checksum was found
+   */
+  bool decodeBits(const std::vector<bool>& bits, Frame& frame) const
+  {
+    // byte alignment is unknown if preamble bits were lost, try all alignments near end of preamble
+    size_t preambleEnd = 0;
+    bool preambleBit = !invertBits;
+    while (preambleEnd < bits.size() && bits[preambleEnd] == preambleBit)
+    {
+      preambleEnd++;
+    }
+
+    size_t first = preambleEnd > 15? preambleEnd - 15 : 0;
+    for (size_t offset = first; offset <= preambleEnd; offset++)
+    {
+      byte message[MAX_FRAME_SIZE];
+      size_t size = 0;
+      for (size_t i = offset; i + 8 <= bits.size() && size < MAX_FRAME_SIZE; i += 8)
+      {
+        byte b = 0;
+        for (byte j=0; j<8; j++)
+        {
+          if (bits[i + j])
+          {
+            b |= lsbFirst? (1 << j) : (0x80 >> j);
+          }
+        }
+        message[size++] = b;
+      }
+
+      if (decodeMessage(message, size, frame))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * decode byte aligned message as returned by OregonScientific::getMessage()
+   *
+   * @return true if checksum is valid
+   */
+  bool decodeMessage(const byte* message, size_t size, Frame& frame) const
+  {
+    // extract nibbles
+    byte nibbles[2*MAX_FRAME_SIZE];
+    size_t count = 0;
+    for (size_t i=0; i<size && i<MAX_FRAME_SIZE; i++)
+    {
+      byte lo = message[i] & 0xF;
+      byte hi = message[i] >> 4;
+      nibbles[count++] = flipOutputNibbles? hi : lo;
+      nibbles[count++] = flipOutputNibbles? lo : hi;
+    }
+    if (invertBits)
+    {
+      for (size_t i=0; i<count; i++)
+      {
+        nibbles[i] = ~nibbles[i] & 0xF;
+      }
+    }
+
+    // skip preamble (at least one nibble) and find sync
+    size_t n = 0;
+    while (n < count && nibbles[n] == 0xF) n++;
+    if (n == 0 || n >= count || nibbles[n] != 0xA)
+    {
+      return false;
+    }
+    n++;
+
+    // id (4) + channel (1) + rolling code (2) + flags (1) + temperature (4) + humidity (2) + filler (1) + checksum (2)
+    if (count - n < 17)
+    {
+      return false;
+    }
+    const byte* p = nibbles + n;
+    byte checksum = 0;
+    for (byte i=0; i<15; i++)
+    {
+      checksum += p[i];
+    }
+    if (checksum != (p[15] | (p[16] << 4)))
+    {
+      return false;
+    }
+
+    frame.id = (getByte(p) << 8) | getByte(p + 2);
+
+    frame.channel = 0;
+    for (byte c=1; c<=3; c++)
+    {
+      if (p[4] == (1 << (c - 1)))
+      {
+        frame.channel = c;
+      }
+    }
+    if (!frame.channel)
+    {
+      return false;
+    }
+
+    frame.rollingCode = getByte(p + 5);
+    frame.lowBatt = p[7] & 0x4;
+
+    if (p[8] > 9 || p[9] > 9 || p[10] > 9 || p[11] > 1 || p[12] > 9 || p[13] > 9)
+    {
+      return false;
+    }
+    frame.temp = (p[8] + 10*p[9] + 100*p[10])/10.0f;
+    if (p[11])
+    {
+      frame.temp = -frame.temp;
+    }
+    frame.hum = p[12] + 10*p[13];
+
+    return true;
+  }
+
+private:
+  byte getByte(const byte* p) const
+  {
+    return flipInputNibbles? (p[0] << 4) | p[1] : (p[1] << 4) | p[0];
+  }
+
+private:
+  static const byte MAX_FRAME_SIZE = 16; // [bytes]
+
+private:
+  bool invertBits = false;
+  bool flipInputNibbles = true;
+  bool flipOutputNibbles = false;
+  bool lsbFirst = true;
+};
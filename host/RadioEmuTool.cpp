@@ -0,0 +1,438 @@
+/*****************************************************************************
+ *
+ * Replay the Radio Path of the Firmware on the Si4432 Emulator
+ *
+ * file:     RadioEmuTool.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -Wall -Wextra -Ishim -o radio_emu_tool RadioEmuTool.cpp
+ *
+ * usage:
+ *   ./radio_emu_tool                  (one transmission, phase timing and frame check)
+ *   ./radio_emu_tool -b               (estimate radio configuration with burst writes)
+ *   ./radio_emu_tool -n 100 -v        (100 transmissions, SPI trace of first one)
+ *   ./radio_emu_tool -o capture.cu8   (on-air signal as rtl_sdr capture for oregon_decode)
+ *
+ * Runs SolarDHT<VARIANT_DEFAULT> unchanged on the shims of the directory
+ * shim with the register level Si4432 emulator (Si4432Emulator.h) attached
+ * to the SPI shim and the SDN and NIRQ pins (Si4432Device.h). setup() with
+ * setupRadio(), the RTC wakeups with radio.turnOn() and radioInterrupt()
+ * with transmitSensorData() drive the emulator through the Si4432 library
+ * shim, the ADC sequence and the timers run on the model of HostBoard.h.
+ * The temperature and humidity of the sensor change with each transmission.
+ *
+ * The phases of each radio session are derived from the recorded SPI
+ * transactions and pins. Each frame on air is Manchester decoded and
+ * verified with the receiver (OregonScientificDecoder.h) against the values
+ * transmitted by the sketch and compared chip by chip with the reference
+ * encoder (ManchesterEncoder.h). Exit code 1 if a check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+#include "HostBoard.h"
+#include "Si4432Device.h"
+#include "../SolarDHT.hpp"
+#include "OregonScientificDecoder.h"
+
+typedef SolarDHT<VARIANT_DEFAULT> Sketch;
+
+struct Options
+{
+  uint32_t transmissions = 1;
+  bool burst = false;
+  bool verbose = false;
+  const char* capture = nullptr;
+  uint32_t sampleRate = 2000000; // [Hz] of capture
+};
+
+struct Phases
+{
+  double chipReady = 0;  // [µs] SDN released to NIRQ
+  double config = 0;     // [µs] boot() incl. config callback
+  double sensor = 0;     // [µs] boot() to sendPacket(), readSensor() and encoder
+  double load = 0;       // [µs] sendPacket() until TXON
+  double txStart = 0;    // [µs] TXON to GPIO0 high
+  double air = 0;        // [µs] GPIO0 high
+  double shutdown = 0;   // [µs] GPIO0 low (PKSENT) to SDN high
+  double radioOn = 0;    // [µs] SDN released to SDN high
+  double spi = 0;        // [µs] MCU time spent on SPI
+  double burst = 0;      // [µs] MCU time of config with burst writes
+  uint32_t spiBytes = 0;
+  uint32_t spiTransactions = 0;
+  uint32_t burstTransactions = 0;
+};
+
+/**
+ * [µs] MCU time of a transaction at SPI_BAUD_RATE
+ */
+static double getSpiTime(size_t bytes)
+{
+  return SPIClass::TRANSACTION_OVERHEAD + 8e6*bytes/SPI_BAUD_RATE;
+}
+
+/**
+ * @return index of the first write to reg at or after start with (data & mask) == match, end if none
+ */
+static size_t findWrite(const std::vector<Si4432Device::Transaction>& transactions, size_t start, size_t end,
+                        uint8_t reg, uint8_t mask, uint8_t match)
+{
+  for (size_t i=start; i<end; i++)
+  {
+    const Si4432Device::Transaction& t = transactions[i];
+    if (t.write && t.address == reg && !t.data.empty() && (t.data[0] & mask) == match)
+    {
+      return i;
+    }
+  }
+  return end;
+}
+
+/**
+ * phases of a radio session with one transmission
+ *
+ * @return false if the register sequence of boot() or sendPacket() is incomplete
+ */
+static bool getPhases(const Si4432Device::Session& session, const std::vector<Si4432Device::Transaction>& transactions, Phases& phases)
+{
+  size_t end = session.endTransaction;
+  size_t configStart = findWrite(transactions, session.firstTransaction, end, Si4432Emulator::REG_MODULATION_MODE2, 0, 0);
+  size_t configEnd = findWrite(transactions, configStart, end, Si4432Emulator::REG_STATE,
+                               Si4432Emulator::STATE_TXON | Si4432Emulator::STATE_RXON, 0);
+  size_t loadStart = findWrite(transactions, configEnd, end, Si4432Emulator::REG_OPERATION_CONTROL,
+                               Si4432Emulator::FIFO_CLEAR_TX, Si4432Emulator::FIFO_CLEAR_TX);
+  size_t loadEnd = findWrite(transactions, loadStart, end, Si4432Emulator::REG_STATE,
+                             Si4432Emulator::STATE_TXON, Si4432Emulator::STATE_TXON);
+  if (loadEnd == end)
+  {
+    return false;
+  }
+
+  phases.chipReady = session.chipReady - session.powerOn;
+  phases.config = transactions[configEnd].end - transactions[configStart].start;
+  phases.sensor = transactions[loadStart].start - transactions[configEnd].end;
+  phases.load = transactions[loadEnd].end - transactions[loadStart].start;
+  phases.txStart = session.txOn - transactions[loadEnd].end;
+  phases.air = session.txOff - session.txOn;
+  phases.shutdown = session.powerOff - session.txOff;
+  phases.radioOn = session.powerOff - session.powerOn;
+  for (size_t i=session.firstTransaction; i<end; i++)
+  {
+    size_t bytes = 1 + transactions[i].data.size();
+    phases.spi += getSpiTime(bytes);
+    phases.spiBytes += bytes;
+    phases.spiTransactions++;
+  }
+
+  // burst estimate: config registers in ascending order, one transaction per contiguous block
+  std::map<uint8_t, uint8_t> registers;
+  for (size_t i=configStart; i<configEnd; i++)
+  {
+    const Si4432Device::Transaction& t = transactions[i];
+    for (size_t j=0; t.write && j<t.data.size(); j++)
+    {
+      registers[t.address + j] = t.data[j];
+    }
+  }
+  int previous = -2;
+  size_t block = 0;
+  for (const auto& r : registers)
+  {
+    if (r.first != previous + 1 && block)
+    {
+      phases.burst += getSpiTime(1 + block);
+      phases.burstTransactions++;
+      block = 0;
+    }
+    block++;
+    previous = r.first;
+  }
+  if (block)
+  {
+    phases.burst += getSpiTime(1 + block);
+    phases.burstTransactions++;
+  }
+  phases.burst += getSpiTime(2); // REG_STATE
+  phases.burstTransactions++;
+  return true;
+}
+
+static void printTransactions(const Si4432Device::Session& session, const std::vector<Si4432Device::Transaction>& transactions)
+{
+  for (size_t i=session.firstTransaction; i<session.endTransaction; i++)
+  {
+    const Si4432Device::Transaction& t = transactions[i];
+    printf("  %8.3f ms %c %02X:", (t.start - session.powerOn)/1000.0, t.write? 'W' : 'R', t.address);
+    for (uint8_t b : t.data)
+    {
+      printf(" %02X", b);
+    }
+    printf("\n");
+  }
+}
+
+/**
+ * @return bits of Manchester chips, false if a chip pair is not a transition
+ */
+static bool demanchester(const std::vector<bool>& chips, bool inverted, std::vector<bool>& bits)
+{
+  bits.clear();
+  for (size_t i=0; i + 1 < chips.size(); i += 2)
+  {
+    if (chips[i] == chips[i + 1])
+    {
+      return false;
+    }
+    bits.push_back(chips[i] != inverted);
+  }
+  return true;
+}
+
+/**
+ * append frame to I/Q capture, 10 kHz carrier offset and noise as the generator of OregonDecode
+ */
+static void appendCapture(std::vector<uint8_t>& iq, const std::vector<bool>& chips, double chipTime, uint32_t sampleRate, std::mt19937& rng)
+{
+  std::normal_distribution<float> noise(0, 4);
+  float amplitude = 4*sqrtf(2)*powf(10, 20/20.0f); // SNR 20 dB
+  float phaseStep = 2*M_PI*10000/sampleRate;
+  float phase = 0;
+  auto addSample = [&](bool on)
+  {
+    float i = noise(rng);
+    float q = noise(rng);
+    if (on)
+    {
+      i += amplitude*cosf(phase);
+      q += amplitude*sinf(phase);
+    }
+    phase += phaseStep;
+    iq.push_back((uint8_t)std::min(255.0f, std::max(0.0f, 127.5f + i)));
+    iq.push_back((uint8_t)std::min(255.0f, std::max(0.0f, 127.5f + q)));
+  };
+
+  // 20 ms idle before each frame
+  for (uint32_t s=0; s<sampleRate/50; s++)
+  {
+    addSample(false);
+  }
+  double samplesPerChip = chipTime*sampleRate/1e6;
+  size_t start = iq.size()/2;
+  for (size_t c=0; c<chips.size(); c++)
+  {
+    size_t end = start + (size_t)((c + 1)*samplesPerChip);
+    while (iq.size()/2 < end)
+    {
+      addSample(chips[c]);
+    }
+  }
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: radio_emu_tool [options]\n"
+    "  -n <count>    transmissions, default 1\n"
+    "  -b            estimate radio configuration with burst writes\n"
+    "  -o <file>     write on-air signal as 2 MS/s .cu8 capture\n"
+    "  -v            SPI trace of first transmission\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:bo:vh")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n': options.transmissions = atoi(optarg); break;
+      case 'b': options.burst = true; break;
+      case 'o': options.capture = optarg; break;
+      case 'v': options.verbose = true; break;
+      default: usage(); return 1;
+    }
+  }
+  if (options.transmissions == 0)
+  {
+    usage();
+    return 1;
+  }
+
+  HostBoard& board = HostBoard::instance();
+  board.install();
+  Si4432Device device(PIN_RADIO_CS, PIN_RADIO_NSDN, PIN_RADIO_NIRQ);
+  board.attach(&device);
+  Si4432Emulator& radio = device.getEmulator();
+  Analog2DigitalConverter::instance().setValue(ADC_INPUTCTRL_MUXPOS_SCALEDIOVCC_Val, 3.0f);
+  HostClimate& climate = getHostClimate();
+
+  Sketch& sketch = Sketch::instance();
+  HostBoard::unprotect(sketch.flash);
+  HostBoard::unprotect(sketch.historyFlash);
+  sketch.setup();
+  if (!sketch.hasRadio)
+  {
+    printf("radio init failed\n");
+    return 1;
+  }
+
+  ManchesterEncoder manchester;
+  manchester.setInverted(true);
+  manchester.setLsbFirst(true);
+  OregonScientificDecoder decoder;
+  decoder.setLsbFirst(true);
+
+  std::vector<uint8_t> iq;
+  std::mt19937 rng(4711);
+  Phases total;
+  uint32_t frames = 0;
+  uint32_t failures = 0;
+  size_t nextSession = 0;
+  uint64_t timeout = getHostTime() + (uint64_t)options.transmissions*3600000000ULL;
+  while (frames < options.transmissions)
+  {
+    if (getHostTime() > timeout)
+    {
+      printf("no transmission within 1 h\n");
+      return 1;
+    }
+
+    // 100 ms steps, each radio session is evaluated before the next wakeup changes the frame
+    board.run(getHostTime() + 100000);
+    const std::vector<Si4432Device::Session>& sessions = device.getSessions();
+    for (; nextSession < sessions.size() && frames < options.transmissions; nextSession++)
+    {
+      const Si4432Device::Session& session = sessions[nextSession];
+      if (nextSession + 1 == sessions.size() && device.isPoweredOn())
+      {
+        break;
+      }
+      if (!session.transmissions)
+      {
+        // setupRadio(): init and turn off
+        continue;
+      }
+
+      frames++;
+      if (options.verbose && frames == 1)
+      {
+        printf("transmission 1\n");
+        printTransactions(session, device.getTransactions());
+      }
+
+      // verify on-air signal against the frame of the sketch
+      Phases phases;
+      bool sequence = session.transmissions == 1 && getPhases(session, device.getTransactions(), phases);
+      const byte* message = sketch.getFrame();
+      byte size = sketch.frameSize;
+      const std::vector<bool>& chips = radio.getChips();
+      bool chipsMatch = chips.size() == 16u*size;
+      for (size_t h=0; chipsMatch && h<chips.size(); h++)
+      {
+        chipsMatch = chips[h] == manchester.getLevel(message, h);
+      }
+      std::vector<bool> bits;
+      OregonScientificDecoder::Frame received;
+      bool decoded = demanchester(chips, true, bits) && decoder.decodeBits(bits, received)
+                  && received.id == 0xF824 && received.channel == 1 && received.rollingCode == sketch.schedule.getRollingCode()
+                  && received.lowBatt == sketch.isLowBattery() && fabsf(received.temp - sketch.transmitTemperature) < 0.051f
+                  && received.hum == (byte)round(sketch.transmitHumidity);
+      bool ok = sequence && radio.isOOK() && chipsMatch && decoded && !session.antennaError && session.txOn < session.txOff;
+      if (!ok)
+      {
+        failures++;
+        printf("transmission %u: FAILED sequence=%d ook=%d chips=%d decoded=%d antenna=%s\n", frames, sequence,
+               radio.isOOK(), chipsMatch, decoded, session.antennaError? "TX+RX" : "ok");
+      }
+      if (options.capture)
+      {
+        appendCapture(iq, chips, radio.getChipTime(), options.sampleRate, rng);
+      }
+      radio.clearChips();
+
+      total.chipReady += phases.chipReady;
+      total.config += phases.config;
+      total.sensor += phases.sensor;
+      total.load += phases.load;
+      total.txStart += phases.txStart;
+      total.air += phases.air;
+      total.shutdown += phases.shutdown;
+      total.radioOn += phases.radioOn;
+      total.spi += phases.spi;
+      total.burst += phases.burst;
+      total.spiBytes += phases.spiBytes;
+      total.spiTransactions += phases.spiTransactions;
+      total.burstTransactions += phases.burstTransactions;
+
+      // next reading
+      climate.temperature = -20 + 0.1f*(float)((frames*37) % 600);
+      climate.humidity = (frames*13) % 100;
+    }
+  }
+
+  double n = options.transmissions;
+  printf("radio %.2f MHz, %.0f bit/s, chip %.1f us, TX power %u\n", radio.getFrequency(), 1e6/radio.getBitTime(),
+         radio.getChipTime(), radio.getRegister(Si4432Emulator::REG_TX_POWER) & 0x07);
+  printf("phase              [ms]\n");
+  printf("chip ready     %8.3f\n", total.chipReady/n/1000);
+  printf("config         %8.3f\n", total.config/n/1000);
+  printf("sensor         %8.3f\n", total.sensor/n/1000);
+  printf("FIFO load      %8.3f\n", total.load/n/1000);
+  printf("TX start       %8.3f\n", total.txStart/n/1000);
+  printf("on air         %8.3f\n", total.air/n/1000);
+  printf("shutdown       %8.3f\n", total.shutdown/n/1000);
+  printf("radio on       %8.3f\n", total.radioOn/n/1000);
+  printf("SPI %.0f bytes in %.0f transactions per transmission, %.3f ms MCU time\n", total.spiBytes/n, total.spiTransactions/n, total.spi/n/1000);
+  if (options.burst)
+  {
+    printf("config with burst writes: %.0f transactions, %.3f ms MCU time (%.3f ms saved per transmission)\n",
+           total.burstTransactions/n, total.burst/n/1000, (total.config - total.burst)/n/1000);
+  }
+  printf("%u of %u frames verified\n", options.transmissions - failures, options.transmissions);
+
+  if (options.capture)
+  {
+    FILE* file = fopen(options.capture, "wb");
+    if (!file)
+    {
+      perror(options.capture);
+      return 1;
+    }
+    // trailing gap
+    appendCapture(iq, std::vector<bool>(), 0, options.sampleRate, rng);
+    fwrite(iq.data(), 1, iq.size(), file);
+    fclose(file);
+  }
+
+  return failures? 1 : 0;
+}
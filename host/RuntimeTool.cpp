@@ -0,0 +1,307 @@
+/*****************************************************************************
+ *
+ * Validate the Remaining Runtime Estimate with Synthetic Discharge Traces
+ *
+ * file:     RuntimeTool.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -o runtime_tool RuntimeTool.cpp
+ *
+ * usage:
+ *   ./runtime_tool                         (all synthetic scenarios)
+ *   ./runtime_tool -p 120 -e 10            (120 µW load, battery 10 % below nominal capacity)
+ *   ./history_tool -d dump.txt > h.csv && ./runtime_tool -c h.csv   (estimate from recorded history)
+ *
+ * Each scenario simulates the battery charge with load and solar harvest per
+ * wakeup, derives the supply voltage from the discharge curve with ADC noise
+ * and runs RuntimeEstimator.h like the firmware. The actual runtime is the
+ * time until the charge is exhausted. The report compares the estimate with
+ * the actual remaining runtime at checkpoints and lists the lead time of the
+ * low battery warning (RUNTIME_WARNING) and false warnings of units that do
+ * not die. The scenario lipo-vddio feeds the regulated supply voltage to
+ * the estimator like the SCALEDIOVCC input and must not report warnings.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+#include "ArduinoHost.h"
+#include "../RuntimeEstimator.h"
+
+static const float WARNING_DAYS = 14; // same as RUNTIME_WARNING of SolarDHTConfig.h
+
+struct Options
+{
+  float power = 67;          // [µW] load, README: activity and standby without display
+  float period = 180;        // [s] wakeup period
+  float capacityError = 0;   // [%] actual capacity below model
+  float noise = 0.005f;      // [V] ADC noise
+  uint32_t seed = 4711;
+  const char* csv = nullptr;
+};
+
+struct Scenario
+{
+  const char* name;
+  const BatteryModel& battery;
+  float harvest;     // [fraction of load] daily average
+  float darkStart;   // [d] begin of period without harvest
+  float darkDays;    // [d] duration of period without harvest
+  float maxDays;     // [d] simulated duration
+  float regulated;   // [V] regulated supply voltage measured instead of battery voltage, 0=battery voltage
+};
+
+static const Scenario SCENARIOS[] = {
+  { "lipo-dark",      BATTERY_LIPO_50, 0,    0,  0,  200, 0    },
+  { "lipo-weak-sun",  BATTERY_LIPO_50, 0.6f, 0,  0,  400, 0    },
+  { "lipo-balanced",  BATTERY_LIPO_50, 1.5f, 0,  0,  200, 0    },
+  { "lipo-dark-week", BATTERY_LIPO_50, 1.5f, 30, 7,  200, 0    },
+  { "cr2032",         BATTERY_CR2032,  0,    0,  0,  800, 0    },
+  { "lipo-vddio",     BATTERY_LIPO_50, 1.5f, 0,  0,  200, 3.3f }, // SCALEDIOVCC behind 3.3 V regulator
+};
+
+struct Sample
+{
+  float time;     // [d]
+  float runtime;  // [d] estimate
+  bool warning;
+};
+
+/**
+ * @return [mA] solar harvest current, half sine from 6:00 to 18:00 with the given daily average
+ */
+static float getHarvest(float day, float average)
+{
+  float hour = fmodf(day, 1)*24;
+  if (hour < 6 || hour > 18)
+  {
+    return 0;
+  }
+  return average*M_PI*sinf(M_PI*(hour - 6)/12);
+}
+
+static void runScenario(const Options& options, const Scenario& scenario)
+{
+  std::mt19937 rng(options.seed);
+  std::normal_distribution<float> noise(0, options.noise);
+
+  const BatteryModel& battery = scenario.battery;
+  RuntimeEstimator estimator(battery);
+  float capacity = battery.capacity*(1 - options.capacityError/100);
+  float charge = capacity; // [mAh]
+  float step = options.period/3600; // [h]
+  float death = NAN;
+  std::vector<Sample> samples;
+
+  for (uint32_t n=0; n*step < scenario.maxDays*24; n++)
+  {
+    float day = n*step/24;
+    float voltage = 0;
+    // battery voltage from actual state of charge, inverse of the model curve
+    float soc = 100*charge/capacity;
+    for (byte i=1; i<battery.points; i++)
+    {
+      if (soc >= battery.charge[i] || i == battery.points - 1)
+      {
+        float f = (soc - battery.charge[i])/(battery.charge[i - 1] - battery.charge[i]);
+        voltage = battery.voltage[i] + f*(battery.voltage[i - 1] - battery.voltage[i]);
+        break;
+      }
+    }
+    if (scenario.regulated > 0)
+    {
+      voltage = scenario.regulated;
+    }
+    voltage += noise(rng);
+
+    float load = options.power/1000/voltage; // [mA]
+    bool dark = day >= scenario.darkStart && day < scenario.darkStart + scenario.darkDays;
+    float harvest = dark? 0 : getHarvest(day, scenario.harvest*load);
+    charge += (harvest - load)*step;
+    if (charge > capacity)
+    {
+      charge = capacity;
+    }
+    if (charge <= 0)
+    {
+      death = day;
+      break;
+    }
+
+    estimator.update(voltage, options.power/1000, step);
+    Sample sample = { day, estimator.getRuntime()/24, estimator.isRuntimeShorter(WARNING_DAYS) };
+    samples.push_back(sample);
+  }
+
+  printf("\n%s: %s, load %.0f uW, harvest %.0f%% of load, ", scenario.name, battery.name, options.power, 100*scenario.harvest);
+  if (std::isnan(death))
+  {
+    printf("survives %.0f d\n", scenario.maxDays);
+  }
+  else
+  {
+    printf("dies after %.1f d\n", death);
+  }
+  printf("  final: SoC %.0f%%, net %.4f mA, load %.4f mA, harvest %.4f mA, runtime %.1f d\n", estimator.getStateOfCharge(),
+         estimator.getNetCurrent(), estimator.getLoadCurrent(), estimator.getHarvestCurrent(), estimator.getRuntime()/24);
+
+  if (std::isnan(death))
+  {
+    uint32_t warnings = 0;
+    for (const Sample& s : samples)
+    {
+      warnings += s.warning;
+    }
+    printf("  false warnings: %u of %zu wakeups\n", warnings, samples.size());
+    return;
+  }
+
+  static const float CHECKPOINTS[] = { 60, 30, 14, 7, 3, 1 };
+  printf("  %10s %10s %8s\n", "actual [d]", "estim. [d]", "error");
+  for (float checkpoint : CHECKPOINTS)
+  {
+    float t = death - checkpoint;
+    if (t < 0)
+    {
+      continue;
+    }
+    size_t i = std::min(samples.size() - 1, (size_t)(t*24/step));
+    float estimate = samples[i].runtime;
+    if (estimate >= RuntimeEstimator::UNLIMITED/24)
+    {
+      printf("  %10.0f %10s %8s\n", checkpoint, "unlimited", "-");
+    }
+    else
+    {
+      printf("  %10.0f %10.1f %7.0f%%\n", checkpoint, estimate, 100*(estimate - checkpoint)/checkpoint);
+    }
+  }
+
+  // lead time: warning active from then on until death
+  float lead = 0;
+  for (size_t i=samples.size(); i-- > 0;)
+  {
+    if (!samples[i].warning)
+    {
+      break;
+    }
+    lead = death - samples[i].time;
+  }
+  printf("  warning (< %.0f d) %.1f d before death\n", WARNING_DAYS, lead);
+}
+
+/**
+ * run estimator on CSV of HistoryTool -d (time [s], temperature, humidity, voltage, time base)
+ */
+static int runCsv(const Options& options)
+{
+  FILE* file = fopen(options.csv, "r");
+  if (!file)
+  {
+    perror(options.csv);
+    return 1;
+  }
+  RuntimeEstimator estimator(BATTERY_LIPO_50);
+  char line[256];
+  double last = NAN;
+  uint32_t samples = 0;
+  printf("%10s %8s %6s %10s %10s %10s\n", "time [h]", "VCC [V]", "SoC", "net [mA]", "harv. [mA]", "runtime [d]");
+  while (fgets(line, sizeof(line), file))
+  {
+    double time;
+    float temperature, humidity, voltage;
+    if (sscanf(line, "%lf,%f,%f,%f", &time, &temperature, &humidity, &voltage) != 4)
+    {
+      continue;
+    }
+    float elapsed = std::isnan(last)? options.period/3600 : (time - last)/3600;
+    last = time;
+    estimator.update(voltage, options.power/1000, elapsed);
+    if (samples++ % 20 == 0)
+    {
+      printf("%10.1f %8.2f %5.0f%% %10.4f %10.4f %10.1f%s\n", time/3600, voltage, estimator.getStateOfCharge(),
+             estimator.getNetCurrent(), estimator.getHarvestCurrent(), estimator.getRuntime()/24, estimator.isValid()? "" : " (no trend)");
+    }
+  }
+  fclose(file);
+  return 0;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: runtime_tool [options]\n"
+    "  -p <uW>       average load power, default 67\n"
+    "  -t <s>        wakeup period, default 180\n"
+    "  -e <percent>  actual battery capacity below model, default 0\n"
+    "  -n <V>        ADC noise, default 0.005\n"
+    "  -s <name>     only scenario\n"
+    "  -c <file>     run estimator on history CSV (HistoryTool -d) with LiPo model\n");
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  const char* only = nullptr;
+  int opt;
+  while ((opt = getopt(argc, argv, "p:t:e:n:s:c:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'p': options.power = atof(optarg); break;
+      case 't': options.period = atof(optarg); break;
+      case 'e': options.capacityError = atof(optarg); break;
+      case 'n': options.noise = atof(optarg); break;
+      case 's': only = optarg; break;
+      case 'c': options.csv = optarg; break;
+      default: usage(); return 1;
+    }
+  }
+  if (options.power <= 0 || options.period <= 0)
+  {
+    usage();
+    return 1;
+  }
+
+  if (options.csv)
+  {
+    return runCsv(options);
+  }
+
+  for (const Scenario& scenario : SCENARIOS)
+  {
+    if (!only || !strcmp(only, scenario.name))
+    {
+      runScenario(options, scenario);
+    }
+  }
+  return 0;
+}
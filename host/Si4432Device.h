@@ -0,0 +1,238 @@
+/*****************************************************************************
+ *
+ * Si4432 Emulator behind the SPI Shim and the Radio Pins
+ *
+ * file:     Si4432Device.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "HostBoard.h"
+#include "Si4432Emulator.h"
+
+/**
+ * connects Si4432Emulator.h to the SPI shim and to the SDN and NIRQ pins, so
+ * the Si4432 library shim and the sketch drive the register model like the
+ * module
+ *
+ * sync() is called by the HostBoard model with each host time advance: SDN
+ * is sampled first (a pin write takes effect at the previous sync), then the
+ * emulator is advanced event by event to the host time and NIRQ is driven
+ * low while an enabled interrupt is pending.
+ *
+ * SPI transactions and radio sessions (SDN low to SDN high) are recorded
+ * with their host time, including the TX state of GPIO0 and the antenna
+ * switch error GPIO0 and GPIO1 high at the same time.
+ */
+class Si4432Device : public HostSpiDevice, public HostDevice
+{
+public:
+  struct Transaction
+  {
+    uint64_t start;  // [µs] host time of first byte
+    uint64_t end;    // [µs] host time of deselect
+    bool write;
+    uint8_t address;
+    std::vector<uint8_t> data; // written or read
+  };
+
+  /**
+   * [µs] host times, 0 if not reached
+   */
+  struct Session
+  {
+    uint64_t powerOn;    // SDN released
+    uint64_t chipReady;  // first NIRQ low
+    uint64_t txOn;       // first GPIO0 high
+    uint64_t txOff;      // last GPIO0 low
+    uint64_t powerOff;   // SDN high
+    size_t firstTransaction;
+    size_t endTransaction;
+    uint32_t transmissions;
+    bool antennaError;
+  };
+
+public:
+  Si4432Device(uint32_t csPin, uint32_t sdnPin, uint32_t nirqPin) :
+    sdnPin(sdnPin),
+    nirqPin(nirqPin)
+  {
+    // SDN pulled high until driven by the MCU, NIRQ idle high
+    getHostPin(sdnPin).level = HIGH;
+    getHostPin(nirqPin).level = HIGH;
+    SPI.attach(this, csPin);
+  }
+
+  ~Si4432Device()
+  {
+    SPI.attach(nullptr, 0);
+  }
+
+public:
+  void select() override
+  {
+    emulator.select();
+    addressed = false;
+  }
+
+  void deselect() override
+  {
+    emulator.deselect();
+    if (addressed)
+    {
+      transaction.end = getHostTime();
+      transactions.push_back(transaction);
+    }
+  }
+
+  uint8_t transfer(uint8_t data) override
+  {
+    uint8_t result = emulator.transfer(data);
+    if (!addressed)
+    {
+      transaction.start = getHostTime();
+      transaction.write = data & 0x80;
+      transaction.address = data & 0x7F;
+      transaction.data.clear();
+      addressed = true;
+    }
+    else
+    {
+      transaction.data.push_back(transaction.write? data : result);
+    }
+    return result;
+  }
+
+  void sync() override
+  {
+    bool shutdown = getHostPin(sdnPin).level == HIGH;
+    if (shutdown != isShutdown)
+    {
+      isShutdown = shutdown;
+      if (shutdown)
+      {
+        Session& session = sessions.back();
+        session.powerOff = emulator.getTime();
+        session.endTransaction = transactions.size();
+        session.transmissions = emulator.getTransmissions() - session.transmissions;
+      }
+      else
+      {
+        sessions.push_back(Session());
+        Session& session = sessions.back();
+        session.powerOn = emulator.getTime();
+        session.firstTransaction = transactions.size();
+        session.transmissions = emulator.getTransmissions();
+      }
+      emulator.setShutdown(shutdown);
+    }
+
+    uint64_t now = getHostTime();
+    while (emulator.getNextEvent() <= now)
+    {
+      advance(emulator.getNextEvent());
+    }
+    advance(now);
+
+    getHostPin(nirqPin).level = emulator.isInterruptPending()? LOW : HIGH;
+  }
+
+  uint64_t getNextEvent() const override
+  {
+    return emulator.getNextEvent() == UINT64_MAX? HostBoard::NONE : emulator.getNextEvent();
+  }
+
+  Si4432Emulator& getEmulator()
+  {
+    return emulator;
+  }
+
+  const std::vector<Transaction>& getTransactions() const
+  {
+    return transactions;
+  }
+
+  /**
+   * @return sessions since construction, the last one is open if SDN is low
+   */
+  const std::vector<Session>& getSessions() const
+  {
+    return sessions;
+  }
+
+  bool isPoweredOn() const
+  {
+    return !isShutdown;
+  }
+
+private:
+  void advance(uint64_t time)
+  {
+    while (emulator.getTime() < time)
+    {
+      uint64_t step = time - emulator.getTime();
+      emulator.advance(step > UINT32_MAX? UINT32_MAX : (uint32_t)step);
+    }
+    if (isShutdown || sessions.empty())
+    {
+      return;
+    }
+
+    Session& session = sessions.back();
+    if (!session.chipReady && emulator.isInterruptPending())
+    {
+      session.chipReady = time;
+    }
+    bool tx = emulator.getGpio(0);
+    if (tx != txState)
+    {
+      txState = tx;
+      if (tx && !session.txOn)
+      {
+        session.txOn = time;
+      }
+      else if (!tx)
+      {
+        session.txOff = time;
+      }
+    }
+    session.antennaError |= emulator.getGpio(0) && emulator.getGpio(1);
+  }
+
+private:
+  uint32_t sdnPin;
+  uint32_t nirqPin;
+  Si4432Emulator emulator;
+  bool isShutdown = true;
+  bool txState = false;
+  bool addressed = false;
+  Transaction transaction;
+  std::vector<Transaction> transactions;
+  std::vector<Session> sessions;
+};
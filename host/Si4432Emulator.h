@@ -0,0 +1,650 @@
+/*****************************************************************************
+ *
+ * Register-level Si4432 Emulator
+ *
+ * file:     Si4432Emulator.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * software model of the Si4432 behind its SPI, SDN, NIRQ and GPIO pins
+ *
+ * Modelled (datasheet rev 1.1):
+ * - register file with reset values, SPI read/write with address auto
+ *   increment, burst access to the FIFO (0x7F)
+ * - interrupt status registers cleared on read, NIRQ low while an enabled
+ *   status bit is set
+ * - shutdown, power on reset (SDN released or software reset) with CHIPRDY
+ *   and POR interrupts, crystal start-up and PLL settling before TX
+ * - 64 byte TX and RX FIFO with clear and overflow
+ * - TX in FIFO mode: with packet handler preamble, sync word, header,
+ *   length, data and CRC-16 (CCITT only), without packet handler the FIFO
+ *   content; LSB first, data inversion, Manchester encoding and its
+ *   inversion; PKSENT and return to the idle state of REG_STATE
+ * - GPIO0..2 as TX/RX state outputs (antenna switch)
+ * - RX: a frame injected by the test raises PREAVAL and PKVALID after its
+ *   air time
+ *
+ * The on-air signal is recorded as chips (one level per Manchester half bit
+ * or per bit without Manchester) with the chip duration derived from the TX
+ * data rate registers.
+ *
+ * Time advances only with advance(), all durations in µs. Si4432Device.h
+ * attaches the emulator to the SPI shim and the radio pins of the sketch.
+ */
+class Si4432Emulator
+{
+public:
+  enum Register
+  {
+    REG_DEVICE_TYPE       = 0x00,
+    REG_VERSION           = 0x01,
+    REG_DEVICE_STATUS     = 0x02,
+    REG_INT_STATUS1       = 0x03,
+    REG_INT_STATUS2       = 0x04,
+    REG_INT_ENABLE1       = 0x05,
+    REG_INT_ENABLE2       = 0x06,
+    REG_STATE             = 0x07,
+    REG_OPERATION_CONTROL = 0x08,
+    REG_GPIO0_CONF        = 0x0B,
+    REG_GPIO1_CONF        = 0x0C,
+    REG_GPIO2_CONF        = 0x0D,
+    REG_DATAACCESS_CONTROL= 0x30,
+    REG_HEADER_CONTROL2   = 0x33,
+    REG_PREAMBLE_LENGTH   = 0x34,
+    REG_SYNC_WORD3        = 0x36,
+    REG_TRANSMIT_HEADER3  = 0x3A,
+    REG_PKG_LEN           = 0x3E,
+    REG_RECEIVED_LENGTH   = 0x4B,
+    REG_TX_POWER          = 0x6D,
+    REG_TX_DATARATE1      = 0x6E,
+    REG_TX_DATARATE0      = 0x6F,
+    REG_MODULATION_MODE1  = 0x70,
+    REG_MODULATION_MODE2  = 0x71,
+    REG_FREQBAND          = 0x75,
+    REG_FREQCARRIER_H     = 0x76,
+    REG_FREQCARRIER_L     = 0x77,
+    REG_FIFO              = 0x7F,
+    REGISTERS             = 0x80
+  };
+
+  // REG_INT_STATUS1
+  static const uint8_t INT_FIFO_ERROR  = 0x80;
+  static const uint8_t INT_PKSENT      = 0x04;
+  static const uint8_t INT_PKVALID     = 0x02;
+  static const uint8_t INT_CRCERROR    = 0x01;
+  // REG_INT_STATUS2
+  static const uint8_t INT_PREAVAL     = 0x40;
+  static const uint8_t INT_CHIPRDY     = 0x02;
+  static const uint8_t INT_POR         = 0x01;
+  // REG_STATE
+  static const uint8_t STATE_SWRES     = 0x80;
+  static const uint8_t STATE_TXON      = 0x08;
+  static const uint8_t STATE_RXON      = 0x04;
+  static const uint8_t STATE_PLLON     = 0x02;
+  static const uint8_t STATE_XTON      = 0x01;
+  // REG_OPERATION_CONTROL
+  static const uint8_t FIFO_CLEAR_RX   = 0x02;
+  static const uint8_t FIFO_CLEAR_TX   = 0x01;
+  // REG_GPIOn_CONF
+  static const uint8_t GPIO_TX_STATE_OUTPUT = 0x12;
+  static const uint8_t GPIO_RX_STATE_OUTPUT = 0x15;
+
+  static const uint32_t POR_TIME = 16800;  // [µs] SDN released to chip ready
+  static const uint32_t XTAL_TIME = 600;   // [µs] standby to ready
+  static const uint32_t PLL_TIME = 200;    // [µs] ready to TX/RX
+  static const uint16_t FIFO_SIZE = 64;    // [bytes]
+
+  enum State
+  {
+    SHUTDOWN,
+    POWER_ON,  // reset in progress
+    IDLE,      // standby, sleep or ready
+    TX_SETTLE,
+    TX,
+    RX
+  };
+
+public:
+  Si4432Emulator()
+  {
+    reset();
+    state = SHUTDOWN;
+  }
+
+public:
+  /**
+   * SDN pin, high = shutdown, registers are lost
+   */
+  void setShutdown(bool shutdown)
+  {
+    if (shutdown)
+    {
+      state = SHUTDOWN;
+      txFifo.clear();
+      rxFifo.clear();
+    }
+    else if (state == SHUTDOWN)
+    {
+      startPowerOn();
+    }
+  }
+
+  /**
+   * NIRQ pin is low
+   */
+  bool isInterruptPending() const
+  {
+    return state != SHUTDOWN && state != POWER_ON
+        && ((registers[REG_INT_STATUS1] & registers[REG_INT_ENABLE1]) || (registers[REG_INT_STATUS2] & registers[REG_INT_ENABLE2]));
+  }
+
+  /**
+   * @return level of GPIO0..2
+   */
+  bool getGpio(uint8_t gpio) const
+  {
+    if (gpio > 2 || state == SHUTDOWN)
+    {
+      return false;
+    }
+    switch (registers[REG_GPIO0_CONF + gpio] & 0x1F)
+    {
+      case GPIO_TX_STATE_OUTPUT: return state == TX;
+      case GPIO_RX_STATE_OUTPUT: return state == RX;
+      default:                   return false;
+    }
+  }
+
+  /**
+   * SPI chip select
+   */
+  void select()
+  {
+    selected = true;
+    addressed = false;
+    transactions++;
+  }
+
+  void deselect()
+  {
+    selected = false;
+  }
+
+  /**
+   * SPI byte transfer, first byte after select() is the address (bit 7 = write)
+   *
+   * @return byte on MISO
+   */
+  uint8_t transfer(uint8_t data)
+  {
+    spiBytes++;
+    if (!selected || state == SHUTDOWN)
+    {
+      return 0xFF;
+    }
+    if (!addressed)
+    {
+      address = data & 0x7F;
+      writing = data & 0x80;
+      addressed = true;
+      return 0;
+    }
+
+    uint8_t result = 0;
+    if (writing)
+    {
+      write(address, data);
+    }
+    else
+    {
+      result = read(address);
+    }
+    if (address != REG_FIFO)
+    {
+      address = (address + 1) & 0x7F;
+    }
+    return result;
+  }
+
+  /**
+   * advance time and process internal events
+   */
+  void advance(uint32_t us)
+  {
+    uint64_t end = now + us;
+    while (getNextEvent() <= end)
+    {
+      now = getNextEvent();
+      processEvent();
+    }
+    now = end;
+  }
+
+  /**
+   * @return time of next internal event [µs], UINT64_MAX if none
+   */
+  uint64_t getNextEvent() const
+  {
+    return state == POWER_ON || state == TX_SETTLE || state == TX || (state == RX && rxFrame.size())? eventTime : UINT64_MAX;
+  }
+
+  uint64_t getTime() const
+  {
+    return now;
+  }
+
+  State getState() const
+  {
+    return state;
+  }
+
+  /**
+   * receive frame in RX state, bytes as they will appear in the RX FIFO
+   */
+  void inject(const std::vector<uint8_t>& frame)
+  {
+    if (state == RX && !frame.empty())
+    {
+      rxFrame = frame;
+      eventTime = now + (uint64_t)(8*(frame.size() + 8))*getBitTime();
+    }
+  }
+
+  /**
+   * @return [µs] duration of one bit at the TX data rate
+   */
+  double getBitTime() const
+  {
+    uint32_t txdr = (registers[REG_TX_DATARATE1] << 8) | registers[REG_TX_DATARATE0];
+    bool scale = registers[REG_MODULATION_MODE1] & 0x20;
+    return txdr? (scale? 2097152.0 : 65536.0)/txdr : 0;
+  }
+
+  /**
+   * @return carrier frequency [MHz]
+   */
+  double getFrequency() const
+  {
+    uint8_t band = registers[REG_FREQBAND];
+    uint16_t fc = (registers[REG_FREQCARRIER_H] << 8) | registers[REG_FREQCARRIER_L];
+    return 10.0*(((band >> 5) & 1) + 1)*((band & 0x1F) + 24 + fc/64000.0);
+  }
+
+  bool isOOK() const
+  {
+    return (registers[REG_MODULATION_MODE2] & 0x03) == 0x01;
+  }
+
+  uint8_t getRegister(uint8_t reg) const
+  {
+    return registers[reg & 0x7F];
+  }
+
+  /**
+   * @return on-air chips of all transmissions since last clearChips(), true = carrier on (OOK)
+   */
+  const std::vector<bool>& getChips() const
+  {
+    return chips;
+  }
+
+  /**
+   * @return [µs] duration of one chip of the last transmission
+   */
+  double getChipTime() const
+  {
+    return chipTime;
+  }
+
+  void clearChips()
+  {
+    chips.clear();
+  }
+
+  uint32_t getSpiBytes() const
+  {
+    return spiBytes;
+  }
+
+  uint32_t getSpiTransactions() const
+  {
+    return transactions;
+  }
+
+  uint32_t getTransmissions() const
+  {
+    return transmissions;
+  }
+
+private:
+  void reset()
+  {
+    static const uint8_t DEFAULTS[][2] = {
+      { REG_DEVICE_TYPE, 0x08 }, { REG_VERSION, 0x06 }, { REG_INT_ENABLE2, 0x03 }, { REG_STATE, STATE_XTON },
+      { 0x09, 0x7F }, { 0x0A, 0x06 }, { REG_DATAACCESS_CONTROL, 0x8D }, { 0x32, 0x0C }, { REG_HEADER_CONTROL2, 0x22 },
+      { REG_PREAMBLE_LENGTH, 0x08 }, { 0x35, 0x2A }, { REG_SYNC_WORD3, 0x2D }, { 0x37, 0xD4 }, { REG_TX_POWER, 0x18 },
+      { REG_TX_DATARATE1, 0x0A }, { REG_TX_DATARATE0, 0x3D }, { REG_MODULATION_MODE1, 0x0C }, { 0x72, 0x20 },
+      { REG_FREQBAND, 0x75 }, { REG_FREQCARRIER_H, 0xBB }, { REG_FREQCARRIER_L, 0x80 },
+    };
+    for (uint8_t& r : registers)
+    {
+      r = 0;
+    }
+    for (const auto& d : DEFAULTS)
+    {
+      registers[d[0]] = d[1];
+    }
+    txFifo.clear();
+    rxFifo.clear();
+    rxFrame.clear();
+  }
+
+  void startPowerOn()
+  {
+    reset();
+    state = POWER_ON;
+    eventTime = now + POR_TIME;
+  }
+
+  uint8_t read(uint8_t reg)
+  {
+    switch (reg)
+    {
+      case REG_DEVICE_STATUS:
+        return state == TX? 0x02 : state == RX? 0x01 : 0x00;
+
+      case REG_INT_STATUS1:
+      case REG_INT_STATUS2:
+      {
+        // cleared on read
+        uint8_t status = registers[reg];
+        registers[reg] = 0;
+        return status;
+      }
+
+      case REG_FIFO:
+      {
+        if (rxFifo.empty())
+        {
+          registers[REG_INT_STATUS1] |= INT_FIFO_ERROR;
+          return 0;
+        }
+        uint8_t b = rxFifo.front();
+        rxFifo.erase(rxFifo.begin());
+        return b;
+      }
+
+      default:
+        return registers[reg];
+    }
+  }
+
+  void write(uint8_t reg, uint8_t value)
+  {
+    switch (reg)
+    {
+      case REG_DEVICE_TYPE:
+      case REG_VERSION:
+      case REG_DEVICE_STATUS:
+      case REG_INT_STATUS1:
+      case REG_INT_STATUS2:
+      case REG_RECEIVED_LENGTH:
+        // read only
+        break;
+
+      case REG_STATE:
+      {
+        // TX/RX return to the state given with TXON/RXON, crystal start-up only if it was off
+        bool crystalRunning = idleState & STATE_XTON;
+        registers[reg] = value & ~STATE_SWRES;
+        idleState = value & ~(STATE_SWRES | STATE_TXON | STATE_RXON);
+        if (value & STATE_SWRES)
+        {
+          startPowerOn();
+        }
+        else if ((value & STATE_TXON) && state == IDLE)
+        {
+          state = TX_SETTLE;
+          eventTime = now + (crystalRunning? 0 : XTAL_TIME) + PLL_TIME;
+        }
+        else if ((value & STATE_RXON) && state == IDLE)
+        {
+          state = RX;
+          rxFrame.clear();
+        }
+        else if (!(value & (STATE_TXON | STATE_RXON)) && state != POWER_ON)
+        {
+          // abort TX/RX
+          state = IDLE;
+        }
+        break;
+      }
+
+      case REG_OPERATION_CONTROL:
+        registers[reg] = value;
+        if (value & FIFO_CLEAR_TX)
+        {
+          txFifo.clear();
+        }
+        if (value & FIFO_CLEAR_RX)
+        {
+          rxFifo.clear();
+        }
+        break;
+
+      case REG_FIFO:
+        if (txFifo.size() < FIFO_SIZE)
+        {
+          txFifo.push_back(value);
+        }
+        else
+        {
+          registers[REG_INT_STATUS1] |= INT_FIFO_ERROR;
+        }
+        break;
+
+      default:
+        registers[reg] = value;
+        break;
+    }
+  }
+
+  void processEvent()
+  {
+    switch (state)
+    {
+      case POWER_ON:
+        state = IDLE;
+        idleState = registers[REG_STATE];
+        registers[REG_INT_STATUS2] |= INT_CHIPRDY | INT_POR;
+        break;
+
+      case TX_SETTLE:
+        startTransmission();
+        break;
+
+      case TX:
+        transmissions++;
+        registers[REG_INT_STATUS1] |= INT_PKSENT;
+        registers[REG_STATE] = idleState;
+        state = IDLE;
+        break;
+
+      case RX:
+        rxFifo.insert(rxFifo.end(), rxFrame.begin(), rxFrame.end());
+        if (rxFifo.size() > FIFO_SIZE)
+        {
+          rxFifo.resize(FIFO_SIZE);
+          registers[REG_INT_STATUS1] |= INT_FIFO_ERROR;
+        }
+        registers[REG_RECEIVED_LENGTH] = rxFrame.size();
+        registers[REG_INT_STATUS2] |= INT_PREAVAL;
+        registers[REG_INT_STATUS1] |= INT_PKVALID;
+        rxFrame.clear();
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  void startTransmission()
+  {
+    uint8_t access = registers[REG_DATAACCESS_CONTROL];
+    uint8_t mode1 = registers[REG_MODULATION_MODE1];
+    uint8_t mode2 = registers[REG_MODULATION_MODE2];
+    bool packetHandler = access & 0x08;
+    bool lsbFirst = access & 0x40;
+    bool manchester = mode1 & 0x01;
+    bool manchesterInverted = mode1 & 0x02;
+    bool invert = mode2 & 0x08;
+    bool fifoMode = ((mode2 >> 4) & 0x03) == 0x02;
+
+    state = TX;
+    if (!fifoMode)
+    {
+      // direct mode, transmit until TXON is cleared
+      eventTime = UINT64_MAX;
+      return;
+    }
+
+    std::vector<bool> bits;
+    if (packetHandler)
+    {
+      uint8_t control2 = registers[REG_HEADER_CONTROL2];
+      uint16_t preamble = registers[REG_PREAMBLE_LENGTH] | ((control2 & 0x01) << 8); // [nibbles]
+      for (uint16_t i=0; i<4*preamble; i++)
+      {
+        bits.push_back(i % 2 == 0);
+      }
+      uint8_t syncLength = ((control2 >> 1) & 0x03) + 1;
+      for (uint8_t i=0; i<syncLength; i++)
+      {
+        addByte(bits, registers[REG_SYNC_WORD3 + i], false, invert);
+      }
+
+      std::vector<uint8_t> payload;
+      uint8_t headerLength = (control2 >> 4) & 0x07;
+      for (uint8_t i=0; i<headerLength && i<4; i++)
+      {
+        payload.push_back(registers[REG_TRANSMIT_HEADER3 + i]);
+      }
+      uint8_t length = registers[REG_PKG_LEN];
+      if (!(control2 & 0x08))
+      {
+        payload.push_back(length);
+      }
+      size_t dataStart = payload.size();
+      for (uint8_t i=0; i<length && i<txFifo.size(); i++)
+      {
+        payload.push_back(txFifo[i]);
+      }
+      txFifo.erase(txFifo.begin(), txFifo.begin() + std::min<size_t>(length, txFifo.size()));
+      if (access & 0x04)
+      {
+        uint16_t crc = crc16(payload, (access & 0x20)? dataStart : 0);
+        payload.push_back(crc >> 8);
+        payload.push_back(crc & 0xFF);
+      }
+      for (uint8_t b : payload)
+      {
+        addByte(bits, b, lsbFirst, invert);
+      }
+    }
+    else
+    {
+      // without packet handler the FIFO content is sent until the FIFO is empty
+      for (uint8_t b : txFifo)
+      {
+        addByte(bits, b, lsbFirst, invert);
+      }
+      txFifo.clear();
+    }
+
+    double bitTime = getBitTime();
+    chipTime = manchester? bitTime/2 : bitTime;
+    for (bool bit : bits)
+    {
+      if (manchester)
+      {
+        bool first = bit != manchesterInverted;
+        chips.push_back(first);
+        chips.push_back(!first);
+      }
+      else
+      {
+        chips.push_back(bit);
+      }
+    }
+    eventTime = now + (uint64_t)(bits.size()*bitTime + 0.5);
+  }
+
+  static void addByte(std::vector<bool>& bits, uint8_t b, bool lsbFirst, bool invert)
+  {
+    for (uint8_t i=0; i<8; i++)
+    {
+      bool bit = (b >> (lsbFirst? i : 7 - i)) & 1;
+      bits.push_back(bit != invert);
+    }
+  }
+
+  static uint16_t crc16(const std::vector<uint8_t>& data, size_t start)
+  {
+    uint16_t crc = 0;
+    for (size_t i=start; i<data.size(); i++)
+    {
+      crc ^= data[i] << 8;
+      for (uint8_t j=0; j<8; j++)
+      {
+        crc = (crc & 0x8000)? (crc << 1) ^ 0x1021 : crc << 1;
+      }
+    }
+    return crc;
+  }
+
+private:
+  uint8_t registers[REGISTERS];
+  State state;
+  uint8_t idleState = STATE_XTON; // REG_STATE without TXON/RXON
+  uint64_t now = 0;
+  uint64_t eventTime = 0;
+  std::vector<uint8_t> txFifo;
+  std::vector<uint8_t> rxFifo;
+  std::vector<uint8_t> rxFrame;
+  std::vector<bool> chips;
+  double chipTime = 0;
+  bool selected = false;
+  bool addressed = false;
+  bool writing = false;
+  uint8_t address = 0;
+  uint32_t spiBytes = 0;
+  uint32_t transactions = 0;
+  uint32_t transmissions = 0;
+};
@@ -0,0 +1,313 @@
+/*****************************************************************************
+ *
+ * Per Node Time Series in Memory Mapped Columnar Files
+ *
+ * file:     TimeSeriesStore.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <cerrno>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ArduinoHost.h"
+
+/**
+ * time series of one node as columnar ring buffer in a memory mapped file
+ *
+ * file layout (little endian, fixed size):
+ *
+ *   offset          size          content
+ *   0               64            Header
+ *   64              4*capacity    time [s]
+ *   64 + 4*capacity 2*capacity    temperature [0.1 °C]
+ *   64 + 6*capacity 1*capacity    humidity [%]
+ *   64 + 7*capacity 1*capacity    flags (bit 0: low battery)
+ *
+ * The columns are written before the count in the header is incremented, so
+ * a crash loses at most the sample being appended. The latest sample is at
+ * (count - 1) % capacity, the lookup is O(1). The file is created sparse, only
+ * written pages use disk space.
+ */
+class TimeSeriesFile
+{
+public:
+  static const uint32_t MAGIC = 0x53544853; // "SHTS"
+  static const uint16_t VERSION = 1;
+  static const byte FLAG_LOW_BATTERY = 0x01;
+
+  struct Header
+  {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t node;        // stable node ID
+    uint32_t capacity;    // [samples]
+    uint32_t count;       // [samples] appended since creation
+    uint16_t id;          // Oregon Scientific model ID
+    byte channel;
+    byte rollingCode;     // latest rolling code of node
+    uint16_t remaps;      // rolling code changes
+    byte reserved[42];
+  };
+  static_assert(sizeof(Header) == 64, "header size");
+
+  struct Sample
+  {
+    uint32_t time;        // [s]
+    float temp;           // [°C]
+    byte hum;             // [%]
+    bool lowBatt;
+  };
+
+public:
+  TimeSeriesFile() = default;
+  TimeSeriesFile(const TimeSeriesFile&) = delete;
+  TimeSeriesFile& operator=(const TimeSeriesFile&) = delete;
+
+  ~TimeSeriesFile()
+  {
+    close();
+  }
+
+public:
+  /**
+   * map existing file or create new file with given capacity
+   *
+   * @param capacity [samples] used if the file is created
+   * @return false if the file could not be mapped or has an invalid header
+   */
+  bool open(const char* path, uint16_t node, uint32_t capacity)
+  {
+    int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+      perror(path);
+      return false;
+    }
+    struct stat st;
+    bool created = fstat(fd, &st) == 0 && st.st_size == 0;
+    if (!created)
+    {
+      Header existing;
+      if (pread(fd, &existing, sizeof(existing), 0) != sizeof(existing) || existing.magic != MAGIC || existing.version != VERSION
+          || (off_t)getFileSize(existing.capacity) != st.st_size)
+      {
+        fprintf(stderr, "%s: invalid time series file\n", path);
+        ::close(fd);
+        return false;
+      }
+      capacity = existing.capacity;
+    }
+    else if (ftruncate(fd, getFileSize(capacity)) != 0)
+    {
+      perror(path);
+      ::close(fd);
+      return false;
+    }
+
+    size = getFileSize(capacity);
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+      perror(path);
+      return false;
+    }
+    base = (byte*)mapped;
+    header = (Header*)base;
+    if (created)
+    {
+      header->magic = MAGIC;
+      header->version = VERSION;
+      header->node = node;
+      header->capacity = capacity;
+    }
+    times = (uint32_t*)(base + sizeof(Header));
+    temperatures = (int16_t*)(base + sizeof(Header) + 4*capacity);
+    humidities = base + sizeof(Header) + 6*capacity;
+    flags = base + sizeof(Header) + 7*capacity;
+    return true;
+  }
+
+  void close()
+  {
+    if (base)
+    {
+      munmap(base, size);
+      base = nullptr;
+      header = nullptr;
+    }
+  }
+
+  void append(const Sample& sample)
+  {
+    uint32_t i = header->count % header->capacity;
+    times[i] = sample.time;
+    temperatures[i] = (int16_t)lroundf(sample.temp*10);
+    humidities[i] = sample.hum;
+    flags[i] = sample.lowBatt? FLAG_LOW_BATTERY : 0;
+    __atomic_store_n(&header->count, header->count + 1, __ATOMIC_RELEASE);
+  }
+
+  /**
+   * @param age 0 = latest sample
+   * @return false if not stored
+   */
+  bool get(uint32_t age, Sample& sample) const
+  {
+    if (age >= getSize())
+    {
+      return false;
+    }
+    uint32_t i = (header->count - 1 - age) % header->capacity;
+    sample.time = times[i];
+    sample.temp = temperatures[i]/10.0f;
+    sample.hum = humidities[i];
+    sample.lowBatt = flags[i] & FLAG_LOW_BATTERY;
+    return true;
+  }
+
+  bool getLatest(Sample& sample) const
+  {
+    return get(0, sample);
+  }
+
+  /**
+   * @return [samples] stored, max. capacity
+   */
+  uint32_t getSize() const
+  {
+    return header->count < header->capacity? header->count : header->capacity;
+  }
+
+  Header& getHeader()
+  {
+    return *header;
+  }
+
+  const Header& getHeader() const
+  {
+    return *header;
+  }
+
+  static size_t getFileSize(uint32_t capacity)
+  {
+    return sizeof(Header) + 8*(size_t)capacity;
+  }
+
+private:
+  byte* base = nullptr;
+  size_t size = 0;
+  Header* header = nullptr;
+  uint32_t* times = nullptr;
+  int16_t* temperatures = nullptr;
+  byte* humidities = nullptr;
+  byte* flags = nullptr;
+};
+
+/**
+ * directory with one TimeSeriesFile per node (node-<n>.ts)
+ */
+class TimeSeriesStore
+{
+public:
+  TimeSeriesStore(const std::string& directory, uint32_t capacity) : directory(directory), capacity(capacity) {}
+
+public:
+  /**
+   * create directory if missing and map all existing node files
+   *
+   * @return false on error
+   */
+  bool open()
+  {
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+      perror(directory.c_str());
+      return false;
+    }
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+    {
+      perror(directory.c_str());
+      return false;
+    }
+    bool ok = true;
+    while (dirent* entry = readdir(dir))
+    {
+      unsigned node;
+      char end;
+      if (sscanf(entry->d_name, "node-%u.t%c", &node, &end) == 2 && end == 's' && node <= 0xFFFF)
+      {
+        ok = add((uint16_t)node) && ok;
+      }
+    }
+    closedir(dir);
+    return ok;
+  }
+
+  /**
+   * @return file of node, created if missing, nullptr on error
+   */
+  TimeSeriesFile* get(uint16_t node)
+  {
+    auto it = files.find(node);
+    if (it != files.end())
+    {
+      return it->second.get();
+    }
+    return add(node)? files[node].get() : nullptr;
+  }
+
+  const std::map<uint16_t, std::unique_ptr<TimeSeriesFile>>& getFiles() const
+  {
+    return files;
+  }
+
+private:
+  bool add(uint16_t node)
+  {
+    std::unique_ptr<TimeSeriesFile> file(new TimeSeriesFile());
+    std::string path = directory + "/node-" + std::to_string(node) + ".ts";
+    if (!file->open(path.c_str(), node, capacity))
+    {
+      return false;
+    }
+    files[node] = std::move(file);
+    return true;
+  }
+
+private:
+  std::string directory;
+  uint32_t capacity;
+  std::map<uint16_t, std::unique_ptr<TimeSeriesFile>> files;
+};
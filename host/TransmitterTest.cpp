@@ -0,0 +1,307 @@
+/*****************************************************************************
+ *
+ * Replay the SYN115 Half Bit Buffer and Decode the Output
+ *
+ * file:     TransmitterTest.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -Ishim -o transmitter_test TransmitterTest.cpp
+ *
+ * usage:
+ *   ./transmitter_test [-v]
+ *
+ * Runs SYN115_Transmitter.hpp unchanged on the register model of the
+ * directory shim. The test plays the half bit buffer like TCC1 in normal PWM
+ * mode with DMA reload of CCB0 on overflow, expands each compare value into
+ * output samples, Manchester decodes the samples and checks:
+ * - TH frames of OregonScientific::encodeTH() padded to MAX_PACKET_SIZE are
+ *   decoded by OregonScientificDecoder.h
+ * - random messages of 1 .. MAX_PACKET_SIZE bytes are received bit exact
+ * - at MAX_PACKET_SIZE the buffer MAX_HALF_BITS = 2*8*MAX_PACKET_SIZE + 2
+ *   is used completely and not exceeded (guard bytes after the buffer), a
+ *   larger packet is rejected
+ * - the output is off when the last DMA beat completes and INT_PKSENT is
+ *   reported
+ *
+ * Exit code 1 if a check fails.
+ */
+
+#include <cstdio>
+#include <new>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <System.h>
+using namespace SAMD21LPE;
+
+#include "../OregonScientific.h"
+#include "../SYN115_Transmitter.hpp"
+#include "OregonScientificDecoder.h"
+
+static const byte DATA_PIN = 17;
+static const byte POWER_PIN = 3;
+static const byte SAMPLES_PER_HALF_BIT = 8;
+static const byte GUARD = 0xA5;
+
+static uint16_t pending = 0;
+static bool verbose = false;
+static uint32_t failures = 0;
+
+static void check(bool ok, const char* what, size_t size)
+{
+  if (!ok)
+  {
+    failures++;
+    printf("FAILED %s (%zu bytes)\n", what, size);
+  }
+  else if (verbose)
+  {
+    printf("ok     %s (%zu bytes)\n", what, size);
+  }
+}
+
+/**
+ * transmitter placed in front of guard bytes, the half bit buffer is the
+ * last member and is not initialized, so overflows change the guard or the
+ * padding
+ */
+class GuardedTransmitter
+{
+public:
+  GuardedTransmitter()
+  {
+    memset(memory, GUARD, sizeof(memory));
+    radio = new (memory) SYN115_Transmitter(DATA_PIN, POWER_PIN);
+  }
+
+  SYN115_Transmitter& get()
+  {
+    return *radio;
+  }
+
+  /**
+   * @return true if all bytes from end of buffer to end of guard are unchanged
+   */
+  bool isGuardIntact(const byte* bufferEnd) const
+  {
+    if (bufferEnd < memory || bufferEnd > memory + sizeof(SYN115_Transmitter))
+    {
+      return false;
+    }
+    for (const byte* p = bufferEnd; p < memory + sizeof(memory); p++)
+    {
+      if (*p != GUARD)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  alignas(SYN115_Transmitter) byte memory[sizeof(SYN115_Transmitter) + 64];
+  SYN115_Transmitter* radio;
+};
+
+/**
+ * play transmission like TCC1 and DMAC: each period outputs the compare value
+ * CC0, on overflow CC0 is loaded from CCB0 and the DMA beat reloads CCB0
+ *
+ * @param samples output level, SAMPLES_PER_HALF_BIT per half bit
+ * @param bufferStart start of half bit buffer, derived from DMA descriptor
+ * @param offAtEnd output compare is off when the last beat completes
+ */
+static void play(std::vector<bool>& samples, const byte*& bufferStart, bool& offAtEnd)
+{
+  const DmacDescriptor& descriptor = ((const DmacDescriptor*)DMAC->BASEADDR.reg)[DirectMemoryAccess::CHANNEL_RADIO];
+  uint16_t beats = descriptor.BTCNT.reg;
+  const uint16_t* source = (const uint16_t*)descriptor.SRCADDR.reg - beats;
+  volatile uint16_t* destination = (volatile uint16_t*)descriptor.DSTADDR.reg;
+  bufferStart = (const byte*)(source - 2);
+
+  uint32_t period = TCC1->PER.reg + 1;
+  uint32_t compare = TCC1->CC[0].reg;
+  offAtEnd = false;
+  for (uint32_t beat=0; TCC1->CTRLA.reg & TCC_CTRLA_ENABLE; beat++)
+  {
+    for (byte s=0; s<SAMPLES_PER_HALF_BIT; s++)
+    {
+      samples.push_back((2*s + 1)*period/(2*SAMPLES_PER_HALF_BIT) < compare);
+    }
+
+    // overflow: buffered compare update and DMA beat
+    compare = TCC1->CCB[0].reg;
+    *destination = source[beat];
+    if (beat + 1 == beats)
+    {
+      offAtEnd = compare == 0;
+      DMAC->INTSTATUS.reg = 1 << DirectMemoryAccess::CHANNEL_RADIO;
+      DirectMemoryAccess::instance().handleInterrupt();
+      DMAC->INTSTATUS.reg = 0;
+    }
+  }
+}
+
+/**
+ * @return bits of Manchester half bit pairs, false in valid if a pair has no transition
+ */
+static std::vector<bool> decodeManchester(const std::vector<bool>& samples, bool inverted, bool& valid)
+{
+  std::vector<bool> bits;
+  valid = samples.size() % (2*SAMPLES_PER_HALF_BIT) == 0;
+  for (size_t i=0; i + 2*SAMPLES_PER_HALF_BIT <= samples.size(); i += 2*SAMPLES_PER_HALF_BIT)
+  {
+    byte first = 0, second = 0;
+    for (byte s=0; s<SAMPLES_PER_HALF_BIT; s++)
+    {
+      first += samples[i + s];
+      second += samples[i + SAMPLES_PER_HALF_BIT + s];
+    }
+    bool high = first > SAMPLES_PER_HALF_BIT/2;
+    if (high == (second > SAMPLES_PER_HALF_BIT/2))
+    {
+      valid = false;
+    }
+    bits.push_back(high != inverted);
+  }
+  return bits;
+}
+
+/**
+ * send message and return received bits, checks buffer bound and end of transmission
+ */
+static std::vector<bool> transmit(const byte* message, size_t size)
+{
+  GuardedTransmitter guarded;
+  SYN115_Transmitter& radio = guarded.get();
+  radio.setManchesterEncoding(true, true); // inverted, as SolarDHT::setupRadio()
+  radio.setPacketHandling(false, true);    // LSB
+  radio.setBaudRate(1.4);
+  radio.setInterruptCallback([]{ pending |= SYN115_Transmitter::getActive()->getIntStatus(); });
+  radio.init();
+
+  // start-up one shot
+  pending = 0;
+  radio.turnOn();
+  check(digitalRead(POWER_PIN) == HIGH && (TCC1->CTRLA.reg & TCC_CTRLA_ENABLE), "power up and start-up timer", size);
+  TCC1->INTFLAG.reg.raise(TCC_INTFLAG_OVF);
+  SYN115_Transmitter::handleInterrupt();
+  check(pending == SYN115_Transmitter::INT_CHIPRDY, "INT_CHIPRDY", size);
+
+  pending = 0;
+  std::vector<bool> samples;
+  if (!radio.sendPacket(size, message))
+  {
+    check(false, "sendPacket", size);
+    return std::vector<bool>();
+  }
+  check(getHostPin(DATA_PIN).function == PIO_TIMER, "data pin on TCC1/WO[0]", size);
+
+  const byte* bufferStart;
+  bool offAtEnd;
+  play(samples, bufferStart, offAtEnd);
+  check(offAtEnd, "output off after last DMA beat", size);
+  check(pending == SYN115_Transmitter::INT_PKSENT, "INT_PKSENT", size);
+  check(getHostPin(DATA_PIN).function == PIO_OUTPUT && digitalRead(DATA_PIN) == LOW, "data pin low after transmission", size);
+  check(samples.size() == 16*size*SAMPLES_PER_HALF_BIT, "number of half bits", size);
+  check(guarded.isGuardIntact(bufferStart + SYN115_Transmitter::MAX_HALF_BITS*sizeof(uint16_t)), "buffer bound", size);
+  if (size == SYN115_Transmitter::MAX_PACKET_SIZE)
+  {
+    const DmacDescriptor& descriptor = ((const DmacDescriptor*)DMAC->BASEADDR.reg)[DirectMemoryAccess::CHANNEL_RADIO];
+    check(descriptor.SRCADDR.reg == (uintptr_t)(bufferStart + SYN115_Transmitter::MAX_HALF_BITS*sizeof(uint16_t)), "DMA ends at end of buffer", size);
+  }
+
+  bool valid;
+  std::vector<bool> bits = decodeManchester(samples, true, valid);
+  check(valid, "Manchester transitions", size);
+  radio.turnOff();
+  return bits;
+}
+
+static std::vector<byte> toBytes(const std::vector<bool>& bits)
+{
+  std::vector<byte> bytes(bits.size()/8);
+  for (size_t i=0; i<bits.size(); i++)
+  {
+    if (bits[i])
+    {
+      bytes[i/8] |= 1 << (i % 8); // LSB first
+    }
+  }
+  return bytes;
+}
+
+int main(int argc, char* argv[])
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "v")) != -1)
+  {
+    switch (opt)
+    {
+      case 'v': verbose = true; break;
+      default: fprintf(stderr, "usage: transmitter_test [-v]\n"); return 1;
+    }
+  }
+
+  // Oregon TH frames padded to max. packet size
+  OregonScientific oregon;
+  OregonScientificDecoder decoder;
+  decoder.setLsbFirst(true);
+  static const float TEMPERATURES[] = { -12.3f, 0, 21.5f, 59.9f };
+  for (byte i=0; i<4; i++)
+  {
+    byte message[SYN115_Transmitter::MAX_PACKET_SIZE] = {};
+    byte size = oregon.encodeTH(0xF824, i % 3 + 1, 0x40 + i, i == 3, TEMPERATURES[i], 20*i + 15);
+    memcpy(message, oregon.getMessage(), size);
+    OregonScientificDecoder::Frame frame;
+    bool decoded = decoder.decodeBits(transmit(message, sizeof(message)), frame);
+    check(decoded && frame.id == 0xF824 && frame.channel == i % 3 + 1 && frame.rollingCode == 0x40 + i && frame.lowBatt == (i == 3)
+          && fabsf(frame.temp - TEMPERATURES[i]) < 0.05f && frame.hum == 20*i + 15, "Oregon TH frame", sizeof(message));
+  }
+
+  // random messages, all sizes
+  std::mt19937 rng(4711);
+  for (size_t size=1; size<=SYN115_Transmitter::MAX_PACKET_SIZE; size++)
+  {
+    std::vector<byte> message(size);
+    for (byte& b : message)
+    {
+      b = rng();
+    }
+    check(toBytes(transmit(message.data(), size)) == message, "bit exact round trip", size);
+  }
+
+  // oversized packet
+  GuardedTransmitter guarded;
+  byte message[SYN115_Transmitter::MAX_PACKET_SIZE + 1] = {};
+  guarded.get().init();
+  check(!guarded.get().sendPacket(sizeof(message), message), "packet larger than MAX_PACKET_SIZE rejected", sizeof(message));
+
+  printf("%s, %u failed checks, buffer %u half bits\n", failures? "FAILED" : "passed", failures, SYN115_Transmitter::MAX_HALF_BITS);
+  return failures? 1 : 0;
+}
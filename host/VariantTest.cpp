@@ -0,0 +1,149 @@
+/*****************************************************************************
+ *
+ * Instantiate and Run All Deployment Variants on the Host Shims
+ *
+ * file:     VariantTest.cpp
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+/*
+ * host build:
+ *   g++ -std=c++11 -O2 -Wall -Wextra -Ishim -o variant_test VariantTest.cpp
+ *
+ * usage:
+ *   ./variant_test [-h hours]
+ *
+ * Instantiates SolarDHT<> for each entry of SOLARDHT_VARIANTS in one build
+ * and runs setup() and the following wakeups on the peripheral model of
+ * HostBoard.h for the given simulated time (default 2 h). Checks per variant:
+ * - the sketch is asleep at the end (no hanging ISR, no pending watchdog)
+ * - temperature and humidity of the sensor are those of HostClimate
+ * - the supply voltage matches the ADC input (blocking read or DMA sequence)
+ * - a SYN115 variant transmits packets, a display variant updates the display
+ *
+ * The SPI shim has no device attached, so the Si4432 variants run with
+ * radio init failed (like a board without radio module). RadioEmuTool.cpp
+ * runs the Si4432 path with the emulator attached.
+ *
+ * Exit code 1 if a check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "HostBoard.h"
+#include "../SolarDHT.hpp"
+
+static_assert(sizeof(SOLARDHT_VARIANTS)/sizeof(*SOLARDHT_VARIANTS) == 7, "instantiate new variants in main()");
+
+static const float SUPPLY_VOLTAGE = 3.0f; // [V]
+
+static uint32_t failures = 0;
+
+static void check(bool ok, const char* variant, const char* what)
+{
+  if (!ok)
+  {
+    failures++;
+    printf("FAILED %s: %s\n", variant, what);
+  }
+}
+
+template<const SolarDHTConfig& CONFIG>
+static void runVariant(uint64_t duration)
+{
+  typedef SolarDHT<CONFIG> Sketch;
+
+  HostBoard& board = HostBoard::instance();
+  board.reset();
+  uint32_t transmissions = board.getTransmissions();
+
+  Sketch& sketch = Sketch::instance();
+  HostBoard::unprotect(sketch.flash);
+  HostBoard::unprotect(sketch.historyFlash);
+
+  sketch.setup();
+  uint32_t calls = board.run(getHostTime() + duration);
+  transmissions = board.getTransmissions() - transmissions;
+
+  const HostClimate& climate = getHostClimate();
+  check(sketch.activeDepth == 0 && (!CONFIG.energyMeter || !sketch.awake), CONFIG.name, "asleep after run");
+  check(!sketch.timeout.getTimer().active, CONFIG.name, "watchdog cancelled");
+  if (CONFIG.hasSensor())
+  {
+    check(fabsf(sketch.temperature - climate.temperature) < 0.2f, CONFIG.name, "temperature");
+    check(fabsf(sketch.humidity - climate.humidity) < 1.0f, CONFIG.name, "humidity");
+  }
+  if (!CONFIG.radioMeasurement || !sketch.hasRadio)
+  {
+    check(fabsf(sketch.supplyVoltage - SUPPLY_VOLTAGE) < 0.05f, CONFIG.name, "supply voltage");
+  }
+  if (CONFIG.radio == SolarDHTConfig::RADIO_SYN115)
+  {
+    check(sketch.hasRadio && transmissions > 0, CONFIG.name, "SYN115 transmissions");
+  }
+  if (CONFIG.display)
+  {
+    check(sketch.displayUpdateCount > 0, CONFIG.name, "display updates");
+  }
+
+  printf("%-13s %6zu %8u %6.1f %5.1f %5.2f %-5s %6u\n", CONFIG.name, sizeof(Sketch), calls,
+         sketch.temperature, sketch.humidity, sketch.supplyVoltage, sketch.hasRadio? "yes" : "no", transmissions);
+}
+
+int main(int argc, char** argv)
+{
+  float hours = 2;
+  int opt;
+  while ((opt = getopt(argc, argv, "h:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'h':
+        hours = atof(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-h hours]\n", argv[0]);
+        return 2;
+    }
+  }
+  uint64_t duration = (uint64_t)(hours*3600e6);
+
+  Analog2DigitalConverter& adc = Analog2DigitalConverter::instance();
+  adc.setValue(ADC_INPUTCTRL_MUXPOS_SCALEDIOVCC_Val, SUPPLY_VOLTAGE);
+  HostBoard::instance().install();
+
+  printf("variant       sizeof      ISR   T[°C] RH[%%]  V[V] radio   sent\n");
+  runVariant<VARIANT_DEFAULT>(duration);
+  runVariant<VARIANT_MINIMAL>(duration);
+  runVariant<VARIANT_TRANSMITTER>(duration);
+  runVariant<VARIANT_DISPLAY_ONLY>(duration);
+  runVariant<VARIANT_DOWNLINK>(duration);
+  runVariant<VARIANT_MULTI_ZONE>(duration);
+  runVariant<VARIANT_CODED>(duration);
+
+  printf("%s (%u failures)\n", failures? "FAILED" : "passed", failures);
+  return failures? 1 : 0;
+}
@@ -0,0 +1,90 @@
+#!/bin/sh
+#
+# Compare Flash and RAM Footprint of the SolarDHT Deployment Variants
+#
+# file:     footprint.sh
+# encoding: UTF-8
+# created:  18.10.2026
+#
+# Copyright (C) 2026 Jens B.
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# usage:
+#   ./footprint.sh [fqbn]        (default Seeeduino:samd:seeed_XIAO_m0)
+#   ./footprint.sh -H            host build, without arduino-cli
+#
+# Builds each variant of SOLARDHT_VARIANTS (SolarDHTConfig.h) with
+# arduino-cli using the build flags from config_tool and prints the section
+# sizes of the ELF file. Flash includes the reserved flash regions of the
+# flash log and the history. Requires arduino-cli with the board package and
+# the libraries listed in README.md. Set SIZE to the arm-none-eabi-size
+# binary if it is not on the path.
+#
+# The ramfunc column is the code placed in RAM with RAMFUNC (option
+# HAS_RAMFUNC), the script exits with 1 if a variant exceeds RAMFUNC_BUDGET
+# of SolarDHTConfig.h or if a variant fails to build.
+#
+# With -H all variants are instantiated in one -Os host build of
+# VariantTest.cpp (g++, shims of host/shim) and compared by the symbols of
+# each SolarDHT<> instantiation: code of the sketch class including the
+# inlined driver calls (shared driver code is not counted), size of the
+# object in RAM and reserved flash regions. The numbers are x86-64, only the
+# differences between the variants carry over to the target.
+
+FQBN=${1:-Seeeduino:samd:seeed_XIAO_m0}
+HOST=$(cd "$(dirname "$0")" && pwd)
+SKETCH=$(dirname "$HOST")
+BUILD=${BUILD:-/tmp/solardht-footprint}
+
+if [ "$1" = "-H" ]; then
+  g++ -std=c++11 -O2 -o "$BUILD-config_tool" "$HOST/ConfigTool.cpp" || exit 1
+  g++ -std=c++11 -Os -I"$HOST/shim" -o "$BUILD-variant_test" "$HOST/VariantTest.cpp" || exit 1
+  nm -C -S --radix=d "$BUILD-variant_test" > "$BUILD-variant_test.sym" || exit 1
+
+  printf "%-14s %8s %8s %8s\n" "variant" "code" "object" "reserved"
+  for variant in $("$BUILD-config_tool" -n); do
+    symbol="SolarDHT<VARIANT_$(echo "$variant" | tr 'a-z-' 'A-Z_')>::"
+    awk -v name="$variant" -v symbol="$symbol" '
+      index($0, symbol) != 0 && index($0, "guard variable") == 0 && !seen[$1]++ {
+        if ($3 ~ /^[Tt]$/) { code += $2 }
+        else if (index($0, "::instance()::sdht") && $3 ~ /^[BbDd]$/) { object += $2 }
+        else if (index($0, "Region(") && index($0, ")::region")) { reserved += $2 }
+      }
+      END { printf "%-14s %8d %8d %8d\n", name, code, object, reserved }' "$BUILD-variant_test.sym"
+  done
+  exit 0
+fi
+SIZE=${SIZE:-$(command -v arm-none-eabi-size || find "$HOME/.arduino15" -name arm-none-eabi-size -type f 2>/dev/null | head -1)}
+
+if [ -z "$SIZE" ]; then
+  echo "arm-none-eabi-size not found, set SIZE" >&2
+  exit 1
+fi
+NM=${NM:-${SIZE%size}nm}
+BUDGET=$(sed -n 's/^#define RAMFUNC_BUDGET *\([0-9]*\).*/\1/p' "$SKETCH/SolarDHTConfig.h")
+STATUS=0
+
+g++ -std=c++11 -O2 -o "$BUILD-config_tool" "$HOST/ConfigTool.cpp" || exit 1
+
+printf "%-14s %8s %8s %8s %8s %8s %8s\n" "variant" "text" "data" "bss" "flash" "RAM" "ramfunc"
+for variant in $("$BUILD-config_tool" -n); do
+  # placeholder key, HAS_DOWNLINK requires DOWNLINK_KEY as build flag
+  flags="$("$BUILD-config_tool" -f "$variant") -DDOWNLINK_KEY=${DOWNLINK_KEY:-0,0,0,0}"
+  if ! arduino-cli compile --fqbn "$FQBN" --build-path "$BUILD/$variant" \
+       --build-property "compiler.cpp.extra_flags=$flags" "$SKETCH" > "$BUILD-$variant.log" 2>&1; then
+    echo "$variant: build failed, see $BUILD-$variant.log" >&2
+    STATUS=1
+    continue
+  fi
+  # code symbols in RAM (SRAM starts at 0x20000000)
+  ramfunc=$("$NM" -S --radix=d "$BUILD/$variant/SolarDHT.ino.elf" | \
+    awk '$4 != "" && $3 ~ /^[TtWw]$/ && $1 + 0 >= 536870912 { sum += $2 } END { print sum + 0 }')
+  "$SIZE" "$BUILD/$variant/SolarDHT.ino.elf" | awk -v name="$variant" -v ramfunc="$ramfunc" \
+    'NR == 2 { printf "%-14s %8d %8d %8d %8d %8d %8d\n", name, $1, $2, $3, $1 + $2, $2 + $3, ramfunc }'
+  if [ "$ramfunc" -gt "$BUDGET" ]; then
+    echo "$variant: RAMFUNC code $ramfunc bytes exceeds RAMFUNC_BUDGET $BUDGET" >&2
+    STATUS=1
+  fi
+done
+exit $STATUS
@@ -0,0 +1,129 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the SAMD21LPE ADC Header
+ *
+ * file:     Analog2DigitalConverter.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+namespace SAMD21LPE
+{
+
+/**
+ * subset of SAMD21LPE::Analog2DigitalConverter, read() returns the value
+ * of the input set by the host test: [V] for supply voltage and pins, [°C]
+ * for the temperature sensor
+ */
+class Analog2DigitalConverter
+{
+public:
+  enum Prescaler
+  {
+    DIV4, DIV8, DIV16, DIV32, DIV64, DIV128, DIV256, DIV512
+  };
+
+  static const byte INPUTS = 0x20;
+
+private:
+  Analog2DigitalConverter()
+  {
+    for (byte i=0; i<INPUTS; i++)
+    {
+      values[i] = 0.8f;
+    }
+    values[ADC_INPUTCTRL_MUXPOS_TEMP_Val] = 21.0f;
+    values[ADC_INPUTCTRL_MUXPOS_SCALEDIOVCC_Val] = 3.0f;
+  }
+
+public:
+  static Analog2DigitalConverter& instance()
+  {
+    static Analog2DigitalConverter adc;
+    return adc;
+  }
+
+public:
+  void enable(byte clockGen, uint32_t frequency, Prescaler prescaler)
+  {
+    (void)clockGen;
+    (void)frequency;
+    (void)prescaler;
+    enabled = true;
+  }
+
+  void setSampling(byte sampleLength, byte averaging)
+  {
+    (void)sampleLength;
+    (void)averaging;
+  }
+
+  void disable()
+  {
+    enabled = false;
+  }
+
+  /**
+   * single conversion with temporary enable
+   */
+  float read(uint32_t input)
+  {
+    delayMicroseconds(200);
+    conversions++;
+    return values[input % INPUTS];
+  }
+
+  /**
+   * host: value returned by read()
+   */
+  void setValue(uint32_t input, float value)
+  {
+    values[input % INPUTS] = value;
+  }
+
+  /**
+   * host: value returned by read(), used by the peripheral model for DMA sequences
+   */
+  float getValue(uint32_t input) const
+  {
+    return values[input % INPUTS];
+  }
+
+  /**
+   * host: number of read() calls
+   */
+  uint32_t getConversions() const
+  {
+    return conversions;
+  }
+
+private:
+  bool enabled = false;
+  uint32_t conversions = 0;
+  float values[INPUTS];
+};
+
+}
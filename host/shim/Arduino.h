@@ -0,0 +1,559 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the Arduino Core Header
+ *
+ * file:     Arduino.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+/**
+ * replaces <Arduino.h> of the SAMD core for host tests of the hardware
+ * headers of the sketch (e.g. SYN115_Transmitter.hpp), build with -Ishim
+ *
+ * Pin functions record the pin state, the NVIC functions record enable,
+ * priority and pending state per IRQ. Interrupts are never executed
+ * asynchronously, the host test calls the handlers.
+ *
+ * Time is simulated in µs: each call of micros(), millis() or
+ * NVIC_GetPendingIRQ() advances it by 1 µs so that polling loops terminate,
+ * delay() advances it by the delay.
+ * The host model callback is called whenever time advances and when the
+ * sketch polls a pin or a pending IRQ, so the host test can model
+ * peripherals (e.g. complete a DMA transfer or pull an interrupt pin).
+ * Timers of the peripheral shims (RealTimeClock.h, TimerCounter.h) are
+ * collected as HostTimer and fired by the event loop of the host test.
+ */
+
+#include <algorithm>
+#include <stdio.h>
+
+#include "../ArduinoHost.h"
+#include "SAMD21Registers.h"
+
+using std::min;
+using std::max;
+
+#define LOW            0x0
+#define HIGH           0x1
+
+#define INPUT          0x0
+#define OUTPUT         0x1
+#define INPUT_PULLUP   0x2
+#define INPUT_PULLDOWN 0x3
+
+#define CHANGE         0x2
+#define FALLING        0x3
+#define RISING         0x4
+
+#define DEC 10
+#define HEX 16
+
+#ifndef F_CPU
+  #define F_CPU 48000000L
+#endif
+
+typedef enum _EPioType
+{
+  PIO_NOT_A_PIN = -1,
+  PIO_EXTINT = 0,
+  PIO_ANALOG,
+  PIO_SERCOM,
+  PIO_SERCOM_ALT,
+  PIO_TIMER,
+  PIO_TIMER_ALT,
+  PIO_COM,
+  PIO_AC_CLK,
+  PIO_DIGITAL,
+  PIO_INPUT,
+  PIO_INPUT_PULLUP,
+  PIO_OUTPUT
+} EPioType;
+
+// ---- host time and model -------------------------------------------------
+
+typedef void (*HostCallback)();
+
+/**
+ * [µs] simulated time since start
+ */
+inline uint64_t& getHostTime()
+{
+  static uint64_t time = 0;
+  return time;
+}
+
+/**
+ * peripheral model of the host test, may be null
+ */
+inline HostCallback& getHostModel()
+{
+  static HostCallback model = nullptr;
+  return model;
+}
+
+inline void runHostModel()
+{
+  if (getHostModel())
+  {
+    getHostModel()();
+  }
+}
+
+inline void advanceHostTime(uint64_t us)
+{
+  getHostTime() += us;
+  runHostModel();
+}
+
+inline unsigned long micros()
+{
+  advanceHostTime(1);
+  return getHostTime();
+}
+
+inline unsigned long millis()
+{
+  return micros()/1000;
+}
+
+inline void delay(unsigned long ms)
+{
+  advanceHostTime(ms*1000ULL);
+}
+
+inline void delayMicroseconds(unsigned int us)
+{
+  advanceHostTime(us);
+}
+
+/**
+ * one shot or periodic timer of a peripheral shim
+ */
+struct HostTimer
+{
+  static const byte MAX_TIMERS = 32;
+
+  uint64_t deadline = 0; // [µs] host time
+  uint64_t period = 0;   // [µs], 0 = one shot
+  HostCallback callback = nullptr;
+  bool active = false;
+
+  HostTimer()
+  {
+    if (getCount() < MAX_TIMERS)
+    {
+      getTimers()[getCount()++] = this;
+    }
+  }
+
+  HostTimer(const HostTimer&) = delete;
+
+  void start(uint64_t us, bool repeat, HostCallback callback)
+  {
+    deadline = getHostTime() + us;
+    period = repeat? us : 0;
+    this->callback = callback;
+    active = true;
+  }
+
+  void cancel()
+  {
+    active = false;
+  }
+
+  /**
+   * @return active timer with the earliest deadline, null if none
+   */
+  static HostTimer* getNext()
+  {
+    HostTimer* next = nullptr;
+    for (byte i=0; i<getCount(); i++)
+    {
+      HostTimer* timer = getTimers()[i];
+      if (timer->active && (!next || timer->deadline < next->deadline))
+      {
+        next = timer;
+      }
+    }
+    return next;
+  }
+
+  /**
+   * advance time to the earliest deadline and call its callback like the ISR
+   *
+   * @return false if no timer is active
+   */
+  static bool fireNext()
+  {
+    HostTimer* timer = getNext();
+    if (!timer)
+    {
+      return false;
+    }
+    if (timer->deadline > getHostTime())
+    {
+      advanceHostTime(timer->deadline - getHostTime());
+    }
+    if (timer->period)
+    {
+      timer->deadline += timer->period;
+    }
+    else
+    {
+      timer->active = false;
+    }
+    if (timer->callback)
+    {
+      timer->callback();
+    }
+    return true;
+  }
+
+  static void cancelAll()
+  {
+    for (byte i=0; i<getCount(); i++)
+    {
+      getTimers()[i]->active = false;
+    }
+  }
+
+  static HostTimer** getTimers()
+  {
+    static HostTimer* timers[MAX_TIMERS];
+    return timers;
+  }
+
+  static byte& getCount()
+  {
+    static byte count = 0;
+    return count;
+  }
+};
+
+// ---- pins -----------------------------------------------------------------
+
+#define PIN_LED      13
+#define PIN_LED2     11
+#define PIN_LED3     12
+#define PIN_SPI_MISO 9
+
+struct HostPin
+{
+  uint32_t mode;
+  uint32_t level;
+  EPioType function;
+  HostCallback interrupt;
+  uint32_t interruptMode;
+};
+
+/**
+ * subset of the pin description of the variant, port 0 and pin number = Arduino pin
+ */
+struct PinDescription
+{
+  uint32_t ulPort;
+  uint32_t ulPin;
+  uint32_t ulADCChannelNumber;
+};
+
+static const byte HOST_PINS = 32;
+
+inline HostPin& getHostPin(uint32_t pin)
+{
+  static HostPin pins[HOST_PINS];
+  return pins[pin % HOST_PINS];
+}
+
+inline void pinMode(uint32_t pin, uint32_t mode)
+{
+  HostPin& p = getHostPin(pin);
+  p.mode = mode;
+  p.function = mode == OUTPUT? PIO_OUTPUT : PIO_INPUT;
+}
+
+inline void digitalWrite(uint32_t pin, uint32_t level)
+{
+  getHostPin(pin).level = level;
+}
+
+inline int digitalRead(uint32_t pin)
+{
+  runHostModel();
+  return getHostPin(pin).level;
+}
+
+inline void attachInterrupt(uint32_t pin, HostCallback callback, uint32_t mode)
+{
+  HostPin& p = getHostPin(pin);
+  p.interrupt = callback;
+  p.interruptMode = mode;
+}
+
+inline void detachInterrupt(uint32_t pin)
+{
+  getHostPin(pin).interrupt = nullptr;
+}
+
+struct HostPinDescriptions
+{
+  PinDescription pins[HOST_PINS];
+
+  HostPinDescriptions()
+  {
+    for (byte i=0; i<HOST_PINS; i++)
+    {
+      pins[i].ulPort = 0;
+      pins[i].ulPin = i;
+      pins[i].ulADCChannelNumber = i;
+    }
+  }
+
+  const PinDescription& operator[](uint32_t pin) const
+  {
+    return pins[pin % HOST_PINS];
+  }
+};
+
+static const HostPinDescriptions g_APinDescription;
+
+// ---- interrupts -----------------------------------------------------------
+
+inline void noInterrupts()
+{
+}
+
+inline void interrupts()
+{
+}
+
+inline uint32_t __get_PRIMASK()
+{
+  return 0;
+}
+
+inline void __set_PRIMASK(uint32_t primask)
+{
+  (void)primask;
+}
+
+inline void __disable_irq()
+{
+}
+
+inline void __enable_irq()
+{
+}
+
+inline void __WFI()
+{
+}
+
+static uint32_t SystemCoreClock = F_CPU;
+
+struct HostNvic
+{
+  bool enabled[HOST_IRQS];
+  bool pending[HOST_IRQS];
+  uint32_t priority[HOST_IRQS];
+};
+
+inline HostNvic& getHostNvic()
+{
+  static HostNvic nvic;
+  return nvic;
+}
+
+inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+  getHostNvic().enabled[irq] = true;
+}
+
+inline void NVIC_DisableIRQ(IRQn_Type irq)
+{
+  getHostNvic().enabled[irq] = false;
+}
+
+inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+  getHostNvic().priority[irq] = priority;
+}
+
+inline uint32_t NVIC_GetPendingIRQ(IRQn_Type irq)
+{
+  advanceHostTime(1);
+  return getHostNvic().pending[irq];
+}
+
+inline void NVIC_SetPendingIRQ(IRQn_Type irq)
+{
+  getHostNvic().pending[irq] = true;
+}
+
+inline void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+  getHostNvic().pending[irq] = false;
+}
+
+// ---- SERCOM ---------------------------------------------------------------
+
+#define GCM_EIC          0x05
+#define GCM_SERCOM0_CORE 0x14
+
+class SERCOM
+{
+public:
+  SERCOM(byte index) : index(index) {}
+
+public:
+  byte getSercomIndex() const
+  {
+    return index;
+  }
+
+private:
+  byte index;
+};
+
+static SERCOM sercom0(0);
+static SERCOM sercom2(2);
+
+#define PERIPH_SPI  sercom0
+#define PERIPH_WIRE sercom2
+
+// ---- serial ---------------------------------------------------------------
+
+class Print
+{
+public:
+  virtual ~Print() = default;
+
+public:
+  virtual size_t write(uint8_t c) = 0;
+
+  size_t print(const char* s)
+  {
+    size_t n = 0;
+    while (*s)
+    {
+      n += write(*s++);
+    }
+    return n;
+  }
+
+  size_t print(char c)
+  {
+    return write(c);
+  }
+
+  size_t print(unsigned char value, int base = DEC)
+  {
+    return print((unsigned long)value, base);
+  }
+
+  size_t print(int value, int base = DEC)
+  {
+    return print((long)value, base);
+  }
+
+  size_t print(unsigned int value, int base = DEC)
+  {
+    return print((unsigned long)value, base);
+  }
+
+  size_t print(long value, int base = DEC)
+  {
+    if (value < 0 && base == DEC)
+    {
+      return write('-') + print((unsigned long)-value, base);
+    }
+    return print((unsigned long)value, base);
+  }
+
+  size_t print(unsigned long value, int base = DEC)
+  {
+    char text[24];
+    snprintf(text, sizeof(text), base == HEX? "%lX" : "%lu", value);
+    return print(text);
+  }
+
+  size_t print(double value, int digits = 2)
+  {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return print(text);
+  }
+
+  size_t println()
+  {
+    return write('\n');
+  }
+
+  template<typename T> size_t println(T value)
+  {
+    return print(value) + println();
+  }
+
+  template<typename T> size_t println(T value, int format)
+  {
+    return print(value, format) + println();
+  }
+};
+
+class Stream : public Print
+{
+};
+
+/**
+ * USB serial, writes to stdout
+ */
+class HostSerial : public Stream
+{
+public:
+  size_t write(uint8_t c) override
+  {
+    return fputc(c, stdout) == EOF? 0 : 1;
+  }
+
+  void begin(unsigned long baud)
+  {
+    (void)baud;
+  }
+
+  void end()
+  {
+  }
+
+  void flush()
+  {
+    fflush(stdout);
+  }
+
+  operator bool() const
+  {
+    return true;
+  }
+};
+
+static HostSerial Serial;
@@ -0,0 +1,188 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the GD_ePaper Library
+ *
+ * file:     GD_ePaper.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include "Arduino.h"
+
+/**
+ * font metadata of Adafruit GFX, the host fonts have no glyphs
+ */
+struct GFXfont
+{
+  const uint8_t* bitmap;
+  const void* glyph;
+  uint16_t first;
+  uint16_t last;
+  uint8_t yAdvance;
+  uint8_t xAdvance; // host: fixed advance per character
+};
+
+class GD_ePaper
+{
+public:
+  static const uint16_t COLOR_BLACK = 0x0000;
+  static const uint16_t COLOR_WHITE = 0xFFFF;
+};
+
+/**
+ * subset of the 1.02" e-paper display driver, records the printed text of
+ * the current screen and counts refreshes
+ */
+class GDEW0102T4 : public GD_ePaper
+{
+public:
+  static const uint16_t WIDTH = 128;
+  static const uint16_t HEIGHT = 80;
+  static const uint32_t TRANSFER_TIME = 25; // [ms] page image over SPI
+
+public:
+  GDEW0102T4(uint8_t cs, uint8_t dc, uint8_t rst, uint8_t busy)
+  {
+    (void)cs;
+    (void)dc;
+    (void)rst;
+    (void)busy;
+  }
+
+public:
+  void init()
+  {
+    sleeping = false;
+  }
+
+  void setRotation(uint8_t rotation)
+  {
+    this->rotation = rotation;
+  }
+
+  void setTextColor(uint16_t color)
+  {
+    (void)color;
+  }
+
+  void newScreen()
+  {
+    text.clear();
+  }
+
+  /**
+   * @param font null selects the built-in 6x8 font
+   */
+  void setFont(const GFXfont* font = nullptr)
+  {
+    this->font = font;
+  }
+
+  void getTextBounds(const char* s, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) const
+  {
+    *x1 = x;
+    *y1 = y;
+    *w = strlen(s)*(font? font->xAdvance : 6);
+    *h = font? font->yAdvance : 8;
+  }
+
+  void setCursor(int16_t x, int16_t y)
+  {
+    (void)x;
+    (void)y;
+    if (!text.empty())
+    {
+      text += ' ';
+    }
+  }
+
+  int16_t height() const
+  {
+    return rotation & 1? WIDTH : HEIGHT;
+  }
+
+  size_t print(const char* s)
+  {
+    text += s;
+    return strlen(s);
+  }
+
+  void setPartialRefresh(bool partial)
+  {
+    this->partial = partial;
+  }
+
+  /**
+   * transfer page image, refresh and power down
+   */
+  void updateScreen(bool reset)
+  {
+    (void)reset;
+    delay(TRANSFER_TIME);
+    refreshes++;
+    partialRefreshes += partial;
+    screen = text;
+    sleeping = true;
+  }
+
+  bool isSleeping() const
+  {
+    return sleeping;
+  }
+
+  void sleep()
+  {
+    sleeping = true;
+  }
+
+  /**
+   * host: text of the last refreshed screen, printed strings separated by spaces
+   */
+  const std::string& getScreen() const
+  {
+    return screen;
+  }
+
+  uint32_t getRefreshes() const
+  {
+    return refreshes;
+  }
+
+  uint32_t getPartialRefreshes() const
+  {
+    return partialRefreshes;
+  }
+
+private:
+  const GFXfont* font = nullptr;
+  uint8_t rotation = 0;
+  bool sleeping = true;
+  bool partial = false;
+  uint32_t refreshes = 0;
+  uint32_t partialRefreshes = 0;
+  std::string text;
+  std::string screen;
+};
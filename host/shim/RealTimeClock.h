@@ -0,0 +1,95 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the SAMD21LPE RTC Header
+ *
+ * file:     RealTimeClock.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+namespace SAMD21LPE
+{
+
+/**
+ * subset of SAMD21LPE::RealTimeClock, the counter follows the host time and
+ * the timer callback is fired by the event loop of the host test
+ */
+class RealTimeClock
+{
+private:
+  RealTimeClock() = default;
+
+public:
+  static RealTimeClock& instance()
+  {
+    static RealTimeClock rtc;
+    return rtc;
+  }
+
+public:
+  void enable(byte clockGen, uint32_t frequency, uint16_t prescaler)
+  {
+    (void)clockGen;
+    (void)frequency;
+    (void)prescaler;
+    origin = getHostTime();
+  }
+
+  /**
+   * @param ms duration until callback
+   */
+  void start(uint32_t ms, bool repeat, HostCallback callback)
+  {
+    timer.start(ms*1000ULL, repeat, callback);
+  }
+
+  void cancel()
+  {
+    timer.cancel();
+  }
+
+  /**
+   * @return [ms] since enable()
+   */
+  uint32_t getElapsed()
+  {
+    return (micros() - origin)/1000;
+  }
+
+  /**
+   * host: timer of start()
+   */
+  HostTimer& getTimer()
+  {
+    return timer;
+  }
+
+private:
+  uint64_t origin = 0; // [µs] host time of enable()
+  HostTimer timer;
+};
+
+}
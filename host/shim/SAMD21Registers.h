@@ -0,0 +1,570 @@
+/*****************************************************************************
+ *
+ * Host Register Model of the SAMD21 Peripherals
+ *
+ * file:     SAMD21Registers.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * subset of the CMSIS device definitions of the SAMD21 used by the hardware
+ * headers of the sketch, so that they can be compiled and run unchanged by
+ * host tests
+ *
+ * Registers are plain memory with the reset value 0. Self clearing bits
+ * (e.g. SWRST) are cleared on write, so reset and synchronization loops
+ * terminate. Interrupt flag registers are write-one-to-clear, the host test
+ * sets pending flags with raise(). Peripheral behaviour (counting, DMA
+ * transfers) is up to the test.
+ */
+
+template<typename T, T SELF_CLEARING = 0>
+struct HostRegister
+{
+  T value;
+
+  operator T() const
+  {
+    return value;
+  }
+
+  HostRegister& operator=(T v)
+  {
+    value = v & ~SELF_CLEARING;
+    return *this;
+  }
+
+  template<typename V> HostRegister& operator|=(V v)
+  {
+    return *this = (T)(value | v);
+  }
+
+  template<typename V> HostRegister& operator&=(V v)
+  {
+    return *this = (T)(value & v);
+  }
+};
+
+template<typename T>
+struct HostFlagRegister
+{
+  T value;
+
+  operator T() const
+  {
+    return value;
+  }
+
+  /**
+   * write one to clear
+   */
+  HostFlagRegister& operator=(T v)
+  {
+    value &= ~v;
+    return *this;
+  }
+
+  void raise(T flags)
+  {
+    value |= flags;
+  }
+};
+
+template<typename T>
+struct HostReg
+{
+  T reg;
+};
+
+/**
+ * register with bit field access
+ */
+template<typename T, typename BITS>
+struct HostBitReg
+{
+  union
+  {
+    T reg;
+    BITS bit;
+  };
+};
+
+inline uint64_t& getHostTime();
+
+// ---- IRQ numbers ----------------------------------------------------------
+
+enum IRQn_Type
+{
+  PM_IRQn      = 0,
+  SYSCTRL_IRQn = 1,
+  WDT_IRQn     = 2,
+  RTC_IRQn     = 3,
+  EIC_IRQn     = 4,
+  NVMCTRL_IRQn = 5,
+  DMAC_IRQn    = 6,
+  USB_IRQn     = 7,
+  EVSYS_IRQn   = 8,
+  SERCOM0_IRQn = 9,
+  TCC0_IRQn    = 15,
+  TCC1_IRQn    = 16,
+  TCC2_IRQn    = 17,
+  TC3_IRQn     = 18,
+  TC4_IRQn     = 19,
+  TC5_IRQn     = 20,
+  ADC_IRQn     = 23,
+  HOST_IRQS    = 32
+};
+
+// ---- PM -------------------------------------------------------------------
+
+#define PM_AHBMASK_DMAC       (1ul << 5)
+#define PM_APBBMASK_DMAC      (1ul << 4)
+#define PM_APBCMASK_TCC0      (1ul << 8)
+#define PM_APBCMASK_TCC1      (1ul << 9)
+#define PM_APBCMASK_TCC2      (1ul << 10)
+#define PM_APBCMASK_ADC       (1ul << 16)
+
+struct Pm
+{
+  HostReg<uint32_t> AHBMASK;
+  HostReg<uint32_t> APBAMASK;
+  HostReg<uint32_t> APBBMASK;
+  HostReg<uint32_t> APBCMASK;
+};
+
+// ---- SYSCTRL --------------------------------------------------------------
+
+#define SYSCTRL_VREF_TSEN           (1ul << 1)
+
+struct SysctrlOsc8mBits
+{
+  uint32_t :1;
+  uint32_t ENABLE:1;
+  uint32_t :4;
+  uint32_t RUNSTDBY:1;
+  uint32_t ONDEMAND:1;
+  uint32_t PRESC:2;
+  uint32_t :22;
+};
+
+struct Sysctrl
+{
+  HostBitReg<uint32_t, SysctrlOsc8mBits> OSC8M;
+  HostReg<uint32_t> VREF;
+};
+
+// ---- GCLK -----------------------------------------------------------------
+
+#define GCLK_CLKCTRL_GEN_GCLK0_Val        0x0ul
+#define GCLK_CLKCTRL_ID_TCC0_TCC1_Val     0x1Aul
+#define GCLK_GENDIV_ID(value)             ((uint32_t)(value) & 0xFul)
+#define GCLK_GENDIV_DIV(value)            ((uint32_t)(value) << 8)
+#define GCLK_GENCTRL_ID(value)            ((uint32_t)(value) & 0xFul)
+#define GCLK_GENCTRL_SRC_OSCULP32K        (0x3ul << 8)
+#define GCLK_GENCTRL_SRC_OSC8M            (0x6ul << 8)
+#define GCLK_GENCTRL_SRC_DFLL48M          (0x7ul << 8)
+#define GCLK_GENCTRL_GENEN                (1ul << 16)
+#define GCLK_GENCTRL_IDC                  (1ul << 17)
+
+struct GclkStatusBits
+{
+  uint8_t :7;
+  uint8_t SYNCBUSY:1;
+};
+
+struct Gclk
+{
+  HostReg<uint8_t> CTRL;
+  HostBitReg<uint8_t, GclkStatusBits> STATUS;
+  HostReg<uint16_t> CLKCTRL;
+  HostReg<uint32_t> GENCTRL;
+  HostReg<uint32_t> GENDIV;
+};
+
+// ---- SERCOM ---------------------------------------------------------------
+
+struct SercomCtrlaBits
+{
+  uint32_t SWRST:1;
+  uint32_t ENABLE:1;
+  uint32_t :30;
+};
+
+struct SercomSyncbusyBits
+{
+  uint32_t SWRST:1;
+  uint32_t ENABLE:1;
+  uint32_t SYSOP:1;
+  uint32_t :29;
+};
+
+struct SercomI2cmBaudBits
+{
+  uint32_t BAUD:8;
+  uint32_t BAUDLOW:8;
+  uint32_t HSBAUD:8;
+  uint32_t HSBAUDLOW:8;
+};
+
+struct SercomI2cmStatusBits
+{
+  uint16_t :4;
+  uint16_t BUSSTATE:2;
+  uint16_t :10;
+};
+
+struct SercomI2cm
+{
+  HostBitReg<uint32_t, SercomCtrlaBits> CTRLA;
+  HostReg<uint32_t> CTRLB;
+  HostBitReg<uint32_t, SercomI2cmBaudBits> BAUD;
+  HostBitReg<uint16_t, SercomI2cmStatusBits> STATUS;
+  HostBitReg<uint32_t, SercomSyncbusyBits> SYNCBUSY;
+};
+
+struct SercomSpi
+{
+  HostBitReg<uint32_t, SercomCtrlaBits> CTRLA;
+  HostReg<uint32_t> CTRLB;
+  HostReg<uint8_t> BAUD;
+  HostBitReg<uint32_t, SercomSyncbusyBits> SYNCBUSY;
+};
+
+union Sercom
+{
+  SercomI2cm I2CM;
+  SercomSpi SPI;
+};
+
+// ---- ADC ------------------------------------------------------------------
+
+#define ADC_CTRLA_SWRST                     (1u << 0)
+#define ADC_CTRLA_ENABLE                    (1u << 1)
+#define ADC_REFCTRL_REFSEL_INT1V            (0x0u << 0)
+#define ADC_AVGCTRL_SAMPLENUM_1             (0x0u << 0)
+#define ADC_AVGCTRL_ADJRES(value)           ((uint8_t)((value) << 4))
+#define ADC_SAMPCTRL_SAMPLEN(value)         ((uint8_t)((value) & 0x3F))
+#define ADC_CTRLB_FREERUN                   (1u << 2)
+#define ADC_CTRLB_RESSEL_12BIT              (0x0u << 4)
+#define ADC_CTRLB_PRESCALER(value)          ((uint16_t)((value) << 8))
+#define ADC_SWTRIG_START                    (1u << 1)
+#define ADC_INPUTCTRL_MUXPOS(value)         ((uint32_t)(value) & 0x1Ful)
+#define ADC_INPUTCTRL_MUXPOS_TEMP_Val       0x18ul
+#define ADC_INPUTCTRL_MUXPOS_BANDGAP_Val    0x19ul
+#define ADC_INPUTCTRL_MUXPOS_SCALEDCOREVCC_Val 0x1Aul
+#define ADC_INPUTCTRL_MUXPOS_SCALEDIOVCC_Val   0x1Bul
+#define ADC_INPUTCTRL_MUXNEG_GND            (0x18ul << 8)
+#define ADC_INPUTCTRL_INPUTSCAN(value)      ((uint32_t)(value) << 16)
+#define ADC_INPUTCTRL_GAIN_1X               (0x0ul << 24)
+#define ADC_INTFLAG_MASK                    0x0Fu
+
+struct AdcStatusBits
+{
+  uint8_t :7;
+  uint8_t SYNCBUSY:1;
+};
+
+struct Adc
+{
+  HostReg<HostRegister<uint8_t, ADC_CTRLA_SWRST>> CTRLA;
+  HostReg<uint8_t> REFCTRL;
+  HostReg<uint8_t> AVGCTRL;
+  HostReg<uint8_t> SAMPCTRL;
+  HostReg<uint16_t> CTRLB;
+  HostReg<uint8_t> SWTRIG;
+  HostReg<uint32_t> INPUTCTRL;
+  HostReg<HostFlagRegister<uint8_t>> INTFLAG;
+  HostBitReg<uint8_t, AdcStatusBits> STATUS;
+  HostReg<uint16_t> RESULT;
+};
+
+// ---- PORT -----------------------------------------------------------------
+
+#define PORT_PINCFG_PULLEN          (1u << 2)
+
+struct PortGroup
+{
+  HostReg<uint32_t> DIR;
+  HostReg<uint32_t> OUT;
+  HostReg<uint32_t> IN;
+  HostReg<uint8_t> PMUX[16];
+  HostReg<uint8_t> PINCFG[32];
+};
+
+struct Port
+{
+  PortGroup Group[2];
+};
+
+// ---- NVMCTRL --------------------------------------------------------------
+
+#define NVMCTRL_CTRLA_CMD_ER        0x02u
+#define NVMCTRL_CTRLA_CMD_WP        0x04u
+#define NVMCTRL_CTRLA_CMD_PBC       0x44u
+#define NVMCTRL_CTRLA_CMDEX_KEY     (0xA5u << 8)
+#define NVMCTRL_STATUS_PRM          (1u << 0)
+#define NVMCTRL_STATUS_LOAD         (1u << 1)
+#define NVMCTRL_STATUS_PROGE        (1u << 2)
+#define NVMCTRL_STATUS_LOCKE        (1u << 3)
+#define NVMCTRL_STATUS_NVME         (1u << 4)
+#define NVMCTRL_STATUS_MASK         0x011Fu
+
+#define NVMCTRL_CTRLB_SLEEPPRM_WAKEONACCESS_Val  0x0u
+#define NVMCTRL_CTRLB_SLEEPPRM_WAKEUPINSTANT_Val 0x1u
+#define NVMCTRL_CTRLB_SLEEPPRM_DISABLED_Val      0x3u
+
+static const uint16_t HOST_NVM_ROW_SIZE = 256; // [bytes]
+
+struct NvmctrlCtrlbBits
+{
+  uint32_t :1;
+  uint32_t RWS:4;
+  uint32_t :2;
+  uint32_t MANW:1;
+  uint32_t SLEEPPRM:2;
+  uint32_t :6;
+  uint32_t READMODE:2;
+  uint32_t CACHEDIS:1;
+  uint32_t :13;
+};
+
+struct NvmctrlIntflagBits
+{
+  uint8_t READY:1;
+  uint8_t ERROR:1;
+  uint8_t :6;
+};
+
+/**
+ * CTRLA executes the command on write: row erase sets the row at ADDR
+ * (host address/2) to 0xFF, page buffer clear and page write do nothing,
+ * the page buffer is the flash content written directly by the sketch
+ */
+struct HostNvmCommand
+{
+  uint16_t value;
+
+  operator uint16_t() const
+  {
+    return value;
+  }
+
+  HostNvmCommand& operator=(uint32_t v);
+};
+
+struct Nvmctrl
+{
+  HostReg<HostNvmCommand> CTRLA;
+  HostBitReg<uint32_t, NvmctrlCtrlbBits> CTRLB;
+  HostBitReg<uint8_t, NvmctrlIntflagBits> INTFLAG;
+  HostReg<HostFlagRegister<uint16_t>> STATUS;
+  HostReg<uintptr_t> ADDR;
+
+  Nvmctrl()
+  {
+    INTFLAG.bit.READY = 1;
+  }
+};
+
+/**
+ * temperature log row of the NVM software calibration area: 25.0 °C and
+ * 85.0 °C, INT1V 1.000 V, ADC 2730 and 3321
+ */
+inline const volatile uint32_t* getHostTemperatureLog()
+{
+  static const uint32_t log[2] = { 25 | (85ul << 12), (2730ul << 8) | (3321ul << 20) };
+  return log;
+}
+
+#define NVMCTRL_TEMP_LOG ((uintptr_t)getHostTemperatureLog())
+
+// ---- SCB and SysTick ------------------------------------------------------
+
+struct Scb
+{
+  uint32_t VTOR;
+};
+
+/**
+ * current value of SysTick counting down from LOAD once per ms of host time
+ */
+struct HostSysTickValue
+{
+  operator uint32_t() const;
+
+  HostSysTickValue& operator=(uint32_t v)
+  {
+    (void)v; // write clears, counter follows host time
+    return *this;
+  }
+};
+
+struct SysTickType
+{
+  uint32_t CTRL;
+  uint32_t LOAD = 48000 - 1;
+  HostSysTickValue VAL;
+};
+
+// ---- TCC ------------------------------------------------------------------
+
+#define TCC_CTRLA_SWRST             (1ul << 0)
+#define TCC_CTRLA_ENABLE            (1ul << 1)
+#define TCC_CTRLA_PRESCALER_DIV1    (0x0ul << 8)
+#define TCC_CTRLA_RUNSTDBY          (1ul << 11)
+#define TCC_CTRLBSET_ONESHOT        (1ul << 3)
+#define TCC_WAVE_WAVEGEN_NFRQ       (0x0ul << 0)
+#define TCC_WAVE_WAVEGEN_NPWM       (0x2ul << 0)
+#define TCC_WAVE_WAVEGEN_Msk        (0x7ul << 0)
+#define TCC_PER_PER(value)          ((uint32_t)(value) & 0xFFFFFFul)
+#define TCC_SYNCBUSY_SWRST          (1ul << 0)
+#define TCC_INTENSET_OVF            (1ul << 0)
+#define TCC_INTFLAG_OVF             (1ul << 0)
+#define TCC_INTFLAG_MASK            0x000F3C0Ful
+
+#define TCC1_DMAC_ID_OVF            18
+
+struct Tcc
+{
+  HostReg<HostRegister<uint32_t, TCC_CTRLA_SWRST>> CTRLA;
+  HostReg<uint8_t> CTRLBCLR;
+  HostReg<uint8_t> CTRLBSET;
+  HostReg<uint32_t> SYNCBUSY;
+  HostReg<uint32_t> INTENCLR;
+  HostReg<uint32_t> INTENSET;
+  HostReg<HostFlagRegister<uint32_t>> INTFLAG;
+  HostReg<uint32_t> COUNT;
+  HostReg<uint32_t> WAVE;
+  HostReg<uint32_t> PER;
+  HostReg<uint32_t> CC[4];
+  HostReg<uint32_t> PERB;
+  HostReg<uint32_t> CCB[4];
+};
+
+// ---- DMAC -----------------------------------------------------------------
+
+#define DMAC_CTRL_SWRST             (1u << 0)
+#define DMAC_CTRL_DMAENABLE         (1u << 1)
+#define DMAC_CTRL_LVLEN(value)      ((uint16_t)((value) << 8))
+#define DMAC_CHID_ID(value)         ((uint8_t)(value))
+#define DMAC_CHCTRLA_SWRST          (1u << 0)
+#define DMAC_CHCTRLA_ENABLE         (1u << 1)
+#define DMAC_CHCTRLA_RUNSTDBY       (1u << 6)
+#define DMAC_CHCTRLB_TRIGSRC(value) ((uint32_t)(value) << 8)
+#define DMAC_CHCTRLB_TRIGACT_BEAT   (0x2ul << 22)
+#define DMAC_CHINTENSET_TERR        (1u << 0)
+#define DMAC_CHINTENSET_TCMPL       (1u << 1)
+#define DMAC_CHINTFLAG_TERR         (1u << 0)
+#define DMAC_CHINTFLAG_TCMPL        (1u << 1)
+#define DMAC_CHINTFLAG_MASK         0x07u
+#define DMAC_BTCTRL_VALID           (1u << 0)
+#define DMAC_BTCTRL_BLOCKACT_INT    (0x1u << 3)
+#define DMAC_BTCTRL_BEATSIZE_Pos    8
+#define DMAC_BTCTRL_BEATSIZE_Msk    (0x3u << DMAC_BTCTRL_BEATSIZE_Pos)
+#define DMAC_BTCTRL_BEATSIZE_BYTE   (0x0u << DMAC_BTCTRL_BEATSIZE_Pos)
+#define DMAC_BTCTRL_BEATSIZE_HWORD  (0x1u << DMAC_BTCTRL_BEATSIZE_Pos)
+#define DMAC_BTCTRL_BEATSIZE_WORD   (0x2u << DMAC_BTCTRL_BEATSIZE_Pos)
+#define DMAC_BTCTRL_SRCINC          (1u << 10)
+#define DMAC_BTCTRL_DSTINC          (1u << 11)
+
+#define ADC_DMAC_ID_RESRDY          39
+
+/**
+ * the address registers hold host pointers (uintptr_t)
+ */
+struct DmacDescriptor
+{
+  HostReg<uint16_t> BTCTRL;
+  HostReg<uint16_t> BTCNT;
+  HostReg<uintptr_t> SRCADDR;
+  HostReg<uintptr_t> DSTADDR;
+  HostReg<uintptr_t> DESCADDR;
+};
+
+/**
+ * channel registers (CHCTRLA .. CHINTFLAG) of the channel selected by CHID
+ * are a single set, the last selected channel
+ */
+struct Dmac
+{
+  HostReg<HostRegister<uint16_t, DMAC_CTRL_SWRST>> CTRL;
+  HostReg<uintptr_t> BASEADDR;
+  HostReg<uintptr_t> WRBADDR;
+  HostReg<uint32_t> INTSTATUS;
+  HostReg<uint8_t> CHID;
+  HostReg<HostRegister<uint8_t, DMAC_CHCTRLA_SWRST>> CHCTRLA;
+  HostReg<uint32_t> CHCTRLB;
+  HostReg<uint8_t> CHINTENCLR;
+  HostReg<uint8_t> CHINTENSET;
+  HostReg<HostFlagRegister<uint8_t>> CHINTFLAG;
+};
+
+// ---- instances ------------------------------------------------------------
+
+template<class Peripheral, int INSTANCE = 0>
+Peripheral* getHostPeripheral()
+{
+  static Peripheral peripheral;
+  return &peripheral;
+}
+
+#define PM      getHostPeripheral<Pm>()
+#define SYSCTRL getHostPeripheral<Sysctrl>()
+#define GCLK    getHostPeripheral<Gclk>()
+#define TCC1    getHostPeripheral<Tcc, 1>()
+#define DMAC    getHostPeripheral<Dmac>()
+#define ADC     getHostPeripheral<Adc>()
+#define PORT    getHostPeripheral<Port>()
+#define NVMCTRL getHostPeripheral<Nvmctrl>()
+#define SCB     getHostPeripheral<Scb>()
+#define SysTick getHostPeripheral<SysTickType>()
+#define SERCOM0 getHostPeripheral<Sercom, 0>()
+#define SERCOM1 getHostPeripheral<Sercom, 1>()
+#define SERCOM2 getHostPeripheral<Sercom, 2>()
+#define SERCOM3 getHostPeripheral<Sercom, 3>()
+#define SERCOM4 getHostPeripheral<Sercom, 4>()
+#define SERCOM5 getHostPeripheral<Sercom, 5>()
+
+#define SERCOM_INSTS { SERCOM0, SERCOM1, SERCOM2, SERCOM3, SERCOM4, SERCOM5 }
+
+inline HostNvmCommand& HostNvmCommand::operator=(uint32_t v)
+{
+  value = v;
+  if ((v & 0xFF00u) == NVMCTRL_CTRLA_CMDEX_KEY && (v & 0x7Fu) == NVMCTRL_CTRLA_CMD_ER)
+  {
+    uintptr_t row = (NVMCTRL->ADDR.reg*2) & ~(uintptr_t)(HOST_NVM_ROW_SIZE - 1);
+    memset((void*)row, 0xFF, HOST_NVM_ROW_SIZE);
+  }
+  return *this;
+}
+
+inline HostSysTickValue::operator uint32_t() const
+{
+  uint32_t load = SysTick->LOAD;
+  return load - (uint32_t)((getHostTime() % 1000)*(load + 1)/1000);
+}
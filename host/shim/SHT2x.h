@@ -0,0 +1,189 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the SHT2x Library
+ *
+ * file:     SHT2x.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Wire.h"
+
+#define SHT2x_REQ_NONE        0x00
+#define SHT2x_REQ_TEMPERATURE 0x01
+#define SHT2x_REQ_HUMIDITY    0x02
+#define SHT2x_REQ_FAIL        0xFF
+
+/**
+ * subset of the Si7021 class of the SHT2x library, conversions complete
+ * after the conversion time of the resolution in host time and return the
+ * values of HostClimate
+ */
+class Si7021
+{
+public:
+  bool isConnected()
+  {
+    return Wire.isActive() && getHostClimate().connected;
+  }
+
+  bool reset()
+  {
+    requestType = SHT2x_REQ_NONE;
+    return isConnected();
+  }
+
+  /**
+   * @param res 0 = RH 12 bit/T 14 bit .. 3 = RH 11 bit/T 11 bit
+   */
+  void setResolution(uint8_t res)
+  {
+    resolution = res & 3;
+  }
+
+  bool heatOn()
+  {
+    return isConnected();
+  }
+
+  bool heatOff()
+  {
+    return isConnected();
+  }
+
+  bool batteryOK()
+  {
+    return true;
+  }
+
+  uint32_t getEIDA()
+  {
+    return 0x15A2B3C4;
+  }
+
+  uint32_t getEIDB()
+  {
+    return 0x1500D5E6;
+  }
+
+  bool requestTemperature()
+  {
+    return request(SHT2x_REQ_TEMPERATURE, TEMPERATURE_TIME[resolution]);
+  }
+
+  bool requestHumidity()
+  {
+    return request(SHT2x_REQ_HUMIDITY, HUMIDITY_TIME[resolution]);
+  }
+
+  bool requestReady()
+  {
+    return requestType != SHT2x_REQ_NONE && getHostTime() >= ready;
+  }
+
+  bool reqTempReady()
+  {
+    return requestType == SHT2x_REQ_TEMPERATURE && requestReady();
+  }
+
+  bool reqHumReady()
+  {
+    return requestType == SHT2x_REQ_HUMIDITY && requestReady();
+  }
+
+  uint8_t getRequestType() const
+  {
+    return requestType;
+  }
+
+  bool readTemperature()
+  {
+    if (!reqTempReady())
+    {
+      return false;
+    }
+    temperature = getHostClimate().temperature;
+    requestType = SHT2x_REQ_NONE;
+    return true;
+  }
+
+  bool readHumidity()
+  {
+    if (!reqHumReady())
+    {
+      return false;
+    }
+    humidity = getHostClimate().humidity;
+    temperature = getHostClimate().temperature;
+    requestType = SHT2x_REQ_NONE;
+    return true;
+  }
+
+  /**
+   * temperature of the last humidity conversion
+   */
+  bool readCachedTemperature()
+  {
+    if (!reqHumReady())
+    {
+      return false;
+    }
+    temperature = getHostClimate().temperature;
+    return true;
+  }
+
+  float getTemperature() const
+  {
+    return temperature;
+  }
+
+  float getHumidity() const
+  {
+    return humidity;
+  }
+
+private:
+  bool request(uint8_t type, uint32_t us)
+  {
+    if (!isConnected())
+    {
+      requestType = SHT2x_REQ_FAIL;
+      return false;
+    }
+    requestType = type;
+    ready = getHostTime() + us;
+    return true;
+  }
+
+private:
+  // [µs] max. conversion time per resolution, humidity includes temperature
+  const uint32_t TEMPERATURE_TIME[4] = { 10800, 3800, 6200, 2400 };
+  const uint32_t HUMIDITY_TIME[4] = { 22800, 7400, 11900, 9500 };
+
+  uint8_t resolution = 0;
+  uint8_t requestType = SHT2x_REQ_NONE;
+  uint64_t ready = 0; // [µs] host time
+  float temperature = 0;
+  float humidity = 0;
+};
@@ -0,0 +1,151 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the Arduino SPI Library
+ *
+ * file:     SPI.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+#define LSBFIRST  0
+#define MSBFIRST  1
+
+#define SPI_MODE0 0x02
+#define SPI_MODE1 0x00
+#define SPI_MODE2 0x03
+#define SPI_MODE3 0x01
+
+class SPISettings
+{
+public:
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+  SPISettings() : SPISettings(4000000, MSBFIRST, SPI_MODE0) {}
+
+public:
+  uint32_t clock;
+  uint8_t bitOrder;
+  uint8_t dataMode;
+};
+
+/**
+ * host: SPI slave, e.g. a register model of a radio
+ */
+class HostSpiDevice
+{
+public:
+  virtual ~HostSpiDevice() = default;
+
+public:
+  virtual void select() = 0;
+  virtual void deselect() = 0;
+  virtual uint8_t transfer(uint8_t data) = 0;
+};
+
+/**
+ * subset of SPIClass, transfers go to the attached device while its chip
+ * select pin is low, MISO reads 0xFF otherwise
+ *
+ * The chip select is sampled with each transfer and the device is deselected
+ * by endTransaction(). The host time advances by the duration of each byte
+ * at the clock of the transaction.
+ */
+class SPIClass
+{
+public:
+  static const uint32_t TRANSACTION_OVERHEAD = 2; // [µs] chip select and SERCOM setup
+
+public:
+  void begin()
+  {
+    active = true;
+  }
+
+  void end()
+  {
+    active = false;
+  }
+
+  void beginTransaction(SPISettings settings)
+  {
+    this->settings = settings;
+    advanceHostTime(TRANSACTION_OVERHEAD);
+  }
+
+  void endTransaction()
+  {
+    if (device && selected)
+    {
+      device->deselect();
+    }
+    selected = false;
+  }
+
+  uint8_t transfer(uint8_t data)
+  {
+    if (!active || !settings.clock)
+    {
+      return 0xFF;
+    }
+    byteTime += 8000000000ULL/settings.clock; // [ns]
+    advanceHostTime(byteTime/1000);
+    byteTime %= 1000;
+    if (!device || getHostPin(csPin).level != LOW)
+    {
+      return 0xFF;
+    }
+    if (!selected)
+    {
+      device->select();
+      selected = true;
+    }
+    return device->transfer(data);
+  }
+
+  /**
+   * host: connect device to chip select pin, null to disconnect
+   */
+  void attach(HostSpiDevice* device, uint32_t csPin)
+  {
+    this->device = device;
+    this->csPin = csPin;
+    selected = false;
+  }
+
+  bool isActive() const
+  {
+    return active;
+  }
+
+private:
+  SPISettings settings;
+  HostSpiDevice* device = nullptr;
+  uint32_t csPin = 0;
+  bool selected = false;
+  bool active = false;
+  uint64_t byteTime = 0; // [ns] remainder below 1 µs
+};
+
+static SPIClass SPI;
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the SAMD21LPE System Header
+ *
+ * file:     System.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+namespace SAMD21LPE
+{
+
+/**
+ * subset of SAMD21LPE::System, records the generic clock of each peripheral,
+ * the sleep mode and the SysTick state
+ */
+class System
+{
+public:
+  enum SleepMode
+  {
+    IDLE0,
+    IDLE1,
+    IDLE2,
+    STANDBY
+  };
+
+public:
+  static void enableClock(byte clockId, byte clockGen)
+  {
+    getClockGen(clockId) = clockGen + 1;
+  }
+
+  /**
+   * @return generic clock generator + 1 of peripheral, 0 if disabled
+   */
+  static byte& getClockGen(byte clockId)
+  {
+    static byte clockGens[64];
+    return clockGens[clockId % 64];
+  }
+
+  static void setupClockGenOSCULP32K(byte clockGen, byte divider)
+  {
+    (void)clockGen;
+    (void)divider;
+  }
+
+  static void setSleepMode(SleepMode mode)
+  {
+    getSleepMode() = mode;
+  }
+
+  static SleepMode& getSleepMode()
+  {
+    static SleepMode mode = IDLE0;
+    return mode;
+  }
+
+  static void enableSysTick()
+  {
+    isSysTickEnabled() = true;
+  }
+
+  static void disableSysTick()
+  {
+    isSysTickEnabled() = false;
+  }
+
+  static bool& isSysTickEnabled()
+  {
+    static bool enabled = true;
+    return enabled;
+  }
+
+  static void setSleepOnExitISR(bool enabled)
+  {
+    (void)enabled;
+  }
+
+  static void cacheVectorTable()
+  {
+  }
+
+  static void reducePowerConsumption()
+  {
+  }
+
+  static void enablePORT()
+  {
+  }
+};
+
+}
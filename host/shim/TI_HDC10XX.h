@@ -0,0 +1,152 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the TI HDC10XX Library
+ *
+ * file:     TI_HDC10XX.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Wire.h"
+
+/**
+ * subset of TI_HDC1080, the acquisition completes after the conversion time
+ * of the resolution in host time and returns the values of HostClimate
+ */
+class TI_HDC1080
+{
+public:
+  enum AcquisitionType
+  {
+    ACQ_TYPE_TEMPERATURE = 1,
+    ACQ_TYPE_HUMIDITY    = 2,
+    ACQ_TYPE_COMBINED    = 3
+  };
+
+public:
+  bool isConnected()
+  {
+    return Wire.isActive() && getHostClimate().connected;
+  }
+
+  bool reset()
+  {
+    acquisition = 0;
+    return isConnected();
+  }
+
+  bool setResolution(uint8_t humidityBits, uint8_t temperatureBits)
+  {
+    this->humidityBits = humidityBits;
+    this->temperatureBits = temperatureBits;
+    return isConnected();
+  }
+
+  bool isSupplyVoltageOK()
+  {
+    return true;
+  }
+
+  uint32_t readSerialIdLow()
+  {
+    return 0x0000A1B2;
+  }
+
+  uint32_t readSerialIdHigh()
+  {
+    return 0x0000C3D4;
+  }
+
+  bool startAcquisition(AcquisitionType type)
+  {
+    if (!isConnected())
+    {
+      acquisition = 0;
+      return false;
+    }
+    acquisition = type;
+    ready = getHostTime() + getAcquisitionTime();
+    return true;
+  }
+
+  bool isAcquisitionComplete()
+  {
+    return acquisition && getHostTime() >= ready;
+  }
+
+  bool readTemperature()
+  {
+    if (!(acquisition & ACQ_TYPE_TEMPERATURE) || !isAcquisitionComplete())
+    {
+      return false;
+    }
+    temperature = getHostClimate().temperature;
+    return true;
+  }
+
+  bool readHumidity()
+  {
+    if (!(acquisition & ACQ_TYPE_HUMIDITY) || !isAcquisitionComplete())
+    {
+      return false;
+    }
+    humidity = getHostClimate().humidity;
+    return true;
+  }
+
+  float getTemperature() const
+  {
+    return temperature;
+  }
+
+  float getHumidity() const
+  {
+    return humidity;
+  }
+
+  /**
+   * @return [µs] conversion time of the last acquisition type, datasheet 8.5
+   */
+  uint32_t getAcquisitionTime() const
+  {
+    uint32_t time = 0;
+    if (acquisition & ACQ_TYPE_TEMPERATURE)
+    {
+      time += temperatureBits >= 14? 6350 : 3650;
+    }
+    if (acquisition & ACQ_TYPE_HUMIDITY)
+    {
+      time += humidityBits >= 14? 6500 : humidityBits >= 11? 3850 : 2500;
+    }
+    return time;
+  }
+
+private:
+  byte acquisition = 0;
+  uint8_t humidityBits = 14;
+  uint8_t temperatureBits = 14;
+  uint64_t ready = 0; // [µs] host time
+  float temperature = 0;
+  float humidity = 0;
+};
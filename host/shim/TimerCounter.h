@@ -0,0 +1,114 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the SAMD21LPE TC Header
+ *
+ * file:     TimerCounter.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+namespace SAMD21LPE
+{
+
+/**
+ * subset of SAMD21LPE::TimerCounter, the timer callback is fired by the
+ * event loop of the host test, wait() advances the host time
+ */
+class TimerCounter
+{
+public:
+  enum Prescaler
+  {
+    DIV1, DIV2, DIV4, DIV8, DIV16, DIV64, DIV256, DIV1024
+  };
+
+  enum Resolution
+  {
+    RES8,
+    RES16,
+    RES32
+  };
+
+public:
+  TimerCounter() = default;
+
+public:
+  void enable(byte id, byte clockGen, uint32_t frequency, Prescaler prescaler, Resolution resolution,
+              uint16_t maxDuration = 1000, bool runStandby = true, byte priority = 0)
+  {
+    (void)clockGen;
+    (void)frequency;
+    (void)prescaler;
+    (void)resolution;
+    (void)maxDuration;
+    (void)runStandby;
+    (void)priority;
+    this->id = id;
+  }
+
+  /**
+   * @param ms duration until callback
+   */
+  void start(uint32_t ms, bool repeat, HostCallback callback)
+  {
+    timer.start(ms*1000ULL, repeat, callback);
+  }
+
+  void cancel()
+  {
+    timer.cancel();
+  }
+
+  /**
+   * sleep until duration has elapsed
+   */
+  void wait(uint32_t ms)
+  {
+    delay(ms);
+  }
+
+  /**
+   * host: TC instance of enable(), 0 if not enabled
+   */
+  byte getId() const
+  {
+    return id;
+  }
+
+  /**
+   * host: timer of start()
+   */
+  HostTimer& getTimer()
+  {
+    return timer;
+  }
+
+private:
+  byte id = 0;
+  HostTimer timer;
+};
+
+}
@@ -0,0 +1,123 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the Arduino Wire Library
+ *
+ * file:     Wire.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+/**
+ * host: climate measured by the I2C sensor shims (SHT2x.h, TI_HDC10XX.h)
+ */
+struct HostClimate
+{
+  float temperature = 21.5; // [°C]
+  float humidity = 45;      // [%]
+  bool connected = true;    // sensors respond on the bus
+};
+
+inline HostClimate& getHostClimate()
+{
+  static HostClimate climate;
+  return climate;
+}
+
+/**
+ * subset of TwoWire, every write is acknowledged while the sensors are
+ * connected, reads return no data
+ */
+class TwoWire
+{
+public:
+  void begin()
+  {
+    active = true;
+  }
+
+  void end()
+  {
+    active = false;
+  }
+
+  void setTimeout(uint32_t timeout)
+  {
+    (void)timeout;
+  }
+
+  void setClock(uint32_t clock)
+  {
+    (void)clock;
+  }
+
+  void beginTransmission(uint8_t address)
+  {
+    (void)address;
+  }
+
+  size_t write(uint8_t data)
+  {
+    (void)data;
+    return 1;
+  }
+
+  /**
+   * @return 0 = ACK, 2 = NACK on address
+   */
+  uint8_t endTransmission(bool stop = true)
+  {
+    (void)stop;
+    return active && getHostClimate().connected? 0 : 2;
+  }
+
+  uint8_t requestFrom(uint8_t address, size_t quantity, bool stop = true)
+  {
+    (void)address;
+    (void)quantity;
+    (void)stop;
+    return 0;
+  }
+
+  int available()
+  {
+    return 0;
+  }
+
+  int read()
+  {
+    return -1;
+  }
+
+  bool isActive() const
+  {
+    return active;
+  }
+
+private:
+  bool active = false;
+};
+
+static TwoWire Wire;
@@ -0,0 +1,387 @@
+/*****************************************************************************
+ *
+ * Host Replacement of the Si4432 Library
+ *
+ * file:     si4432.h
+ * encoding: UTF-8
+ * created:  18.10.2026
+ *
+ *****************************************************************************
+ *
+ * Copyright (C) 2026 Jens B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "SPI.h"
+
+/**
+ * subset of the Si4432 library used by the sketch, register accesses over
+ * the SPI shim in the order of the library
+ *
+ * Without a device attached to the SPI shim all registers read 0xFF and
+ * init() fails like with a missing radio. Host tests attach a register model
+ * (e.g. Si4432Emulator.h) and drive the NIRQ pin.
+ *
+ * Settings given before init() are written by boot(), the configuration
+ * callback of setConfigCallback() is called by boot() for the remaining
+ * registers.
+ */
+class Si4432
+{
+public:
+  enum Registers
+  {
+    REG_DEV_TYPE           = 0x00,
+    REG_DEV_VERSION        = 0x01,
+    REG_DEV_STATUS         = 0x02,
+    REG_INT_STATUS1        = 0x03,
+    REG_INT_STATUS2        = 0x04,
+    REG_INT_ENABLE1        = 0x05,
+    REG_INT_ENABLE2        = 0x06,
+    REG_STATE              = 0x07,
+    REG_OPERATION_CONTROL  = 0x08,
+    REG_GPIO0_CONF         = 0x0B,
+    REG_GPIO1_CONF         = 0x0C,
+    REG_GPIO2_CONF         = 0x0D,
+    REG_DATAACCESS_CONTROL = 0x30,
+    REG_PKG_LEN            = 0x3E,
+    REG_RECEIVED_LENGTH    = 0x4B,
+    REG_TX_POWER           = 0x6D,
+    REG_TX_DATARATE1       = 0x6E,
+    REG_TX_DATARATE0       = 0x6F,
+    REG_MODULATION_MODE1   = 0x70,
+    REG_MODULATION_MODE2   = 0x71,
+    REG_FREQBAND           = 0x75,
+    REG_FREQCARRIER_H      = 0x76,
+    REG_FREQCARRIER_L      = 0x77,
+    REG_FIFO               = 0x7F
+  };
+
+  enum ModulationType
+  {
+    UnmodulatedCarrier = 0x00,
+    OOK                = 0x01,
+    FSK                = 0x02,
+    GFSK               = 0x03
+  };
+
+  /**
+   * REG_STATE after TX and RX
+   */
+  enum IdleMode
+  {
+    SleepMode = 0x00, // standby, crystal off
+    Ready     = 0x01  // crystal on
+  };
+
+  /**
+   * getIntStatus(): REG_INT_STATUS1 | REG_INT_STATUS2 << 8
+   */
+  enum InterruptStatus
+  {
+    INT_CRCERROR = 0x0001,
+    INT_PKVALID  = 0x0002,
+    INT_PKSENT   = 0x0004,
+    INT_POR      = 0x0100,
+    INT_CHIPRDY  = 0x0200,
+    INT_PREAVAL  = 0x4000
+  };
+
+  static const byte GPIO_TX_STATE_OUTPUT = 0x12;
+  static const byte GPIO_RX_STATE_OUTPUT = 0x15;
+
+  static const byte DEVICE_TYPE = 0x08;
+  static const byte STATE_RXON = 0x04;
+  static const byte STATE_TXON = 0x08;
+  static const byte FIFO_CLEAR_TX = 0x01;
+  static const byte FIFO_CLEAR_RX = 0x02;
+  static const uint16_t CHIP_READY_TIMEOUT = 50; // [ms]
+
+  typedef void (*Callback)();
+
+public:
+  Si4432(byte csPin, byte sdnPin, byte intPin) : csPin(csPin), sdnPin(sdnPin), intPin(intPin) {}
+
+public:
+  void setModulationType(ModulationType type)
+  {
+    modulation = type;
+  }
+
+  void setManchesterEncoding(bool enabled, bool inverted)
+  {
+    manchester = enabled;
+    manchesterInverted = inverted;
+  }
+
+  /**
+   * packet handler with CRC, written by boot() and startListening()
+   */
+  void setPacketHandling(bool enabled, bool lsbFirst)
+  {
+    packetHandling = enabled;
+    this->lsbFirst = lsbFirst;
+  }
+
+  void setSendBlocking(bool blocking)
+  {
+    sendBlocking = blocking;
+  }
+
+  void setConfigCallback(Callback callback)
+  {
+    configCallback = callback;
+  }
+
+  void setIdleMode(IdleMode mode)
+  {
+    idleMode = mode;
+  }
+
+  /**
+   * @param level 0..7
+   * @param direct not used
+   */
+  void setTransmitPower(byte level, bool direct)
+  {
+    (void)direct;
+    ChangeRegister(REG_TX_POWER, 0x18 | (level & 0x07)); // LNA switch
+  }
+
+  /**
+   * @param mhz 240 .. 480 MHz (low band)
+   */
+  void setFrequency(float mhz)
+  {
+    byte band = (byte)(mhz/10) - 24;
+    uint16_t carrier = (uint16_t)lround((mhz/10 - (band + 24))*64000);
+    ChangeRegister(REG_FREQBAND, 0x40 | band);
+    ChangeRegister(REG_FREQCARRIER_H, carrier >> 8);
+    ChangeRegister(REG_FREQCARRIER_L, carrier & 0xFF);
+  }
+
+  /**
+   * @param kbps TX data rate, scaled below 30 kbps
+   */
+  void setBaudRate(float kbps)
+  {
+    this->kbps = kbps;
+    uint16_t txdr = (uint16_t)lround(kbps*1000*(kbps < 30? 1 << 21 : 1 << 16)/1e6);
+    ChangeRegister(REG_MODULATION_MODE1, getModulationMode1());
+    ChangeRegister(REG_TX_DATARATE1, txdr >> 8);
+    ChangeRegister(REG_TX_DATARATE0, txdr & 0xFF);
+  }
+
+  /**
+   * power up radio, verify device type and configure
+   *
+   * @return false if the radio does not respond
+   */
+  bool init(SPIClass* spi, uint32_t spiClock)
+  {
+    this->spi = spi;
+    spiSettings = SPISettings(spiClock, MSBFIRST, SPI_MODE0);
+    pinMode(csPin, OUTPUT);
+    digitalWrite(csPin, HIGH);
+    pinMode(sdnPin, OUTPUT);
+    pinMode(intPin, INPUT);
+    spi->begin();
+
+    turnOn();
+    for (uint16_t ms=0; ms<CHIP_READY_TIMEOUT && digitalRead(intPin); ms++)
+    {
+      delay(1);
+    }
+    if (ReadRegister(REG_DEV_TYPE) != DEVICE_TYPE)
+    {
+      return false;
+    }
+    getIntStatus();
+    boot();
+    return true;
+  }
+
+  /**
+   * release SDN, the radio reports INT_CHIPRDY after power on reset
+   */
+  void turnOn()
+  {
+    digitalWrite(sdnPin, LOW);
+  }
+
+  void turnOff()
+  {
+    digitalWrite(sdnPin, HIGH);
+  }
+
+  /**
+   * write settings, call configuration callback and enter idle mode
+   */
+  void boot()
+  {
+    ChangeRegister(REG_MODULATION_MODE2, 0x20 | modulation); // FIFO mode
+    ChangeRegister(REG_MODULATION_MODE1, getModulationMode1());
+    ChangeRegister(REG_DATAACCESS_CONTROL, getDataAccessControl());
+    if (configCallback)
+    {
+      configCallback();
+    }
+    ChangeRegister(REG_STATE, idleMode);
+  }
+
+  /**
+   * load TX FIFO and start transmission, INT_PKSENT when completed
+   */
+  bool sendPacket(byte length, const byte* data)
+  {
+    ChangeRegister(REG_OPERATION_CONTROL, FIFO_CLEAR_TX);
+    ChangeRegister(REG_OPERATION_CONTROL, 0);
+    ChangeRegister(REG_PKG_LEN, length);
+    BurstWrite(REG_FIFO, data, length);
+    const byte enable[] = { (byte)INT_PKSENT, 0 };
+    BurstWrite(REG_INT_ENABLE1, enable, sizeof(enable));
+    getIntStatus();
+    ChangeRegister(REG_STATE, STATE_TXON | idleMode);
+
+    if (sendBlocking)
+    {
+      uint32_t start = millis();
+      while (digitalRead(intPin) && millis() - start < 1000);
+      return !digitalRead(intPin) && (getIntStatus() & INT_PKSENT);
+    }
+    return true;
+  }
+
+  /**
+   * switch to RX, INT_PKVALID or INT_CRCERROR when a packet was received
+   */
+  void startListening()
+  {
+    ChangeRegister(REG_DATAACCESS_CONTROL, getDataAccessControl());
+    ChangeRegister(REG_OPERATION_CONTROL, FIFO_CLEAR_RX);
+    ChangeRegister(REG_OPERATION_CONTROL, 0);
+    ChangeRegister(REG_INT_ENABLE1, INT_PKVALID | INT_CRCERROR);
+    ChangeRegister(REG_INT_ENABLE2, 0);
+    getIntStatus();
+    ChangeRegister(REG_STATE, STATE_RXON | Ready);
+  }
+
+  /**
+   * read RX FIFO
+   *
+   * @param length [bytes] of packet, max. 64
+   */
+  void getPacketReceived(byte* length, byte* data)
+  {
+    *length = ReadRegister(REG_RECEIVED_LENGTH);
+    BurstRead(REG_FIFO, data, *length);
+  }
+
+  /**
+   * @return pending interrupts, cleared by reading
+   */
+  uint16_t getIntStatus()
+  {
+    byte status1 = ReadRegister(REG_INT_STATUS1);
+    byte status2 = ReadRegister(REG_INT_STATUS2);
+    return status1 | (status2 << 8);
+  }
+
+  byte getIntPin() const
+  {
+    return intPin;
+  }
+
+  void ChangeRegister(Registers reg, byte value)
+  {
+    BurstWrite(reg, &value, 1);
+  }
+
+  byte ReadRegister(Registers reg)
+  {
+    byte value = 0xFF;
+    BurstRead(reg, &value, 1);
+    return value;
+  }
+
+  void BurstWrite(Registers reg, const byte* data, byte length)
+  {
+    beginTransfer(0x80 | reg);
+    for (byte i=0; i<length; i++)
+    {
+      spi->transfer(data[i]);
+    }
+    endTransfer();
+  }
+
+  void BurstRead(Registers reg, byte* data, byte length)
+  {
+    beginTransfer(reg);
+    for (byte i=0; i<length; i++)
+    {
+      data[i] = spi->transfer(0xFF);
+    }
+    endTransfer();
+  }
+
+private:
+  void beginTransfer(byte address)
+  {
+    if (!spi)
+    {
+      spi = &SPI;
+    }
+    spi->beginTransaction(spiSettings);
+    digitalWrite(csPin, LOW);
+    spi->transfer(address);
+  }
+
+  void endTransfer()
+  {
+    digitalWrite(csPin, HIGH);
+    spi->endTransaction();
+  }
+
+  byte getModulationMode1() const
+  {
+    return (kbps < 30? 0x20 : 0) | (manchesterInverted? 0x02 : 0) | (manchester? 0x01 : 0); // txdtrtscale
+  }
+
+  byte getDataAccessControl() const
+  {
+    return (lsbFirst? 0x40 : 0) | (packetHandling? 0x8C : 0); // RX and TX packet handler, CRC
+  }
+
+private:
+  byte csPin;
+  byte sdnPin;
+  byte intPin;
+  SPIClass* spi = nullptr;
+  SPISettings spiSettings;
+  ModulationType modulation = GFSK;
+  bool manchester = false;
+  bool manchesterInverted = false;
+  bool packetHandling = true;
+  bool lsbFirst = false;
+  bool sendBlocking = true;
+  float kbps = 1;
+  IdleMode idleMode = Ready;
+  Callback configCallback = nullptr;
+};